@@ -82,6 +82,8 @@ def get_num_cores():
     cores += len(args.program)
   if args.checkpoint:
     cores += len(args.checkpoint)
+  if args.trace:
+    cores += len(args.trace)
   return cores
 
 def make_checkpoint_loader():
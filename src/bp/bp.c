@@ -54,6 +54,7 @@
 #include "prefetcher/branch_misprediction_table.h"
 #include "prefetcher/fdip.h"
 
+#include "checkpoint.h"
 #include "decoupled_frontend.h"
 #include "icache_stage.h"
 #include "model.h"
@@ -94,6 +95,8 @@ Hash_Table per_branch_stat;
 /******************************************************************************/
 // Local prototypes
 
+static void bp_data_ckpt(Ckpt_Stream* stream, void* bp_data);
+
 /******************************************************************************/
 /* set_bp_data set the global bp_data pointer (so I don't have to pass it around
  * everywhere */
@@ -295,11 +298,43 @@ void init_bp_data(uns8 proc_id, Bp_Data* bp_data) {
   if (ENABLE_BP_CONF) {
     bp_data->br_conf = &br_conf_table[CONF_MECH];
     bp_data->br_conf->init_func();
+    ckpt_unsupported("branch confidence (ENABLE_BP_CONF)");
   }
 
+  /* histories, CRS and the tagless iBTB; the BTB and tagged iBTB are caches
+     and the direction predictors register their own state */
+  ckpt_register("bp_data", proc_id, bp_data_ckpt, bp_data);
+
   hbt_init();
 }
 
+/******************************************************************************/
+/* bp_data_ckpt: saves or restores (see ckpt_io) the warmed per-core predictor state */
+
+static void bp_data_ckpt(Ckpt_Stream* stream, void* arg) {
+  Bp_Data* bp_data = (Bp_Data*)arg;
+  uns tc_size = 0x1 << IBTB_HIST_LENGTH;
+
+  ckpt_io(stream, &bp_data->global_hist, sizeof(bp_data->global_hist));
+  ckpt_io(stream, &bp_data->targ_hist, sizeof(bp_data->targ_hist));
+  ckpt_io(stream, &bp_data->targ_index, sizeof(bp_data->targ_index));
+  ckpt_io(stream, &bp_data->on_path_pred, sizeof(bp_data->on_path_pred));
+  ckpt_io(stream, bp_data->crs.entries, sizeof(Crs_Entry) * CRS_ENTRIES * 2);
+  ckpt_io(stream, bp_data->crs.off_path, sizeof(Flag) * CRS_ENTRIES);
+  ckpt_io(stream, &bp_data->crs.depth, sizeof(bp_data->crs.depth));
+  ckpt_io(stream, &bp_data->crs.head, sizeof(bp_data->crs.head));
+  ckpt_io(stream, &bp_data->crs.tail, sizeof(bp_data->crs.tail));
+  ckpt_io(stream, &bp_data->crs.tail_save, sizeof(bp_data->crs.tail_save));
+  ckpt_io(stream, &bp_data->crs.depth_save, sizeof(bp_data->crs.depth_save));
+  ckpt_io(stream, &bp_data->crs.tos, sizeof(bp_data->crs.tos));
+  ckpt_io(stream, &bp_data->crs.next, sizeof(bp_data->crs.next));
+  if (bp_data->tc_tagless)
+    ckpt_io(stream, bp_data->tc_tagless, sizeof(Addr) * tc_size);
+  if (bp_data->tc_selector)
+    ckpt_io(stream, bp_data->tc_selector, sizeof(uns8) * tc_size);
+}
+
+
 Flag bp_is_predictable(Bp_Data* bp_data, uns proc_id) {
   return !bp_data->bp->full_func(proc_id);
 }
@@ -991,9 +1026,10 @@ void bp_target_known_op(Bp_Data* bp_data, Op* op) {
   ASSERT(bp_data->proc_id, bp_data->proc_id == op->proc_id);
   ASSERT(bp_data->proc_id, op->table_info->cf_type);
 
-  // Do not update BTB with invalid target addresses.
+  // Do not update BTB with invalid target addresses. The proc bits of the other cores are not part of the address.
   const Addr MIN_VALID_PC = 0x40;
-  if (op->oracle_info.target < MIN_VALID_PC || op->oracle_info.npc >= 0xffffffffffff) {
+  if (convert_to_cmp_addr(0, op->oracle_info.target) < MIN_VALID_PC ||
+      convert_to_cmp_addr(0, op->oracle_info.npc) >= 0xffffffffffff) {
     return;
   }
 
@@ -569,6 +569,49 @@ class TAGE64K {
   void SpecLoopUpdate(UINT64 PC, bool Taken, long long on_path_phist, int on_path_ptghist, bool off_path);
   void LoopUpdate(UINT64 PC, bool Taken, bool ALLOC, int lhit, long long on_path_phist, int on_path_ptghist);
 
+  // Checkpointing of the warmed S and N components (see checkpoint.h). Pstate, the GEHL pointers
+  // and the snapshot containers only describe in-flight branches and are not saved.
+  template <class Archive>
+  void serialize(Archive& ar) {
+#ifdef IMLI
+    ar.io(IGEHLA);
+    ar.io(IMGEHLA);
+    ar.io(IMHIST);
+    ar.io(IMLIcount);
+#endif
+    ar.io(GGEHLA);
+    ar.io(PGEHLA);
+    ar.io(LGEHLA);
+    ar.io(SGEHLA);
+    ar.io(TGEHLA);
+    ar.io(static_cast<SpeculativeStatesBase&>(Sstate));
+    ar.io(Sstate.ghist);
+    ar.io(Bias);
+    ar.io(BiasSK);
+    ar.io(BiasBank);
+    ar.io(L_shist);
+    ar.io(S_slhist);
+    ar.io(T_slhist);
+    ar.io(updatethreshold);
+    ar.io(Pupdatethreshold);
+    ar.io(WL);
+    ar.io(WS);
+    ar.io(WT);
+    ar.io(WI);
+    ar.io(WIM);
+    ar.io(WB);
+    ar.io(FirstH);
+    ar.io(SecondH);
+    ar.io(WITHLOOP);
+    ar.io(use_alt_on_na);
+    // gtable[2..BORN-1] and gtable[BORN+1..NHIST] share these two arrays
+    ar.io_array(gtable[1], NBANKLOW * (1 << LOGG));
+    ar.io_array(gtable[BORN], NBANKHIGH * (1 << LOGG));
+    ar.io_array(btable, 1 << LOGB);
+    ar.io(TICK);
+    ar.io(Seed);
+  }
+
   // P: Predictor components
   PredictorStates Pstate;
   // S: Speculative components
@@ -24,6 +24,7 @@
 #include "bp/bp.param.h"
 
 #include "cbp_to_scarab.h"
+#include "checkpoint.h"
 
 template <typename CBP_CLASS>
 class CBP_To_Scarab_Intf {
@@ -36,6 +37,9 @@ class CBP_To_Scarab_Intf {
       for (uns i = 0; i < NUM_CORES; ++i) {
         cbp_predictors.emplace_back();
       }
+      for (uns i = 0; i < NUM_CORES; ++i) {
+        register_ckpt(i);
+      }
     }
     ASSERTM(0, cbp_predictors.size() == NUM_CORES, "cbp_predictors not initialized correctly");
   }
@@ -76,8 +80,16 @@ class CBP_To_Scarab_Intf {
   void recover(Recovery_Info*) { /* CBP Interface does not support speculative updates */ }
 
   Flag full(uns proc_id) { return cbp_predictors.at(proc_id).IsFull(); }
+
+  /* Predictors without serialize() cannot be saved to a warm-state checkpoint */
+  void register_ckpt(uns proc_id) { ckpt_unsupported("this CBP branch predictor"); }
 };
 
+template <>
+void CBP_To_Scarab_Intf<TAGE64K>::register_ckpt(uns proc_id) {
+  ckpt_register_object("tage64k", proc_id, &cbp_predictors.at(proc_id));
+}
+
 // Specialization for TAGE64K
 template <>
 uns8 CBP_To_Scarab_Intf<TAGE64K>::pred(Op* op) {
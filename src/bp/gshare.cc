@@ -32,6 +32,8 @@ extern "C" {
 #include "statistics.h"
 }
 
+#include "checkpoint.h"
+
 #define PHT_INIT_VALUE (0x1 << (PHT_CTR_BITS - 1)) /* weakly taken */
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_BP_DIR, ##args)
 
@@ -69,9 +71,14 @@ uns8 bp_gshare_full(uns proc_id) {
 }
 
 void bp_gshare_init() {
+  // called once per core, but the state covers all cores
+  if (gshare_state_all_cores.size() != 0)
+    return;
   gshare_state_all_cores.resize(NUM_CORES);
-  for (auto& gshare_state : gshare_state_all_cores) {
-    gshare_state.pht.resize(1 << HIST_LENGTH, PHT_INIT_VALUE);
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    auto& pht = gshare_state_all_cores[proc_id].pht;
+    pht.resize(1 << HIST_LENGTH, PHT_INIT_VALUE);
+    ckpt_register_data("gshare_pht", proc_id, pht.data(), pht.size());
   }
 }
 
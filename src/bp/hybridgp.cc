@@ -35,6 +35,7 @@ extern "C" {
 }
 
 #include "bp/template_lib/utils.h"
+#include "checkpoint.h"
 
 #define PHT_INIT_VALUE (1 << (PHT_CTR_BITS - 1)) /* weakly taken */
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_BP_DIR, ##args)
@@ -61,6 +62,15 @@ struct Hybridgp_State {
   Circular_Buffer<Hybridgp_In_Flight_State> in_flight;
 
   Hybridgp_State(uns max_in_flight_branches) : in_flight(max_in_flight_branches) {}
+
+  // warmed tables only: bht is a cache_lib cache and checkpoints itself
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(hybspht);
+    ar.io(hybgpht);
+    ar.io(hybppht);
+    ar.io(filter);
+  }
 };
 
 std::vector<Hybridgp_State> hybridgp_state_all_cores;
@@ -258,6 +268,9 @@ void update_all_phts(const Op* op, Hybridgp_State& hybridgp_state, const Hybridg
 }  // namespace
 
 void bp_hybridgp_init() {
+  // called once per core, but the state covers all cores
+  if (hybridgp_state_all_cores.size() != 0)
+    return;
   for (uns i = 0; i < NUM_CORES; ++i) {
     hybridgp_state_all_cores.emplace_back(NODE_TABLE_SIZE);
   }
@@ -281,6 +294,10 @@ void bp_hybridgp_init() {
       brmispred = fopen(brmispredfile, "w");
     }
   }
+  if (INF_HYBRIDGP)
+    ckpt_unsupported("INF_HYBRIDGP");
+  for (uns i = 0; i < NUM_CORES; ++i)
+    ckpt_register_object("hybridgp", i, &hybridgp_state_all_cores[i]);
 }
 
 uns8 bp_hybridgp_pred(Op* op) {
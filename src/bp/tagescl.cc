@@ -34,6 +34,7 @@ extern "C" {
 }
 
 #include "bp/template_lib/tagescl.h"
+#include "checkpoint.h"
 
 namespace {
 // A vector of TAGE-SC-L tables. One table per core.
@@ -75,9 +76,13 @@ void bp_tagescl_init() {
     tagescl_predictors.reserve(NUM_CORES);
     for (uns i = 0; i < NUM_CORES; ++i) {
       if (BP_MECH == TAGESCL_BP) {
-        tagescl_predictors.push_back(std::make_unique<Tage_SC_L<TAGE_SC_L_CONFIG_64KB>>(NODE_TABLE_SIZE));
+        auto predictor = std::make_unique<Tage_SC_L<TAGE_SC_L_CONFIG_64KB>>(NODE_TABLE_SIZE);
+        ckpt_register_object("tagescl", i, predictor.get());
+        tagescl_predictors.push_back(std::move(predictor));
       } else {
-        tagescl_predictors.push_back(std::make_unique<Tage_SC_L<TAGE_SC_L_CONFIG_80KB>>(NODE_TABLE_SIZE));
+        auto predictor = std::make_unique<Tage_SC_L<TAGE_SC_L_CONFIG_80KB>>(NODE_TABLE_SIZE);
+        ckpt_register_object("tagescl80", i, predictor.get());
+        tagescl_predictors.push_back(std::move(predictor));
       }
     }
   }
@@ -198,6 +198,13 @@ class Loop_Predictor {
     prediction_info->hit_bank = -1;
   }
 
+
+  // Checkpointing of the warmed table (see checkpoint.h).
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(table_);
+  }
+
  private:
   struct LoopPredictorEntry {
     int16_t total_iterations = 0;                                                              // 10 bits
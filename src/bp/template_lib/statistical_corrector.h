@@ -183,6 +183,41 @@ class Statistical_Corrector {
     }
   }
 
+
+  // Checkpointing of the warmed tables (see checkpoint.h).
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(global_history_);
+    ar.io(path_);
+    ar.io(first_local_history_table_);
+    ar.io(second_local_history_table_);
+    ar.io(third_local_history_table_);
+    ar.io(imli_counter_);
+    ar.io(imli_table_);
+    ar.io(first_high_confidence_ctr_);
+    ar.io(second_high_confidence_ctr_);
+    ar.io(update_threshold_);
+    ar.io(p_update_thresholds_);
+    ar.io(global_history_gehl_);
+    ar.io(path_gehl_);
+    ar.io(first_local_gehl_);
+    ar.io(second_local_gehl_);
+    ar.io(third_local_gehl_);
+    ar.io(first_imli_gehl_);
+    ar.io(second_imli_gehl_);
+    ar.io(global_history_threshold_table_);
+    ar.io(path_threshold_table_);
+    ar.io(first_local_threshold_table_);
+    ar.io(second_local_threshold_table_);
+    ar.io(third_local_threshold_table_);
+    ar.io(first_imli_threshold_table_);
+    ar.io(second_imli_threshold_table_);
+    ar.io(bias_threshold_table_);
+    ar.io(bias_table_);
+    ar.io(bias_sk_table_);
+    ar.io(bias_bank_table_);
+  }
+
  private:
   using Counter_Type = Saturating_Counter<CONFIG::SC::PRECISION, true>;
   using Per_PC_Threshold_Table_Type =
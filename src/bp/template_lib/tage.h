@@ -80,6 +80,16 @@ class Long_History_Register {
     return head_;
   }
 
+
+  // Checkpointing of the warmed history (see checkpoint.h). The buffer geometry
+  // comes from the constructor.
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(num_speculative_bits_);
+    ar.io(history_bits_);
+    ar.io(head_);
+  }
+
  private:
   int num_speculative_bits_ = 0;  // keeps track of how many bits can be
                                   // discarded during a rewind without losing
@@ -292,6 +302,17 @@ class Tage_Histories {
   int64_t path_history_;
   int64_t head_old_;
   int64_t path_history_old_;
+
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(history_register_);
+    ar.io(folded_histories_for_indices_);
+    ar.io(folded_histories_for_tags_0_);
+    ar.io(folded_histories_for_tags_1_);
+    ar.io(path_history_);
+    ar.io(head_old_);
+    ar.io(path_history_old_);
+  }
 };
 
 template <class TAGE_CONFIG>
@@ -553,6 +574,19 @@ class Tage {
     *prediction_info = {};
   }
 
+
+  // Checkpointing of the warmed tables. tagged_table_ptrs_ point into this
+  // object and random_number_gen_ belongs to the owner, so neither is saved.
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(tage_histories_);
+    ar.io(bimodal_table_);
+    ar.io(low_history_tagged_table_);
+    ar.io(high_history_tagged_table_);
+    ar.io(alt_selector_table_);
+    ar.io(tick_);
+  }
+
  private:
   struct Bimodal_Entry {
     int8_t hysteresis = 1;
@@ -117,6 +117,18 @@ class Tage_SC_L : public Tage_SC_L_Base {
   void flush_branch_and_repair_state(int64_t branch_id, uint64_t br_pc, Branch_Type br_type, bool resolve_dir,
                                      uint64_t br_target) override;
 
+
+  // Checkpointing of the warmed predictor (see checkpoint.h). The prediction
+  // info buffer only holds in-flight branches and is not saved.
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(random_number_gen_.seed_);
+    ar.io(tage_);
+    ar.io(statistical_corrector_);
+    ar.io(loop_predictor_);
+    ar.io(loop_predictor_beneficial_);
+  }
+
  private:
   Random_Number_Generator random_number_gen_;
   Tage<typename CONFIG::TAGE> tage_;
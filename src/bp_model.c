@@ -0,0 +1,419 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/***************************************************************************************
+ * File         : bp_model.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Model that replays the branches of the frontend stream through
+ *                the branch predictors in program order (no core modeling)
+ *
+ * Every control flow op goes through bp_predict_op(), bp_target_known_op(),
+ * bp_resolve_op() and bp_retire_op() as soon as it is fetched, and the
+ * predictor is recovered right away on a wrong prediction, the way cmp_warmup
+ * trains it. There is no pipeline, memory system or wrong path, so a run is
+ * bound by the frontend and the predictors themselves.
+ *
+ * The bp_model_extra_mechs predictors see the same stream through their Bp
+ * interface functions. They predict conditional branch directions only; the
+ * BTB, iBTB and call-return stack belong to bp_mech. At the end bp_model.out
+ * lists the MPKI of every predictor, the HBT (hbt.c) view of the run and the
+ * static branches with the most bp_mech mispredicts.
+ ***************************************************************************************/
+
+#include "bp_model.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "debug/debug.param.h"
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+
+#include "bp/bp.param.h"
+#include "core.param.h"
+#include "general.param.h"
+#include "prefetcher/pref.param.h"
+
+#include "bp/hbt.h"
+#include "frontend/frontend.h"
+#include "isa/isa_macros.h"
+#include "libs/hash_lib.h"
+
+#include "freq.h"
+#include "map.h"
+#include "model.h"
+#include "op_pool.h"
+#include "sim.h"
+#include "statistics.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_BP, ##args)
+
+#define BP_MODEL_FETCH_BATCH 16 /* ops per frontend_fetch_ops call */
+
+/**************************************************************************************/
+/* Types */
+
+/* one static branch */
+typedef struct Bp_Model_Branch_struct {
+  Addr addr;
+  Cf_Type cf_type;
+  Counter execs;
+  Counter taken;
+  Counter hard_execs;                     /* predicted while the HBT had it as hard */
+  Counter target_misses;                  /* bp_mech predicted the wrong next pc */
+  Counter mispreds[BP_MODEL_MAX_MECHS];   /* direction mispredicts, [0] is bp_mech */
+} Bp_Model_Branch;
+
+typedef struct Bp_Model_Core_struct {
+  Hash_Table branches; /* Bp_Model_Branch by address */
+  Counter cbrs;
+  Counter hard_cbrs;
+  Counter hard_mispreds; /* bp_mech direction mispredicts of hard cbrs */
+  Counter target_misses;
+  Counter mispreds[BP_MODEL_MAX_MECHS];
+} Bp_Model_Core;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void bp_model_replay(Op* op, Flag record);
+static void bp_model_extra_replay(Bp* mech, Op* op);
+static void bp_model_fetch(uns proc_id);
+static void bp_model_report_core(FILE* file, uns proc_id);
+static int bp_model_branch_cmp(const void* a, const void* b);
+
+/**************************************************************************************/
+/* Global variables */
+
+Bp_Model bp_model;
+static Bp* mechs[BP_MODEL_MAX_MECHS]; /* [0] is bp_mech */
+static uns num_mechs;
+static Bp_Model_Core* cores;
+
+/**************************************************************************************/
+/* bp_model_init */
+
+void bp_model_init(uns mode) {
+  if (mode != WARMUP_MODE)
+    return;
+
+  ASSERTM(0, !CONFIDENCE_ENABLE, "The bp model has no decoupled frontend to resolve confidence in\n");
+  ASSERTM(0, !FDIP_DUAL_PATH_PREF_UOC_ONLINE_ENABLE, "The bp model has no uop cache\n");
+
+  freq_init();
+
+  bp_model.thread_data = (Thread_Data*)calloc(NUM_CORES, sizeof(Thread_Data));
+  bp_model.bp_recovery_info = (Bp_Recovery_Info*)malloc(sizeof(Bp_Recovery_Info) * NUM_CORES);
+  bp_model.bp_data = (Bp_Data*)malloc(sizeof(Bp_Data) * NUM_CORES);
+  cores = (Bp_Model_Core*)calloc(NUM_CORES, sizeof(Bp_Model_Core));
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    bp_model.thread_data[proc_id].proc_id = proc_id;
+    set_thread_data(&bp_model.thread_data[proc_id]);
+    /* free_op() unlinks ops from the dependence maps, so every core needs one */
+    set_map_data(&td->map_data);
+    init_map(proc_id);
+    init_bp_recovery_info(proc_id, &bp_model.bp_recovery_info[proc_id]);
+    init_bp_data(proc_id, &bp_model.bp_data[proc_id]);
+    init_hash_table(&cores[proc_id].branches, "BP model static branches", 4096, sizeof(Bp_Model_Branch));
+  }
+
+  mechs[0] = &bp_table[BP_MECH];
+  num_mechs = 1;
+  if (BP_MODEL_EXTRA_MECHS) {
+    char names[BP_MODEL_MAX_MECHS - 1][MAX_STR_LENGTH + 1];
+    uns num_names = parse_string_array(names, BP_MODEL_EXTRA_MECHS, BP_MODEL_MAX_MECHS - 1);
+    for (uns ii = 0; ii < num_names; ii++) {
+      Bp* mech = NULL;
+      for (uns jj = 0; bp_table[jj].name; jj++)
+        if (strncmp(names[ii], bp_table[jj].name, MAX_STR_LENGTH) == 0)
+          mech = &bp_table[jj];
+      if (!mech)
+        FATAL_ERROR(0, "Invalid bp_mech ('%s') in bp_model_extra_mechs\n", names[ii]);
+      /* tagescl picks its table size from BP_MECH, and predictors that share
+         their init function (tagescl and tagescl80) share their state */
+      ASSERTM(0, mech->id != TAGESCL_BP, "tagescl can only be the bp_mech; compare against tagescl80 instead\n");
+      for (uns jj = 0; jj < num_mechs; jj++)
+        ASSERTM(0, mech->init_func != mechs[jj]->init_func, "%s shares its state with %s\n", mech->name,
+                mechs[jj]->name);
+      ASSERTM(0, !USE_LATE_BP || mech->init_func != bp_table[LATE_BP_MECH].init_func,
+              "%s shares its state with the late_bp_mech\n", mech->name);
+      mech->init_func();
+      mechs[num_mechs++] = mech;
+    }
+  }
+}
+
+/**************************************************************************************/
+/* bp_model_reset: */
+
+void bp_model_reset() {
+}
+
+/**************************************************************************************/
+/* bp_model_cycle: */
+
+void bp_model_cycle() {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if (sim_done[proc_id] || retired_exit[proc_id])
+      continue;
+    if (freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
+      cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+      set_thread_data(&bp_model.thread_data[proc_id]);
+      set_map_data(&td->map_data);
+      set_bp_recovery_info(&bp_model.bp_recovery_info[proc_id]);
+      set_bp_data(&bp_model.bp_data[proc_id]);
+      STAT_EVENT(proc_id, NODE_CYCLE);
+      bp_model_fetch(proc_id);
+    }
+  }
+}
+
+/**************************************************************************************/
+/* bp_model_fetch: replays up to BP_MODEL_INSTS_PER_CYCLE instructions of the core's
+   stream, stopping early at the end of the stream or at the instruction limit */
+
+static void bp_model_fetch(uns proc_id) {
+  Op* ops[BP_MODEL_FETCH_BATCH];
+
+  for (uns insts = 0; insts < BP_MODEL_INSTS_PER_CYCLE;) {
+    if (!frontend_can_fetch_op(proc_id)) {
+      retired_exit[proc_id] = TRUE;
+      return;
+    }
+    uns num = frontend_fetch_ops(proc_id, ops, BP_MODEL_FETCH_BATCH);
+    for (uns ii = 0; ii < num; ii++) {
+      Op* op = ops[ii];
+      op_count[proc_id]++;
+      unique_count_per_core[proc_id]++;
+      unique_count++;
+
+      if (op->table_info->cf_type)
+        bp_model_replay(op, TRUE);
+
+      uop_count[proc_id]++;
+      STAT_EVENT(proc_id, NODE_UOP_COUNT);
+      if (op->eom) {
+        inst_count[proc_id]++;
+        STAT_EVENT(proc_id, NODE_INST_COUNT);
+        if (op->fetched_instruction) {
+          inst_count_fetched[proc_id]++;
+          STAT_EVENT(proc_id, NODE_INST_COUNT_FETCHED);
+        }
+        insts++;
+        if (op->exit)
+          retired_exit[proc_id] = TRUE;
+        else if (IS_CALLSYS(op->table_info) || op->table_info->bar_type & BAR_FETCH ||
+                 inst_count[proc_id] % NODE_RETIRE_RATE == 0)
+          frontend_retire(proc_id, op->inst_uid);
+      }
+      free_op(op);
+    }
+    if (retired_exit[proc_id] || (INST_LIMIT && inst_count[proc_id] >= inst_limit[proc_id]))
+      return;
+  }
+}
+
+/**************************************************************************************/
+/* bp_model_warmup: trains the predictors without counting anything */
+
+void bp_model_warmup(Op* op) {
+  if (op->table_info->cf_type) {
+    set_thread_data(&bp_model.thread_data[op->proc_id]);
+    set_bp_recovery_info(&bp_model.bp_recovery_info[op->proc_id]);
+    set_bp_data(&bp_model.bp_data[op->proc_id]);
+    bp_model_replay(op, FALSE);
+  }
+}
+
+/**************************************************************************************/
+/* bp_model_replay: predicts, resolves and retires one cf op with every predictor */
+
+static void bp_model_replay(Op* op, Flag record) {
+  uns proc_id = op->proc_id;
+  Bp_Data* bp_data = &bp_model.bp_data[proc_id];
+  Flag cbr = op->table_info->cf_type == CF_CBR;
+
+  bp_predict_op(bp_data, op, 1, op->inst_info->addr);
+  bp_target_known_op(bp_data, op);
+  bp_resolve_op(bp_data, op);
+  if (op->oracle_info.mispred || op->oracle_info.misfetch)
+    bp_recover_op(bp_data, op->table_info->cf_type, &op->recovery_info);
+  bp_retire_op(bp_data, op);
+
+  /* what the direction predictor said, before the BTB had its say */
+  Flag mispreds[BP_MODEL_MAX_MECHS];
+  mispreds[0] = cbr && op->oracle_info.pred_orig != op->oracle_info.dir;
+  Flag target_miss = op->oracle_info.mispred || op->oracle_info.misfetch;
+  Flag hard = op->oracle_info.hbt_pred_is_hard;
+
+  /* the extra predictors may overwrite the prediction and recovery fields of
+     the op, bp_mech is done with them by now */
+  for (uns ii = 1; ii < num_mechs; ii++) {
+    bp_model_extra_replay(mechs[ii], op);
+    mispreds[ii] = cbr && op->oracle_info.pred != op->oracle_info.dir;
+  }
+
+  if (!record)
+    return;
+
+  Bp_Model_Core* core = &cores[proc_id];
+  Flag new_entry;
+  Bp_Model_Branch* branch = (Bp_Model_Branch*)hash_table_access_create(&core->branches, op->inst_info->addr,
+                                                                        &new_entry);
+  if (new_entry) {
+    memset(branch, 0, sizeof(Bp_Model_Branch));
+    branch->addr = op->inst_info->addr;
+    branch->cf_type = op->table_info->cf_type;
+  }
+  branch->execs++;
+  branch->taken += op->oracle_info.dir;
+  branch->hard_execs += hard;
+  branch->target_misses += target_miss;
+  core->target_misses += target_miss;
+  if (cbr) {
+    core->cbrs++;
+    core->hard_cbrs += hard;
+    core->hard_mispreds += hard && mispreds[0];
+    for (uns ii = 0; ii < num_mechs; ii++) {
+      branch->mispreds[ii] += mispreds[ii];
+      core->mispreds[ii] += mispreds[ii];
+    }
+  }
+}
+
+/**************************************************************************************/
+/* bp_model_extra_replay: runs one op through a predictor other than bp_mech, in the
+   order bp.c calls bp_mech. Only conditional branches are predicted; the others
+   just update the predictor's history with their (always right) direction. */
+
+static void bp_model_extra_replay(Bp* mech, Op* op) {
+  Flag cbr = op->table_info->cf_type == CF_CBR;
+
+  mech->timestamp_func(op);
+  op->oracle_info.pred = cbr ? mech->pred_func(op) : op->oracle_info.dir;
+  op->oracle_info.recover_at_decode = FALSE;
+  op->oracle_info.recover_at_exec = op->oracle_info.pred != op->oracle_info.dir;
+  mech->spec_update_func(op);
+  mech->update_func(op);
+  if (op->oracle_info.recover_at_exec) {
+    op->recovery_info.new_dir = op->oracle_info.dir;
+    mech->recover_func(&op->recovery_info);
+  }
+  mech->retire_func(op);
+}
+
+/**************************************************************************************/
+/* bp_model_debug: */
+
+void bp_model_debug() {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    DEBUG(proc_id, "insts:%s  cbrs:%s  mispreds:%s\n", unsstr64(inst_count[proc_id]),
+          unsstr64(cores[proc_id].cbrs), unsstr64(cores[proc_id].mispreds[0]));
+}
+
+/**************************************************************************************/
+/* bp_model_done: writes bp_model.out */
+
+void bp_model_done() {
+  char file_name[MAX_STR_LENGTH + 1];
+  snprintf(file_name, MAX_STR_LENGTH, "%s/%s%s", OUTPUT_DIR, FILE_TAG, "bp_model.out");
+  FILE* file = fopen(file_name, "w");
+  ASSERTM(0, file, "Could not open %s\n", file_name);
+
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    bp_model_report_core(file, proc_id);
+  fclose(file);
+}
+
+/**************************************************************************************/
+/* bp_model_report_core: */
+
+static void bp_model_report_core(FILE* file, uns proc_id) {
+  Bp_Model_Core* core = &cores[proc_id];
+  double kinsts = inst_count[proc_id] / 1000.0;
+
+  fprintf(file, "Core %u\n", proc_id);
+  fprintf(file, "Insts:                %12llu\n", inst_count[proc_id]);
+  fprintf(file, "Cond branches:        %12llu\n", core->cbrs);
+  fprintf(file, "Static branches:      %12d\n\n", core->branches.count);
+
+  fprintf(file, "%-16s %14s %10s %10s\n", "Predictor", "Cond mispreds", "MPKI", "Accuracy");
+  for (uns ii = 0; ii < num_mechs; ii++)
+    fprintf(file, "%-16s %14llu %10.4f %9.4f%%\n", mechs[ii]->name, core->mispreds[ii],
+            kinsts ? core->mispreds[ii] / kinsts : 0.0,
+            core->cbrs ? 100.0 * (core->cbrs - core->mispreds[ii]) / core->cbrs : 0.0);
+  fprintf(file, "%-16s %14llu %10.4f   (%s with BTB, iBTB and CRS, any cf)\n\n", "Wrong next pc",
+          core->target_misses, kinsts ? core->target_misses / kinsts : 0.0, mechs[0]->name);
+
+  fprintf(file, "HBT hard cond branches:   %12llu %9.4f%% of cond branches\n", core->hard_cbrs,
+          core->cbrs ? 100.0 * core->hard_cbrs / core->cbrs : 0.0);
+  fprintf(file, "HBT hard mispreds:        %12llu %9.4f%% of %s mispreds\n\n", core->hard_mispreds,
+          core->mispreds[0] ? 100.0 * core->hard_mispreds / core->mispreds[0] : 0.0, mechs[0]->name);
+
+  if (!core->branches.count || !BP_MODEL_TOP_BRANCHES) {
+    fprintf(file, "\n");
+    return;
+  }
+  Bp_Model_Branch** branches = (Bp_Model_Branch**)hash_table_flatten(&core->branches, NULL);
+  qsort(branches, core->branches.count, sizeof(Bp_Model_Branch*), bp_model_branch_cmp);
+  uns num = MIN2((uns)core->branches.count, BP_MODEL_TOP_BRANCHES);
+
+  fprintf(file, "Top %u static branches by %s mispreds:\n", num, mechs[0]->name);
+  fprintf(file, "%-18s %-8s %12s %8s %12s %7s %12s", "Addr", "Type", "Execs", "Taken", "HBT hard", "HBT ctr",
+          "Wrong npc");
+  for (uns ii = 0; ii < num_mechs; ii++)
+    fprintf(file, " %12s", mechs[ii]->name);
+  fprintf(file, "\n");
+  for (uns jj = 0; jj < num; jj++) {
+    Bp_Model_Branch* branch = branches[jj];
+    fprintf(file, "0x%-16llx %-8s %12llu %7.2f%% %12llu %7u %12llu", branch->addr, cf_type_names[branch->cf_type],
+            branch->execs, 100.0 * branch->taken / branch->execs, branch->hard_execs, hbt_get_counter(branch->addr),
+            branch->target_misses);
+    for (uns ii = 0; ii < num_mechs; ii++)
+      fprintf(file, " %12llu", branch->mispreds[ii]);
+    fprintf(file, "\n");
+  }
+  fprintf(file, "\n");
+  free(branches);
+}
+
+/**************************************************************************************/
+/* bp_model_branch_cmp: most bp_mech direction mispredicts first, then most wrong
+   next pcs, then lowest address */
+
+static int bp_model_branch_cmp(const void* a, const void* b) {
+  const Bp_Model_Branch* x = *(Bp_Model_Branch* const*)a;
+  const Bp_Model_Branch* y = *(Bp_Model_Branch* const*)b;
+  if (x->mispreds[0] != y->mispreds[0])
+    return x->mispreds[0] < y->mispreds[0] ? 1 : -1;
+  if (x->target_misses != y->target_misses)
+    return x->target_misses < y->target_misses ? 1 : -1;
+  return x->addr < y->addr ? -1 : x->addr > y->addr;
+}
@@ -0,0 +1,69 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/***************************************************************************************
+ * File         : bp_model.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Model that replays the branches of the frontend stream through
+ *                the branch predictors in program order (no core modeling)
+ ***************************************************************************************/
+
+#ifndef __BP_MODEL_H__
+#define __BP_MODEL_H__
+
+#include "bp/bp.h"
+
+#include "thread.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define BP_MODEL_MAX_MECHS 8 /* bp_mech plus up to 7 bp_model_extra_mechs */
+
+/**************************************************************************************/
+/* bp model data  */
+
+typedef struct Bp_Model_struct {
+  Thread_Data* thread_data;
+  Bp_Recovery_Info* bp_recovery_info;
+  Bp_Data* bp_data;
+} Bp_Model;
+
+/**************************************************************************************/
+/* Global vars */
+
+extern Bp_Model bp_model;
+
+/**************************************************************************************/
+/* Prototypes */
+
+void bp_model_init(uns mode);
+void bp_model_reset(void);
+void bp_model_cycle(void);
+void bp_model_debug(void);
+void bp_model_done(void);
+void bp_model_warmup(Op* op);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __BP_MODEL_H__ */
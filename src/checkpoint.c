@@ -0,0 +1,282 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : checkpoint.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Section registry and file format for warm-state checkpoints.
+ *
+ * File layout (host endian):
+ *
+ *   Ckpt_File_Header | Ckpt_Section_Header | payload | Ckpt_Section_Header | ...
+ ***************************************************************************************/
+
+#include "checkpoint.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/utils.h"
+
+#include "debug/debug.param.h"
+#include "general.param.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_CKPT, ##args)
+
+#define CKPT_MAX_UNSUPPORTED 16
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Ckpt_Section_struct {
+  char name[CKPT_NAME_LENGTH];
+  uns proc_id;
+  void* data;  // plain data sections
+  size_t size;
+  Ckpt_Func func;  // function sections
+  void* arg;
+} Ckpt_Section;
+
+struct Ckpt_Stream_struct {
+  FILE* file;
+  const char* file_name;
+  const char* section;
+  uns64 left;  // bytes of the current section not read yet
+  Flag saving;
+};
+
+typedef struct Ckpt_File_Header_struct {
+  char magic[8];  // CKPT_MAGIC, not NUL terminated
+  uns32 version;
+  uns32 num_sections;
+} Ckpt_File_Header;
+
+typedef struct Ckpt_Section_Header_struct {
+  char name[CKPT_NAME_LENGTH];
+  uns32 proc_id;
+  uns32 reserved;
+  uns64 size;
+} Ckpt_Section_Header;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Ckpt_Section* sections = NULL;
+static uns num_sections = 0;
+static uns max_sections = 0;
+static const char* unsupported[CKPT_MAX_UNSUPPORTED];
+static uns num_unsupported = 0;
+
+/**************************************************************************************/
+/* Static Prototypes */
+
+static Ckpt_Section* new_section(const char* name, uns proc_id);
+static void check_supported(const char* action);
+
+/**************************************************************************************/
+/* new_section: */
+
+static Ckpt_Section* new_section(const char* name, uns proc_id) {
+  if (num_sections == max_sections) {
+    max_sections = max_sections ? 2 * max_sections : 64;
+    sections = (Ckpt_Section*)realloc(sections, max_sections * sizeof(Ckpt_Section));
+    ASSERT(0, sections);
+  }
+  Ckpt_Section* section = &sections[num_sections++];
+  memset(section, 0, sizeof(Ckpt_Section));
+  strncpy(section->name, name, CKPT_NAME_LENGTH - 1);  // long names are compared truncated
+  section->proc_id = proc_id;
+  return section;
+}
+
+/**************************************************************************************/
+/* ckpt_register: */
+
+void ckpt_register(const char* name, uns proc_id, Ckpt_Func func, void* arg) {
+  Ckpt_Section* section = new_section(name, proc_id);
+  section->func = func;
+  section->arg = arg;
+}
+
+/**************************************************************************************/
+/* ckpt_register_data: */
+
+void ckpt_register_data(const char* name, uns proc_id, void* ptr, size_t size) {
+  Ckpt_Section* section = new_section(name, proc_id);
+  section->data = ptr;
+  section->size = size;
+}
+
+/**************************************************************************************/
+/* ckpt_unsupported: */
+
+void ckpt_unsupported(const char* name) {
+  for (uns ii = 0; ii < num_unsupported; ii++)
+    if (!strcmp(unsupported[ii], name))
+      return;
+  ASSERT(0, num_unsupported < CKPT_MAX_UNSUPPORTED);
+  unsupported[num_unsupported++] = name;
+}
+
+/**************************************************************************************/
+/* check_supported: */
+
+static void check_supported(const char* action) {
+  if (!num_unsupported)
+    return;
+  for (uns ii = 0; ii < num_unsupported; ii++)
+    fprintf(mystderr, "Checkpointing is not supported for %s\n", unsupported[ii]);
+  FATAL_ERROR(0, "Cannot %s a warm-state checkpoint with this configuration\n", action);
+}
+
+/**************************************************************************************/
+/* ckpt_write: */
+
+void ckpt_write(Ckpt_Stream* stream, const void* ptr, size_t size) {
+  if (size && fwrite(ptr, size, 1, stream->file) != 1)
+    FATAL_ERROR(0, "Could not write checkpoint section %s to %s\n", stream->section, stream->file_name);
+}
+
+/**************************************************************************************/
+/* ckpt_read: */
+
+void ckpt_read(Ckpt_Stream* stream, void* ptr, size_t size) {
+  ASSERTM(0, size <= stream->left, "Checkpoint section %s is shorter than expected\n", stream->section);
+  if (size && fread(ptr, size, 1, stream->file) != 1)
+    FATAL_ERROR(0, "Could not read checkpoint section %s from %s\n", stream->section, stream->file_name);
+  stream->left -= size;
+}
+
+/**************************************************************************************/
+/* ckpt_io: */
+
+void ckpt_io(Ckpt_Stream* stream, void* ptr, size_t size) {
+  if (stream->saving)
+    ckpt_write(stream, ptr, size);
+  else
+    ckpt_read(stream, ptr, size);
+}
+
+Flag ckpt_saving(Ckpt_Stream* stream) {
+  return stream->saving;
+}
+
+/**************************************************************************************/
+/* ckpt_save: */
+
+void ckpt_save(const char* file_name) {
+  Ckpt_Stream stream = {NULL, file_name, NULL, 0, TRUE};
+  Ckpt_File_Header header;
+
+  check_supported("save");
+  stream.file = fopen(file_name, "wb");
+  if (!stream.file)
+    FATAL_ERROR(0, "Could not open checkpoint file %s for writing\n", file_name);
+
+  memcpy(header.magic, CKPT_MAGIC, sizeof(header.magic));
+  header.version = CKPT_VERSION;
+  header.num_sections = num_sections;
+  stream.section = "header";
+  ckpt_write(&stream, &header, sizeof(header));
+
+  for (uns ii = 0; ii < num_sections; ii++) {
+    Ckpt_Section* section = &sections[ii];
+    Ckpt_Section_Header sec_header;
+    memset(&sec_header, 0, sizeof(sec_header));
+    strncpy(sec_header.name, section->name, CKPT_NAME_LENGTH);
+    sec_header.proc_id = section->proc_id;
+
+    stream.section = section->name;
+    long header_pos = ftell(stream.file);
+    ckpt_write(&stream, &sec_header, sizeof(sec_header));
+    if (section->func)
+      section->func(&stream, section->arg);
+    else
+      ckpt_write(&stream, section->data, section->size);
+
+    /* function sections only know their size once written */
+    long end_pos = ftell(stream.file);
+    sec_header.size = end_pos - header_pos - sizeof(sec_header);
+    fseek(stream.file, header_pos, SEEK_SET);
+    ckpt_write(&stream, &sec_header, sizeof(sec_header));
+    fseek(stream.file, end_pos, SEEK_SET);
+    DEBUG(section->proc_id, "Saved checkpoint section %s (%llu bytes)\n", section->name, sec_header.size);
+  }
+
+  if (fclose(stream.file))
+    FATAL_ERROR(0, "Could not write checkpoint file %s\n", file_name);
+  fprintf(mystdout, "** Saved warm-state checkpoint %s (%u sections)\n", file_name, num_sections);
+}
+
+/**************************************************************************************/
+/* ckpt_load: */
+
+void ckpt_load(const char* file_name) {
+  Ckpt_Stream stream = {NULL, file_name, "header", sizeof(Ckpt_File_Header), FALSE};
+  Ckpt_File_Header header;
+
+  check_supported("load");
+  stream.file = fopen(file_name, "rb");
+  if (!stream.file)
+    FATAL_ERROR(0, "Could not open checkpoint file %s\n", file_name);
+
+  ckpt_read(&stream, &header, sizeof(header));
+  if (memcmp(header.magic, CKPT_MAGIC, sizeof(header.magic)) || header.version != CKPT_VERSION)
+    FATAL_ERROR(0, "%s is not a version %d warm-state checkpoint\n", file_name, CKPT_VERSION);
+  if (header.num_sections != num_sections)
+    FATAL_ERROR(0, "Checkpoint %s has %u sections, this configuration has %u\n", file_name, header.num_sections,
+                num_sections);
+
+  for (uns ii = 0; ii < num_sections; ii++) {
+    Ckpt_Section* section = &sections[ii];
+    Ckpt_Section_Header sec_header;
+
+    stream.section = section->name;
+    stream.left = sizeof(sec_header);
+    ckpt_read(&stream, &sec_header, sizeof(sec_header));
+    sec_header.name[CKPT_NAME_LENGTH - 1] = '\0';
+    if (strcmp(sec_header.name, section->name) || sec_header.proc_id != section->proc_id)
+      FATAL_ERROR(0, "Checkpoint %s has section %s (core %u) where %s (core %u) was expected\n", file_name,
+                  sec_header.name, sec_header.proc_id, section->name, section->proc_id);
+    if (!section->func && sec_header.size != section->size)
+      FATAL_ERROR(0, "Checkpoint section %s is %llu bytes, this configuration needs %llu\n", section->name,
+                  sec_header.size, (uns64)section->size);
+
+    stream.left = sec_header.size;
+    if (section->func)
+      section->func(&stream, section->arg);
+    else
+      ckpt_read(&stream, section->data, section->size);
+    ASSERTM(section->proc_id, stream.left == 0, "Checkpoint section %s has %llu bytes left over\n", section->name,
+            stream.left);
+    DEBUG(section->proc_id, "Loaded checkpoint section %s (%llu bytes)\n", section->name, sec_header.size);
+  }
+
+  fclose(stream.file);
+  fprintf(mystdout, "** Loaded warm-state checkpoint %s (%u sections)\n", file_name, num_sections);
+}
@@ -0,0 +1,190 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : checkpoint.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Save and restore warmed microarchitectural state.
+ *
+ * Every component that holds state trained during warmup registers one or more
+ * sections from its init function, either as a plain block of memory
+ * (ckpt_register_data) or as a callback that streams its state through ckpt_io()
+ * in both directions (ckpt_saving() tells which one). ckpt_save() writes the sections in
+ * registration order; ckpt_load() expects exactly the same sections (name,
+ * proc_id and size) in the same order, i.e. a simulator built and configured
+ * the same way, and fails loudly otherwise. Components whose state cannot be
+ * checkpointed call ckpt_unsupported() so that a checkpoint is never silently
+ * incomplete.
+ ***************************************************************************************/
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include <stddef.h>
+
+#include "globals/global_types.h"
+
+#define CKPT_MAGIC "SCRBWARM"
+#define CKPT_VERSION 1
+#define CKPT_NAME_LENGTH 64
+
+typedef struct Ckpt_Stream_struct Ckpt_Stream;
+typedef void (*Ckpt_Func)(Ckpt_Stream* stream, void* arg);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Registers a section written and read back by func(stream, arg). */
+void ckpt_register(const char* name, uns proc_id, Ckpt_Func func, void* arg);
+
+/* Registers a section that is the size bytes at ptr. */
+void ckpt_register_data(const char* name, uns proc_id, void* ptr, size_t size);
+
+/* Marks a configured component whose state is not checkpointed; saving or
+   loading a checkpoint then fails with its name. */
+void ckpt_unsupported(const char* name);
+
+/* Stream accessors for the callbacks */
+void ckpt_write(Ckpt_Stream* stream, const void* ptr, size_t size);
+void ckpt_read(Ckpt_Stream* stream, void* ptr, size_t size);
+/* ckpt_write() while saving, ckpt_read() while loading, for code shared by both */
+void ckpt_io(Ckpt_Stream* stream, void* ptr, size_t size);
+Flag ckpt_saving(Ckpt_Stream* stream);
+
+void ckpt_save(const char* file_name);
+void ckpt_load(const char* file_name);
+
+#ifdef __cplusplus
+}
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "globals/assert.h"
+
+/* Walks C++ state in either direction. A class lists its members once:
+
+     template <class Archive>
+     void serialize(Archive& ar) { ar.io(a); ar.io(b); }
+
+   and io() recurses into members that have serialize() themselves, copies
+   trivially copyable ones as bytes and handles std::vector / std::pair.
+   Vectors must already have their checkpointed size (they are sized by the
+   configuration at init time). Pointers are never followed. */
+class Ckpt_Archive {
+ public:
+  explicit Ckpt_Archive(Ckpt_Stream* stream) : stream(stream) {}
+
+  template <typename T>
+  void io(T& x) {
+    io_member(x, 0);
+  }
+
+  template <typename T>
+  void io(std::vector<T>& vec) {
+    uns64 size = vec.size();
+    io_bytes(&size, sizeof(size));
+    ASSERTM(0, size == vec.size(), "checkpointed vector has %llu elements, expected %llu\n", size,
+            (uns64)vec.size());
+    io_array(vec.data(), vec.size());
+  }
+
+  void io(std::vector<bool>& vec) {
+    uns64 size = vec.size();
+    io_bytes(&size, sizeof(size));
+    ASSERTM(0, size == vec.size(), "checkpointed vector has %llu elements, expected %llu\n", size,
+            (uns64)vec.size());
+    for (size_t ii = 0; ii < vec.size(); ii++) {
+      bool bit = vec[ii];
+      io_bytes(&bit, sizeof(bit));
+      vec[ii] = bit;
+    }
+  }
+
+  template <typename T, size_t N>
+  void io(T (&array)[N]) {
+    io_array(array, N);
+  }
+
+  template <typename T, typename U>
+  void io(std::pair<T, U>& pair) {
+    io(pair.first);
+    io(pair.second);
+  }
+
+  template <typename T>
+  void io_array(T* array, size_t num) {
+    if (std::is_trivially_copyable<T>::value && !has_serialize<T>(0))
+      io_bytes(array, num * sizeof(T));
+    else
+      for (size_t ii = 0; ii < num; ii++)
+        io(array[ii]);
+  }
+
+  void io_bytes(void* ptr, size_t size) { ckpt_io(stream, ptr, size); }
+
+  bool is_saving() const { return ckpt_saving(stream); }
+
+  /* Adapter for ckpt_register(): the arg is a T* with serialize() */
+  template <typename T>
+  static void run(Ckpt_Stream* stream, void* arg) {
+    Ckpt_Archive ar(stream);
+    static_cast<T*>(arg)->serialize(ar);
+  }
+
+ private:
+  Ckpt_Stream* stream;
+
+  template <typename T>
+  static constexpr auto has_serialize(int) -> decltype(std::declval<T&>().serialize(std::declval<Ckpt_Archive&>()),
+                                                       bool()) {
+    return true;
+  }
+  template <typename T>
+  static constexpr bool has_serialize(long) {
+    return false;
+  }
+
+  template <typename T>
+  auto io_member(T& x, int) -> decltype(x.serialize(*this), void()) {
+    x.serialize(*this);
+  }
+
+  template <typename T>
+  void io_member(T& x, long) {
+    static_assert(std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value,
+                  "checkpointed members need serialize() or must be plain data");
+    io_bytes(&x, sizeof(T));
+  }
+};
+
+template <typename T>
+void ckpt_register_object(const char* name, uns proc_id, T* obj) {
+  ckpt_register(name, proc_id, Ckpt_Archive::run<T>, obj);
+}
+
+#endif /* __cplusplus */
+
+#endif /* #ifndef __CHECKPOINT_H__ */
@@ -46,6 +46,7 @@
 #include "dvfs/dvfs.h"
 #include "dvfs/perf_pred.h"
 #include "memory/cache_part.h"
+#include "memory/cache_sweep.h"
 #include "prefetcher/D_JOLT.h"
 #include "prefetcher/FNL+MMA.h"
 #include "prefetcher/eip.h"
@@ -62,6 +63,7 @@
 #include "map_rename.h"
 #include "op_pool.h"
 #include "sim.h"
+#include "simprof.h"
 #include "statistics.h"
 #include "uop_queue_stage.h"
 
@@ -77,6 +79,28 @@
 Cmp_Model cmp_model;
 Flag perf_pred_started = FALSE;
 
+/**************************************************************************************/
+/* Idle cycle detection (IDLE_SKIP) */
+
+#define IDLE_PROGRESS_VALUES 26
+
+/* Values that change whenever a core or its decoupled frontend makes
+ * progress. A cycle that leaves them unchanged was a fixed point: the
+ * following cycles repeat it until a timer of the core fires (the earliest
+ * such time is computed by cmp_core_next_event_time) or the memory system
+ * delivers something. */
+typedef struct Idle_Info_struct {
+  Counter progress[IDLE_PROGRESS_VALUES];
+  Flag quiescent; /* the last simulated cycle was a fixed point */
+} Idle_Info;
+
+static Idle_Info* idle_infos;
+static Counter idle_chip_cycles = 0;           /* chip cycles simulated so far */
+static Counter idle_mem_cycles = 0;            /* memory cycles simulated so far */
+static Counter idle_cached_chip_cycles = MAX_CTR; /* chip cycle of the cached core event time */
+static Counter idle_cached_mem_cycles = MAX_CTR;  /* memory cycle of the cached core event time */
+static Counter idle_cached_event_time;
+
 /**************************************************************************************/
 /* Static prototypes */
 
@@ -86,6 +110,9 @@ static void cmp_measure_chip_util(void);
 static void cmp_istreams(void);
 static void cmp_cores(void);
 static void warmup_uncore(uns proc_id, Addr addr, Flag write);
+static Counter cmp_stage_op_counts(Stage_Data* sds, uns depth, uns width);
+static void cmp_update_idle_info(uns proc_id);
+static Counter cmp_core_next_event_time(uns proc_id);
 
 /**************************************************************************************/
 /* cmp_init */
@@ -146,6 +173,8 @@ void cmp_init(uns mode) {
 
   cmp_model.window_size = NODE_TABLE_SIZE;
 
+  idle_infos = (Idle_Info*)calloc(NUM_CORES, sizeof(Idle_Info));
+
   set_memory(&cmp_model.memory);
 
   // init_memory will call init_uncores, which setup the partition stuffs
@@ -161,6 +190,7 @@ void cmp_init(uns mode) {
     dvfs_init();
 
   cache_part_init();
+  cache_sweep_init();
 
   ASSERTM(0, !USE_LATE_BP || LATE_BP_LATENCY < (DECODE_CYCLES + MAP_CYCLES),
           "Late branch prediction latency should be less than the total "
@@ -241,35 +271,224 @@ void cmp_cores(void) {
       cmp_set_all_stages(proc_id);
 
       /* Back-end pipeline */
+      SIMPROF_BEGIN(DCACHE_STAGE);
       update_dcache_stage(&exec->sd);
+      SIMPROF_END(DCACHE_STAGE);
+      SIMPROF_BEGIN(EXEC_STAGE);
       update_exec_stage(&node->sd);
+      SIMPROF_END(EXEC_STAGE);
+      SIMPROF_BEGIN(NODE_STAGE);
       update_node_stage(map->last_sd);
+      SIMPROF_END(NODE_STAGE);
+      SIMPROF_BEGIN(MAP_STAGE);
       update_map_stage(idq_stage_get_stage_data());
+      SIMPROF_END(MAP_STAGE);
 
       if (UOP_CACHE_ENABLE) {
         /* IDQ stage that bridges the front-end and back-end */
         /* This stage can get uops from the uc->sd, cache queue, or decoder. */
+        SIMPROF_BEGIN(IDQ_STAGE);
         update_idq_stage(dec->last_sd, &uc->sd, uop_queue_stage_get_latest_sd());
+        SIMPROF_END(IDQ_STAGE);
 
         /* Front-end pipiline */
+        SIMPROF_BEGIN(UOP_QUEUE_STAGE);
         update_uop_queue_stage(&uc->sd);
+        SIMPROF_END(UOP_QUEUE_STAGE);
       } else {
+        SIMPROF_BEGIN(IDQ_STAGE);
         update_idq_stage(dec->last_sd, NULL, NULL);
+        SIMPROF_END(IDQ_STAGE);
+        SIMPROF_BEGIN(UOP_QUEUE_STAGE);
         update_uop_queue_stage(NULL);
+        SIMPROF_END(UOP_QUEUE_STAGE);
       }
+      SIMPROF_BEGIN(DECODE_STAGE);
       update_decode_stage(&ic->sd);
+      SIMPROF_END(DECODE_STAGE);
+      SIMPROF_BEGIN(ICACHE_STAGE);
       update_icache_stage();
+      SIMPROF_END(ICACHE_STAGE);
 
       /* Decoupled branch prediction and prefetching */
+      SIMPROF_BEGIN(DECOUPLED_FE);
       update_decoupled_fe();
+      SIMPROF_END(DECOUPLED_FE);
+      SIMPROF_BEGIN(FDIP);
       update_fdip();
+      SIMPROF_END(FDIP);
+      SIMPROF_BEGIN(EIP);
       update_eip();
+      SIMPROF_END(EIP);
 
       cmp_measure_chip_util();
       // 매 사이클 Backward Walk 엔진 구동
+      SIMPROF_BEGIN(H2P_BACKWARD_WALK);
       cycle_backward_walk_engine(proc_id);
+      SIMPROF_END(H2P_BACKWARD_WALK);
+
+      if (IDLE_SKIP)
+        cmp_update_idle_info(proc_id);
     }
   }
+
+  if (freq_is_ready(FREQ_DOMAIN_L1))
+    idle_chip_cycles++;
+  if (freq_is_ready(FREQ_DOMAIN_MEMORY))
+    idle_mem_cycles++;
+}
+
+/**************************************************************************************/
+/* cmp_stage_op_counts: the op counts of every pipe stage of a
+ * multi-cycle stage, so that ops moving down the pipe count as progress */
+
+static Counter cmp_stage_op_counts(Stage_Data* sds, uns depth, uns width) {
+  Counter counts = 0;
+  for (uns ii = 0; ii < depth; ii++) {
+    counts = counts * (width + 1) + sds[ii].op_count;
+  }
+  return counts;
+}
+
+/**************************************************************************************/
+/* cmp_update_idle_info: note whether the core's last cycle was a fixed point */
+
+static void cmp_update_idle_info(uns proc_id) {
+  Idle_Info* info = &idle_infos[proc_id];
+  Counter progress[IDLE_PROGRESS_VALUES] = {
+      op_count[proc_id],
+      unique_count_per_core[proc_id],
+      node->ret_op,
+      node->node_count,
+      node->last_scheduled_opnum,
+      (Counter)(node->next_op_into_rs ? node->next_op_into_rs->op_num : 0),
+      cmp_stage_op_counts(map->sds, MAP_CYCLES, ISSUE_WIDTH),
+      idq_stage_get_stage_data()->op_count,
+      idq_stage_get_occupancy(),
+      get_uop_queue_stage_length(),
+      uop_queue_stage_get_latest_sd()->op_count,
+      UOP_CACHE_ENABLE ? uc->sd.op_count : 0,
+      cmp_stage_op_counts(dec->sds, DECODE_CYCLES + ICACHE_LATENCY - 1, DECODE_WIDTH),
+      ic->sd.op_count,
+      ic->state,
+      ic->next_state,
+      exec->sd.op_count,
+      dc->sd.op_count,
+      mem->uncores[proc_id].num_outstanding_l1_accesses,
+      mem->uncores[proc_id].num_outstanding_l1_misses,
+      mem->req_count,
+      decoupled_fe_get_op_count(),
+      decoupled_fe_ftq_num_fts(),
+      decoupled_fe_ftq_num_ops(),
+      decoupled_fe_is_off_path(),
+      fdip_get_ftq_offset(proc_id),
+  };
+
+  info->quiescent = !memcmp(progress, info->progress, sizeof(progress));
+  if (!info->quiescent)
+    memcpy(info->progress, progress, sizeof(progress));
+}
+
+/**************************************************************************************/
+/* cmp_core_next_event_time: earliest time a quiescent core can change
+ * state on its own (MAX_CTR if it only waits for the memory system) */
+
+static Counter cmp_core_next_event_time(uns proc_id) {
+  Freq_Domain_Id domain = FREQ_DOMAIN_CORES[proc_id];
+  /* the last simulated core cycle: a ready cycle has not been simulated yet */
+  Flag ready = freq_is_ready(domain);
+  Counter core_cycle = freq_cycle_count(domain) - (ready ? 1 : 0);
+  Counter core_cycle_start = (ready ? freq_time() : freq_next_cycle_time(domain)) - freq_get_cycle_time(domain);
+  Counter next_event_cycle = MAX_CTR;
+
+#define IDLE_TIMER(cycle)                                  \
+  do {                                                     \
+    Counter _cycle = (cycle);                              \
+    if (_cycle > core_cycle && _cycle < next_event_cycle) \
+      next_event_cycle = _cycle;                           \
+  } while (0)
+
+  Bp_Recovery_Info* recovery_info = &cmp_model.bp_recovery_info[proc_id];
+  IDLE_TIMER(recovery_info->recovery_cycle);
+  IDLE_TIMER(recovery_info->redirect_cycle);
+
+  /* the H2P backward walk finishes after its remaining cycles */
+  if (bw_engines && bw_engines[proc_id] && bw_engines[proc_id]->state == BW_WALKING)
+    IDLE_TIMER(core_cycle + bw_engines[proc_id]->walk_cycles_remaining);
+  if (FDIP_ENABLE && FDIP_ADJUSTABLE_FTQ)
+    IDLE_TIMER((core_cycle / FDIP_ADJUSTABLE_FTQ_CYC + 1) * FDIP_ADJUSTABLE_FTQ_CYC);
+
+  Node_Stage* node_stage = &cmp_model.node_stage[proc_id];
+  if (node_stage->rdy_head || node_stage->sd.op_count)
+    return freq_time();
+  for (Op* op = node_stage->node_head; op; op = op->next_node) {
+    IDLE_TIMER(op->rdy_cycle);
+    if (op->rdy_cycle && op->rdy_cycle != MAX_CTR)
+      IDLE_TIMER(op->rdy_cycle - 1); /* the issue queue schedules one cycle ahead */
+    IDLE_TIMER(op->exec_cycle);
+    IDLE_TIMER(op->dcache_cycle);
+    IDLE_TIMER(op->done_cycle);
+    IDLE_TIMER(op->wake_cycle);
+    IDLE_TIMER(op->replay_cycle);
+  }
+
+  Exec_Stage* exec_stage = &cmp_model.exec_stage[proc_id];
+  for (uns ii = 0; ii < NUM_FUS; ii++) {
+    IDLE_TIMER(exec_stage->fus[ii].avail_cycle);
+    IDLE_TIMER(exec_stage->fus[ii].idle_cycle);
+  }
+  IDLE_TIMER(cmp_model.dcache_stage[proc_id].idle_cycle);
+
+#undef IDLE_TIMER
+
+  if (next_event_cycle == MAX_CTR ||
+      next_event_cycle - core_cycle > (MAX_CTR - core_cycle_start) / freq_get_cycle_time(domain))
+    return MAX_CTR;
+  return core_cycle_start + (next_event_cycle - core_cycle) * freq_get_cycle_time(domain);
+}
+
+/**************************************************************************************/
+/* cmp_next_event_time: the chip can skip its cycles until the returned
+ * time if every core is quiescent and neither the on-chip memory queues
+ * nor the prefetch request queues hold a request. The skip ends at the
+ * earliest pending timestamp: a frontend or core timer, or the next DRAM
+ * cycle. Ramulator is ticked every memory cycle (its controllers track
+ * refresh per tick) and returns the requests handed to it only then. */
+
+Counter cmp_next_event_time() {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if (!idle_infos[proc_id].quiescent)
+      return freq_time();
+  }
+  if (!mem_queues_empty() || !pref_queues_empty())
+    return freq_time();
+
+  /* Core state does not change until the next chip or memory cycle is simulated */
+  if (idle_cached_chip_cycles != idle_chip_cycles ||
+      idle_cached_mem_cycles != idle_mem_cycles) {
+    idle_cached_event_time = MAX_CTR;
+    for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      idle_cached_event_time = MIN2(idle_cached_event_time, cmp_core_next_event_time(proc_id));
+    }
+    idle_cached_chip_cycles = idle_chip_cycles;
+    idle_cached_mem_cycles = idle_mem_cycles;
+  }
+
+  return MIN2(idle_cached_event_time, freq_next_cycle_time(FREQ_DOMAIN_MEMORY));
+}
+
+/**************************************************************************************/
+/* cmp_idle_skip: account per-cycle state kept outside the stats for
+ * chip cycles skipped while quiescent */
+
+void cmp_idle_skip(Counter cycles) {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    fdip_idle_skip(proc_id, cycles);
+    backward_walk_engine_idle_skip(proc_id, cycles);
+    set_node_stage(&cmp_model.node_stage[proc_id]);
+    node_stage_idle_skip(cycles);
+  }
+  pref_idle_skip(cycles);
 }
 
 /**************************************************************************************/
@@ -309,6 +528,7 @@ void cmp_done() {
     dvfs_done();
 
   finalize_memory();
+  cache_sweep_done();
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     cmp_set_all_stages(proc_id);
   }
@@ -455,6 +675,7 @@ void warmup_uncore(uns proc_id, Addr addr, Flag write) {
   }
   if (L1_PART_SHADOW_WARMUP)
     cache_part_l1_warmup(proc_id, addr);
+  cache_sweep_warmup(CACHE_SWEEP_LEVEL_LLC, proc_id, addr);
 }
 
 /**************************************************************************************/
@@ -501,6 +722,7 @@ void cmp_warmup(Op* op) {
   if (is_load || is_store) {
     Cache* dcache = &(cmp_model.dcache_stage[proc_id].dcache);
     Dcache_Data* dc_data = cache_access(dcache, va, &dummy_line_addr, TRUE);
+    cache_sweep_warmup(CACHE_SWEEP_LEVEL_DCACHE, proc_id, va);
     if (dc_data) {
       // set some fields to meet expectations of the simulation mode
       if (is_store)
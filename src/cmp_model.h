@@ -88,6 +88,8 @@ void cmp_done(void);
 void cmp_wake(Op*, Op*, uns8);
 void cmp_retire_hook(Op*);
 void cmp_warmup(Op*);
+Counter cmp_next_event_time(void);
+void cmp_idle_skip(Counter);
 
 /**************************************************************************************/
 
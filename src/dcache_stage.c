@@ -46,6 +46,7 @@
 #include "prefetcher/pref.param.h"
 
 #include "bp/bp.h"
+#include "memory/cache_sweep.h"
 #include "prefetcher/l2l1pref.h"
 #include "prefetcher/pref_common.h"
 #include "prefetcher/stream_pref.h"
@@ -245,6 +246,7 @@ void update_dcache_stage(Stage_Data* src_sd) {
     /* now access the dcache with it */
     Addr line_addr;
     Dcache_Data* line = (Dcache_Data*)cache_access(&dc->dcache, op->oracle_info.va, &line_addr, TRUE);
+    cache_sweep_access(CACHE_SWEEP_LEVEL_DCACHE, op->proc_id, op->oracle_info.va);
     op->dcache_cycle = cycle_count;
     dc->idle_cycle = MAX2(dc->idle_cycle, cycle_count + DCACHE_CYCLES);
 
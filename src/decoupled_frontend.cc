@@ -15,11 +15,14 @@
 #include "ft.h"
 #include "op.h"
 #include "op_pool.h"
+#include "simprof.h"
 #include "thread.h"
 
 #include "confidence/conf.hpp"
 
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_DECOUPLED_FE, ##args)
+// Ops taken from the frontend per call; only very long instructions need more than one
+#define FE_FETCH_BATCH_SIZE 16
 
 class Decoupled_FE {
  public:
@@ -37,8 +40,10 @@ class Decoupled_FE {
   void stall(Op* op);
   void retire(Op* op, int op_proc_id, uns64 inst_uid);
   void set_ftq_num(uint64_t set_ftq_ft_num) { ftq_ft_num = set_ftq_ft_num; }
+  void set_fetch_budget(Counter insts);
   uint64_t get_ftq_num() { return ftq_ft_num; }
   Op* get_cur_op() { return cur_op; }
+  uint64_t get_op_count() { return dfe_op_count; }
   uns get_conf() { return conf->get_conf(); }
   Off_Path_Reason get_off_path_reason() { return conf->get_off_path_reason(); }
   Conf_Off_Path_Reason get_conf_off_path_reason() { return conf->get_conf_off_path_reason(); }
@@ -66,6 +71,8 @@ class Decoupled_FE {
   uint64_t redirect_cycle;
   bool stalled;
   uint64_t ftq_ft_num;
+  // on-path instructions left to fetch, MAX_CTR when unlimited (see sampling in sim.c)
+  Counter fetch_budget;
   bool trace_mode;
   Op* cur_op;
   Conf* conf;
@@ -158,6 +165,10 @@ void decoupled_fe_set_ftq_num(uint64_t ftq_ft_num) {
   dfe->set_ftq_num(ftq_ft_num);
 }
 
+void decoupled_fe_set_fetch_budget(uns proc_id, Counter insts) {
+  per_core_dfe[proc_id].set_fetch_budget(insts);
+}
+
 uint64_t decoupled_fe_get_ftq_num() {
   return dfe->get_ftq_num();
 }
@@ -166,6 +177,10 @@ Op* decoupled_fe_get_cur_op() {
   return dfe->get_cur_op();
 }
 
+uint64_t decoupled_fe_get_op_count() {
+  return dfe->get_op_count();
+}
+
 uns decoupled_fe_get_conf() {
   return dfe->get_conf();
 }
@@ -192,7 +207,7 @@ Decoupled_FE::Decoupled_FE(uns _proc_id) : proc_id(_proc_id), current_ft_to_push
 }
 
 void Decoupled_FE::init(uns _proc_id) {
-  trace_mode = false;
+  trace_mode = (FRONTEND == FE_SYNTH);
 
 #ifdef ENABLE_PT_MEMTRACE
   trace_mode |= (FRONTEND == FE_PT || FRONTEND == FE_MEMTRACE);
@@ -205,6 +220,7 @@ void Decoupled_FE::init(uns _proc_id) {
   redirect_cycle = 0;
   stalled = false;
   ftq_ft_num = FE_FTQ_BLOCK_NUM;
+  fetch_budget = MAX_CTR;
   cur_op = nullptr;
 
   current_ft_to_push = FT(proc_id);
@@ -288,60 +304,75 @@ void Decoupled_FE::update() {
   if (CONFIDENCE_ENABLE)
     conf->per_cycle_update();
 
+  // The ops of an instruction are fetched with one call. The checks below only
+  // change at instruction boundaries, so they are made once per instruction.
+  Op* batch[FE_FETCH_BATCH_SIZE];
+  uns batch_size = 0;
+  uns batch_pos = 0;
   while (1) {
-    ASSERT(proc_id, ftq_num_fts() <= ftq_ft_num);
-    ASSERT(proc_id, cfs_taken_this_cycle <= FE_FTQ_TAKEN_CFS_PER_CYCLE);
-
-    if (ftq_num_fts() == ftq_ft_num) {
-      DEBUG(proc_id, "Break due to full FTQ\n");
-      if (off_path)
-        STAT_EVENT(proc_id, FTQ_BREAK_FULL_FT_OFFPATH);
-      else
-        STAT_EVENT(proc_id, FTQ_BREAK_FULL_FT_ONPATH);
-      break;
-    }
-    if (cfs_taken_this_cycle == FE_FTQ_TAKEN_CFS_PER_CYCLE) {
-      DEBUG(proc_id, "Break due to max cfs taken per cycle\n");
-      if (off_path)
-        STAT_EVENT(proc_id, FTQ_BREAK_MAX_CFS_TAKEN_OFFPATH);
-      else
-        STAT_EVENT(proc_id, FTQ_BREAK_MAX_CFS_TAKEN_ONPATH);
-      break;
-    }
-    // use `>=` because inst size does not necessarily align with FE_FTQ_BYTES_PER_CYCLE
-    if (bytes_this_cycle >= FE_FTQ_BYTES_PER_CYCLE) {
-      DEBUG(proc_id, "Break due to max bytes per cycle\n");
-      if (off_path)
-        STAT_EVENT(proc_id, FTQ_BREAK_MAX_BYTES_OFFPATH);
-      else
-        STAT_EVENT(proc_id, FTQ_BREAK_MAX_BYTES_ONPATH);
-      break;
-    }
-    if (BP_MECH != MTAGE_BP && !bp_is_predictable(g_bp_data, proc_id)) {
-      DEBUG(proc_id, "Break due to limited branch predictor\n");
-      if (off_path)
-        STAT_EVENT(proc_id, FTQ_BREAK_PRED_BR_OFFPATH);
-      else
-        STAT_EVENT(proc_id, FTQ_BREAK_PRED_BR_ONPATH);
-      break;
-    }
-    if (stalled) {
-      DEBUG(proc_id, "Break due to wait for fetch barrier resolved\n");
-      if (off_path)
-        STAT_EVENT(proc_id, FTQ_BREAK_BAR_FETCH_OFFPATH);
-      else
-        STAT_EVENT(proc_id, FTQ_BREAK_BAR_FETCH_ONPATH);
-      break;
-    }
-    if (!frontend_can_fetch_op(proc_id)) {
-      std::cout << "Warning could not fetch inst from frontend" << std::endl;
-      break;
+    if (batch_pos == batch_size) {
+      ASSERTD(proc_id, ftq_num_fts() <= ftq_ft_num);
+      ASSERTD(proc_id, cfs_taken_this_cycle <= FE_FTQ_TAKEN_CFS_PER_CYCLE);
+
+      if (ftq_num_fts() == ftq_ft_num) {
+        DEBUG(proc_id, "Break due to full FTQ\n");
+        if (off_path)
+          STAT_EVENT(proc_id, FTQ_BREAK_FULL_FT_OFFPATH);
+        else
+          STAT_EVENT(proc_id, FTQ_BREAK_FULL_FT_ONPATH);
+        break;
+      }
+      if (cfs_taken_this_cycle == FE_FTQ_TAKEN_CFS_PER_CYCLE) {
+        DEBUG(proc_id, "Break due to max cfs taken per cycle\n");
+        if (off_path)
+          STAT_EVENT(proc_id, FTQ_BREAK_MAX_CFS_TAKEN_OFFPATH);
+        else
+          STAT_EVENT(proc_id, FTQ_BREAK_MAX_CFS_TAKEN_ONPATH);
+        break;
+      }
+      // use `>=` because inst size does not necessarily align with FE_FTQ_BYTES_PER_CYCLE
+      if (bytes_this_cycle >= FE_FTQ_BYTES_PER_CYCLE) {
+        DEBUG(proc_id, "Break due to max bytes per cycle\n");
+        if (off_path)
+          STAT_EVENT(proc_id, FTQ_BREAK_MAX_BYTES_OFFPATH);
+        else
+          STAT_EVENT(proc_id, FTQ_BREAK_MAX_BYTES_ONPATH);
+        break;
+      }
+      if (BP_MECH != MTAGE_BP && !bp_is_predictable(g_bp_data, proc_id)) {
+        DEBUG(proc_id, "Break due to limited branch predictor\n");
+        if (off_path)
+          STAT_EVENT(proc_id, FTQ_BREAK_PRED_BR_OFFPATH);
+        else
+          STAT_EVENT(proc_id, FTQ_BREAK_PRED_BR_ONPATH);
+        break;
+      }
+      if (stalled) {
+        DEBUG(proc_id, "Break due to wait for fetch barrier resolved\n");
+        if (off_path)
+          STAT_EVENT(proc_id, FTQ_BREAK_BAR_FETCH_OFFPATH);
+        else
+          STAT_EVENT(proc_id, FTQ_BREAK_BAR_FETCH_ONPATH);
+        break;
+      }
+      if (!off_path && fetch_budget == 0) {
+        DEBUG(proc_id, "Break due to exhausted fetch budget\n");
+        break;
+      }
+      if (!frontend_can_fetch_op(proc_id)) {
+        std::cout << "Warning could not fetch inst from frontend" << std::endl;
+        break;
+      }
+
+      SIMPROF_BEGIN(FRONTEND_FETCH_OP);
+      batch_size = frontend_fetch_ops(proc_id, batch, FE_FETCH_BATCH_SIZE);
+      SIMPROF_END(FRONTEND_FETCH_OP);
+      batch_pos = 0;
     }
 
     fwd_progress = 0;
     uint64_t pred_addr = 3;
-    Op* op = alloc_op(proc_id);
-    frontend_fetch_op(proc_id, op);
+    Op* op = batch[batch_pos++];
     op->op_num = dfe_op_count++;
     op->off_path = off_path;
     if (!CONFIDENCE_ENABLE)
@@ -353,7 +384,9 @@ void Decoupled_FE::update() {
 
     if (op->table_info->cf_type) {
       ASSERT(proc_id, op->eom);
+      SIMPROF_BEGIN(BP_PREDICT_OP);
       pred_addr = bp_predict_op(g_bp_data, op, cf_num++, op->inst_info->addr);
+      SIMPROF_END(BP_PREDICT_OP);
       DEBUG(proc_id,
             "Predict CF fetch_addr:%llx true_npc:%llx pred_npc:%lx mispred:%i misfetch:%i btb miss:%i taken:%i "
             "recover_at_decode:%i recover_at_exec:%i off_path:%i bar_fetch:%i\n",
@@ -428,6 +461,10 @@ void Decoupled_FE::update() {
 
       bytes_this_cycle += op->inst_info->trace_info.inst_size;
       cfs_taken_this_cycle += cf_taken || bar_fetch;
+
+      // the last instruction of the budget ends its FT like a fetch barrier so the FT reaches the icache
+      if (!op->off_path && fetch_budget != MAX_CTR && --fetch_budget == 0 && ft_ended_by == FT_NOT_ENDED)
+        ft_ended_by = FT_BAR_FETCH;
     }
 
     current_ft_to_push.add_op(op, ft_ended_by);
@@ -569,6 +606,15 @@ uint64_t Decoupled_FE::ftq_num_ops() {
   return num_ops;
 }
 
+/* The sampled simulation drains the pipeline by exhausting the budget and
+   then moves the frontend ahead functionally, so a recovery address recorded
+   before the drain no longer matches the next fetched op. */
+void Decoupled_FE::set_fetch_budget(Counter insts) {
+  ASSERT(proc_id, !off_path);
+  fetch_budget = insts;
+  recovery_addr = 0;
+}
+
 void Decoupled_FE::stall(Op* op) {
   stalled = true;
   DEBUG(proc_id, "Decoupled fetch stalled due to barrier fetch_addr0x:%llx off_path:%i op_num:%llu\n",
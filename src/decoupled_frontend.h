@@ -123,8 +123,12 @@ uint64_t decoupled_fe_ftq_iter_ft_offset(decoupled_fe_iter* iter);
 uint64_t decoupled_fe_ftq_num_ops();
 uint64_t decoupled_fe_ftq_num_fts();
 void decoupled_fe_set_ftq_num(uint64_t ftq_ft_num);
+/* Limits the on-path instructions fetched from now on to insts (MAX_CTR lifts the limit) */
+void decoupled_fe_set_fetch_budget(uns proc_id, Counter insts);
 uint64_t decoupled_fe_get_ftq_num();
 Op* decoupled_fe_get_cur_op();
+/* op_num of the next op fetched into the FTQ */
+uint64_t decoupled_fe_get_op_count();
 uns decoupled_fe_get_conf();
 Off_Path_Reason decoupled_fe_get_off_path_reason();
 Conf_Off_Path_Reason decoupled_fe_get_conf_off_path_reason();
@@ -30,7 +30,7 @@ void init_dependency_chain_cache(uns proc_id) {
     block_caches[proc_id] = (Dependency_Chain_Cache_Entry*)calloc(BLOCK_CACHE_SIZE, sizeof(Dependency_Chain_Cache_Entry));
     empty_block_tag_store[proc_id] = (Block_Cache_Tag_Entry*)calloc(EMPTY_BLOCK_TAG_STORE_SIZE, sizeof(Block_Cache_Tag_Entry));
     bw_engines[proc_id] = (Backward_Walk_Engine*)calloc(1, sizeof(Backward_Walk_Engine));
-    bw_engines[proc_id]->snapshot_buffer = (Op*)calloc(FILL_BUFFER_SIZE, sizeof(Op));
+    bw_engines[proc_id]->snapshot_buffer = (Retired_Op_Record*)calloc(FILL_BUFFER_SIZE, sizeof(Retired_Op_Record));
     ASSERT(proc_id, dependency_chain_caches[proc_id] && block_caches[proc_id] && empty_block_tag_store[proc_id] && bw_engines[proc_id]);
 }
 
@@ -55,15 +55,15 @@ void reset_dependency_chain_cache(uns proc_id) {
 // SourceList 헬퍼 함수 (Bit Vector 최적화 적용)
 // =================================================================
 
-static void add_reg_to_live_in_list(SourceList* list, Reg_Info* reg) {
-    if (reg->id < 64) {
-        list->reg_vector |= (1ULL << reg->id);
+static void add_reg_to_live_in_list(SourceList* list, uns8 reg_id) {
+    if (reg_id < 64) {
+        list->reg_vector |= (1ULL << reg_id);
     }
 }
 
-static bool remove_reg_from_live_in_list(SourceList* list, Reg_Info* reg) {
-    if (reg->id < 64 && ((list->reg_vector >> reg->id) & 1ULL)) {
-        list->reg_vector &= ~(1ULL << reg->id);
+static bool remove_reg_from_live_in_list(SourceList* list, uns8 reg_id) {
+    if (reg_id < 64 && ((list->reg_vector >> reg_id) & 1ULL)) {
+        list->reg_vector &= ~(1ULL << reg_id);
         return true;
     }
     return false;
@@ -89,29 +89,24 @@ static bool remove_addr_from_live_in_list(SourceList* list, Addr addr) {
 // 핵심 로직: 스냅샷을 기반으로 체인 추출 및 캐시 저장
 // =================================================================
 
-void add_dependency_chain(uns proc_id, Op* ordered_ops, int ordered_op_count) {
+void add_dependency_chain(uns proc_id, Retired_Op_Record* ordered_ops, int ordered_op_count) {
     if (ordered_op_count < 1) return;
 
     // --- 파트 0: 이제 함수는 이미 정렬된 '스냅샷'을 받음 ---
 
     // --- 파트 1: Backward Dataflow Walk로 의존성 있는 명령어 '표시' ---
     Addr block_start_pc_map[FILL_BUFFER_SIZE];
-    Addr current_block_start_pc = 0;
-    if (ordered_op_count > 0 && ordered_ops[0].inst_info) {
-        current_block_start_pc = ordered_ops[0].inst_info->addr;
-    }
+    Addr current_block_start_pc = ordered_ops[0].pc;
     for (int i = 0; i < ordered_op_count; ++i) {
         block_start_pc_map[i] = current_block_start_pc;
-        if (ordered_ops[i].table_info && ordered_ops[i].table_info->cf_type != NOT_CF) {
-            if (i + 1 < ordered_op_count && ordered_ops[i+1].inst_info) {
-                current_block_start_pc = ordered_ops[i + 1].inst_info->addr;
-            }
+        if (ordered_ops[i].cf_type != NOT_CF && i + 1 < ordered_op_count) {
+            current_block_start_pc = ordered_ops[i + 1].pc;
         }
     }
     
     int trigger_op_idx = -1;
     for (int i = ordered_op_count - 1; i >= 0; --i) {
-        if (ordered_ops[i].oracle_info.hbt_pred_is_hard) {
+        if (ordered_ops[i].h2p) {
             trigger_op_idx = i;
             break;
         }
@@ -122,40 +117,37 @@ void add_dependency_chain(uns proc_id, Op* ordered_ops, int ordered_op_count) {
     bool is_data_dependent[FILL_BUFFER_SIZE];
     memset(is_data_dependent, false, sizeof(is_data_dependent));
     
-    Op* trigger_op = &ordered_ops[trigger_op_idx];
+    Retired_Op_Record* trigger_op = &ordered_ops[trigger_op_idx];
     is_data_dependent[trigger_op_idx] = true;
 
-    if (trigger_op->inst_info && trigger_op->table_info) {
-        for (int i = 0; i < trigger_op->table_info->num_src_regs; ++i) add_reg_to_live_in_list(&live_in_list, &trigger_op->inst_info->srcs[i]);
-    }
-    if (trigger_op->table_info && trigger_op->table_info->mem_type == MEM_LD) add_addr_to_live_in_list(&live_in_list, trigger_op->oracle_info.va);
+    for (int i = 0; i < trigger_op->num_src_regs; ++i) add_reg_to_live_in_list(&live_in_list, trigger_op->srcs[i]);
+    if (trigger_op->mem_type == MEM_LD) add_addr_to_live_in_list(&live_in_list, trigger_op->va);
 
     int first_dep_op_idx = trigger_op_idx;
     for (int i = trigger_op_idx - 1; i >= 0; --i) {
-        Op* current_op = &ordered_ops[i];
+        Retired_Op_Record* current_op = &ordered_ops[i];
         bool depends = false;
-        if (!current_op->table_info || !current_op->inst_info) continue;
-        
-        for (int d = 0; d < current_op->table_info->num_dest_regs; ++d) {
-            if (remove_reg_from_live_in_list(&live_in_list, &current_op->inst_info->dests[d])) depends = true;
+
+        for (int d = 0; d < current_op->num_dest_regs; ++d) {
+            if (remove_reg_from_live_in_list(&live_in_list, current_op->dests[d])) depends = true;
         }
-        if (current_op->table_info->mem_type == MEM_ST && remove_addr_from_live_in_list(&live_in_list, current_op->oracle_info.va)) depends = true;
+        if (current_op->mem_type == MEM_ST && remove_addr_from_live_in_list(&live_in_list, current_op->va)) depends = true;
 
         if (depends) {
             is_data_dependent[i] = true;
             first_dep_op_idx = i;
-            for (int s = 0; s < current_op->table_info->num_src_regs; ++s) add_reg_to_live_in_list(&live_in_list, &current_op->inst_info->srcs[s]);
-            if (current_op->table_info->mem_type == MEM_LD) add_addr_to_live_in_list(&live_in_list, current_op->oracle_info.va);
+            for (int s = 0; s < current_op->num_src_regs; ++s) add_reg_to_live_in_list(&live_in_list, current_op->srcs[s]);
+            if (current_op->mem_type == MEM_LD) add_addr_to_live_in_list(&live_in_list, current_op->va);
         }
     }
 
     // --- 파트 2: 순수 데이터 의존성 체인을 dependency_chain_cache에 저장 ---
     Dependency_Chain_Cache_Entry* dep_cache = dependency_chain_caches[proc_id];
-    int dep_entry_index = trigger_op->inst_info->addr % DEPENDENCY_CHAIN_CACHE_SIZE;
+    int dep_entry_index = trigger_op->pc % DEPENDENCY_CHAIN_CACHE_SIZE;
     Dependency_Chain_Cache_Entry* dep_entry = &dep_cache[dep_entry_index];
     
     dep_entry->is_valid = TRUE;
-    dep_entry->h2p_branch_pc = trigger_op->inst_info->addr;
+    dep_entry->h2p_branch_pc = trigger_op->pc;
     dep_entry->h2p_branch_op_num = trigger_op->op_num;
     dep_entry->chain_length = 0;
     for (int i = first_dep_op_idx; i <= trigger_op_idx; ++i) {
@@ -173,7 +165,7 @@ void add_dependency_chain(uns proc_id, Op* ordered_ops, int ordered_op_count) {
     int current_block_start_idx = first_dep_op_idx;
 
     for (int i = first_dep_op_idx; i <= trigger_op_idx; ++i) {
-        bool is_block_terminator = (ordered_ops[i].table_info && ordered_ops[i].table_info->cf_type != NOT_CF);
+        bool is_block_terminator = (ordered_ops[i].cf_type != NOT_CF);
         bool is_last_op_in_slice = (i == trigger_op_idx);
 
         if (is_block_terminator || is_last_op_in_slice) {
@@ -243,6 +235,16 @@ void cycle_backward_walk_engine(uns proc_id) {
     }
 }
 
+// IDLE_SKIP로 건너뛴 사이클만큼 walk를 진행 (완료 사이클은 건너뛰지 않음)
+void backward_walk_engine_idle_skip(uns proc_id, Counter cycles) {
+    Backward_Walk_Engine* engine = bw_engines ? bw_engines[proc_id] : NULL;
+
+    if (engine && engine->state == BW_WALKING) {
+        ASSERT(proc_id, engine->walk_cycles_remaining > cycles);
+        engine->walk_cycles_remaining -= cycles;
+    }
+}
+
 void periodically_reset_caches(uns proc_id) {
     if (block_caches && block_caches[proc_id]) {
         for (int i = 0; i < BLOCK_CACHE_SIZE; ++i) {
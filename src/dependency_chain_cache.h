@@ -2,8 +2,7 @@
 #define __DEPENDENCY_CC_H__
 
 #include "globals/global_types.h"
-#include "op.h"
-#include "table_info.h"
+#include "fill_buffer.h"
 #include <stdbool.h>
 
 // =================================================================
@@ -33,7 +32,7 @@ typedef struct Dependency_Chain_Cache_Entry_struct {
   Addr          h2p_branch_pc;
   Counter       h2p_branch_op_num;
   uns           chain_length;
-  Op            chain[MAX_CHAIN_LENGTH];
+  Retired_Op_Record chain[MAX_CHAIN_LENGTH];
   uint64_t     dependency_mask;     // 기본 블록 내 의존성 비트마스크
   uns          total_ops_in_block;  // 마스크와 함께 사용할 블록의 총 명령어 수
 } Dependency_Chain_Cache_Entry;
@@ -51,7 +50,7 @@ typedef enum {
 typedef struct Backward_Walk_Engine_struct {
     Backward_Walk_State state;
     Counter             walk_cycles_remaining;
-    Op* snapshot_buffer; // Changed from array to pointer
+    Retired_Op_Record* snapshot_buffer; // Changed from array to pointer
     int                 snapshot_op_count;
 } Backward_Walk_Engine;
 
@@ -63,9 +62,10 @@ extern Backward_Walk_Engine** bw_engines;
 // =================================================================
 void init_dependency_chain_cache(uns proc_id);
 void reset_dependency_chain_cache(uns proc_id);
-void add_dependency_chain(uns proc_id, Op* snapshot_buffer, int op_count);
+void add_dependency_chain(uns proc_id, Retired_Op_Record* snapshot_buffer, int op_count);
 void periodically_reset_caches(uns proc_id);
 void cycle_backward_walk_engine(uns proc_id); 
+void backward_walk_engine_idle_skip(uns proc_id, Counter cycles);
 Dependency_Chain_Cache_Entry* get_dependency_chain(uns proc_id, Addr pc);
 Dependency_Chain_Cache_Entry* get_dependency_chain_block(uns proc_id, Addr pc);
 extern Dependency_Chain_Cache_Entry** dependency_chain_caches;
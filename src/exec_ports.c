@@ -251,6 +251,16 @@ void init_exec_ports_rs_list(uns proc_id, Reservation_Station* rs, Func_Unit* lo
     ASSERTM(proc_id, num_fus == num_fus_pre || (num_fus_pre == 0 && num_fus == NUM_FUS),
             "Decoded a different number of connections that was counted before the loop\n");
 
+    // for each FU type, the connected FUs that can execute it (used by the mask based scheduler)
+    rs[i].fu_type_fus = (uns64*)calloc(FU_TYPE_WIDTH, sizeof(uns64));
+    for (uns32 type = 0; type < FU_TYPE_WIDTH; ++type) {
+      for (uns32 fu_idx = 0; fu_idx < rs[i].num_fus; ++fu_idx) {
+        Func_Unit* fu = rs[i].connected_fus[fu_idx];
+        if (fu->type & (1ull << type))
+          rs[i].fu_type_fus[type] |= 1ull << fu->fu_id;
+      }
+    }
+
     power_calc_instruction_window_size(&rs[i]);
   }
   ASSERTM(proc_id, tmp == FALSE, "Found more RS_CONNECTIONS than expected\n");
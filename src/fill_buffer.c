@@ -16,6 +16,9 @@ void init_fill_buffer(uns proc_id, const char* name) {
         retired_fill_buffers = (Fill_Buffer**)calloc(NUM_CORES, sizeof(Fill_Buffer*));
         ASSERT(0, retired_fill_buffers);
     }
+    // FILL_BUFFER_SIZE가 0이면 fill buffer를 끈다 (NULL이면 fill_buffer_add가 건너뜀)
+    if (!FILL_BUFFER_SIZE)
+        return;
 
     retired_fill_buffers[proc_id] = (Fill_Buffer*)malloc(sizeof(Fill_Buffer));
     ASSERT(proc_id, retired_fill_buffers[proc_id]);
@@ -23,7 +26,7 @@ void init_fill_buffer(uns proc_id, const char* name) {
     
     fb->name = strdup(name);
     fb->size = FILL_BUFFER_SIZE;
-    fb->entries = (Op*)calloc(fb->size, sizeof(Op));
+    fb->entries = (Retired_Op_Record*)calloc(fb->size, sizeof(Retired_Op_Record));
     ASSERT(proc_id, fb->entries);
     reset_fill_buffer(proc_id);
 }
@@ -35,7 +38,32 @@ void reset_fill_buffer(uns proc_id) {
         fb->head = 0;
         fb->tail = 0;
         fb->count = 0;
-        memset(fb->entries, 0, sizeof(Op) * fb->size);
+        memset(fb->entries, 0, sizeof(Retired_Op_Record) * fb->size);
+    }
+}
+
+static void fill_retired_op_record(Retired_Op_Record* record, Op* op) {
+    record->pc = op->inst_info->addr;
+    record->op_num = op->op_num;
+    record->va = op->oracle_info.va;
+    record->sched_cycle = op->sched_cycle;
+    record->exec_cycle = op->exec_cycle;
+    record->done_cycle = op->done_cycle;
+    record->retire_cycle = op->retire_cycle;
+    record->mem_size = op->oracle_info.mem_size;
+    record->op_type = op->table_info->op_type;
+    record->cf_type = op->table_info->cf_type;
+    record->mem_type = op->table_info->mem_type;
+    record->num_src_regs = op->table_info->num_src_regs;
+    record->num_dest_regs = op->table_info->num_dest_regs;
+    record->h2p = op->oracle_info.hbt_pred_is_hard;
+    for (uns i = 0; i < op->table_info->num_src_regs; i++) {
+        ASSERT(op->proc_id, op->inst_info->srcs[i].id < 256);
+        record->srcs[i] = op->inst_info->srcs[i].id;
+    }
+    for (uns i = 0; i < op->table_info->num_dest_regs; i++) {
+        ASSERT(op->proc_id, op->inst_info->dests[i].id < 256);
+        record->dests[i] = op->inst_info->dests[i].id;
     }
 }
 
@@ -50,10 +78,10 @@ void fill_buffer_add(uns proc_id, Op* op) {
     // Buffer is full, overwrite the oldest entry
     if (fb->count == fb->size) {
         // 1. 덮어씌워질, 즉 가장 오래된 op(head 위치)를 가져옵니다.
-        Op* evicted_op = &fb->entries[fb->head];
+        Retired_Op_Record* evicted_op = &fb->entries[fb->head];
 
         // 2. 만약 이 op가 H2P 브랜치라면, 경로 기록 함수를 호출합니다.
-        if (evicted_op->oracle_info.hbt_pred_is_hard) {
+        if (evicted_op->h2p) {
             record_on_off_path(proc_id, evicted_op);
         }
         // head 이동
@@ -62,8 +90,7 @@ void fill_buffer_add(uns proc_id, Op* op) {
     }
 
     // 새 op 추가
-    op->chain_bit = FALSE;
-    fb->entries[fb->tail] = *op;
+    fill_retired_op_record(&fb->entries[fb->tail], op);
     fb->tail = (fb->tail + 1) % fb->size;
     fb->count++;
 }
\ No newline at end of file
@@ -6,8 +6,29 @@
 #include "core.param.h"
 #include "table_info.h"
 
+// 리타이어된 op에서 H2P 분석(fill buffer, dependency chain, on/off path)이
+// 읽는 필드만 복사한 레코드. Op 전체를 복사하지 않고 포인터도 담지 않는다.
+typedef struct Retired_Op_Record_struct {
+  Addr            pc;
+  Counter         op_num;
+  Addr            va;            // 메모리 명령어의 가상 주소
+  Counter         sched_cycle;
+  Counter         exec_cycle;
+  Counter         done_cycle;
+  Counter         retire_cycle;
+  uns             mem_size;
+  uns8            op_type;       // Op_Type
+  uns8            cf_type;       // Cf_Type
+  uns8            mem_type;      // Mem_Type
+  uns8            num_src_regs;
+  uns8            num_dest_regs;
+  Flag            h2p;           // oracle_info.hbt_pred_is_hard
+  uns8            srcs[MAX_SRCS];   // Reg_Info.id
+  uns8            dests[MAX_DESTS]; // Reg_Info.id
+} Retired_Op_Record;
+
 typedef struct Fill_Buffer_struct {
-  Op*             entries;
+  Retired_Op_Record* entries;
   int             head;
   int             tail;
   int             count;
@@ -37,6 +37,7 @@
 #include "memory/memory.param.h"
 #include "ramulator.param.h"
 
+#include "checkpoint.h"
 #include "statistics.h"
 
 /**************************************************************************************/
@@ -116,6 +117,8 @@ void freq_init(void) {
   GET_STAT_EVENT(0, PARAM_L1_CYCLE_TIME) = l1_cycle_time;
   // GET_STAT_EVENT(0, PARAM_MEMORY_CYCLE_TIME) = MEMORY_CYCLE_TIME;
   GET_STAT_EVENT(0, PARAM_MEMORY_CYCLE_TIME) = RAMULATOR_TCK;
+  /* cache replacement timestamps are in this time base */
+  ckpt_register_data("freq_time", 0, &cur_time, sizeof(cur_time));
 }
 
 static Freq_Domain_Id freq_domain_create(char* name, uns cycle_time) {
@@ -173,6 +176,48 @@ void freq_advance_time(void) {
   }
 }
 
+Counter freq_next_cycle_time(Freq_Domain_Id id) {
+  ASSERT(0, id < num_domains);
+  return cur_time + domains[id].time_until_next_cycle;
+}
+
+void freq_skip_until(Counter end_time) {
+  Counter last_skipped_time = cur_time;
+
+  /* Currently ready domains have already simulated this cycle */
+  for (uns i = 0; i < num_domains; i++) {
+    if (domains[i].time_until_next_cycle == 0) {
+      domains[i].time_until_next_cycle = domains[i].cycle_time;
+    }
+  }
+
+  /* Count the cycles of every domain that start before the given time */
+  Counter next_cycle_times[MAX_FREQ_DOMAINS];
+  for (uns i = 0; i < num_domains; i++) {
+    Counter next_cycle_time = cur_time + domains[i].time_until_next_cycle;
+    if (next_cycle_time < end_time) {
+      Counter skipped_cycles = (end_time - 1 - next_cycle_time) / domains[i].cycle_time + 1;
+      domains[i].cycles += skipped_cycles;
+      next_cycle_time += skipped_cycles * domains[i].cycle_time;
+      last_skipped_time = MAX2(last_skipped_time, next_cycle_time - domains[i].cycle_time);
+      DEBUG(0, "Domain %s skipped %lld cycles\n", domains[i].name, skipped_cycles);
+    }
+    next_cycle_times[i] = next_cycle_time;
+  }
+
+  /* Move time to the start of the last skipped cycle */
+  Counter time_delta = last_skipped_time - cur_time;
+  cur_time = last_skipped_time;
+  INC_STAT_EVENT_ALL(EXECUTION_TIME, time_delta);
+  INC_STAT_EVENT_ALL(POWER_TIME, time_delta);
+  DEBUG(0, "Skipping time to %lld fs\n", cur_time);
+
+  for (uns i = 0; i < num_domains; i++) {
+    ASSERT(0, next_cycle_times[i] > cur_time);
+    domains[i].time_until_next_cycle = next_cycle_times[i] - cur_time;
+  }
+}
+
 void freq_reset_cycle_counts(void) {
   for (uns i = 0; i < num_domains; i++) {
     domains[i].cycles = 0;
@@ -61,6 +61,16 @@ Flag freq_is_ready(Freq_Domain_Id id);
    ready to be simulated */
 void freq_advance_time(void);
 
+/* Returns the time (in femtoseconds) at which the next cycle of the
+   specified domain starts (the current time if the domain is ready) */
+Counter freq_next_cycle_time(Freq_Domain_Id id);
+
+/* Advance time without simulating anything: every domain cycle that
+   starts before the specified time (in femtoseconds) is counted as
+   elapsed. The next call to freq_advance_time() lands on the first
+   domain cycle at or after that time. */
+void freq_skip_until(Counter end_time);
+
 /* Reset cycle time of each domain to zero but keep the time value. */
 void freq_reset_cycle_counts(void);
 
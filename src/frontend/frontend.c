@@ -37,6 +37,7 @@
 
 #include "bp/bp.h"
 
+#include "checkpoint.h"
 #include "frontend_intf.h"
 #include "icache_stage.h"
 #include "op.h"
@@ -44,6 +45,7 @@
 #include "pin_trace_fe.h"
 #include "sim.h"
 #include "statistics.h"
+#include "synth_fe.h"
 #include "thread.h"
 
 #ifdef ENABLE_PT_MEMTRACE
@@ -66,16 +68,22 @@ void frontend_init() {
   switch (FRONTEND) {
     case FE_PIN_EXEC_DRIVEN: {
       pin_exec_driven_init(NUM_CORES);
+      ckpt_unsupported("the exec-driven frontend");
       break;
     }
     case FE_TRACE: {
       trace_init();
       break;
     }
+    case FE_SYNTH: {
+      synth_init();
+      break;
+    }
 #ifdef ENABLE_PT_MEMTRACE
     case FE_PT:
     case FE_MEMTRACE: {
       ext_trace_init();
+      ckpt_unsupported("the PT/memtrace frontends");
       break;
     }
 #endif
@@ -95,6 +103,10 @@ void frontend_done(Flag* retired_exit) {
       trace_done();
       break;
     }
+    case FE_SYNTH: {
+      synth_done();
+      break;
+    }
 #ifdef ENABLE_PT_MEMTRACE
     case FE_PT:
     case FE_MEMTRACE: {
@@ -108,6 +120,34 @@ void frontend_done(Flag* retired_exit) {
   }
 }
 
+void frontend_fork_prepare() {
+  switch (FRONTEND) {
+    case FE_TRACE: {
+      trace_fork_prepare();
+      break;
+    }
+    case FE_SYNTH:
+      break; /* plain memory, inherited as it is */
+    default:
+      ASSERT(0, 0);
+      break;
+  }
+}
+
+void frontend_fork_child() {
+  switch (FRONTEND) {
+    case FE_TRACE: {
+      trace_fork_child();
+      break;
+    }
+    case FE_SYNTH:
+      break;
+    default:
+      ASSERT(0, 0);
+      break;
+  }
+}
+
 Addr frontend_next_fetch_addr(uns proc_id) {
   return convert_to_cmp_addr(proc_id, frontend->next_fetch_addr(proc_id));
 }
@@ -121,6 +161,13 @@ void frontend_fetch_op(uns proc_id, Op* op) {
   collect_op_stats(op);
 }
 
+uns frontend_fetch_ops(uns proc_id, Op** ops, uns max) {
+  uns num = frontend->fetch_ops(proc_id, ops, max);
+  for (uns ii = 0; ii < num; ii++)
+    collect_op_stats(ops[ii]);
+  return num;
+}
+
 void frontend_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
   DEBUG(proc_id, "Redirect after op_num %lld to 0x%08llx\n", op_count[proc_id] - 1, fetch_addr);
   frontend->redirect(proc_id, inst_uid, fetch_addr);
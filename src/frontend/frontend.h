@@ -41,6 +41,11 @@ void frontend_init(void);
 
 void frontend_done(Flag* retired_exit);
 
+/* Called around the fork() of a running simulation (see opt2_fork_sweep):
+   prepare in the parent before forking, child in every child afterwards */
+void frontend_fork_prepare(void);
+void frontend_fork_child(void);
+
 /* Get next instruction fetch address */
 Addr frontend_next_fetch_addr(uns proc_id);
 
@@ -50,6 +55,13 @@ Flag frontend_can_fetch_op(uns proc_id);
 /* Get an op from the frontend */
 void frontend_fetch_op(uns proc_id, struct Op_struct* op);
 
+/* Get the ops of one instruction from the frontend, allocated from the op
+   pool. Stops after the eom op or after max ops, whichever comes first, and
+   returns how many ops it put in ops. A caller that only checks its fetch
+   limits between instructions thus makes one call per instruction instead of
+   one per op. */
+uns frontend_fetch_ops(uns proc_id, struct Op_struct** ops, uns max);
+
 /* Redirect the front end (down the wrong path) */
 void frontend_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr);
 
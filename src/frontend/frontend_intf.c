@@ -35,6 +35,7 @@
 /* Include headers of all the implementations here */
 #include "frontend/pin_exec_driven_fe.h"
 #include "frontend/pin_trace_fe.h"
+#include "frontend/synth_fe.h"
 
 #ifdef ENABLE_PT_MEMTRACE
 #include "frontend/pt_memtrace/trace_fe.h"
@@ -46,6 +47,7 @@ Frontend_Impl frontend_table[] = {
    prefix##_next_fetch_addr,            \
    prefix##_can_fetch_op,               \
    prefix##_fetch_op,                   \
+   prefix##_fetch_ops,                  \
    prefix##_redirect,                   \
    prefix##_recover,                    \
    prefix##_retire},
@@ -56,6 +56,11 @@ typedef struct Frontend_Intf_struct {
   /* Get an op from the frontend */
   void (*fetch_op)(uns proc_id, struct Op_struct* op);
 
+  /* Get the ops of the next instruction (or of the rest of the current one),
+     at most max, allocated from the op pool. Returns how many were put in
+     ops. */
+  uns (*fetch_ops)(uns proc_id, struct Op_struct** ops, uns max);
+
   /* Redirect the front end (down the wrong path) */
   void (*redirect)(uns proc_id, uns64 inst_uid, Addr fetch_addr);
 
@@ -38,13 +38,16 @@ extern "C" {
 #include "general.param.h"
 
 #include "op.h"
+#include "op_pool.h"
 #include "sim.h"
 }
 
 #include <time.h>
+#include <unistd.h>
 
 #include "frontend/pin_exec_driven_fe.h"
 #include "pin/pin_lib/message_queue_interface_lib.h"
+#include "pin/pin_lib/op_ring.h"
 #include "pin/pin_lib/pin_scarab_common_lib.h"
 #include "pin/pin_lib/uop_generator.h"
 
@@ -55,20 +58,70 @@ extern "C" {
 Server* server;
 std::vector<ScarabOpBuffer_type> cached_cop_buffers;
 
+/* With PIN_EXEC_DRIVEN_OP_RING, ops come through a shared-memory ring per core
+   (pin/pin_lib/op_ring.h) and are consumed in place from the current batch. */
+struct Op_Ring_Reader {
+  Op_Ring* ring;
+  Op_Ring_Batch* batch;  // batch being consumed, NULL if none
+  uns32 pos;
+  uns64 epoch;  // redirects/recovers sent to PIN
+  Flag fetch_outstanding;  // an FE_FETCH_OP has not been answered yet
+  char path[MAX_STR_LENGTH + 1];
+};
+std::vector<Op_Ring_Reader> op_rings;
+
 void get_next_op_buffer_from_pin(uns proc_id);
 void update_op_buffer_if_empty(uns proc_id);
 void invalidate_op_buffer(uns proc_id);
 
+static inline void send_to_pin(uns proc_id, Scarab_To_Pin_Cmd type, Addr inst_addr, uns64 inst_uid) {
+  Scarab_To_Pin_Msg msg;
+  msg.type = type;
+  msg.inst_addr = inst_addr;
+  msg.inst_uid = inst_uid;
+  msg.epoch = op_rings.empty() ? 0 : op_rings[proc_id].epoch;
+
+  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+}
+
 /**********************************************************
  * Cached Op interface
  **********************************************************/
-void get_next_op_buffer_from_pin(uns proc_id) {
-  Scarab_To_Pin_Msg msg;
-  msg.type = FE_FETCH_OP;
-  msg.inst_addr = 0;
-  msg.inst_uid = 0;
+static void get_next_op_batch_from_ring(uns proc_id) {
+  Op_Ring_Reader* reader = &op_rings[proc_id];
+  Op_Ring_Wait wait = {};
+
+  while (true) {
+    Op_Ring_Batch* batch = op_ring_peek(reader->ring);
+    if (!batch) {
+      /* PIN only writes ahead while it has room, ask for the next batch */
+      if (!reader->fetch_outstanding) {
+        send_to_pin(proc_id, FE_FETCH_OP, 0, 0);
+        reader->fetch_outstanding = TRUE;
+      }
+      if (!op_ring_wait(&wait, PIN_EXEC_DRIVEN_OP_RING_TIMEOUT))
+        FATAL_ERROR(proc_id, "PIN wrote no ops into the op ring for %u seconds\n", PIN_EXEC_DRIVEN_OP_RING_TIMEOUT);
+      continue;
+    }
+    if (batch->is_response)
+      reader->fetch_outstanding = FALSE;
+    if (batch->epoch == reader->epoch && batch->num_ops) {
+      ASSERT(proc_id, batch->num_ops <= OP_RING_MAX_BATCH);
+      reader->batch = batch;
+      reader->pos = 0;
+      return;
+    }
+    /* produced before PIN saw our last redirect/recover */
+    op_ring_release(reader->ring);
+  }
+}
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);                       // blocking
+void get_next_op_buffer_from_pin(uns proc_id) {
+  if (!op_rings.empty()) {
+    get_next_op_batch_from_ring(proc_id);
+    return;
+  }
+  send_to_pin(proc_id, FE_FETCH_OP, 0, 0);
   cached_cop_buffers[proc_id] = server->receive<ScarabOpBuffer_type>(proc_id);  // blocking
 }
 // void get_next_op_buffer_from_pin(uns proc_id) {
@@ -108,14 +161,46 @@ void get_next_op_buffer_from_pin(uns proc_id) {
 //   cached_cop_buffers[proc_id] = received_buffer;
 // }
 
+static inline Flag op_buffer_empty(uns proc_id) {
+  if (!op_rings.empty())
+    return op_rings[proc_id].batch == NULL;
+  return cached_cop_buffers[proc_id].empty();
+}
+
+static inline compressed_op* op_buffer_front(uns proc_id) {
+  if (!op_rings.empty())
+    return &op_rings[proc_id].batch->ops[op_rings[proc_id].pos];
+  return &cached_cop_buffers[proc_id].front();
+}
+
+static inline void op_buffer_pop_front(uns proc_id) {
+  if (!op_rings.empty()) {
+    Op_Ring_Reader* reader = &op_rings[proc_id];
+    if (++reader->pos == reader->batch->num_ops) {
+      op_ring_release(reader->ring);
+      reader->batch = NULL;
+    }
+    return;
+  }
+  cached_cop_buffers[proc_id].pop_front();
+}
+
 void update_op_buffer_if_empty(uns proc_id) {
-  if (cached_cop_buffers[proc_id].size() == 0) {
+  if (op_buffer_empty(proc_id)) {
     DEBUG(proc_id, "Calling FETCH_OP to PIN\n");
     get_next_op_buffer_from_pin(proc_id);
   }
 }
 
 inline void invalidate_op_buffer(uns proc_id) {
+  if (!op_rings.empty()) {
+    Op_Ring_Reader* reader = &op_rings[proc_id];
+    if (reader->batch) {
+      op_ring_release(reader->ring);
+      reader->batch = NULL;
+    }
+    return;
+  }
   cached_cop_buffers[proc_id].clear();
 }
 
@@ -129,6 +214,18 @@ Addr get_fetch_address(uns proc_id, compressed_op* cop) {
 void pin_exec_driven_init(uns numProcs) {
   server = new Server(PIN_EXEC_DRIVEN_FE_SOCKET, numProcs);
   cached_cop_buffers.resize(numProcs);
+  if (PIN_EXEC_DRIVEN_OP_RING) {
+    op_rings.resize(numProcs);
+    for (uns proc_id = 0; proc_id < numProcs; proc_id++) {
+      Op_Ring_Reader* reader = &op_rings[proc_id];
+      op_ring_path(reader->path, sizeof(reader->path), getpid(), proc_id);
+      reader->ring = op_ring_create(reader->path, PIN_EXEC_DRIVEN_OP_RING);
+      reader->batch = NULL;
+      reader->epoch = 0;
+      reader->fetch_outstanding = FALSE;
+      send_to_pin(proc_id, FE_OP_RING, getpid(), proc_id);
+    }
+  }
   uop_generator_init(numProcs);
 }
 
@@ -145,6 +242,9 @@ void pin_exec_driven_done(Flag* retired_exit) {
   for (uint32_t i = 0; i < server->getNumClients(); ++i) {
     server->wait_for_client_to_close(i);
   }
+  for (uns proc_id = 0; proc_id < op_rings.size(); proc_id++)
+    op_ring_destroy(op_rings[proc_id].ring, op_rings[proc_id].path);
+  op_rings.clear();
   delete server;
 }
 
@@ -152,14 +252,14 @@ Flag pin_exec_driven_can_fetch_op(uns proc_id) {
   DEBUG(proc_id, "Can Fetch Op begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  return !cached_cop_buffers[proc_id].empty() && !is_sentinal_op(&cached_cop_buffers[proc_id].front());
+  return !op_buffer_empty(proc_id) && !is_sentinal_op(op_buffer_front(proc_id));
 }
 
 Addr pin_exec_driven_next_fetch_addr(uns proc_id) {
   DEBUG(proc_id, "Next Fetch Addr begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  Addr next_fetch_addr = get_fetch_address(proc_id, &cached_cop_buffers[proc_id].front());
+  Addr next_fetch_addr = get_fetch_address(proc_id, op_buffer_front(proc_id));
   ASSERT_PROC_ID_IN_ADDR(proc_id, next_fetch_addr);
   return next_fetch_addr;
 }
@@ -168,16 +268,17 @@ void pin_exec_driven_fetch_op(uns proc_id, Op* op) {
   DEBUG(proc_id, "Fetch Op begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  Flag eom = uop_generator_extract_op(proc_id, op, &cached_cop_buffers[proc_id].front());
+  compressed_op* cop = op_buffer_front(proc_id);
+  Flag eom = uop_generator_extract_op(proc_id, op, cop);
   if (eom) {
     if (!decoupled_fe_is_off_path()) {
-      if (cached_cop_buffers[proc_id].front().scarab_marker_roi_begin == true) {
+      if (cop->scarab_marker_roi_begin == true) {
         ASSERT(proc_id, !roi_dump_began);
         // reset stats
         printf("Reached roi dump begin marker, reset stats\n");
         reset_stats(TRUE);
         roi_dump_began = TRUE;
-      } else if (cached_cop_buffers[proc_id].front().scarab_marker_roi_end == true) {
+      } else if (cop->scarab_marker_roi_end == true) {
         ASSERT(proc_id, roi_dump_began);
         // dump stats
         printf("Reached roi dump end marker, dump stats between\n");
@@ -186,23 +287,30 @@ void pin_exec_driven_fetch_op(uns proc_id, Op* op) {
         roi_dump_ID++;
       }
     }
-    cached_cop_buffers[proc_id].pop_front();
+    op_buffer_pop_front(proc_id);
   }
 
   DEBUG(proc_id, "Fetch Op end: %llx (%llu)\n", op->inst_info->addr, op->inst_uid);
 }
 
+uns pin_exec_driven_fetch_ops(uns proc_id, Op** ops, uns max) {
+  uns num = 0;
+  do {
+    ops[num] = alloc_op(proc_id);
+    pin_exec_driven_fetch_op(proc_id, ops[num]);
+  } while (!ops[num++]->eom && num < max);
+  return num;
+}
+
 void pin_exec_driven_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
   DEBUG(proc_id, "Fetch Redirect: %llx (%llu)\n", fetch_addr, inst_uid);
   /* PIN will asynchronously redirect, Scarab does not need to wait for PIN to
    * finish. Processes will synchronize when Scarab sends next command to PIN*/
-  Scarab_To_Pin_Msg msg;
-  msg.type = FE_REDIRECT;
-  msg.inst_addr = convert_to_cmp_addr(0, fetch_addr);  // removing proc_id
-  msg.inst_uid = inst_uid;
   uop_generator_recover(proc_id);
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  if (!op_rings.empty())
+    op_rings[proc_id].epoch++;
+  send_to_pin(proc_id, FE_REDIRECT, convert_to_cmp_addr(0, fetch_addr), inst_uid);  // removing proc_id
   invalidate_op_buffer(proc_id);
   DEBUG(proc_id, "Fetch Redirect end: %llx\n", fetch_addr);
 }
@@ -211,24 +319,17 @@ void pin_exec_driven_recover(uns proc_id, uns64 inst_uid) {
   DEBUG(proc_id, "Fetch Recover: %llu\n", inst_uid);
   /* PIN will asynchronously recover, Scarab does not need to wait for PIN to
    * finish. Processes will synchronize when Scarab sends next command to PIN*/
-  Scarab_To_Pin_Msg msg;
-  msg.type = FE_RECOVER_AFTER;
-  msg.inst_addr = 0;
-  msg.inst_uid = inst_uid;
   uop_generator_recover(proc_id);
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  if (!op_rings.empty())
+    op_rings[proc_id].epoch++;
+  send_to_pin(proc_id, FE_RECOVER_AFTER, 0, inst_uid);
   invalidate_op_buffer(proc_id);
   DEBUG(proc_id, "Fetch Recover end: %llu\n", inst_uid);
 }
 
 void pin_exec_driven_retire(uns proc_id, uns64 inst_uid) {
   DEBUG(proc_id, "Fetch Retire: %llu\n", inst_uid);
-  Scarab_To_Pin_Msg msg;
-  msg.type = FE_RETIRE;
-  msg.inst_addr = inst_uid == (uns64)-1;
-  msg.inst_uid = inst_uid;
-
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  send_to_pin(proc_id, FE_RETIRE, inst_uid == (uns64)-1, inst_uid);
   DEBUG(proc_id, "Fetch Retire end: %llu\n", inst_uid);
 }
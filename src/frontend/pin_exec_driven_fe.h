@@ -54,6 +54,9 @@ Addr pin_exec_driven_next_fetch_addr(uns proc_id);
 /* Get an op from pin_exec_driven */
 void pin_exec_driven_fetch_op(uns proc_id, struct Op_struct* op);
 
+/* Get the ops of one instruction from pin_exec_driven, at most max */
+uns pin_exec_driven_fetch_ops(uns proc_id, struct Op_struct** ops, uns max);
+
 /* Redirect pin_exec_driven (down the wrong path) */
 void pin_exec_driven_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr);
 
@@ -0,0 +1,73 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/pin_trace_chunked.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : On-disk layout of chunked (seekable) PIN traces.
+ *
+ * A chunked trace is the ctype_pin_inst stream of a .bz2 PIN trace cut into
+ * fixed-size chunks that are compressed independently, followed by an index:
+ *
+ *   header | chunk 0 | chunk 1 | ... | chunk n-1 | index[n]
+ *
+ * Every chunk holds insts_per_chunk records (the last may hold fewer) and starts
+ * on a PIN_TRACE_CHUNK_ALIGN boundary, so with PIN_TRACE_CODEC_RAW the records
+ * can be used straight out of an mmap of the file. Record N lives in chunk
+ * N / insts_per_chunk, which is what makes seeking O(1). All fields are host
+ * (little) endian. pin/pin_trace/convert_trace.cc writes this format from the
+ * existing .bz2 traces; frontend/pin_trace_read.cc detects it by its magic.
+ ***************************************************************************************/
+
+#ifndef __PIN_TRACE_CHUNKED_H__
+#define __PIN_TRACE_CHUNKED_H__
+
+#include <stdint.h>
+
+#define PIN_TRACE_CHUNKED_MAGIC "SCRBPINT"
+#define PIN_TRACE_CHUNKED_VERSION 1
+#define PIN_TRACE_CHUNK_ALIGN 64
+#define PIN_TRACE_DEFAULT_INSTS_PER_CHUNK 16384
+
+typedef enum Pin_Trace_Codec_enum {
+  PIN_TRACE_CODEC_RAW = 0,  /* uncompressed, read in place from the mapping */
+  PIN_TRACE_CODEC_ZLIB = 1, /* one zlib stream per chunk */
+} Pin_Trace_Codec;
+
+typedef struct Pin_Trace_Chunked_Header_struct {
+  char magic[8];            /* PIN_TRACE_CHUNKED_MAGIC, not NUL terminated */
+  uint32_t version;         /* PIN_TRACE_CHUNKED_VERSION */
+  uint32_t inst_size;       /* sizeof(ctype_pin_inst) of the writer */
+  uint32_t codec;           /* Pin_Trace_Codec */
+  uint32_t insts_per_chunk; /* records per chunk, all but the last chunk */
+  uint64_t num_insts;       /* records in the whole trace */
+  uint64_t num_chunks;
+  uint64_t index_offset; /* file offset of num_chunks Pin_Trace_Chunk_Index entries */
+} Pin_Trace_Chunked_Header;
+
+typedef struct Pin_Trace_Chunk_Index_struct {
+  uint64_t offset;    /* file offset of the chunk */
+  uint32_t size;      /* bytes on disk */
+  uint32_t num_insts; /* records once decompressed */
+} Pin_Trace_Chunk_Index;
+
+#endif /* #ifndef __PIN_TRACE_CHUNKED_H__ */
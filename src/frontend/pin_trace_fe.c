@@ -37,12 +37,14 @@
 #include "debug/debug_macros.h"
 
 #include "bp/bp.param.h"
+#include "general.param.h"
 
 #include "./pin/pin_lib/uop_generator.h"
 #include "bp/bp.h"
 #include "frontend/pin_trace_read.h"
 #include "isa/isa.h"
 
+#include "checkpoint.h"
 #include "ctype_pin_inst.h"
 #include "statistics.h"
 
@@ -58,6 +60,12 @@ static char* trace_files[MAX_NUM_PROCS];
 
 ctype_pin_inst* next_pi;
 
+/**************************************************************************************/
+/* Static Prototypes */
+
+static void trace_ckpt(Ckpt_Stream* stream, void* arg);
+static void trace_read_next_inst(uns proc_id, Op* op);
+
 /**************************************************************************************/
 /* trace_init() */
 
@@ -94,14 +102,33 @@ void trace_init() {
   }
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     trace_setup(proc_id);
+    ckpt_register("trace_position", proc_id, trace_ckpt, &next_pi[proc_id]);
   }
 }
 
 void trace_setup(uns proc_id) {
   pin_trace_open(proc_id, trace_files[proc_id]);
+  if (FAST_FORWARD && FAST_FORWARD_TRACE_INS)
+    pin_trace_skip(proc_id, FAST_FORWARD_TRACE_INS);
   pin_trace_read(proc_id, &next_pi[proc_id]);
 }
 
+/**************************************************************************************/
+/* trace_ckpt: the reader position and the record it has read ahead into next_pi.
+   Warmup stops on an instruction boundary, so the uop generator has nothing
+   in flight. */
+
+static void trace_ckpt(Ckpt_Stream* stream, void* arg) {
+  ctype_pin_inst* pi = (ctype_pin_inst*)arg;
+  uns proc_id = pi - next_pi;
+  uint64_t pos = pin_trace_position(proc_id);
+
+  ckpt_io(stream, &pos, sizeof(pos));
+  ckpt_io(stream, pi, sizeof(ctype_pin_inst));
+  if (!ckpt_saving(stream))
+    pin_trace_seek(proc_id, pos);
+}
+
 /**************************************************************************************/
 /* trace_next_fetch_addr */
 
@@ -123,6 +150,20 @@ void trace_close_trace_file(uns proc_id) {
   pin_trace_close(proc_id);
 }
 
+/**************************************************************************************/
+/* trace_fork_prepare, trace_fork_child: next_pi and the uop generator are
+   plain memory and are inherited as they are; only the readers need help. */
+
+void trace_fork_prepare() {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    pin_trace_fork_prepare(proc_id);
+}
+
+void trace_fork_child() {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    pin_trace_fork_child(proc_id);
+}
+
 Flag trace_can_fetch_op(uns proc_id) {
   return !(uop_generator_get_eom(proc_id) && trace_read_done[proc_id]);
 }
@@ -135,16 +176,30 @@ void trace_fetch_op(uns proc_id, Op* op) {
     uop_generator_get_uop(proc_id, op, NULL);
   }
 
-  if (uop_generator_get_eom(proc_id)) {
-    int success = pin_trace_read(proc_id, &next_pi[proc_id]);
-    if (!success) {
-      trace_read_done[proc_id] = TRUE;
-      reached_exit[proc_id] = TRUE;
-      /* this flag is supposed to be set in uop_generator_get_uop() but there
-       * is a circular dependency on trace_read_done to be set. So, we set
-       * op->exit here. */
-      op->exit = TRUE;
-    }
+  if (uop_generator_get_eom(proc_id))
+    trace_read_next_inst(proc_id, op);
+}
+
+uns trace_fetch_ops(uns proc_id, Op** ops, uns max) {
+  ASSERT(proc_id, !uop_generator_get_bom(proc_id) || (!trace_read_done[proc_id] && !reached_exit[proc_id]));
+  uns num = uop_generator_get_uops(proc_id, ops, max, &next_pi[proc_id]);
+
+  if (uop_generator_get_eom(proc_id))
+    trace_read_next_inst(proc_id, ops[num - 1]);
+  return num;
+}
+
+/* trace_read_next_inst: called once op, the eom of an instruction, has been
+   generated */
+static void trace_read_next_inst(uns proc_id, Op* op) {
+  int success = pin_trace_read(proc_id, &next_pi[proc_id]);
+  if (!success) {
+    trace_read_done[proc_id] = TRUE;
+    reached_exit[proc_id] = TRUE;
+    /* this flag is supposed to be set in uop_generator_get_uop() but there
+     * is a circular dependency on trace_read_done to be set. So, we set
+     * op->exit here. */
+    op->exit = TRUE;
   }
 }
 
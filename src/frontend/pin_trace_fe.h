@@ -47,6 +47,7 @@ void trace_init(void);
 Addr trace_next_fetch_addr(uns proc_id);
 Flag trace_can_fetch_op(uns proc_id);
 void trace_fetch_op(uns proc_id, Op* op);
+uns trace_fetch_ops(uns proc_id, Op** ops, uns max);
 void trace_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr);
 void trace_recover(uns proc_id, uns64 inst_uid);
 void trace_retire(uns proc_id, uns64 inst_uid);
@@ -56,4 +57,8 @@ void trace_done(void);
 void trace_close_trace_file(uns proc_id);
 void trace_setup(uns proc_id);
 
+/* For forking a warmed-up simulation */
+void trace_fork_prepare(void);
+void trace_fork_child(void);
+
 #endif
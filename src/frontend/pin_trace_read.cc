@@ -23,33 +23,328 @@
  * File         : frontend/pin_trace_read.cc
  * Author       : HPS Research Group
  * Date         :
- * Description  :
+ * Description  : Reads PIN traces, either bzip2 streams or the chunked seekable
+ *                format of frontend/pin_trace_chunked.h.
  ****************************************************************************************/
 #include "frontend/pin_trace_read.h"
 
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
 
+#include "frontend/pin_trace_chunked.h"
 #include "isa/isa.h"
 
 extern "C" {
 #include "globals/assert.h"
 #include "globals/utils.h"
+
+#include "core.param.h"
 }
 
 #define CMP_ADDR_MASK (((uint64_t) - 1) << 58)
 
+/**************************************************************************************/
+/* Chunked traces: the file is mmap'd; raw chunks are read in place, compressed
+   ones are inflated by a small per-core thread pool that keeps the next
+   PIN_TRACE_CHUNKS_AHEAD chunks in flight. Chunk c always decompresses into
+   slots[c % PIN_TRACE_CHUNKS_AHEAD], and a slot is handed back to the pool
+   only once the reader has moved past its chunk. */
+
+class Chunked_Pin_Trace {
+ public:
+  bool open(const char* name);
+  void close();
+  int read(ctype_pin_inst* pi);
+  int read_batch(ctype_pin_inst* buf, int max_insts);
+  void seek(uint64_t inst_num);
+  uint64_t position() const { return cur_chunk * hdr->insts_per_chunk + cur_pos; }
+  /* threads do not survive fork(): stop them before, restart in the child */
+  void fork_prepare();
+  void fork_child();
+
+ private:
+  struct Slot {
+    std::vector<ctype_pin_inst> buf;
+    uint64_t chunk;
+    bool ready;
+  };
+
+  const uint8_t* map;
+  size_t map_size;
+  const Pin_Trace_Chunked_Header* hdr;
+  const Pin_Trace_Chunk_Index* index;
+
+  const ctype_pin_inst* cur;  // records of the current chunk
+  uint32_t cur_n;
+  uint32_t cur_pos;
+  uint64_t cur_chunk;
+
+  std::vector<Slot> slots;
+  std::vector<std::thread> workers;
+  std::deque<Slot*> jobs;
+  std::mutex lock;
+  std::condition_variable job_cv;
+  std::condition_variable done_cv;
+  uns in_flight;
+  bool stop;
+
+  void start_workers();
+  void stop_workers();
+  void schedule(uint64_t chunk);
+  void load_chunk(uint64_t chunk);
+  bool next_chunk();
+  void decode(Slot* slot);
+  void worker();
+};
+
+bool Chunked_Pin_Trace::open(const char* name) {
+  struct stat st;
+  int fd = ::open(name, O_RDONLY);
+  if (fd < 0)
+    return false;
+  if (fstat(fd, &st) || (size_t)st.st_size < sizeof(Pin_Trace_Chunked_Header)) {
+    ::close(fd);
+    return false;
+  }
+  map_size = st.st_size;
+  map = (const uint8_t*)mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED)
+    return false;
+
+  hdr = (const Pin_Trace_Chunked_Header*)map;
+  if (memcmp(hdr->magic, PIN_TRACE_CHUNKED_MAGIC, sizeof(hdr->magic))) {
+    munmap((void*)map, map_size);
+    return false;
+  }
+  ASSERTM(0, hdr->version == PIN_TRACE_CHUNKED_VERSION, "%s: unsupported chunked trace version %u\n", name,
+          hdr->version);
+  ASSERTM(0, hdr->inst_size == sizeof(ctype_pin_inst),
+          "%s: trace records are %u bytes, this build expects %zu. Regenerate the trace.\n", name, hdr->inst_size,
+          sizeof(ctype_pin_inst));
+  ASSERTM(0, hdr->codec == PIN_TRACE_CODEC_RAW || hdr->codec == PIN_TRACE_CODEC_ZLIB, "%s: unknown codec %u\n", name,
+          hdr->codec);
+  ASSERTM(0, hdr->index_offset + hdr->num_chunks * sizeof(Pin_Trace_Chunk_Index) <= map_size,
+          "%s: truncated chunk index\n", name);
+  index = (const Pin_Trace_Chunk_Index*)(map + hdr->index_offset);
+  madvise((void*)map, map_size, MADV_SEQUENTIAL);
+
+  in_flight = 0;
+  if (hdr->codec != PIN_TRACE_CODEC_RAW) {
+    slots.resize(MAX2(PIN_TRACE_CHUNKS_AHEAD, 1));
+    start_workers();
+  }
+  seek(0);
+  return true;
+}
+
+void Chunked_Pin_Trace::close() {
+  stop_workers();
+  munmap((void*)map, map_size);
+}
+
+void Chunked_Pin_Trace::start_workers() {
+  stop = false;
+  for (uns ii = 0; ii < PIN_TRACE_DECODE_THREADS; ii++)
+    workers.emplace_back(&Chunked_Pin_Trace::worker, this);
+}
+
+void Chunked_Pin_Trace::stop_workers() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stop = true;
+    in_flight -= jobs.size();
+    jobs.clear();
+  }
+  job_cv.notify_all();
+  for (auto& thread : workers)
+    thread.join();
+  workers.clear();
+}
+
+void Chunked_Pin_Trace::fork_prepare() {
+  stop_workers();
+}
+
+void Chunked_Pin_Trace::fork_child() {
+  if (hdr->codec == PIN_TRACE_CODEC_RAW)
+    return;  // the mapping is shared copy-on-write, nothing else to redo
+  start_workers();
+  seek(position());  // refill the read-ahead dropped by fork_prepare()
+}
+
+void Chunked_Pin_Trace::decode(Slot* slot) {
+  const Pin_Trace_Chunk_Index* entry = &index[slot->chunk];
+  uLongf size = (uLongf)entry->num_insts * sizeof(ctype_pin_inst);
+
+  ASSERT(0, entry->offset + entry->size <= map_size);
+  slot->buf.resize(entry->num_insts);
+  int ret = uncompress((Bytef*)slot->buf.data(), &size, map + entry->offset, entry->size);
+  ASSERTM(0, ret == Z_OK && size == (uLongf)entry->num_insts * sizeof(ctype_pin_inst),
+          "Corrupt chunk %" PRIu64 " in chunked PIN trace (zlib error %d)\n", slot->chunk, ret);
+}
+
+void Chunked_Pin_Trace::worker() {
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    job_cv.wait(guard, [this] { return stop || !jobs.empty(); });
+    if (stop)
+      return;
+    Slot* slot = jobs.front();
+    jobs.pop_front();
+    guard.unlock();
+    decode(slot);
+    guard.lock();
+    slot->ready = true;
+    in_flight--;
+    done_cv.notify_all();
+  }
+}
+
+void Chunked_Pin_Trace::schedule(uint64_t chunk) {
+  if (chunk >= hdr->num_chunks)
+    return;
+  if (hdr->codec == PIN_TRACE_CODEC_RAW) {
+    const Pin_Trace_Chunk_Index* entry = &index[chunk];
+    uint64_t start = entry->offset & ~(uint64_t)(sysconf(_SC_PAGESIZE) - 1);
+    madvise((void*)(map + start), entry->offset + entry->size - start, MADV_WILLNEED);
+    return;
+  }
+
+  Slot* slot = &slots[chunk % slots.size()];
+  std::lock_guard<std::mutex> guard(lock);
+  slot->chunk = chunk;
+  slot->ready = false;
+  if (!workers.empty()) {
+    jobs.push_back(slot);
+    in_flight++;
+    job_cv.notify_one();
+  }
+}
+
+void Chunked_Pin_Trace::load_chunk(uint64_t chunk) {
+  const Pin_Trace_Chunk_Index* entry = &index[chunk];
+
+  cur_chunk = chunk;
+  cur_pos = 0;
+  cur_n = entry->num_insts;
+  if (hdr->codec == PIN_TRACE_CODEC_RAW) {
+    ASSERT(0, entry->offset + entry->size <= map_size && entry->size == cur_n * sizeof(ctype_pin_inst));
+    cur = (const ctype_pin_inst*)(map + entry->offset);
+    schedule(chunk + 1);
+    return;
+  }
+
+  Slot* slot = &slots[chunk % slots.size()];
+  if (workers.empty()) {
+    decode(slot);
+  } else {
+    std::unique_lock<std::mutex> guard(lock);
+    done_cv.wait(guard, [slot] { return slot->ready; });
+  }
+  ASSERT(0, slot->chunk == chunk);
+  cur = slot->buf.data();
+}
+
+bool Chunked_Pin_Trace::next_chunk() {
+  if (cur_chunk + 1 >= hdr->num_chunks)
+    return false;
+  /* the slot of the chunk just finished now decodes the one furthest ahead */
+  if (hdr->codec != PIN_TRACE_CODEC_RAW)
+    schedule(cur_chunk + slots.size());
+  load_chunk(cur_chunk + 1);
+  return true;
+}
+
+void Chunked_Pin_Trace::seek(uint64_t inst_num) {
+  uint64_t chunk = hdr->insts_per_chunk ? inst_num / hdr->insts_per_chunk : 0;
+
+  if (hdr->codec != PIN_TRACE_CODEC_RAW) {
+    /* drop what is queued and let the running decodes finish before the
+       slots are reassigned */
+    std::unique_lock<std::mutex> guard(lock);
+    in_flight -= jobs.size();
+    jobs.clear();
+    done_cv.wait(guard, [this] { return in_flight == 0; });
+  }
+  if (inst_num >= hdr->num_insts || chunk >= hdr->num_chunks) {
+    cur_chunk = hdr->num_chunks;
+    cur_pos = cur_n = 0;
+    return;
+  }
+
+  for (uint64_t ii = 0; ii < slots.size(); ii++)
+    schedule(chunk + ii);
+  load_chunk(chunk);
+  cur_pos = inst_num - chunk * hdr->insts_per_chunk;
+  ASSERT(0, cur_pos <= cur_n);
+}
+
+int Chunked_Pin_Trace::read(ctype_pin_inst* pi) {
+  if (cur_pos == cur_n && !next_chunk())
+    return 0;
+  memcpy(pi, &cur[cur_pos++], sizeof(ctype_pin_inst));
+  return 1;
+}
+
+int Chunked_Pin_Trace::read_batch(ctype_pin_inst* buf, int max_insts) {
+  int count = 0;
+  while (count < max_insts) {
+    if (cur_pos == cur_n && !next_chunk())
+      break;
+    uint32_t num = MIN2((uint32_t)(max_insts - count), cur_n - cur_pos);
+    memcpy(&buf[count], &cur[cur_pos], num * sizeof(ctype_pin_inst));
+    cur_pos += num;
+    count += num;
+  }
+  return count;
+}
+
+/**************************************************************************************/
+
 FILE** pin_file;
+static Chunked_Pin_Trace** chunked_trace;
+static char** trace_name;
+static uint64_t* pin_file_pos; /* records read from each .bz2 stream */
 
 // static Reg_Id convert_pin_reg_to_scarab_reg(uns pin_reg);
 void pin_trace_file_pointer_init(unsigned char num_cores) {
   pin_file = (FILE**)malloc(num_cores * sizeof(FILE*));
+  chunked_trace = (Chunked_Pin_Trace**)calloc(num_cores, sizeof(Chunked_Pin_Trace*));
+  trace_name = (char**)calloc(num_cores, sizeof(char*));
+  pin_file_pos = (uint64_t*)calloc(num_cores, sizeof(uint64_t));
 }
 
 void pin_trace_open(unsigned char proc_id, const char* name) {
+  char* old_name = trace_name[proc_id];  // name may be the old copy
+  trace_name[proc_id] = strdup(name);
+  free(old_name);
+  pin_file_pos[proc_id] = 0;
+
+  Chunked_Pin_Trace* chunked = new Chunked_Pin_Trace();
+  if (chunked->open(name)) {
+    chunked_trace[proc_id] = chunked;
+    pin_file[proc_id] = NULL;
+    printf("chunked pin trace should be opened now for core %u: %s \n", proc_id, name);
+    return;
+  }
+  delete chunked;
+  chunked_trace[proc_id] = NULL;
+
   char cmdline[1024];
   sprintf(cmdline, "bzip2 -dc %s", name);
   pin_file[proc_id] = popen(cmdline, "r");
@@ -61,15 +356,92 @@ void pin_trace_open(unsigned char proc_id, const char* name) {
 }
 
 void pin_trace_close(unsigned char proc_id) {
-  pclose(pin_file[proc_id]);
+  if (chunked_trace[proc_id]) {
+    chunked_trace[proc_id]->close();
+    delete chunked_trace[proc_id];
+    chunked_trace[proc_id] = NULL;
+    return;
+  }
+  if (pin_file[proc_id]) {
+    pclose(pin_file[proc_id]);
+    pin_file[proc_id] = NULL;
+  }
 }
 
 int pin_trace_read(unsigned char proc_id, ctype_pin_inst* pi) {
   int read_size;
 
+  if (chunked_trace[proc_id])
+    return chunked_trace[proc_id]->read(pi);
+
   read_size = fread(pi, sizeof(ctype_pin_inst), 1, pin_file[proc_id]);
   if (read_size != 1) {
     return 0;
   }
+  pin_file_pos[proc_id]++;
   return 1;
 }
+
+int pin_trace_read_batch(unsigned char proc_id, ctype_pin_inst* buf, int max_insts) {
+  if (chunked_trace[proc_id])
+    return chunked_trace[proc_id]->read_batch(buf, max_insts);
+  int num = fread(buf, sizeof(ctype_pin_inst), max_insts, pin_file[proc_id]);
+  pin_file_pos[proc_id] += num;
+  return num;
+}
+
+void pin_trace_skip(unsigned char proc_id, uint64_t num_insts) {
+  if (chunked_trace[proc_id]) {
+    chunked_trace[proc_id]->seek(chunked_trace[proc_id]->position() + num_insts);
+    return;
+  }
+  /* a bzip2 stream can only be skipped by decompressing it */
+  ctype_pin_inst buf[256];
+  while (num_insts) {
+    int num = pin_trace_read_batch(proc_id, buf, MIN2(num_insts, (uint64_t)256));
+    if (!num)
+      break;
+    num_insts -= num;
+  }
+}
+
+uint64_t pin_trace_position(unsigned char proc_id) {
+  if (chunked_trace[proc_id])
+    return chunked_trace[proc_id]->position();
+  return pin_file_pos[proc_id];
+}
+
+void pin_trace_seek(unsigned char proc_id, uint64_t pos) {
+  if (chunked_trace[proc_id]) {
+    chunked_trace[proc_id]->seek(pos);
+    return;
+  }
+  if (pos < pin_file_pos[proc_id]) {
+    pclose(pin_file[proc_id]);
+    pin_trace_open(proc_id, trace_name[proc_id]);
+  }
+  pin_trace_skip(proc_id, pos - pin_file_pos[proc_id]);
+  ASSERTM(0, pin_file_pos[proc_id] == pos, "Trace %s has fewer than %llu records\n", trace_name[proc_id],
+          (unsigned long long)pos);
+}
+
+void pin_trace_fork_prepare(unsigned char proc_id) {
+  if (chunked_trace[proc_id])
+    chunked_trace[proc_id]->fork_prepare();
+}
+
+void pin_trace_fork_child(unsigned char proc_id) {
+  if (chunked_trace[proc_id]) {
+    chunked_trace[proc_id]->fork_child();
+    return;
+  }
+  if (!pin_file[proc_id])
+    return;
+  /* the bzip2 pipe is shared with the parent and the other children: start a
+     private decompressor and bring it to the same record */
+  uint64_t pos = pin_file_pos[proc_id];
+  pclose(pin_file[proc_id]);
+  pin_trace_open(proc_id, trace_name[proc_id]);
+  pin_trace_skip(proc_id, pos);
+  ASSERTM(0, pin_file_pos[proc_id] == pos, "Trace %s ended while repositioning after fork\n", trace_name[proc_id]);
+}
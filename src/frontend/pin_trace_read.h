@@ -29,6 +29,8 @@
 #ifndef __PIN_TRACE_READ_H__
 #define __PIN_TRACE_READ_H__
 
+#include <stdint.h>
+
 #include "ctype_pin_inst.h"
 
 #ifdef __cplusplus
@@ -40,6 +42,19 @@ int pin_trace_read(unsigned char, ctype_pin_inst*);
 void pin_trace_open(unsigned char, const char*);
 void pin_trace_close(unsigned char);
 
+/* reads up to max_insts records, returns how many were read (0 at the end) */
+int pin_trace_read_batch(unsigned char, ctype_pin_inst*, int);
+/* skips records; O(1) on chunked traces, decompress-and-drop on .bz2 ones */
+void pin_trace_skip(unsigned char, uint64_t);
+/* number of records consumed so far, and repositioning to such a count (for
+   warm-state checkpoints); seeking backwards in a .bz2 trace reopens it */
+uint64_t pin_trace_position(unsigned char);
+void pin_trace_seek(unsigned char, uint64_t);
+/* call before fork() and in the child, which then reads on from the same
+   record independently of its parent and siblings */
+void pin_trace_fork_prepare(unsigned char);
+void pin_trace_fork_child(unsigned char);
+
 #ifdef __cplusplus
 }
 #endif
@@ -52,6 +52,7 @@ extern "C" {
 #define DR_DO_NOT_DEFINE_int64
 
 #include <iostream>
+#include <mutex>
 #include <unordered_map>
 
 #include "frontend/pt_memtrace/memtrace_trace_reader_memtrace.h"
@@ -61,13 +62,15 @@ extern "C" {
 
 static char* trace_files[MAX_NUM_PROCS];
 TraceReader* trace_readers[MAX_NUM_PROCS];
-// TODO: Make per proc?
-uint64_t ins_id = 0;
-uint64_t ins_id_fetched = 0;
-uint64_t prior_tid = 0;
-uint64_t prior_pid = 0;
+// Per core, since with TRACE_READ_AHEAD every core's trace is read on its own thread
+uint64_t ins_id[MAX_NUM_PROCS];
+uint64_t ins_id_fetched[MAX_NUM_PROCS];
+static uint64_t prior_tid[MAX_NUM_PROCS];
+static uint64_t prior_pid[MAX_NUM_PROCS];
 
+// shared by the decoders of all cores
 extern scatter_info_map scatter_info_storage;
+static std::mutex scatter_info_mutex;
 
 Flag roi_dump_began = FALSE;
 Counter roi_dump_ID = 0;
@@ -75,7 +78,7 @@ Counter roi_dump_ID = 0;
 /**************************************************************************************/
 /* Private Functions */
 
-void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
+void fill_in_dynamic_info(int proc_id, ctype_pin_inst* info, const InstInfo* insi) {
   uint8_t ld = 0;
   uint8_t st = 0;
 
@@ -84,7 +87,7 @@ void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
   info->instruction_next_addr = insi->target;
   info->actually_taken = insi->taken;
   info->branch_target = insi->target;
-  info->inst_uid = ins_id;
+  info->inst_uid = ins_id[proc_id];
   info->last_inst_from_trace = insi->last_inst_from_trace;
   info->fetched_instruction = insi->fetched_instruction;
 
@@ -149,7 +152,7 @@ void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
   }
 }
 
-int ffwd(const xed_decoded_inst_t* ins) {
+int ffwd(int proc_id, const xed_decoded_inst_t* ins) {
   if (!FAST_FORWARD) {
     return 0;
   }
@@ -157,7 +160,7 @@ int ffwd(const xed_decoded_inst_t* ins) {
       XED_INS_OperandReg(ins, 1) == XED_REG_RCX) {
     return 0;
   }
-  if ((USE_FETCHED_COUNT ? ins_id_fetched : ins_id) == FAST_FORWARD_TRACE_INS) {
+  if ((USE_FETCHED_COUNT ? ins_id_fetched[proc_id] : ins_id[proc_id]) == FAST_FORWARD_TRACE_INS) {
     return 0;
   }
   return 1;
@@ -177,35 +180,36 @@ int memtrace_trace_read(int proc_id, ctype_pin_inst* next_onpath_pi) {
   do {
     insi = const_cast<InstInfo*>(trace_readers[proc_id]->nextInstruction());
 
-    if (prior_pid == 0) {
-      ASSERT(proc_id, prior_tid == 0);
+    if (prior_pid[proc_id] == 0) {
+      ASSERT(proc_id, prior_tid[proc_id] == 0);
       ASSERT(proc_id, insi->valid);
-      prior_pid = insi->pid;
-      prior_tid = insi->tid;
-      ASSERT(proc_id, prior_tid);
-      ASSERT(proc_id, prior_pid);
+      prior_pid[proc_id] = insi->pid;
+      prior_tid[proc_id] = insi->tid;
+      ASSERT(proc_id, prior_tid[proc_id]);
+      ASSERT(proc_id, prior_pid[proc_id]);
     }
     if (insi->valid) {
-      ins_id++;
+      ins_id[proc_id]++;
       if (insi->fetched_instruction) {
-        ins_id_fetched++;
+        ins_id_fetched[proc_id]++;
       }
     } else {
       std::cout << "Reached end of trace" << std::endl;
       return 0;  // end of trace
     }
-  } while (insi->pid != prior_pid || insi->tid != prior_tid);
+  } while (insi->pid != prior_pid[proc_id] || insi->tid != prior_tid[proc_id]);
 
   if (insi->is_dr_ins) {
     memcpy(next_onpath_pi, insi->info, sizeof(ctype_pin_inst));
     // dr_ins ctype_pin_inst are already populated in memtrace_reader_memtrace
-    fill_in_dynamic_info(next_onpath_pi, insi);
+    fill_in_dynamic_info(proc_id, next_onpath_pi, insi);
   } else {
     memset(next_onpath_pi, 0, sizeof(ctype_pin_inst));
-    fill_in_dynamic_info(next_onpath_pi, insi);
+    fill_in_dynamic_info(proc_id, next_onpath_pi, insi);
     fill_in_basic_info(next_onpath_pi, insi->ins);
     if (XED_INS_IsVgather(insi->ins) || XED_INS_IsVscatter(insi->ins)) {
       xed_category_enum_t category = XED_INS_Category(insi->ins);
+      std::lock_guard<std::mutex> lock(scatter_info_mutex);
       scatter_info_storage[insi->pc] = add_to_gather_scatter_info_storage(insi->pc, XED_INS_IsVgather(insi->ins),
                                                                           XED_INS_IsVscatter(insi->ins), category);
     }
@@ -216,13 +220,25 @@ int memtrace_trace_read(int proc_id, ctype_pin_inst* next_onpath_pi) {
     print_err_if_invalid(next_onpath_pi, insi->ins);
   }
 
-  if (next_onpath_pi->scarab_marker_roi_begin == true) {
+  // End of ROI
+  if (!insi->is_dr_ins && roi(insi->ins))
+    return 0;
+
+  return 1;
+}
+
+/**************************************************************************************/
+/* memtrace_handle_roi_markers: called by the trace frontend on the simulator thread
+ * for every instruction read, since it resets/dumps stats. */
+
+void memtrace_handle_roi_markers(int proc_id, const ctype_pin_inst* pi) {
+  if (pi->scarab_marker_roi_begin == true) {
     assert(!roi_dump_began);
     // reset stats
     std::cout << "Reached roi dump begin marker, reset stats" << std::endl;
     reset_stats(TRUE);
     roi_dump_began = TRUE;
-  } else if (next_onpath_pi->scarab_marker_roi_end == true) {
+  } else if (pi->scarab_marker_roi_end == true) {
     assert(roi_dump_began);
     // dump stats
     std::cout << "Reached roi dump end marker, dump stats between" << std::endl;
@@ -230,12 +246,6 @@ int memtrace_trace_read(int proc_id, ctype_pin_inst* next_onpath_pi) {
     roi_dump_began = FALSE;
     roi_dump_ID++;
   }
-
-  // End of ROI
-  if (!insi->is_dr_ins && roi(insi->ins))
-    return 0;
-
-  return 1;
 }
 
 /**************************************************************************************/
@@ -282,7 +292,7 @@ void memtrace_setup(uns proc_id) {
 
   if (FAST_FORWARD) {
     ASSERT(proc_id, !MEMTRACE_ROI_BEGIN && !MEMTRACE_ROI_END);
-    uint64_t inst_count_to_use = USE_FETCHED_COUNT ? ins_id_fetched : ins_id;
+    uint64_t inst_count_to_use = USE_FETCHED_COUNT ? ins_id_fetched[proc_id] : ins_id[proc_id];
     std::cout << "Enter fast forward " << inst_count_to_use << std::endl;
     // FFWD the first instruction and as many as later ffwding parameters specify.
     // insi is invalid once end of trace is reached.
@@ -291,18 +301,18 @@ void memtrace_setup(uns proc_id) {
     do {
       insi = trace_readers[proc_id]->nextInstruction();
       if (insi->valid) {
-        ins_id++;
+        ins_id[proc_id]++;
         if (insi->fetched_instruction) {
-          ins_id_fetched++;
+          ins_id_fetched[proc_id]++;
         }
       }
 
-      inst_count_to_use = USE_FETCHED_COUNT ? ins_id_fetched : ins_id;
+      inst_count_to_use = USE_FETCHED_COUNT ? ins_id_fetched[proc_id] : ins_id[proc_id];
 
       if ((inst_count_to_use % 10000000) == 0)
         std::cout << "Fast forwarded " << inst_count_to_use << " instructions." << (insi->valid ? " Valid" : " Invalid")
                   << " instr." << std::endl;
-    } while (ffwd(insi->ins));
+    } while (ffwd(proc_id, insi->ins));
     std::cout << "Exit fast forward " << inst_count_to_use << std::endl;
   }
 }
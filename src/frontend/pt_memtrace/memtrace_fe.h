@@ -47,6 +47,7 @@ extern "C" {
 
 void memtrace_init(void);
 int memtrace_trace_read(int proc_id, ctype_pin_inst* pt_next_pi);
+void memtrace_handle_roi_markers(int proc_id, const ctype_pin_inst* pi);
 void memtrace_setup(uns proc_id);
 
 #ifdef __cplusplus
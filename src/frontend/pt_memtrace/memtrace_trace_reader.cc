@@ -29,6 +29,7 @@
 #include "frontend/pt_memtrace/memtrace_trace_reader.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <fcntl.h>
 #include <fstream>
@@ -215,7 +216,7 @@ unique_ptr<xed_decoded_inst_t> TraceReader::makeNop(uint8_t _length) {
 
 // WARNING: This function generates a memory leak!
 xed_decoded_inst_t* TraceReader::createJmp(uint64_t displacement) {
-  static int createdJmps = 0;
+  static std::atomic<int> createdJmps(0);
   xed_encoder_instruction_t inst;
   xed_state_t state;
   state.mmode = XED_MACHINE_MODE_LONG_64;
@@ -235,9 +236,9 @@ xed_decoded_inst_t* TraceReader::createJmp(uint64_t displacement) {
     return nullptr;
   }
   xed_decoded_inst_t* decoded_inst = new xed_decoded_inst_t;
-  createdJmps++;
-  if ((createdJmps % 1000) == 0)
-    warn("generated %i Jmp instructions, possible memory leak", createdJmps);
+  int jmps = ++createdJmps;
+  if ((jmps % 1000) == 0)
+    warn("generated %i Jmp instructions, possible memory leak", jmps);
   xed_decoded_inst_zero(decoded_inst);
   xed_decoded_inst_set_mode(decoded_inst, XED_MACHINE_MODE_LONG_64, XED_ADDRESS_WIDTH_64b);
   error = xed_decode(decoded_inst, encodedBytes, numBytesUsed);
@@ -256,7 +256,8 @@ TraceReaderMemtrace::TraceReaderMemtrace(const std::string& _trace, uint32_t _bu
       mt_seq_(0),
       mt_prior_isize_(0),
       mt_using_info_a_(true),
-      mt_warn_target_(0) {
+      mt_warn_target_(0),
+      mt_first_instr_(true) {
   init(_trace);
 }
 
@@ -327,7 +328,6 @@ bool TraceReaderMemtrace::initTrace() {
 }
 
 bool TraceReaderMemtrace::getNextInstruction__(InstInfo* _info, InstInfo* _prior) {
-  static bool first_instr = true;
   uint32_t prior_isize = mt_prior_isize_;
   bool complete = false;
 
@@ -354,11 +354,11 @@ bool TraceReaderMemtrace::getNextInstruction__(InstInfo* _info, InstInfo* _prior
     switch (mt_state_) {
       case (MTState::INST):
         if (type_is_instr(mt_ref_.instr.type)) {
-          if (first_instr) {
+          if (mt_first_instr_) {
             // if this is the first instruction ever,
             // the file type marker of the trace should have been processed internally by DynamoRIO.
             // it is time to see if encodings are available.
-            first_instr = false;
+            mt_first_instr_ = false;
             instr_t drinst;
             instr_init(dcontext_, &drinst);
             decode(dcontext_, mt_ref_.instr.encoding, &drinst);
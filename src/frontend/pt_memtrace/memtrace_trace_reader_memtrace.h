@@ -85,6 +85,7 @@ class TraceReaderMemtrace : public TraceReader {
   InstInfo mt_info_b_;
   bool mt_using_info_a_;
   uint64_t mt_warn_target_;
+  bool mt_first_instr_;  // is_dr_isa not yet set from the first instruction
 };
 
 #endif
@@ -66,21 +66,22 @@ extern "C" {
 
 char* pt_trace_files[MAX_NUM_PROCS];
 TraceReaderPT* pt_trace_readers[MAX_NUM_PROCS];
-uint64_t pt_ins_id = 0;
-uint64_t pt_prior_tid = 0;
-uint64_t pt_prior_pid = 0;
+// Per core, since with TRACE_READ_AHEAD every core's trace is read on its own thread
+uint64_t pt_ins_id[MAX_NUM_PROCS];
+uint64_t pt_prior_tid[MAX_NUM_PROCS];
+uint64_t pt_prior_pid[MAX_NUM_PROCS];
 
-std::mt19937 gen(0);
+std::mt19937 gen[MAX_NUM_PROCS];  // seeded with 0 in pt_init
 // Generate random addresses near the mean (1GB)
 const uint64_t mean = 1000000000;
 // Generate addresses where approximately 92% hit the L1 cache for DCACHE_SIZE=48KB
 double sd = 14000;
-std::normal_distribution<> d{mean, sd};  // generates an address of 1G +/-25K with 92% proability
-const uint64_t offset = 0xFF0000;        // ensure to generate no zero page address
+std::normal_distribution<> d[MAX_NUM_PROCS];  // generates an address of 1G +/-25K with 92% proability
+const uint64_t offset = 0xFF0000;             // ensure to generate no zero page address
 /**************************************************************************************/
 /* Private Functions for PT */
 
-void pt_fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
+void pt_fill_in_dynamic_info(int proc_id, ctype_pin_inst* info, const InstInfo* insi) {
   uint8_t ld = 0;
   uint8_t st = 0;
 
@@ -89,7 +90,7 @@ void pt_fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
   info->instruction_next_addr = insi->target;
   info->actually_taken = insi->taken;
   info->branch_target = insi->target;
-  info->inst_uid = pt_ins_id;
+  info->inst_uid = pt_ins_id[proc_id];
 
 #ifdef PRINT_INSTRUCTION_INFO
   std::cout << std::hex << info->instruction_addr << " Next " << info->instruction_next_addr << " size "
@@ -104,7 +105,7 @@ void pt_fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
 
   for (uint8_t op = 0; op < xed_decoded_inst_number_of_memory_operands(insi->ins); op++) {
     // generate random address according to normal distribution as PT does not contain memory addresses
-    uint64_t fake_addr = std::round(d(gen)) + offset;
+    uint64_t fake_addr = std::round(d[proc_id](gen[proc_id])) + offset;
     // predicated true ld/st are handled just as regular ld/st
     if (xed_decoded_inst_mem_read(insi->ins, op) && !insi->mem_used[op]) {
       info->ld_vaddr[ld++] = fake_addr;
@@ -143,13 +144,13 @@ int pt_trace_read(int proc_id, ctype_pin_inst* pt_next_pi) {
 
   do {
     insi = const_cast<InstInfo*>(pt_trace_readers[proc_id]->nextInstruction());
-    pt_ins_id++;
+    pt_ins_id[proc_id]++;
     if (!insi->valid)
       return 0;  // end of trace
-  } while (insi->pid != pt_prior_pid || insi->tid != pt_prior_tid);
+  } while (insi->pid != pt_prior_pid[proc_id] || insi->tid != pt_prior_tid[proc_id]);
 
   memset(pt_next_pi, 0, sizeof(ctype_pin_inst));
-  pt_fill_in_dynamic_info(pt_next_pi, insi);
+  pt_fill_in_dynamic_info(proc_id, pt_next_pi, insi);
   fill_in_basic_info(pt_next_pi, insi->ins);
   assert(pt_next_pi->instruction_next_addr && "instruction_next_addr not set");
   uint32_t max_op_width = add_dependency_info(pt_next_pi, insi->ins);
@@ -207,6 +208,8 @@ void pt_init(void) {
     pt_trace_files[proc_id] = tmp_trace_files[proc_id];
   }
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    gen[proc_id].seed(0);
+    d[proc_id] = std::normal_distribution<>{mean, sd};
     pt_setup(proc_id);
   }
 }
@@ -219,25 +222,25 @@ void pt_setup(uns proc_id) {
 
   // FFWD
   const InstInfo* insi = pt_trace_readers[proc_id]->nextInstruction();
-  pt_ins_id++;
+  pt_ins_id[proc_id]++;
 
   if (FAST_FORWARD) {
-    std::cout << "Enter fast forward " << pt_ins_id << std::endl;
+    std::cout << "Enter fast forward " << pt_ins_id[proc_id] << std::endl;
 
     while (!insi->valid || pt_ffwd(insi->ins)) {
       insi = pt_trace_readers[proc_id]->nextInstruction();
-      pt_ins_id++;
-      if ((pt_ins_id % 10000000) == 0)
-        std::cout << "Fast forwarded " << pt_ins_id << " instructions." << std::endl;
-      if (pt_ins_id >= FAST_FORWARD_TRACE_INS)
+      pt_ins_id[proc_id]++;
+      if ((pt_ins_id[proc_id] % 10000000) == 0)
+        std::cout << "Fast forwarded " << pt_ins_id[proc_id] << " instructions." << std::endl;
+      if (pt_ins_id[proc_id] >= FAST_FORWARD_TRACE_INS)
         break;
     }
 
-    std::cout << "Exit fast forward " << pt_ins_id << std::endl;
+    std::cout << "Exit fast forward " << pt_ins_id[proc_id] << std::endl;
   }
 
-  pt_prior_pid = insi->pid;
-  pt_prior_tid = insi->tid;
-  assert(pt_prior_tid);
-  assert(pt_prior_pid);
+  pt_prior_pid[proc_id] = insi->pid;
+  pt_prior_tid[proc_id] = insi->tid;
+  assert(pt_prior_tid[proc_id]);
+  assert(pt_prior_pid[proc_id]);
 }
@@ -62,10 +62,11 @@ class TraceReaderPT : public TraceReader {
   uint64_t num_nops_in_trace = 0, num_inserted_nops = 0;
   uint64_t num_direct_brs_in_trace = 0, num_inserted_direct_brs = 0;
   std::vector<std::string> parsed;
+  uns64 num_nops_at_start = 0;
+  bool should_be_valid = false;
 
  public:
   bool read_next_line(PTInst &inst) {
-    static uns64 num_nops_at_start = 0;
     if (num_nops_at_start <=
         NUM_NOPS) {  // = is because the last one will be overwritten as a JMP to the real instruction stream
       inst.pc = NOPS_BB_START + num_nops_at_start++;
@@ -270,7 +271,6 @@ class TraceReaderPT : public TraceReader {
     // todo: have process inst ret if I should use this info or not
     // want to be able to skip syscalls for now
     InstInfo &_prior = (use_info_a ? inst_info_b : inst_info_a);
-    static bool should_be_valid = false;
     if (should_be_valid)
       assert(_prior.valid);
     should_be_valid = true;
@@ -1,10 +1,14 @@
 #include "trace_fe.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <mutex>
+#include <thread>
 
 #include "bp/bp.param.h"
 
@@ -35,54 +39,118 @@
 
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_TRACE_READ, ##args)
 
+/* Pc_Inst_Map: open-addressing (linear probing) map from PC to the last decoded
+ * ctype_pin_inst seen at that PC. Keys live in their own array so a probe only
+ * touches 8-byte slots; updates overwrite the value in place. */
+class Pc_Inst_Map {
+ public:
+  Pc_Inst_Map() : mask(0), num_entries(0) {}
+
+  ctype_pin_inst *find(uint64_t pc) {
+    if (keys.empty())
+      return NULL;
+    uint64_t idx = slot(pc);
+    while (keys[idx] != EMPTY_KEY) {
+      if (keys[idx] == pc)
+        return &values[idx];
+      idx = (idx + 1) & mask;
+    }
+    return NULL;
+  }
+
+  void insert(uint64_t pc, const ctype_pin_inst &inst) {
+    ASSERT(0, pc != EMPTY_KEY);
+    if ((num_entries + 1) * 4 > keys.size() * 3)
+      resize(keys.empty() ? 1024 : keys.size() * 2);
+    uint64_t idx = slot(pc);
+    while (keys[idx] != EMPTY_KEY && keys[idx] != pc)
+      idx = (idx + 1) & mask;
+    if (keys[idx] == EMPTY_KEY) {
+      keys[idx] = pc;
+      num_entries++;
+    }
+    values[idx] = inst;
+  }
+
+ private:
+  static constexpr uint64_t EMPTY_KEY = ~0ULL;
+  std::vector<uint64_t> keys;
+  std::vector<ctype_pin_inst> values;
+  uint64_t mask;
+  uint64_t num_entries;
+
+  uint64_t slot(uint64_t pc) const { return (pc * 0x9E3779B97F4A7C15ULL >> 20) & mask; }
+
+  void resize(uint64_t size) {
+    std::vector<uint64_t> old_keys(size, EMPTY_KEY);
+    std::vector<ctype_pin_inst> old_values(size);
+    old_keys.swap(keys);
+    old_values.swap(values);
+    mask = size - 1;
+    for (uint64_t i = 0; i < old_keys.size(); i++) {
+      if (old_keys[i] == EMPTY_KEY)
+        continue;
+      uint64_t idx = slot(old_keys[i]);
+      while (keys[idx] != EMPTY_KEY)
+        idx = (idx + 1) & mask;
+      keys[idx] = old_keys[i];
+      values[idx] = old_values[i];
+    }
+  }
+};
+
+/* Per-core TRACE_BUF_SIZE lookahead buffer and the cache lines it covers
+ * (used by FDIP_PERFECT_PREFETCH through buf_map_find). */
+typedef struct Trace_Buf_struct {
+  uint64_t rdptr;
+  uint64_t wrptr;
+  std::vector<ctype_pin_inst> circ_buf;
+  std::unordered_map<Addr, Counter> buf_map;
+} Trace_Buf;
+
 /* Globals */
 static ctype_pin_inst next_onpath_pi[MAX_NUM_PROCS];
 static ctype_pin_inst next_offpath_pi[MAX_NUM_PROCS];
 static bool off_path_mode[MAX_NUM_PROCS] = {false};
 static uint64_t off_path_addr[MAX_NUM_PROCS] = {0};
-static std::unordered_map<uint64_t, ctype_pin_inst> pc_to_inst;
+static Pc_Inst_Map pc_to_inst[MAX_NUM_PROCS];
+static Trace_Buf trace_buf[MAX_NUM_PROCS];
 
-uint64_t rdptr = 0;
-uint64_t wrptr = 0;
-std::vector<ctype_pin_inst> circ_buf;
-std::unordered_map<Addr, Counter> buf_map;
 const int CLINE = ~0x3F;
 
-extern uint64_t ins_id;
-extern uint64_t ins_id_fetched;
+extern uint64_t ins_id[MAX_NUM_PROCS];
+extern uint64_t ins_id_fetched[MAX_NUM_PROCS];
 
-Flag buf_map_find(Addr line_addr) {
+Flag buf_map_find(uns proc_id, Addr line_addr) {
+  std::unordered_map<Addr, Counter> &buf_map = trace_buf[proc_id].buf_map;
   return buf_map.find(line_addr) != buf_map.end();
 }
 
 // inserts the inst written to write_ptr location
-void buf_map_insert() {
-  Addr line_addr = circ_buf[wrptr].instruction_addr & CLINE;
-  auto it = buf_map.find(line_addr);
-  if (it != buf_map.end()) {
-    it->second++;
-  } else {
-    buf_map.insert(std::pair<Addr, Counter>(line_addr, 1));
-  }
-  wrptr = (wrptr + 1) % TRACE_BUF_SIZE;
+static void buf_map_insert(uns proc_id) {
+  Trace_Buf *tb = &trace_buf[proc_id];
+  Addr line_addr = tb->circ_buf[tb->wrptr].instruction_addr & CLINE;
+  tb->buf_map[line_addr]++;
+  tb->wrptr = (tb->wrptr + 1) % TRACE_BUF_SIZE;
 }
 
-void buf_map_remove() {
-  Addr line_addr = circ_buf[rdptr].instruction_addr & CLINE;
-  auto it = buf_map.find(line_addr);
-  assert(it != buf_map.end());
+static void buf_map_remove(uns proc_id) {
+  Trace_Buf *tb = &trace_buf[proc_id];
+  Addr line_addr = tb->circ_buf[tb->rdptr].instruction_addr & CLINE;
+  auto it = tb->buf_map.find(line_addr);
+  assert(it != tb->buf_map.end());
   if (it->second > 1) {
     it->second--;
   } else {
-    buf_map.erase(it);
+    tb->buf_map.erase(it);
   }
-  rdptr = (rdptr + 1) % TRACE_BUF_SIZE;
+  tb->rdptr = (tb->rdptr + 1) % TRACE_BUF_SIZE;
 }
 
 void off_path_generate_inst(uns proc_id, uint64_t *off_path_addr, ctype_pin_inst *inst) {
-  auto op_iter = pc_to_inst.find(*off_path_addr);
-  if (op_iter != pc_to_inst.end()) {
-    *inst = op_iter->second;
+  ctype_pin_inst *cached = pc_to_inst[proc_id].find(*off_path_addr);
+  if (cached) {
+    *inst = *cached;
     *off_path_addr += inst->size;
     DEBUG(proc_id, "Generate off-path inst:%lx inst_size:%i ", inst->instruction_addr, inst->size);
   } else {
@@ -188,48 +256,224 @@ void assert_ctype_pin_inst_same(uns proc_id, ctype_pin_inst inst_a, ctype_pin_in
   }
 }
 
+/**************************************************************************************/
+/* Asynchronous trace read-ahead
+ *
+ * With TRACE_READ_AHEAD > 0 every core gets a producer thread that runs
+ * pt_trace_read()/memtrace_trace_read() (record iteration + XED decode) ahead of
+ * the simulator and hands the decoded ctype_pin_insts over through a single
+ * producer/single consumer ring. The simulator thread only copies out of the ring.
+ * Producers never touch simulator state: ROI markers are handled on the consumer
+ * side (memtrace_handle_roi_markers) when an instruction is actually handed out.
+ * The decoder state (trace readers, uids, pids) is per core, so the producers of
+ * different cores decode in parallel.
+ *
+ * A side that finds the ring empty/full sleeps on a condvar after setting its
+ * *_waiting flag; the other side only takes the lock to notify when the flag is
+ * set, so a ring that never runs dry costs no locking.
+ */
+
+struct Trace_Read_Ahead {
+  std::vector<ctype_pin_inst> slots;
+  std::vector<int> status;  // return value of the trace read that filled the slot
+  uint64_t mask;
+  alignas(64) std::atomic<uint64_t> head;  // next slot to consume (simulator)
+  alignas(64) std::atomic<uint64_t> tail;  // next slot to fill (producer)
+  std::atomic<bool> stop;
+  bool done;  // consumer has seen the end of the trace
+  std::thread producer;
+  std::mutex lock;
+  std::condition_variable not_full;
+  std::condition_variable not_empty;
+  std::atomic<bool> producer_waiting;
+  std::atomic<bool> consumer_waiting;
+};
+
+static Trace_Read_Ahead *read_ahead[MAX_NUM_PROCS];
+
+static int frontend_trace_read(int proc_id, ctype_pin_inst *pi) {
+  if (FRONTEND == FE_PT)
+    return pt_trace_read(proc_id, pi);
+  ASSERT(proc_id, FRONTEND == FE_MEMTRACE);
+  return memtrace_trace_read(proc_id, pi);
+}
+
+static void read_ahead_produce(int proc_id, Trace_Read_Ahead *ra) {
+  while (!ra->stop.load()) {
+    uint64_t tail = ra->tail.load(std::memory_order_relaxed);
+    if (tail - ra->head.load() > ra->mask) {  // ring full
+      std::unique_lock<std::mutex> lock(ra->lock);
+      ra->producer_waiting.store(true);
+      ra->not_full.wait(lock, [&] { return ra->stop.load() || tail - ra->head.load() <= ra->mask; });
+      ra->producer_waiting.store(false);
+      continue;
+    }
+    int ret = frontend_trace_read(proc_id, &ra->slots[tail & ra->mask]);
+    ra->status[tail & ra->mask] = ret;
+    ra->tail.store(tail + 1);
+    if (ra->consumer_waiting.load()) {
+      std::lock_guard<std::mutex> lock(ra->lock);
+      ra->not_empty.notify_one();
+    }
+    if (!ret)
+      break;  // end of trace or ROI, nothing more to read
+  }
+}
+
+static int read_ahead_consume(int proc_id, Trace_Read_Ahead *ra, ctype_pin_inst *pi) {
+  if (ra->done)
+    return 0;
+  uint64_t head = ra->head.load(std::memory_order_relaxed);
+  if (ra->tail.load() == head) {  // ring empty, the producer is decoding
+    std::unique_lock<std::mutex> lock(ra->lock);
+    ra->consumer_waiting.store(true);
+    ra->not_empty.wait(lock, [&] { return ra->tail.load() != head; });
+    ra->consumer_waiting.store(false);
+  }
+  int ret = ra->status[head & ra->mask];
+  if (ret)
+    *pi = ra->slots[head & ra->mask];
+  else
+    ra->done = true;
+  ra->head.store(head + 1);
+  if (ra->producer_waiting.load()) {
+    std::lock_guard<std::mutex> lock(ra->lock);
+    ra->not_full.notify_one();
+  }
+  return ret;
+}
+
+static void read_ahead_stop(void) {
+  for (uns proc_id = 0; proc_id < MAX_NUM_PROCS; proc_id++) {
+    Trace_Read_Ahead *ra = read_ahead[proc_id];
+    if (!ra)
+      continue;
+    {
+      std::lock_guard<std::mutex> lock(ra->lock);
+      ra->stop.store(true);
+      ra->not_full.notify_one();
+    }
+    if (ra->producer.joinable())
+      ra->producer.join();
+    delete ra;
+    read_ahead[proc_id] = NULL;
+  }
+}
+
+static void read_ahead_init(void) {
+  if (!TRACE_READ_AHEAD)
+    return;
+
+  uint64_t size = 1;
+  while (size < TRACE_READ_AHEAD)
+    size <<= 1;
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Trace_Read_Ahead *ra = new Trace_Read_Ahead();
+    ra->slots.resize(size);
+    ra->status.resize(size, 0);
+    ra->mask = size - 1;
+    ra->head.store(0);
+    ra->tail.store(0);
+    ra->stop.store(false);
+    ra->producer_waiting.store(false);
+    ra->consumer_waiting.store(false);
+    ra->done = false;
+    ra->producer = std::thread(read_ahead_produce, proc_id, ra);
+    read_ahead[proc_id] = ra;
+  }
+  // Producers may be blocked on a full ring when the simulation exits.
+  atexit(read_ahead_stop);
+}
+
+// Next instruction of the trace, from the read-ahead ring if enabled.
+static int trace_read_next(int proc_id, ctype_pin_inst *pi) {
+  int ret;
+  if (read_ahead[proc_id])
+    ret = read_ahead_consume(proc_id, read_ahead[proc_id], pi);
+  else
+    ret = frontend_trace_read(proc_id, pi);
+  if (ret && FRONTEND == FE_MEMTRACE)
+    memtrace_handle_roi_markers(proc_id, pi);
+  return ret;
+}
+
 void trace_buf_init() {
   if (!TRACE_BUF_SIZE)
     return;
 
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    circ_buf.resize(TRACE_BUF_SIZE);
-    rdptr = 0;
-    wrptr = 0;
-    if (FRONTEND == FE_PT) {
-      for (uint i = 0; i < TRACE_BUF_SIZE; i++) {
-        pt_trace_read(proc_id, &circ_buf[wrptr]);
-        buf_map_insert();
-      }
-    } else if (FRONTEND == FE_MEMTRACE) {
-      for (uint i = 0; i < TRACE_BUF_SIZE; i++) {
-        memtrace_trace_read(proc_id, &circ_buf[wrptr]);
-        buf_map_insert();
-      }
+    Trace_Buf *tb = &trace_buf[proc_id];
+    tb->circ_buf.resize(TRACE_BUF_SIZE);
+    tb->rdptr = 0;
+    tb->wrptr = 0;
+    for (uint i = 0; i < TRACE_BUF_SIZE; i++) {
+      trace_read_next(proc_id, &tb->circ_buf[tb->wrptr]);
+      buf_map_insert(proc_id);
     }
   }
 }
 
 int trace_read(int proc_id, ctype_pin_inst *next_onpath_pi) {
-  if (!TRACE_BUF_SIZE) {
-    if (FRONTEND == FE_PT)
-      return pt_trace_read(proc_id, next_onpath_pi);
-    else if (FRONTEND == FE_MEMTRACE)
-      return memtrace_trace_read(proc_id, next_onpath_pi);
-  }
+  if (!TRACE_BUF_SIZE)
+    return trace_read_next(proc_id, next_onpath_pi);
 
-  ASSERT(0, TRACE_BUF_SIZE);
-  *next_onpath_pi = circ_buf[rdptr];
-  buf_map_remove();
-  int ret = 0;
-  if (FRONTEND == FE_PT)
-    ret = pt_trace_read(proc_id, &circ_buf[wrptr]);
-  else if (FRONTEND == FE_MEMTRACE)
-    ret = memtrace_trace_read(proc_id, &circ_buf[wrptr]);
-  buf_map_insert();
+  Trace_Buf *tb = &trace_buf[proc_id];
+  *next_onpath_pi = tb->circ_buf[tb->rdptr];
+  buf_map_remove(proc_id);
+  int ret = trace_read_next(proc_id, &tb->circ_buf[tb->wrptr]);
+  buf_map_insert(proc_id);
   return ret;
 }
 
+/* ext_trace_next_inst: reads the next instruction once op, the eom of an
+   instruction, has been generated */
+static void ext_trace_next_inst(uns proc_id, Op *op) {
+  if (!off_path_mode[proc_id]) {
+    int success = false;
+    success = trace_read(proc_id, &next_onpath_pi[proc_id]);
+    if (!success) {
+      trace_read_done[proc_id] = TRUE;
+      reached_exit[proc_id] = TRUE;
+      op->exit = TRUE;
+    } else {
+      ctype_pin_inst *pi = &next_onpath_pi[proc_id];
+      uint64_t addr = pi->instruction_addr;
+      ctype_pin_inst *find = pc_to_inst[proc_id].find(addr);
+      if (find == NULL) {
+        pc_to_inst[proc_id].insert(addr, *pi);
+      } else if (pi->encoding_is_new) {
+        STAT_EVENT(proc_id, INST_MAP_UPDATE_ENCODING);
+        *find = *pi;
+      } else if (pi->inst_binary_lsb != find->inst_binary_lsb || pi->inst_binary_msb != find->inst_binary_msb) {
+        DEBUG(proc_id, "Previously seen PC references new instruction addr:%lx inst_size:%i lsb:%lx msb:%lx\n ", addr,
+              pi->size, pi->inst_binary_lsb, pi->inst_binary_msb);
+        // Handle jitted code
+        STAT_EVENT(proc_id, INST_MAP_UPDATE_JITTED);
+        *find = *pi;
+      } else if (pi->instruction_next_addr != find->instruction_next_addr) {
+        ASSERT(proc_id, pi->op_type == find->op_type);
+        if (pi->cf_type) {
+          ASSERT(proc_id, pi->cf_type == find->cf_type);
+          // This can fail for java pt traces
+          // ASSERT(proc_id, pi->cf_type == CF_CBR ||
+          //                 pi->cf_type >= CF_IBR ||
+          //                 pi->last_inst_from_trace);
+        }
+        STAT_EVENT(proc_id, INST_MAP_UPDATE_NPC_INV + pi->op_type);
+        *find = *pi;
+      } else if (!ctype_pin_inst_same_mem_vaddr(*pi, *find)) {
+        ASSERT(proc_id, pi->op_type == find->op_type);
+        STAT_EVENT(proc_id, INST_MAP_UPDATE_MEM_INV + pi->op_type);
+        *find = *pi;
+      } else if (ENABLE_DEBUG_ASSERTIONS) {
+        assert_ctype_pin_inst_same(proc_id, *pi, *find);
+      }
+    }
+  } else {
+    off_path_generate_inst(proc_id, &off_path_addr[proc_id], &next_offpath_pi[proc_id]);
+  }
+}
+
 void ext_trace_fetch_op(uns proc_id, Op *op) {
   if (uop_generator_get_bom(proc_id)) {
     if (!off_path_mode[proc_id]) {
@@ -241,61 +485,21 @@ void ext_trace_fetch_op(uns proc_id, Op *op) {
     uop_generator_get_uop(proc_id, op, NULL);
   }
 
-  if (uop_generator_get_eom(proc_id)) {
-    if (!off_path_mode[proc_id]) {
-      int success = false;
-      success = trace_read(proc_id, &next_onpath_pi[proc_id]);
-      if (!success) {
-        trace_read_done[proc_id] = TRUE;
-        reached_exit[proc_id] = TRUE;
-        op->exit = TRUE;
-      } else {
-        uint64_t addr = next_onpath_pi[proc_id].instruction_addr;
-        auto find = pc_to_inst.find(addr);
-        if (find == pc_to_inst.end()) {
-          pc_to_inst.insert(std::pair<uint64_t, ctype_pin_inst>(addr, next_onpath_pi[proc_id]));
-        } else if (next_onpath_pi[proc_id].encoding_is_new) {
-          STAT_EVENT(proc_id, INST_MAP_UPDATE_ENCODING);
-          pc_to_inst.erase(addr);
-          pc_to_inst.insert(std::pair<uint64_t, ctype_pin_inst>(addr, next_onpath_pi[proc_id]));
-        } else if (next_onpath_pi[proc_id].inst_binary_lsb != find->second.inst_binary_lsb ||
-                   next_onpath_pi[proc_id].inst_binary_msb != find->second.inst_binary_msb) {
-          DEBUG(proc_id, "Previously seen PC references new instruction addr:%lx inst_size:%i lsb:%lx msb:%lx\n ", addr,
-                next_onpath_pi[proc_id].size, next_onpath_pi[proc_id].inst_binary_lsb,
-                next_onpath_pi[proc_id].inst_binary_msb);
-          // Handle jitted code
-          STAT_EVENT(proc_id, INST_MAP_UPDATE_JITTED);
-          pc_to_inst.erase(addr);
-          pc_to_inst.insert(std::pair<uint64_t, ctype_pin_inst>(addr, next_onpath_pi[proc_id]));
-        } else if (next_onpath_pi[proc_id].instruction_next_addr != find->second.instruction_next_addr) {
-          ASSERT(proc_id, next_onpath_pi[proc_id].op_type == find->second.op_type);
-          if (next_onpath_pi[proc_id].cf_type) {
-            ASSERT(proc_id, next_onpath_pi[proc_id].cf_type == find->second.cf_type);
-            // This can fail for java pt traces
-            // ASSERT(proc_id, next_onpath_pi[proc_id].cf_type == CF_CBR ||
-            //                 next_onpath_pi[proc_id].cf_type >= CF_IBR ||
-            //                 next_onpath_pi[proc_id].last_inst_from_trace);
-          }
-          STAT_EVENT(proc_id, INST_MAP_UPDATE_NPC_INV + next_onpath_pi[proc_id].op_type);
-          pc_to_inst.erase(addr);
-          pc_to_inst.insert(std::pair<uint64_t, ctype_pin_inst>(addr, next_onpath_pi[proc_id]));
-        } else if (!ctype_pin_inst_same_mem_vaddr(next_onpath_pi[proc_id], find->second)) {
-          ASSERT(proc_id, next_onpath_pi[proc_id].op_type == find->second.op_type);
-          STAT_EVENT(proc_id, INST_MAP_UPDATE_MEM_INV + next_onpath_pi[proc_id].op_type);
-          pc_to_inst.erase(addr);
-          pc_to_inst.insert(std::pair<uint64_t, ctype_pin_inst>(addr, next_onpath_pi[proc_id]));
-        } else {
-          assert_ctype_pin_inst_same(proc_id, next_onpath_pi[proc_id], find->second);
-        }
-      }
-    } else {
-      off_path_generate_inst(proc_id, &off_path_addr[proc_id], &next_offpath_pi[proc_id]);
-    }
-  }
+  if (uop_generator_get_eom(proc_id))
+    ext_trace_next_inst(proc_id, op);
+
   DEBUG(proc_id, "Fetch op is_on_path:%i on_path:%lx off_path:%lx\n", off_path_mode[proc_id],
         next_onpath_pi[proc_id].instruction_addr, next_offpath_pi[proc_id].instruction_addr);
 }
 
+uns ext_trace_fetch_ops(uns proc_id, Op **ops, uns max) {
+  uns num = uop_generator_get_uops(proc_id, ops, max,
+                                   off_path_mode[proc_id] ? &next_offpath_pi[proc_id] : &next_onpath_pi[proc_id]);
+  if (uop_generator_get_eom(proc_id))
+    ext_trace_next_inst(proc_id, ops[num - 1]);
+  return num;
+}
+
 Flag ext_trace_can_fetch_op(uns proc_id) {
   return !(uop_generator_get_eom(proc_id) && trace_read_done[proc_id]);
 }
@@ -336,12 +540,14 @@ void ext_trace_init() {
   else if (FRONTEND == FE_MEMTRACE)
     memtrace_init();
 
+  read_ahead_init();
   trace_buf_init();
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
     trace_read(proc_id, &next_onpath_pi[proc_id]);
 }
 
 void ext_trace_done() {
+  read_ahead_stop();
 }
 
 // is also used to print footprint
@@ -798,8 +1004,8 @@ void ext_trace_extract_basic_block_vectors() {
         output_counts(num_of_segments, counts_dynamic, counts_as_built, op_taken_count, bb_identity_map);
 
         // caution that ins_id and ins_id_fetched is only for memtrace
-        ASSERT(proc_id, counts_dynamic.total_size == ins_id);
-        ASSERT(proc_id, counts_dynamic.fetched_size == ins_id_fetched);
+        ASSERT(proc_id, counts_dynamic.total_size == ins_id[proc_id]);
+        ASSERT(proc_id, counts_dynamic.fetched_size == ins_id_fetched[proc_id]);
 
         std::string bbv_output(TRACE_BBV_OUTPUT);
         std::string footprint_output(TRACE_FOOTPRINT_OUTPUT);
@@ -50,12 +50,13 @@ extern "C" {
 #endif
 
 void off_path_generate_inst(uns proc_id, uint64_t *off_path_addr, ctype_pin_inst *inst);
-Flag buf_map_find(uns64 line_addr);
+Flag buf_map_find(uns proc_id, uns64 line_addr);
 
 /* Implementing the frontend interface */
 Addr ext_trace_next_fetch_addr(uns proc_id);
 Flag ext_trace_can_fetch_op(uns proc_id);
 void ext_trace_fetch_op(uns proc_id, Op *op);
+uns ext_trace_fetch_ops(uns proc_id, Op **ops, uns max);
 void ext_trace_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr);
 void ext_trace_recover(uns proc_id, uns64 inst_uid);
 void ext_trace_retire(uns proc_id, uns64 inst_uid);
@@ -0,0 +1,539 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/synth_fe.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Synthetic instruction stream frontend, see frontend/synth_fe.h.
+ ***************************************************************************************/
+
+#include "frontend/synth_fe.h"
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "debug/debug.param.h"
+#include "debug/debug_macros.h"
+
+#include "frontend/synth.param.h"
+#include "general.param.h"
+
+#include "./pin/pin_lib/uop_generator.h"
+#include "isa/isa.h"
+
+#include "checkpoint.h"
+#include "ctype_pin_inst.h"
+#include "op.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_FRONTEND, ##args)
+
+#define SYNTH_CODE_BASE 0x400000
+#define SYNTH_DATA_BASE 0x10000000
+#define SYNTH_INST_SIZE 4
+#define SYNTH_MEM_SIZE 8
+#define SYNTH_LINE_SIZE 64
+#define SYNTH_JUMP_REACH 8  /* forward jumps skip at most this many blocks */
+#define SYNTH_CHASE_MULT 0x9E3779B97F4A7C15ULL /* odd, scatters the chain over the lines */
+
+#define SYNTH_PC(idx) (SYNTH_CODE_BASE + (Addr)(idx)*SYNTH_INST_SIZE)
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Synth_Kind_enum {
+  SYNTH_ALU,
+  SYNTH_MUL,
+  SYNTH_FP,
+  SYNTH_LOAD,
+  SYNTH_STORE,
+  SYNTH_JUMP,
+  SYNTH_CBR_RANDOM, /* random direction and target */
+  SYNTH_CBR_LOOP,   /* jumps back to its block start, falls through after trip iterations */
+  SYNTH_CBR_FALL,   /* never taken */
+} Synth_Kind;
+
+typedef enum Synth_Pattern_enum {
+  SYNTH_STRIDED,
+  SYNTH_CHASE,
+  SYNTH_RANDOM,
+} Synth_Pattern;
+
+/* One instruction of the static program. pi holds its static fields; the
+   dynamic ones (direction, next address, memory address) are filled in on
+   every fetch. */
+typedef struct Synth_Inst_struct {
+  ctype_pin_inst pi;
+  Synth_Kind kind;
+  Synth_Pattern pattern;
+  uns target; /* index of the taken target */
+  uns trip;   /* iterations of a loop branch */
+  uns64 base; /* start offset of a strided walk */
+  uns64 init; /* initial dynamic state */
+} Synth_Inst;
+
+/* Per-core walk of the program. state[] is the dynamic state of every static
+   instruction: the iteration of a loop branch, the step of a strided walk or
+   the current node of a pointer chase. */
+typedef struct Synth_Core_struct {
+  uns64 rng;
+  uns64 count; /* on-path instructions generated */
+  uns next_idx;
+  uns64* state;
+  ctype_pin_inst next_onpath_pi;
+  ctype_pin_inst next_offpath_pi;
+  Flag off_path;
+  Addr off_path_addr;
+} Synth_Core;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Synth_Inst* program;
+static uns num_insts;
+static uns* block_start;
+static uns64 chase_lines; /* lines of the working set the chases go through, a power of 2 */
+
+static Synth_Core* synth_cores;
+
+static const Reg_Id gpr_pool[] = {REG_RAX, REG_RBX, REG_RCX, REG_RDX, REG_RBP, REG_RSI, REG_RDI, REG_R8,
+                                  REG_R9,  REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15};
+
+/**************************************************************************************/
+/* Static Prototypes */
+
+static uns64 synth_hash(uns64 x);
+static uns64 synth_rand(uns64* rng);
+static Reg_Id rand_gpr(uns64* rng);
+static Reg_Id rand_fpr(uns64* rng);
+static uns forward_block(uns64* rng, uns block);
+static void build_inst(uns64* rng, uns idx, uns block, Flag last_in_block);
+static void build_program(void);
+static Addr mem_addr(Synth_Core* core, uns idx, Flag on_path);
+static void fill_inst(Synth_Core* core, uns idx, ctype_pin_inst* pi);
+static void fill_off_path_inst(Synth_Core* core, ctype_pin_inst* pi);
+static void make_nop(Addr addr, ctype_pin_inst* pi);
+static void synth_ckpt(Ckpt_Stream* stream, void* arg);
+static void synth_next_inst(uns proc_id, Op* op);
+
+/**************************************************************************************/
+/* Random numbers: splitmix64, so every seed gives a well mixed stream */
+
+static uns64 synth_hash(uns64 x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static uns64 synth_rand(uns64* rng) {
+  *rng += 0x9E3779B97F4A7C15ULL;
+  return synth_hash(*rng);
+}
+
+static Reg_Id rand_gpr(uns64* rng) {
+  return gpr_pool[synth_rand(rng) % (sizeof(gpr_pool) / sizeof(gpr_pool[0]))];
+}
+
+static Reg_Id rand_fpr(uns64* rng) {
+  return REG_ZMM0 + synth_rand(rng) % 16;
+}
+
+static uns forward_block(uns64* rng, uns block) {
+  return block + 1 + synth_rand(rng) % MIN2(SYNTH_JUMP_REACH, SYNTH_CODE_BLOCKS - 1 - block);
+}
+
+/**************************************************************************************/
+/* build_program: lays out SYNTH_CODE_BLOCKS blocks back to back from
+   SYNTH_CODE_BASE. The last block jumps back to the first, so the on-path
+   walk never leaves the program. */
+
+static void build_inst(uns64* rng, uns idx, uns block, Flag last_in_block) {
+  Synth_Inst* inst = &program[idx];
+  ctype_pin_inst* pi = &inst->pi;
+
+  memset(inst, 0, sizeof(Synth_Inst));
+  pi->instruction_addr = SYNTH_PC(idx);
+  pi->instruction_next_addr = SYNTH_PC(idx + 1);
+  pi->size = SYNTH_INST_SIZE;
+  pi->inst_binary_lsb = idx;
+  pi->num_simd_lanes = 1;
+  pi->lane_width_bytes = SYNTH_MEM_SIZE;
+
+  if (last_in_block) {
+    if (block == SYNTH_CODE_BLOCKS - 1) {
+      inst->kind = SYNTH_JUMP;
+      inst->target = 0;
+    } else if (synth_rand(rng) % 100 < SYNTH_JUMP_PCT) {
+      inst->kind = SYNTH_JUMP;
+      inst->target = forward_block(rng, block);
+    } else if ((synth_rand(rng) >> 11) * (1.0 / (1ULL << 53)) < SYNTH_BRANCH_ENTROPY) {
+      inst->kind = SYNTH_CBR_RANDOM;
+      inst->target = synth_rand(rng) % SYNTH_CODE_BLOCKS;
+    } else if (synth_rand(rng) % 100 < SYNTH_LOOP_PCT) {
+      inst->kind = SYNTH_CBR_LOOP;
+      inst->target = block;
+      inst->trip = 1 + synth_rand(rng) % (2 * SYNTH_LOOP_TRIP - 1);
+    } else {
+      inst->kind = SYNTH_CBR_FALL;
+      inst->target = forward_block(rng, block);
+    }
+    inst->target = block_start[inst->target];
+    pi->op_type = OP_CF;
+    pi->branch_target = SYNTH_PC(inst->target);
+    if (inst->kind == SYNTH_JUMP) {
+      pi->cf_type = CF_BR;
+      strcpy(pi->pin_iclass, "SYNTH_JMP");
+    } else {
+      pi->cf_type = CF_CBR;
+      pi->num_src_regs = 1;
+      pi->src_regs[0] = REG_ZPS;
+      strcpy(pi->pin_iclass, "SYNTH_JCC");
+    }
+    return;
+  }
+
+  uns roll = synth_rand(rng) % 100;
+  if (roll < SYNTH_LOAD_PCT + SYNTH_STORE_PCT) {
+    Flag is_load = roll < SYNTH_LOAD_PCT;
+    uns pattern_roll = synth_rand(rng) % 100;
+    inst->kind = is_load ? SYNTH_LOAD : SYNTH_STORE;
+    if (pattern_roll < SYNTH_STRIDE_PCT) {
+      inst->pattern = SYNTH_STRIDED;
+      inst->base = synth_rand(rng) % SYNTH_WORKING_SET & ~(uns64)(SYNTH_LINE_SIZE - 1);
+    } else if (is_load && pattern_roll < SYNTH_STRIDE_PCT + SYNTH_CHASE_PCT) {
+      inst->pattern = SYNTH_CHASE;
+      inst->init = synth_rand(rng) & (chase_lines - 1);
+    } else {
+      inst->pattern = SYNTH_RANDOM;
+    }
+
+    Reg_Id base = rand_gpr(rng);
+    pi->op_type = OP_MOV;
+    pi->is_move = 1;
+    if (is_load) {
+      /* the pointer a chase loads is its next base */
+      pi->num_ld = 1;
+      pi->ld_size = SYNTH_MEM_SIZE;
+      pi->num_ld1_addr_regs = 1;
+      pi->ld1_addr_regs[0] = base;
+      pi->num_dst_regs = 1;
+      pi->dst_regs[0] = inst->pattern == SYNTH_CHASE ? base : rand_gpr(rng);
+      strcpy(pi->pin_iclass, "SYNTH_LOAD");
+    } else {
+      pi->num_st = 1;
+      pi->st_size = SYNTH_MEM_SIZE;
+      pi->num_st_addr_regs = 1;
+      pi->st_addr_regs[0] = base;
+      pi->num_src_regs = 1;
+      pi->src_regs[0] = rand_gpr(rng);
+      strcpy(pi->pin_iclass, "SYNTH_STORE");
+    }
+  } else if (roll < SYNTH_LOAD_PCT + SYNTH_STORE_PCT + SYNTH_FP_PCT) {
+    inst->kind = SYNTH_FP;
+    pi->op_type = synth_rand(rng) % 2 ? OP_FMUL : OP_FADD;
+    pi->is_fp = 1;
+    pi->num_src_regs = 2;
+    pi->src_regs[0] = rand_fpr(rng);
+    pi->src_regs[1] = rand_fpr(rng);
+    pi->num_dst_regs = 1;
+    pi->dst_regs[0] = rand_fpr(rng);
+    strcpy(pi->pin_iclass, pi->op_type == OP_FMUL ? "SYNTH_FMUL" : "SYNTH_FADD");
+  } else {
+    /* integer ops set the flags the conditional branches read */
+    Flag is_mul = roll < SYNTH_LOAD_PCT + SYNTH_STORE_PCT + SYNTH_FP_PCT + SYNTH_MUL_PCT;
+    inst->kind = is_mul ? SYNTH_MUL : SYNTH_ALU;
+    pi->op_type = is_mul ? OP_IMUL : OP_IADD;
+    pi->num_src_regs = 2;
+    pi->src_regs[0] = rand_gpr(rng);
+    pi->src_regs[1] = rand_gpr(rng);
+    pi->num_dst_regs = 2;
+    pi->dst_regs[0] = rand_gpr(rng);
+    pi->dst_regs[1] = REG_ZPS;
+    strcpy(pi->pin_iclass, is_mul ? "SYNTH_IMUL" : "SYNTH_IADD");
+  }
+}
+
+static void build_program(void) {
+  uns64 rng = SYNTH_SEED;
+  uns* block_size = (uns*)malloc(SYNTH_CODE_BLOCKS * sizeof(uns));
+
+  block_start = (uns*)malloc((SYNTH_CODE_BLOCKS + 1) * sizeof(uns));
+  num_insts = 0;
+  for (uns block = 0; block < SYNTH_CODE_BLOCKS; block++) {
+    block_size[block] = 1 + synth_rand(&rng) % (2 * SYNTH_BB_SIZE - 1);
+    block_start[block] = num_insts;
+    num_insts += block_size[block];
+  }
+  block_start[SYNTH_CODE_BLOCKS] = num_insts;
+
+  chase_lines = 1;
+  while (chase_lines * 2 * SYNTH_LINE_SIZE <= SYNTH_WORKING_SET)
+    chase_lines *= 2;
+
+  program = (Synth_Inst*)malloc(num_insts * sizeof(Synth_Inst));
+  for (uns block = 0; block < SYNTH_CODE_BLOCKS; block++) {
+    for (uns ii = 0; ii < block_size[block]; ii++)
+      build_inst(&rng, block_start[block] + ii, block, ii == block_size[block] - 1);
+  }
+  free(block_size);
+}
+
+/**************************************************************************************/
+/* mem_addr: the address the load or store at idx accesses next. Only the
+   on-path walk advances the pattern. */
+
+static Addr mem_addr(Synth_Core* core, uns idx, Flag on_path) {
+  Synth_Inst* inst = &program[idx];
+  uns64* state = &core->state[idx];
+  uns64 offset;
+
+  switch (inst->pattern) {
+    case SYNTH_STRIDED:
+      offset = (inst->base + *state * SYNTH_STRIDE) % SYNTH_WORKING_SET;
+      if (on_path)
+        (*state)++;
+      break;
+    case SYNTH_CHASE:
+      /* a full-period LCG over the lines, scattered so the chain is not sequential */
+      offset = (*state * SYNTH_CHASE_MULT & (chase_lines - 1)) * SYNTH_LINE_SIZE;
+      if (on_path)
+        *state = (*state * 5 + 1) & (chase_lines - 1);
+      break;
+    default:
+      offset = (on_path ? synth_rand(&core->rng) : synth_hash(core->count ^ idx)) % SYNTH_WORKING_SET;
+      break;
+  }
+  return SYNTH_DATA_BASE + (offset & ~(uns64)(SYNTH_MEM_SIZE - 1));
+}
+
+/**************************************************************************************/
+/* fill_inst: the next on-path instruction, the one at idx. Sets next_idx to
+   its successor. */
+
+static void fill_inst(Synth_Core* core, uns idx, ctype_pin_inst* pi) {
+  Synth_Inst* inst = &program[idx];
+  uns64* state = &core->state[idx];
+  Flag taken = FALSE;
+
+  *pi = inst->pi;
+  pi->inst_uid = core->count;
+  switch (inst->kind) {
+    case SYNTH_LOAD:
+      pi->ld_vaddr[0] = mem_addr(core, idx, TRUE);
+      break;
+    case SYNTH_STORE:
+      pi->st_vaddr[0] = mem_addr(core, idx, TRUE);
+      break;
+    case SYNTH_JUMP:
+      taken = TRUE;
+      break;
+    case SYNTH_CBR_RANDOM:
+      taken = synth_rand(&core->rng) & 1;
+      break;
+    case SYNTH_CBR_LOOP:
+      taken = ++(*state) < inst->trip;
+      if (!taken)
+        *state = 0;
+      break;
+    default:
+      break;
+  }
+
+  pi->actually_taken = taken;
+  if (taken)
+    pi->instruction_next_addr = pi->branch_target;
+  core->next_idx = taken ? inst->target : idx + 1;
+  core->count++;
+}
+
+/**************************************************************************************/
+/* fill_off_path_inst: like off_path_generate_inst() of the memtrace
+   frontend, walks sequentially from the redirect address. Addresses outside
+   the program become nops. */
+
+static void fill_off_path_inst(Synth_Core* core, ctype_pin_inst* pi) {
+  Addr addr = core->off_path_addr;
+  uns idx = (addr - SYNTH_CODE_BASE) / SYNTH_INST_SIZE;
+
+  if (addr < SYNTH_CODE_BASE || idx >= num_insts || (addr - SYNTH_CODE_BASE) % SYNTH_INST_SIZE) {
+    make_nop(addr, pi);
+    core->off_path_addr += DUMMY_NOP_SIZE;
+    return;
+  }
+
+  *pi = program[idx].pi;
+  if (pi->num_ld)
+    pi->ld_vaddr[0] = mem_addr(core, idx, FALSE);
+  if (pi->num_st)
+    pi->st_vaddr[0] = mem_addr(core, idx, FALSE);
+  if (program[idx].kind == SYNTH_JUMP) {
+    pi->actually_taken = TRUE;
+    pi->instruction_next_addr = pi->branch_target;
+  }
+  core->off_path_addr += SYNTH_INST_SIZE;
+}
+
+/* same record as create_dummy_nop(), which is C++ only */
+static void make_nop(Addr addr, ctype_pin_inst* pi) {
+  memset(pi, 0, sizeof(ctype_pin_inst));
+  pi->instruction_addr = addr;
+  pi->instruction_next_addr = addr + DUMMY_NOP_SIZE;
+  pi->size = DUMMY_NOP_SIZE;
+  pi->op_type = OP_NOP;
+  strcpy(pi->pin_iclass, "DUMMY_NOP");
+  pi->fake_inst = 1;
+  pi->fake_inst_reason = WPNM_REASON_REDIRECT_TO_NOT_INSTRUMENTED;
+}
+
+/**************************************************************************************/
+/* synth_init */
+
+void synth_init(void) {
+  ASSERTM(0, SYNTH_CODE_BLOCKS > 0 && SYNTH_BB_SIZE > 0, "SYNTH_CODE_BLOCKS and SYNTH_BB_SIZE must be positive\n");
+  ASSERTM(0, SYNTH_LOAD_PCT + SYNTH_STORE_PCT + SYNTH_MUL_PCT + SYNTH_FP_PCT <= 100,
+          "SYNTH_LOAD_PCT, SYNTH_STORE_PCT, SYNTH_MUL_PCT and SYNTH_FP_PCT add up to more than 100\n");
+  ASSERTM(0, SYNTH_STRIDE_PCT + SYNTH_CHASE_PCT <= 100, "SYNTH_STRIDE_PCT and SYNTH_CHASE_PCT add up to more than 100\n");
+  ASSERTM(0, SYNTH_WORKING_SET >= SYNTH_LINE_SIZE, "SYNTH_WORKING_SET must hold at least one cache line\n");
+  /* a finished core would be restarted in bogus mode, which only the trace frontend supports */
+  ASSERTM(0, NUM_CORES == 1 || !SYNTH_LENGTH, "SYNTH_LENGTH needs a single core, end multicore runs with INST_LIMIT\n");
+
+  build_program();
+  uop_generator_init(NUM_CORES);
+
+  synth_cores = (Synth_Core*)calloc(NUM_CORES, sizeof(Synth_Core));
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Synth_Core* core = &synth_cores[proc_id];
+    core->rng = synth_hash(SYNTH_SEED + proc_id);
+    core->state = (uns64*)malloc(num_insts * sizeof(uns64));
+    for (uns idx = 0; idx < num_insts; idx++)
+      core->state[idx] = program[idx].init;
+    fill_inst(core, 0, &core->next_onpath_pi);
+    ckpt_register("synth_state", proc_id, synth_ckpt, core);
+  }
+}
+
+/**************************************************************************************/
+/* synth_ckpt: the walk, its read-ahead record and the access patterns. Warmup
+   stops on an on-path instruction boundary. */
+
+static void synth_ckpt(Ckpt_Stream* stream, void* arg) {
+  Synth_Core* core = (Synth_Core*)arg;
+
+  ckpt_io(stream, &core->rng, sizeof(core->rng));
+  ckpt_io(stream, &core->count, sizeof(core->count));
+  ckpt_io(stream, &core->next_idx, sizeof(core->next_idx));
+  ckpt_io(stream, &core->next_onpath_pi, sizeof(ctype_pin_inst));
+  ckpt_io(stream, core->state, num_insts * sizeof(uns64));
+}
+
+void synth_done(void) {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    free(synth_cores[proc_id].state);
+  free(synth_cores);
+  free(program);
+  free(block_start);
+}
+
+/**************************************************************************************/
+/* Frontend interface, mirrors the memtrace frontend (ext_trace_*) */
+
+Addr synth_next_fetch_addr(uns proc_id) {
+  return synth_cores[proc_id].next_onpath_pi.instruction_addr;
+}
+
+Flag synth_can_fetch_op(uns proc_id) {
+  return !(uop_generator_get_eom(proc_id) && trace_read_done[proc_id]);
+}
+
+void synth_fetch_op(uns proc_id, Op* op) {
+  Synth_Core* core = &synth_cores[proc_id];
+
+  if (uop_generator_get_bom(proc_id)) {
+    ASSERT(proc_id, core->off_path || !trace_read_done[proc_id]);
+    uop_generator_get_uop(proc_id, op, core->off_path ? &core->next_offpath_pi : &core->next_onpath_pi);
+  } else {
+    uop_generator_get_uop(proc_id, op, NULL);
+  }
+
+  if (uop_generator_get_eom(proc_id))
+    synth_next_inst(proc_id, op);
+}
+
+uns synth_fetch_ops(uns proc_id, Op** ops, uns max) {
+  Synth_Core* core = &synth_cores[proc_id];
+
+  ASSERT(proc_id, !uop_generator_get_bom(proc_id) || core->off_path || !trace_read_done[proc_id]);
+  uns num = uop_generator_get_uops(proc_id, ops, max,
+                                   core->off_path ? &core->next_offpath_pi : &core->next_onpath_pi);
+
+  if (uop_generator_get_eom(proc_id))
+    synth_next_inst(proc_id, ops[num - 1]);
+  return num;
+}
+
+/* synth_next_inst: called once op, the eom of an instruction, has been
+   generated */
+static void synth_next_inst(uns proc_id, Op* op) {
+  Synth_Core* core = &synth_cores[proc_id];
+
+  if (core->off_path) {
+    fill_off_path_inst(core, &core->next_offpath_pi);
+  } else if (SYNTH_LENGTH && core->count >= SYNTH_LENGTH) {
+    trace_read_done[proc_id] = TRUE;
+    reached_exit[proc_id] = TRUE;
+    op->exit = TRUE;
+  } else {
+    fill_inst(core, core->next_idx, &core->next_onpath_pi);
+  }
+}
+
+void synth_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
+  Synth_Core* core = &synth_cores[proc_id];
+
+  core->off_path = TRUE;
+  core->off_path_addr = convert_to_cmp_addr(0, fetch_addr); /* the program is laid out without proc bits */
+  fill_off_path_inst(core, &core->next_offpath_pi);
+  DEBUG(proc_id, "Redirect on-path:%lx off-path:%lx\n", core->next_onpath_pi.instruction_addr,
+        core->next_offpath_pi.instruction_addr);
+}
+
+void synth_recover(uns proc_id, uns64 inst_uid) {
+  Synth_Core* core = &synth_cores[proc_id];
+  Op dummy_op;
+
+  core->off_path = FALSE;
+  // Finish decoding of the current off-path inst before switching to on-path
+  while (!uop_generator_get_eom(proc_id)) {
+    uop_generator_get_uop(proc_id, &dummy_op, &core->next_offpath_pi);
+  }
+  DEBUG(proc_id, "Recover on-path:%lx\n", core->next_onpath_pi.instruction_addr);
+}
+
+void synth_retire(uns proc_id, uns64 inst_uid) {
+  // Nothing outside the simulator needs to know which instructions retired.
+}
@@ -0,0 +1,67 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/synth_fe.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Synthetic instruction stream frontend (--frontend synth).
+ *
+ * Generates ctype_pin_inst records and feeds them through the same uop
+ * generator as the trace frontends, without any trace file. At init a static
+ * program is built from SYNTH_SEED: SYNTH_CODE_BLOCKS basic blocks of about
+ * SYNTH_BB_SIZE instructions, each ending in a conditional branch (random,
+ * loop or fall-through, see SYNTH_BRANCH_ENTROPY) or a forward jump, with
+ * the SYNTH_*_PCT instruction mix. Every load and store gets a fixed access
+ * pattern over SYNTH_WORKING_SET: a strided walk of its own region, a
+ * pointer chase (loads only) or uniformly random addresses. The dynamic
+ * stream is a walk of that program, so the same PCs always decode to the same
+ * instructions and the stream is deterministic for a given seed, however long
+ * it runs. Wrong-path fetch is supported: off-path instructions come from the
+ * static program without advancing any access pattern.
+ ***************************************************************************************/
+
+#ifndef __SYNTH_FE_H__
+#define __SYNTH_FE_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Forward Declarations */
+
+struct Op_struct;
+
+/**************************************************************************************/
+/* Prototypes */
+
+void synth_init(void);
+void synth_done(void);
+
+/* Implementing the frontend interface */
+Addr synth_next_fetch_addr(uns proc_id);
+Flag synth_can_fetch_op(uns proc_id);
+void synth_fetch_op(uns proc_id, struct Op_struct* op);
+uns synth_fetch_ops(uns proc_id, struct Op_struct** ops, uns max);
+void synth_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr);
+void synth_recover(uns proc_id, uns64 inst_uid);
+void synth_retire(uns proc_id, uns64 inst_uid);
+
+#endif /* #ifndef __SYNTH_FE_H__ */
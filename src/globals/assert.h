@@ -53,6 +53,14 @@ whenever any assert fails.
 #define ENABLE_ASSERTIONS TRUE /* default TRUE */
 #endif
 
+/* Consistency checks of hot paths that are too costly for optimized builds
+ * (NO_DEBUG) */
+#if defined(NO_DEBUG) || defined(NO_ASSERT)
+#define ENABLE_DEBUG_ASSERTIONS FALSE
+#else
+#define ENABLE_DEBUG_ASSERTIONS TRUE
+#endif
+
 /**************************************************************************************/
 /* Prints the current call stack of Scarab. For the function names to be
  * printed, Scarab should be linked with -rdynamic flag. */
@@ -111,6 +119,15 @@ inline void print_backtrace(void) {
     }                                                                                                          \
   } while (0)
 
+/**************************************************************************************/
+/* Asserts that cond is true, like ASSERT, but only in builds with
+ * ENABLE_DEBUG_ASSERTIONS. Meant for checks on hot paths. */
+#define ASSERTD(proc_id, cond)   \
+  do {                           \
+    if (ENABLE_DEBUG_ASSERTIONS) \
+      ASSERT(proc_id, cond);     \
+  } while (0)
+
 /**************************************************************************************/
 /* Asserts that cond is true. If cond is false, prints simulation
  * information and stops the simulation. Always enabled (NO_ASSERT has
@@ -36,6 +36,7 @@
 #include "dvfs/perf_pred.h"
 #include "frontend/frontend_intf.h"
 #include "memory/cache_part.h"
+#include "memory/cache_sweep.h"
 
 #include "addr_trans.h"
 
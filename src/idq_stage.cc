@@ -54,6 +54,7 @@ class IDQ_Stage {
   void debug();
   void update(Stage_Data* dec_src_sd, Stage_Data* ic_uopc_sd, Stage_Data* uop_queue_sd);
   Stage_Data* get_output_stage_data();
+  int get_occupancy() { return occupied_count; }
 
  private:
   uns8 proc_id;
@@ -299,4 +300,8 @@ void update_idq_stage(Stage_Data* dec_src_sd, Stage_Data* ic_uopc_sd, Stage_Data
 
 Stage_Data* idq_stage_get_stage_data() {
   return idq_stage->get_output_stage_data();
+}
+
+int idq_stage_get_occupancy() {
+  return idq_stage->get_occupancy();
 }
\ No newline at end of file
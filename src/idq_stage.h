@@ -56,6 +56,7 @@ void recover_idq_stage(void);
 void debug_idq_stage(void);
 void update_idq_stage(Stage_Data*, Stage_Data*, Stage_Data*);
 Stage_Data* idq_stage_get_stage_data(void);
+int idq_stage_get_occupancy(void);
 
 #ifdef __cplusplus
 }
@@ -29,6 +29,9 @@
 #include "libs/cache_lib.h"
 
 #include <stdlib.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 #include "globals/assert.h"
 #include "globals/global_defs.h"
@@ -45,6 +48,8 @@
 
 #include "frontend/frontend_intf.h"
 
+#include "checkpoint.h"
+
 // DeleteMe
 #define ideal_num_entries 256
 
@@ -57,6 +62,11 @@
 /* Static Prototypes */
 
 static inline uns cache_index(Cache* cache, Addr addr, Addr* tag, Addr* line_addr);
+static void init_cache_tags(Cache* cache);
+static void init_cache_ckpt(Cache* cache);
+static inline void cache_sync_tag(Cache* cache, uns set, uns way);
+static inline void cache_sync_line(Cache* cache, uns set, Cache_Entry* line);
+static inline int cache_find_way(Cache* cache, uns set, Addr tag);
 static inline void update_repl_policy(Cache*, Cache_Entry*, uns, uns, Flag);
 static inline Cache_Entry* find_repl_entry(Cache*, uns8, uns, uns*);
 
@@ -65,6 +75,15 @@ static inline void* access_unsure_lines(Cache*, uns, Addr, Flag);
 static inline Cache_Entry* insert_sure_line(Cache*, uns, Addr);
 static inline void invalidate_unsure_line(Cache*, uns, Addr);
 
+/**************************************************************************************/
+/* Types */
+
+/* Signiture History Counter Table */
+struct ship_shct {
+  Hash_Table shct_hash;
+  Cache_Repl_Signiture shct_key_tpye;
+};
+
 /**************************************************************************************/
 /* Global Variables */
 
@@ -87,6 +106,174 @@ uns ext_cache_index(Cache* cache, Addr addr, Addr* tag, Addr* line_addr) {
   return cache_index(cache, addr, tag, line_addr);
 }
 
+/**************************************************************************************/
+/* Packed tag array: with CACHE_SOA_TAGS each set keeps its tags in tag_stride
+   consecutive Addrs (assoc rounded up to a 32-byte vector), invalid and padding
+   ways holding CACHE_TAG_INVALID. Every write of an entry's valid or tag must
+   be followed by cache_sync_tag()/cache_sync_line() so the two stay identical. */
+
+static void init_cache_tags(Cache* cache) {
+  uns ii;
+
+  cache->tags = NULL;
+  cache->tag_stride = 0;
+  if (!CACHE_SOA_TAGS)
+    return;
+
+  cache->tag_stride = (cache->assoc + 3) & ~3;
+  if (posix_memalign((void**)&cache->tags, 64, sizeof(Addr) * cache->tag_stride * cache->num_sets))
+    ASSERTM(0, FALSE, "Could not allocate the tag array of cache '%s'\n", cache->name);
+  for (ii = 0; ii < cache->tag_stride * cache->num_sets; ii++)
+    cache->tags[ii] = CACHE_TAG_INVALID;
+}
+
+static inline void cache_sync_tag(Cache* cache, uns set, uns way) {
+  Cache_Entry* line = &cache->entries[set][way];
+
+  if (!cache->tags)
+    return;
+  ASSERT(0, !line->valid || line->tag != CACHE_TAG_INVALID);
+  cache->tags[set * cache->tag_stride + way] = line->valid ? line->tag : CACHE_TAG_INVALID;
+}
+
+static inline void cache_sync_line(Cache* cache, uns set, Cache_Entry* line) {
+  ASSERT(0, line >= cache->entries[set] && line < cache->entries[set] + cache->assoc);
+  cache_sync_tag(cache, set, line - cache->entries[set]);
+}
+
+/* cache_find_way: returns the way holding a valid line with this tag, -1 on a miss */
+static inline int cache_find_way(Cache* cache, uns set, Addr tag) {
+  uns ii;
+
+  if (cache->tags) {
+    const Addr* tags = &cache->tags[set * cache->tag_stride];
+    ASSERT(0, tag != CACHE_TAG_INVALID);
+#if defined(__AVX2__)
+    __m256i key = _mm256_set1_epi64x(tag);
+    for (ii = 0; ii < cache->tag_stride; ii += 4) {
+      __m256i eq = _mm256_cmpeq_epi64(_mm256_load_si256((const __m256i*)&tags[ii]), key);
+      int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+      if (mask)
+        return ii + __builtin_ctz(mask);
+    }
+#elif defined(__SSE2__)
+    /* SSE2 has no 64-bit compare: both 32-bit halves have to match */
+    __m128i key = _mm_set1_epi64x(tag);
+    for (ii = 0; ii < cache->tag_stride; ii += 2) {
+      __m128i eq = _mm_cmpeq_epi32(_mm_load_si128((const __m128i*)&tags[ii]), key);
+      eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+      int mask = _mm_movemask_pd(_mm_castsi128_pd(eq));
+      if (mask)
+        return ii + __builtin_ctz(mask);
+    }
+#else
+    for (ii = 0; ii < cache->assoc; ii++)
+      if (tags[ii] == tag)
+        return ii;
+#endif
+    return -1;
+  }
+
+  for (ii = 0; ii < cache->assoc; ii++) {
+    Cache_Entry* line = &cache->entries[set][ii];
+    if (line->valid && line->tag == tag)
+      return ii;
+  }
+  return -1;
+}
+
+/**************************************************************************************/
+/* Checkpointing: lines are saved with their data (not the data pointer), followed by
+   whatever replacement state the policy keeps outside the lines. */
+
+static void cache_ckpt_lines(Ckpt_Stream* stream, Cache* cache, Cache_Entry** sets, uns ways) {
+  for (uns ii = 0; ii < cache->num_sets; ii++) {
+    for (uns jj = 0; jj < ways; jj++) {
+      Cache_Entry* line = &sets[ii][jj];
+      void* data = line->data;
+      ckpt_io(stream, line, sizeof(Cache_Entry));
+      line->data = data;
+      if (cache->data_size)
+        ckpt_io(stream, data, cache->data_size);
+    }
+  }
+}
+
+static void cache_ckpt(Ckpt_Stream* stream, void* arg) {
+  Cache* cache = (Cache*)arg;
+
+  cache_ckpt_lines(stream, cache, cache->entries, cache->assoc);
+  if (cache->tags)
+    ckpt_io(stream, cache->tags, sizeof(Addr) * cache->tag_stride * cache->num_sets);
+  if (cache->repl_policy < REPL_VOID) /* the strategy policies keep no counters */
+    ckpt_io(stream, cache->repl_ctrs, sizeof(uns) * cache->num_sets);
+  ckpt_io(stream, &cache->num_demand_access, sizeof(Counter));
+  ckpt_io(stream, &cache->last_update, sizeof(Counter));
+
+  switch (cache->repl_policy) {
+    case REPL_SHADOW_IDEAL:
+      cache_ckpt_lines(stream, cache, cache->shadow_entries, cache->assoc);
+      break;
+    case REPL_IDEAL_STORAGE:
+      cache_ckpt_lines(stream, cache, cache->shadow_entries, ideal_num_entries);
+      ckpt_io(stream, cache->queue_end, sizeof(uns) * cache->num_sets);
+      break;
+    case REPL_PARTITION:
+      ckpt_io(stream, cache->num_ways_allocted_core, sizeof(uns) * NUM_CORES);
+      ckpt_io(stream, cache->num_ways_occupied_core, sizeof(uns) * NUM_CORES);
+      ckpt_io(stream, cache->lru_index_core, sizeof(uns) * NUM_CORES);
+      ckpt_io(stream, cache->lru_time_core, sizeof(Counter) * NUM_CORES);
+      break;
+    case REPL_BRRIP:
+      ckpt_io(stream, &cache->bimodal_count, sizeof(Counter));
+      break;
+    case REPL_DRRIP:
+      ckpt_io(stream, &cache->bimodal_count, sizeof(Counter));
+      ckpt_io(stream, cache->miss_count, sizeof(Counter) * cache->num_sets);
+      ckpt_io(stream, cache->dedicated_policy_set, sizeof(uns) * cache->num_sets);
+      break;
+    case REPL_SHIP: {
+      /* the signature table is a hash table: save its (key, counter) pairs */
+      Hash_Table* shct = &((struct ship_shct*)cache->predictor)->shct_hash;
+      int count = shct->count;
+      ckpt_io(stream, &count, sizeof(count));
+      if (ckpt_saving(stream)) {
+        for (uns ii = 0; ii < shct->buckets; ii++) {
+          if (shct->dists[ii]) {
+            ckpt_write(stream, &shct->entries[ii].key, sizeof(int64));
+            ckpt_write(stream, shct->entries[ii].data, sizeof(Counter));
+          }
+        }
+      } else {
+        hash_table_clear(shct);
+        for (int ii = 0; ii < count; ii++) {
+          int64 key;
+          Flag new_entry;
+          ckpt_read(stream, &key, sizeof(key));
+          ckpt_read(stream, hash_table_access_create(shct, key, &new_entry), sizeof(Counter));
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+static void init_cache_ckpt(Cache* cache) {
+  static Flag rand_state_registered = FALSE;
+
+  if (cache->repl_policy == REPL_IDEAL) {
+    ckpt_unsupported("REPL_IDEAL caches");
+    return;
+  }
+  ckpt_register(cache->name, 0, cache_ckpt, cache);
+  if (!rand_state_registered) {
+    ckpt_register_data("cache_rand_repl_state", 0, rand_repl_state, sizeof(rand_repl_state));
+    rand_state_registered = TRUE;
+  }
+}
+
 /**************************************************************************************/
 /* init_cache: */
 
@@ -199,6 +386,8 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc, uns l
   }
 
   cache->tag_incl_offset = FALSE;
+  init_cache_tags(cache);
+  init_cache_ckpt(cache);
 }
 
 /**************************************************************************************/
@@ -208,8 +397,7 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc, uns l
 void* cache_access(Cache* cache, Addr addr, Addr* line_addr, Flag update_repl) {
   Addr tag;
   uns set = cache_index(cache, addr, &tag, line_addr);
-  uns ii;
-  void* line_data = NULL;
+  int way;
 
   if (cache->repl_policy >= REPL_VOID)
     return cache_access_strategy(cache, addr, line_addr, update_repl);
@@ -218,31 +406,27 @@ void* cache_access(Cache* cache, Addr addr, Addr* line_addr, Flag update_repl) {
     return access_ideal_storage(cache, set, tag, addr);
   }
 
-  for (ii = 0; ii < cache->assoc; ii++) {
-    Cache_Entry* line = &cache->entries[set][ii];
+  way = cache_find_way(cache, set, tag);
+  if (way >= 0) {
+    Cache_Entry* line = &cache->entries[set][way];
 
-    if (line->valid && line->tag == tag) {
-      /* update replacement state if necessary */
-      ASSERT(0, line->data);
-      DEBUG(0, "Found line in cache '%s' at (set %u, way %u, base 0x%s)\n", cache->name, set, ii,
-            hexstr64s(line->base));
+    /* update replacement state if necessary */
+    ASSERT(0, line->data);
+    DEBUG(0, "Found line in cache '%s' at (set %u, way %u, base 0x%s)\n", cache->name, set, way,
+          hexstr64s(line->base));
 
-      if (update_repl) {
-        if (line->pref) {
-          line->pref = FALSE;
-        }
-        cache->num_demand_access++;
-        update_repl_policy(cache, line, set, ii, FALSE);
-        DEBUG(0, "(%s, %d) [0x%x, 0x%x]: in access\n\n", cache->name, cache->repl_policy, cache->num_sets,
-              cache->assoc);
+    if (update_repl) {
+      if (line->pref) {
+        line->pref = FALSE;
       }
-
-      line_data = line->data;
+      cache->num_demand_access++;
+      update_repl_policy(cache, line, set, way, FALSE);
+      DEBUG(0, "(%s, %d) [0x%x, 0x%x]: in access\n\n", cache->name, cache->repl_policy, cache->num_sets,
+            cache->assoc);
     }
-  }
 
-  if (line_data)
-    return line_data;
+    return line->data;
+  }
 
   /* if it's a miss and we're doing ideal replacement, look in the unsure list
    */
@@ -319,6 +503,7 @@ void* cache_insert_replpos(Cache* cache, uns8 proc_id, Addr addr, Addr* line_add
   new_line->proc_id = proc_id;
   new_line->valid = TRUE;
   new_line->tag = tag;
+  cache_sync_line(cache, set, new_line);
   new_line->base = *line_addr;
   new_line->last_access_time = sim_time;  // FIXME: this fixes valgrind warnings in update_prf_
   new_line->pref = isPrefetch;
@@ -407,6 +592,7 @@ void* cache_insert_replpos(Cache* cache, uns8 proc_id, Addr addr, Addr* line_add
       main_line = &cache->entries[set][lru_ind];
       main_line->valid = TRUE;
       main_line->tag = tag;
+      cache_sync_tag(cache, set, lru_ind);
       main_line->base = *line_addr;
       main_line->last_access_time = sim_time;
     }
@@ -420,15 +606,14 @@ void* cache_insert_replpos(Cache* cache, uns8 proc_id, Addr addr, Addr* line_add
 void cache_invalidate(Cache* cache, Addr addr, Addr* line_addr) {
   Addr tag;
   uns set = cache_index(cache, addr, &tag, line_addr);
-  uns ii;
-
-  for (ii = 0; ii < cache->assoc; ii++) {
-    Cache_Entry* line = &cache->entries[set][ii];
-    if (line->tag == tag && line->valid) {
-      line->tag = 0;
-      line->valid = FALSE;
-      line->base = 0;
-    }
+  int way = cache_find_way(cache, set, tag);
+
+  if (way >= 0) {
+    Cache_Entry* line = &cache->entries[set][way];
+    line->tag = 0;
+    line->valid = FALSE;
+    line->base = 0;
+    cache_sync_tag(cache, set, way);
   }
 
   if (cache->repl_policy == REPL_IDEAL)
@@ -699,18 +884,16 @@ static inline void update_repl_policy(Cache* cache, Cache_Entry* cur_entry, uns
 /*                             is resolved or fetch barrier identified                */
 void update_repl_resteer_policy(Cache* cache, Addr addr) {
   ASSERT(0, cache->repl_policy == REPL_RESTEER);
-  int ii;
   Addr tag;
   Addr line_addr;
   uns set = cache_index(cache, addr, &tag, &line_addr);
-  for (ii = 0; ii < cache->assoc; ii++) {
-    Cache_Entry* line = &cache->entries[set][ii];
-    if (line->valid && line->tag == tag) {
-      ASSERT(0, line->data);
-      DEBUG(0, "updating access time REPL_RESTEER '%s' at (set %u, way %u, base 0x%s)\n", cache->name, set, ii,
-            hexstr64s(line->base));
-      line->last_access_time = sim_time;
-    }
+  int way = cache_find_way(cache, set, tag);
+  if (way >= 0) {
+    Cache_Entry* line = &cache->entries[set][way];
+    ASSERT(0, line->data);
+    DEBUG(0, "updating access time REPL_RESTEER '%s' at (set %u, way %u, base 0x%s)\n", cache->name, set, way,
+          hexstr64s(line->base));
+    line->last_access_time = sim_time;
   }
 }
 
@@ -747,6 +930,7 @@ static inline void* access_unsure_lines(Cache* cache, uns set, Addr tag, Flag up
         if (!cache->entries[set][ii].valid) {
           void* data = cache->entries[set][ii].data;
           memcpy(&cache->entries[set][ii], temp, sizeof(Cache_Entry));
+          cache_sync_tag(cache, set, ii);
           temp->data = data;
           ASSERT(0, dl_list_remove_current(list) == temp);
           ASSERT(0, ++cache->repl_ctrs[set] <= cache->assoc); /* repl ctr holds the sure count */
@@ -782,6 +966,7 @@ static inline Cache_Entry* insert_sure_line(Cache* cache, uns set, Addr tag) {
         temp->data = malloc(sizeof(cache->data_size));
         memcpy(entry->data, temp->data, sizeof(cache->data_size));
         entry->valid = FALSE;
+        cache_sync_tag(cache, set, ii);
         count++;
       }
     }
@@ -858,6 +1043,7 @@ void* access_shadow_lines(Cache* cache, uns set, Addr tag) {
 
         tmp_line = (cache->entries[set][lru_ind]);
         (cache->entries[set][lru_ind]) = *line;
+        cache_sync_tag(cache, set, lru_ind);
         *line = tmp_line;
         line->last_access_time = (cache->entries[set][lru_ind]).last_access_time;
         (cache->entries[set][lru_ind]).last_access_time = sim_time;
@@ -1033,6 +1219,7 @@ void* cache_insert_lru(Cache* cache, uns8 proc_id, Addr addr, Addr* line_addr, A
   new_line->proc_id = proc_id;
   new_line->valid = TRUE;
   new_line->tag = tag;
+  cache_sync_line(cache, set, new_line);
   new_line->base = *line_addr;
   update_repl_policy(cache, new_line, set, repl_index, TRUE);
   if (cache->repl_policy == REPL_TRUE_LRU)
@@ -1074,6 +1261,7 @@ void* cache_insert_lru(Cache* cache, uns8 proc_id, Addr addr, Addr* line_addr, A
       main_line = &cache->entries[set][lru_ind];
       main_line->valid = TRUE;
       main_line->tag = tag;
+      cache_sync_tag(cache, set, lru_ind);
       main_line->base = *line_addr;
       main_line->last_access_time = sim_time;
     }
@@ -1090,6 +1278,7 @@ void reset_cache(Cache* cache) {
   for (ii = 0; ii < cache->num_sets; ii++) {
     for (jj = 0; jj < cache->assoc; jj++) {
       cache->entries[ii][jj].valid = FALSE;
+      cache_sync_tag(cache, ii, jj);
     }
   }
 }
@@ -1106,22 +1295,13 @@ int cache_find_pos_in_lru_stack(Cache* cache, uns8 proc_id, Addr addr, Addr* lin
   uns set = cache_index(cache, addr, &tag, line_addr);
   uns ii;
   int position;
-  Cache_Entry* hit_line = NULL;
-  Flag hit = FALSE;
+  int way = cache_find_way(cache, set, tag);
+  Cache_Entry* hit_line;
 
-  for (ii = 0; ii < cache->assoc; ii++) {
-    hit_line = &cache->entries[set][ii];
-
-    if (hit_line->valid && hit_line->tag == tag) {
-      hit = TRUE;
-      break;
-    }
-  }
-
-  if (!hit)
+  if (way < 0)
     return -1;
 
-  ASSERT(0, hit_line);
+  hit_line = &cache->entries[set][way];
   ASSERT(0, hit_line->proc_id == proc_id);
   position = 0;
   for (ii = 0; ii < cache->assoc; ii++) {
@@ -1270,6 +1450,7 @@ void* cache_insert_strategy(Cache* cache, uns8 proc_id, Addr addr, Addr* line_ad
   else
     *repl_line_addr = 0;
   repl_policy_func_table[policy].action_repl(cache, new_line, proc_id, tag, line_addr, repl_line_addr);
+  cache_sync_line(cache, set, new_line);
   repl_policy_func_table[policy].update_insert(cache, proc_id, set, repl_index, NULL);
 
   return new_line->data;
@@ -1283,7 +1464,7 @@ void* cache_insert_strategy(Cache* cache, uns8 proc_id, Addr addr, Addr* line_ad
 void* cache_access_strategy(Cache* cache, Addr addr, Addr* line_addr, Flag update_repl) {
   Addr tag;
   uns set = cache_index(cache, addr, &tag, line_addr);
-  uns ii;
+  int way;
   int policy;
 
   // Get the selected strategy (policy)
@@ -1293,18 +1474,13 @@ void* cache_access_strategy(Cache* cache, Addr addr, Addr* line_addr, Flag updat
 
   DEBUG(0, "%s, %d: Access Strategy\n", cache->name, cache->repl_policy);
 
-  for (ii = 0; ii < cache->assoc; ii++) {
-    Cache_Entry* line = &cache->entries[set][ii];
-
-    if (line->valid && line->tag == tag) {
-      if (update_repl)
-        repl_policy_func_table[policy].update_hit(cache, set, ii, NULL);
-
-      return line->data;
-    }
-  }
+  way = cache_find_way(cache, set, tag);
+  if (way < 0)
+    return NULL;
 
-  return NULL;
+  if (update_repl)
+    repl_policy_func_table[policy].update_hit(cache, set, way, NULL);
+  return cache->entries[set][way].data;
 }
 
 /*
@@ -1373,6 +1549,8 @@ void general_action_init(Cache* cache, const char* name, uns cache_size, uns ass
         cache->entries[ii][jj].data = INIT_CACHE_DATA_VALUE;
     }
   }
+  init_cache_tags(cache);
+  init_cache_ckpt(cache);
 }
 
 void general_action_repl(Cache* cache, Cache_Entry* new_line, uns8 proc_id, Addr tag, Addr* line_addr,
@@ -1690,12 +1868,6 @@ void ship_update_hit(Cache* cache, uns set, uns way, void* arg);
 void ship_update_insert(Cache* cache, uns8 proc_id, uns set, uns way, void* arg);
 Cache_Entry* ship_update_evict(Cache* cache, uns8 proc_id, uns set, uns* way, void* arg, Flag if_external);
 
-/* Signiture History Counter Table */
-struct ship_shct {
-  Hash_Table shct_hash;
-  Cache_Repl_Signiture shct_key_tpye;
-};
-
 void ship_action_init(Cache* cache, const char* name, uns cache_size, uns assoc, uns line_size, uns data_size,
                       Repl_Policy repl_policy) {
   int ii, jj;
@@ -38,6 +38,9 @@
 /* set data pointers to this initially */
 #define INIT_CACHE_DATA_VALUE ((void*)0x8badbeef)
 
+/* packed tag array value for invalid (and padding) ways */
+#define CACHE_TAG_INVALID ((Addr)-1)
+
 /**************************************************************************************/
 
 typedef enum Repl_Policy_enum {
@@ -120,6 +123,11 @@ typedef struct Cache_struct {
   /* A dynamically allocated array of all of the cache entries. The array is two-dimensional, sets are row major. */
   Cache_Entry** entries;
 
+  /* Packed copy of the valid tags (CACHE_SOA_TAGS), tag_stride slots per set. Lookups compare a whole set here
+     and only touch entries[] on a hit; replacement state stays in entries[]. NULL when disabled. */
+  Addr* tags;
+  uns tag_stride;
+
   /* A linked list for each set in the cache that is used when simulating ideal replacement policies */
   List* unsure_lists;
 
@@ -28,6 +28,14 @@ struct Entry {
   User_Data_Type data;
   // for LRU replacement policy
   Counter accessed_cycle;
+
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(valid);
+    ar.io(key);
+    ar.io(data);
+    ar.io(accessed_cycle);
+  }
 };
 
 template <typename User_Key_Type, typename User_Data_Type>
@@ -36,6 +44,12 @@ class Set {
   std::vector<Entry<User_Key_Type, User_Data_Type>> entries;
   // for round-robin replacement policy
   uns next_evict;
+
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(entries);
+    ar.io(next_evict);
+  }
 };
 
 template <typename User_Key_Type, typename User_Data_Type>
@@ -71,6 +85,12 @@ class Cpp_Cache {
   User_Data_Type* access(User_Key_Type key, bool update_repl);
   Entry<User_Key_Type, User_Data_Type> insert(User_Key_Type key, User_Data_Type data);
   Entry<User_Key_Type, User_Data_Type> invalidate(User_Key_Type key);
+
+  // checkpointing (see checkpoint.h): the geometry comes from the configuration
+  template <class Archive>
+  void serialize(Archive& ar) {
+    ar.io(sets);
+  }
 };
 
 template <typename User_Key_Type, typename User_Data_Type>
@@ -29,6 +29,7 @@
 #include "libs/hash_lib.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "globals/assert.h"
 #include "globals/global_defs.h"
@@ -45,26 +46,161 @@
 
 #define DEBUG(args...) _DEBUG(DEBUG_HASH_LIB, ##args)
 
-int64 HASH_INDEX(const Hash_Table* table, int64 key);
-int64 HASH_INDEX(const Hash_Table* table, int64 key) {
-  int64_t mask = (~0UL) % table->buckets;
-  int64_t hash = 0;
-  int log2 = 64 - __builtin_clzl(table->buckets);
-  for (int i = 0; i < 64; i += log2) {
-    hash ^= (key & mask);
-    key = key >> log2;
+#define HASH_MIN_BUCKETS 8
+#define HASH_MAX_INIT_BUCKETS (1 << 16) /* larger tables start here and grow on demand */
+#define HASH_MAX_DIST 0xffff             /* probe distances are kept in a uns16 */
+#define HASH_FULL(table, count) ((uns64)(count) * 8 > (uns64)(table)->buckets * 7)
+
+/**************************************************************************************/
+/* Prototypes */
+
+static inline uns hash_index(const Hash_Table* table, int64 key);
+static inline int hash_table_find(const Hash_Table* table, int64 key, void const* data);
+static void hash_table_alloc(Hash_Table* table, uns buckets);
+static void hash_table_resize(Hash_Table* table, uns new_buckets);
+static void hash_table_insert(Hash_Table* table, int64 key, void* data);
+static void hash_table_remove(Hash_Table* table, uns index);
+static void* hash_table_create_entry(Hash_Table* table, int64 key);
+
+/**************************************************************************************/
+/* hash_index: Fibonacci hashing, the top log2(buckets) bits of key * 2^64/phi */
+
+static inline uns hash_index(const Hash_Table* table, int64 key) {
+  return (uns)(((uns64)key * 0x9E3779B97F4A7C15ULL) >> table->shift);
+}
+
+/**************************************************************************************/
+/* hash_table_find: return the slot holding key (and matching data through
+   eq_func if data is non-NULL), -1 if there is none. A Robin Hood table can
+   stop probing as soon as it reaches a slot closer to its home than the
+   current probe distance. */
+
+static inline int hash_table_find(const Hash_Table* table, int64 key, void const* data) {
+  uns mask = table->buckets - 1;
+  uns index = hash_index(table, key);
+  uns dist = 1;
+
+  while (table->dists[index] >= dist) {
+    Hash_Table_Entry* entry = &table->entries[index];
+    if (entry->key == key && (!data || table->eq_func(entry->data, data)))
+      return index;
+    index = (index + 1) & mask;
+    dist++;
   }
-  return hash;
+  return -1;
 }
 
 /**************************************************************************************/
-// Global variables
+/* hash_table_alloc: */
+
+static void hash_table_alloc(Hash_Table* table, uns buckets) {
+  ASSERT(0, buckets >= HASH_MIN_BUCKETS && (buckets & (buckets - 1)) == 0);
+  table->buckets = buckets;
+  table->shift = 64 - __builtin_ctz(buckets);
+  table->entries = (Hash_Table_Entry*)malloc(buckets * sizeof(Hash_Table_Entry));
+  table->dists = (uns16*)calloc(buckets, sizeof(uns16));
+  ASSERT(0, table->entries && table->dists);
+}
+
+/**************************************************************************************/
+/* hash_table_resize: move every entry into a fresh slot array. The data
+   pointers move with their keys, so the data itself never moves. */
+
+static void hash_table_resize(Hash_Table* table, uns new_buckets) {
+  Hash_Table_Entry* old_entries = table->entries;
+  uns16* old_dists = table->dists;
+  uns old_buckets = table->buckets;
+  uns ii;
+
+  DEBUG(0, "Resizing %s from %u to %u buckets (%d entries)\n", table->name, old_buckets, new_buckets, table->count);
+  hash_table_alloc(table, new_buckets);
+  for (ii = 0; ii < old_buckets; ii++)
+    if (old_dists[ii])
+      hash_table_insert(table, old_entries[ii].key, old_entries[ii].data);
+
+  free(old_entries);
+  free(old_dists);
+}
+
+/**************************************************************************************/
+/* hash_table_insert: place a key that is not in the table yet. Richer
+   entries (shorter probe distance) give their slot to the one being placed,
+   which keeps the probe lengths even. Does not touch table->count. */
+
+static void hash_table_insert(Hash_Table* table, int64 key, void* data) {
+  Hash_Table_Entry cur = {key, data};
+  uns mask, index, dist;
+
+restart:
+  mask = table->buckets - 1;
+  index = hash_index(table, cur.key);
+  dist = 1;
+  while (table->dists[index]) {
+    if (table->dists[index] < dist) {
+      Hash_Table_Entry tmp_entry = table->entries[index];
+      uns tmp_dist = table->dists[index];
+      table->entries[index] = cur;
+      table->dists[index] = dist;
+      cur = tmp_entry;
+      dist = tmp_dist;
+    }
+    index = (index + 1) & mask;
+    dist++;
+    if (dist > HASH_MAX_DIST) {
+      /* pathological clustering: grow and place whatever entry is in hand.
+         Growing cannot split a run of equal keys (complex tables) */
+      ASSERTM(0, HASH_FULL(table, table->count * 4), "%s: too many entries share one key\n", table->name);
+      hash_table_resize(table, table->buckets * 2);
+      goto restart;
+    }
+  }
+  table->entries[index] = cur;
+  table->dists[index] = dist;
+}
+
+/**************************************************************************************/
+/* hash_table_remove: free the entry in a slot and shift the following run of
+   displaced entries back by one, so no tombstones are left behind. */
+
+static void hash_table_remove(Hash_Table* table, uns index) {
+  uns mask = table->buckets - 1;
+  uns next = (index + 1) & mask;
+
+  sfree(table->data_size, table->entries[index].data);
+  while (table->dists[next] > 1) {
+    table->entries[index] = table->entries[next];
+    table->dists[index] = table->dists[next] - 1;
+    index = next;
+    next = (next + 1) & mask;
+  }
+  table->dists[index] = 0;
+  table->count--;
+  ASSERT(0, table->count >= 0);
+}
+
+/**************************************************************************************/
+/* hash_table_create_entry: */
+
+static void* hash_table_create_entry(Hash_Table* table, int64 key) {
+  void* data;
+
+  if (HASH_FULL(table, table->count + 1))
+    hash_table_resize(table, table->buckets * 2);
+
+  data = smalloc(table->data_size);
+  ASSERT(0, data);
+  hash_table_insert(table, key, data);
+  table->count++;
 
-#define NUM_HASH_TABLE_PRIMES 12
-static uns const hash_table_primes[NUM_HASH_TABLE_PRIMES] = {1, 5, 11, 23, 47, 101, 211, 401, 811, 1601, 3209, 6373};
+  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n", (unsigned long int)table->data_size, table->name,
+          table->count);
+  return data;
+}
 
 /**************************************************************************************/
-/* init_hash_table: */
+/* init_hash_table: the bucket count is a sizing hint. It is rounded up to a
+   power of two, and very large hints only set the starting size up to
+   HASH_MAX_INIT_BUCKETS since the table grows as it fills. */
 
 void init_hash_table(Hash_Table* table, const char* name, uns buckets, uns data_size) {
   init_complex_hash_table(table, name, buckets, data_size, NULL);
@@ -72,12 +208,16 @@ void init_hash_table(Hash_Table* table, const char* name, uns buckets, uns data_
 
 void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets, uns data_size,
                              Flag (*eq_func)(void const*, void const*)) {
+  uns size = HASH_MIN_BUCKETS;
+
+  while (size < buckets && size < HASH_MAX_INIT_BUCKETS)
+    size <<= 1;
+
   table->name = strdup(name);
-  table->buckets = buckets;
   table->data_size = data_size;
   table->count = 0;
-  table->entries = (Hash_Table_Entry**)calloc(buckets, sizeof(Hash_Table_Entry*));
   table->eq_func = eq_func;
+  hash_table_alloc(table, size);
 }
 
 /**************************************************************************************/
@@ -86,32 +226,20 @@ void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets, u
 
 void* hash_table_access(Hash_Table const* table, int64 key) {
   // {{{ access hash table using simple key compare
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-
-  for (temp = bucket; temp != NULL; temp = temp->next)
-    if (temp->key == key)
-      return temp->data;
-
-  return NULL;
+  int index = hash_table_find(table, key, NULL);
+  return index < 0 ? NULL : table->entries[index].data;
   // }}}
 }
 
 void* complex_hash_table_access(Hash_Table const* table, int64 key, void const* data) {
   // {{{ access hash table using a complex comparison
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
+  int index;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
-  for (temp = bucket; temp != NULL; temp = temp->next)
-    if (temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-
-  return NULL;
+  index = hash_table_find(table, key, data);
+  return index < 0 ? NULL : table->entries[index].data;
   // }}}
 }
 
@@ -122,78 +250,27 @@ void* complex_hash_table_access(Hash_Table const* table, int64 key, void const*
 
 void* hash_table_access_create(Hash_Table* table, int64 key, Flag* new_entry) {
   // {{{ access hash table using simple key compare
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
-  *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key)
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
-  *new_entry = TRUE;
-  new_hash = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if (prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size, table->name, table->count);
-
-  return new_hash->data;
+  int index = hash_table_find(table, key, NULL);
+
+  *new_entry = index < 0;
+  if (index >= 0)
+    return table->entries[index].data;
+  return hash_table_create_entry(table, key);
   // }}}
 }
 
 void* complex_hash_table_access_create(Hash_Table* table, int64 key, void const* data, Flag* new_entry) {
   // {{{ access hash table using a complex comparison
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
+  int index;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
-  *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
-  *new_entry = TRUE;
-  new_hash = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if (prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size, table->name, table->count);
-
-  return new_hash->data;
+  index = hash_table_find(table, key, data);
+  *new_entry = index < 0;
+  if (index >= 0)
+    return table->entries[index].data;
+  return hash_table_create_entry(table, key);
   // }}}
 }
 
@@ -203,58 +280,27 @@ void* complex_hash_table_access_create(Hash_Table* table, int64 key, void const*
 
 Flag hash_table_access_delete(Hash_Table* table, int64 key) {
   // {{{ access hash table using simple key compare
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if (prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
+  int index = hash_table_find(table, key, NULL);
 
-  return FALSE;
+  if (index < 0)
+    return FALSE;
+  hash_table_remove(table, index);
+  return TRUE;
   // }}}
 }
 
 Flag complex_hash_table_access_delete(Hash_Table* table, int64 key, void const* data) {
   // {{{ access hash table using a complex comparison
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
+  int index;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key && table->eq_func(temp->data, data)) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if (prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
-
-  return FALSE;
+  index = hash_table_find(table, key, data);
+  if (index < 0)
+    return FALSE;
+  hash_table_remove(table, index);
+  return TRUE;
   // }}}
 }
 
@@ -262,22 +308,19 @@ Flag complex_hash_table_access_delete(Hash_Table* table, int64 key, void const*
 /* hash_table_clear: */
 
 void hash_table_clear(Hash_Table* table) {
-  Hash_Table_Entry* temp0;
-  Hash_Table_Entry* temp1;
   uns count = 0;
-  int ii;
+  uns ii;
+
+  if (table->count == 0)
+    return;
 
   for (ii = 0; ii < table->buckets; ii++) {
-    temp0 = table->entries[ii];
-    while (temp0) {
-      temp1 = temp0->next;
-      sfree(table->data_size, temp0->data);
-      sfree(sizeof(Hash_Table_Entry), temp0);
-      temp0 = temp1;
+    if (table->dists[ii]) {
+      sfree(table->data_size, table->entries[ii].data);
       count++;
     }
-    table->entries[ii] = NULL;
   }
+  memset(table->dists, 0, table->buckets * sizeof(uns16));
   ASSERT(0, count == table->count);
   table->count = 0;
 }
@@ -288,10 +331,9 @@ void hash_table_clear(Hash_Table* table) {
  */
 
 void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
-  Hash_Table_Entry* temp;
   void** new_array;
   uns count = 0;
-  int ii;
+  uns ii;
 
   if (table->count == 0)
     return NULL;
@@ -304,14 +346,9 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
   }
 
   /* write into the new array */
-  count = 0;
-  for (ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while (temp) {
-      new_array[count++] = temp->data;
-      temp = temp->next;
-    }
-  }
+  for (ii = 0; ii < table->buckets; ii++)
+    if (table->dists[ii])
+      new_array[count++] = table->entries[ii].data;
 
   ASSERTM(0, count == table->count, "%d %d\n", count, table->count);
   ASSERTM(0, count > 0, "%d %d\n", count, table->count);
@@ -321,12 +358,11 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
 
 /**************************************************************************************/
 // hash_table_scan: scans all of the nodes in the hash table and runs
-// the scan_fanc on them
+// the scan_fanc on them. scan_func must not insert or delete entries.
 
 void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*), void* arg) {
   int count = 0;
-  Hash_Table_Entry* temp;
-  int ii;
+  uns ii;
 
   ASSERT(0, scan_func);
 
@@ -334,64 +370,32 @@ void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*), void* a
     return;
 
   for (ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while (temp) {
+    if (table->dists[ii]) {
       count++;
-      scan_func(temp->data, arg);
-      temp = temp->next;
+      scan_func(table->entries[ii].data, arg);
     }
   }
   ASSERT(0, count == table->count);
 }
 
 /**************************************************************************************/
-// hash_table_rehash: expand or contract the hash table
-// WARNING: this hasn't really been tested
+// hash_table_rehash: expand or contract the hash table. new_buckets is
+// rounded up to a power of two that still holds every entry; 0 doubles it.
 
 void hash_table_rehash(Hash_Table* table, int new_buckets) {
-  Hash_Table_Entry** new_entries;
-  Hash_Table_Entry** flat_entries;
-  Hash_Table_Entry** old_entries = table->entries;
-  uns old_buckets = table->buckets;
-  Hash_Table_Entry* temp;
-  uns ii, jj;
+  uns size = HASH_MIN_BUCKETS;
 
   ASSERT(0, new_buckets >= 0);
-  if (new_buckets == 0) {  // use next prime
-    new_buckets = table->buckets;
-    for (ii = 0; ii < NUM_HASH_TABLE_PRIMES - 1; ii++)
-      if (hash_table_primes[ii] == old_buckets) {
-        new_buckets = hash_table_primes[ii + 1];
-        break;
-      }
-  }
-  if (new_buckets == old_buckets)
+  if (new_buckets == 0)
+    new_buckets = table->buckets * 2;
+  while (size < (uns)new_buckets)
+    size <<= 1;
+  while ((uns64)table->count * 8 > (uns64)size * 7)
+    size <<= 1;
+  if (size == table->buckets)
     return;
 
-  // flatten hash table into an array of entries
-  flat_entries = (Hash_Table_Entry**)malloc(table->count * sizeof(Hash_Table_Entry*));
-  for (ii = 0, jj = 0; ii < old_buckets; ii++)
-    for (temp = old_entries[ii]; temp; temp = temp->next)
-      flat_entries[jj++] = temp;
-  ASSERT(0, jj == table->count);
-
-  // replace old with new and free the old entry array
-  new_entries = (Hash_Table_Entry**)calloc(new_buckets, sizeof(Hash_Table_Entry*));
-  ASSERT(0, new_entries);
-  ASSERT(0, new_buckets > 0 && new_buckets < 100000);
-  table->buckets = new_buckets;
-  table->entries = new_entries;
-  free(old_entries);
-
-  // insert each element
-  for (ii = 0; ii < table->count; ii++) {
-    Hash_Table_Entry* temp = flat_entries[ii];
-    uns index = HASH_INDEX(table, temp->key);
-    temp->next = table->entries[index];
-    table->entries[index] = temp;
-  }
-
-  free(flat_entries);
+  hash_table_resize(table, size);
 }
 
 /**************************************************************************************/
@@ -400,40 +404,20 @@ void hash_table_rehash(Hash_Table* table, int new_buckets) {
 //                            if it doesn't exist yet
 void hash_table_access_replace(Hash_Table* table, int64 key, void* replacement) {
   // {{{ access hash table using simple key compare
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-  Flag new_entry = FALSE;
-  UNUSED(new_entry);
+  int index = hash_table_find(table, key, NULL);
+
   ASSERT(0, replacement);
-  ASSERT(0, index < table->buckets);
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key) {
-      /* May not want to free the memory in case there are other valid pointers
-         to it. ASSERT(0,temp->data); free(table->data_size, temp->data);
-      */
-      temp->data = replacement;
-      return;
-    } else {
-      prev = temp;
-    }
+  if (index >= 0) {
+    /* May not want to free the memory in case there are other valid pointers
+       to it. ASSERT(0,temp->data); free(table->data_size, temp->data);
+    */
+    table->entries[index].data = replacement;
+    return;
   }
+
+  if (HASH_FULL(table, table->count + 1))
+    hash_table_resize(table, table->buckets * 2);
+  hash_table_insert(table, key, replacement);
   table->count++;
-  new_entry = TRUE;
-  new_hash = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key = key;
-  new_hash->next = NULL;
-  new_hash->data = replacement;
-
-  if (prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n", (unsigned long int)sizeof(Hash_Table_Entry), table->name,
-          table->count);
   // }}}
 }
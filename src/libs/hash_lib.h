@@ -35,18 +35,25 @@
 /**************************************************************************************/
 /* Types */
 
+/* The table is open addressed with Robin Hood probing over a power-of-two
+   array of slots. Only the key and a data pointer live in the slot; the data
+   itself is smalloc'd once per entry so the pointers handed out by the
+   access functions stay valid until that entry is deleted, even when the
+   slot array grows or entries are shifted by a deletion. */
+
 typedef struct Hash_Table_Entry_struct {
   int64 key;
   void* data;
-  struct Hash_Table_Entry_struct* next;
 } Hash_Table_Entry;
 
 typedef struct Hash_Table_struct {
   char* name;
-  uns buckets;
+  uns buckets;  // number of slots (power of two)
   uns data_size;
   int count;  // total number of elements in the hash table
-  Hash_Table_Entry** entries;
+  Hash_Table_Entry* entries;
+  uns16* dists;  // probe distance + 1 for each slot, 0 if the slot is empty
+  uns shift;    // 64 - log2(buckets), for the multiplicative hash
   Flag (*eq_func)(void const* const, void const* const);
 } Hash_Table;
 
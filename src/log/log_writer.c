@@ -0,0 +1,252 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_writer.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/utils.h"
+#include "general.param.h"
+#include "debug/debug.param.h"
+#include "debug/debug_print.h"
+#include "isa/isa.h"
+#include "table_info.h"
+
+extern char* OUTPUT_DIR;
+extern const char* const mem_type_names[];
+
+#define MAX_OPEN_LOG_WRITERS 16
+
+#define REG(x) #x,
+static const char* reg_names[NUM_REGS] = {
+#include "../isa/x86_regs.def"
+};
+#undef REG
+
+// atexit 한 번으로 모든 로그를 닫기 위해 열린 writer를 기억한다.
+static Log_Writer* open_writers[MAX_OPEN_LOG_WRITERS];
+static uns num_open_writers = 0;
+
+static void close_all_log_writers(void) {
+    for (uns i = 0; i < num_open_writers; i++) {
+        log_writer_close(open_writers[i]);
+        open_writers[i] = NULL;
+    }
+    num_open_writers = 0;
+}
+
+static void put_raw(Log_Writer* lw, const void* data, uns size) {
+    if (!lw || !lw->file)
+        return;
+    ASSERT(0, lw->hdr_len + size <= H2P_LOG_MAX_HDR);
+    memcpy(&lw->hdr[lw->hdr_len], data, size);
+    lw->hdr_len += size;
+}
+
+static void put_str(Log_Writer* lw, const char* str) {
+    uns16 len = strlen(str);
+    fwrite(&len, sizeof(len), 1, lw->file);
+    fwrite(str, 1, len, lw->file);
+}
+
+static void put_file_u32(Log_Writer* lw, uns32 val) {
+    fwrite(&val, sizeof(val), 1, lw->file);
+}
+
+// 헤더의 필드 테이블. 필드 개수도 이 배열에서 구하므로 필드를 추가할 때는 여기에만 넣으면 된다.
+typedef struct Record_Field_struct {
+    const char* name;
+    uns32 offset;
+    uns32 size;   // 원소 하나의 크기
+    uns32 count;  // 배열 필드의 원소 개수
+} Record_Field;
+
+#define RECORD_FIELD(field, count) \
+    { #field, offsetof(Retired_Op_Record, field), sizeof(((Retired_Op_Record*)0)->field) / (count), count }
+
+static const Record_Field record_fields[] = {
+    RECORD_FIELD(pc, 1),
+    RECORD_FIELD(op_num, 1),
+    RECORD_FIELD(va, 1),
+    RECORD_FIELD(sched_cycle, 1),
+    RECORD_FIELD(exec_cycle, 1),
+    RECORD_FIELD(done_cycle, 1),
+    RECORD_FIELD(retire_cycle, 1),
+    RECORD_FIELD(mem_size, 1),
+    RECORD_FIELD(op_type, 1),
+    RECORD_FIELD(cf_type, 1),
+    RECORD_FIELD(mem_type, 1),
+    RECORD_FIELD(num_src_regs, 1),
+    RECORD_FIELD(num_dest_regs, 1),
+    RECORD_FIELD(h2p, 1),
+    RECORD_FIELD(srcs, MAX_SRCS),
+    RECORD_FIELD(dests, MAX_DESTS),
+};
+
+#define NUM_RECORD_FIELDS (sizeof(record_fields) / sizeof(record_fields[0]))
+
+static void put_field(Log_Writer* lw, const Record_Field* field) {
+    put_str(lw, field->name);
+    put_file_u32(lw, field->offset);
+    put_file_u32(lw, field->size);
+    put_file_u32(lw, field->count);
+}
+
+static void write_header(Log_Writer* lw, const char* name) {
+    fwrite(H2P_LOG_MAGIC, 1, strlen(H2P_LOG_MAGIC), lw->file);
+    put_file_u32(lw, H2P_LOG_VERSION);
+    put_str(lw, name);
+
+    put_file_u32(lw, sizeof(Retired_Op_Record));
+    put_file_u32(lw, NUM_RECORD_FIELDS);
+    for (uns i = 0; i < NUM_RECORD_FIELDS; i++)
+        put_field(lw, &record_fields[i]);
+
+    // 디코더가 enum 값을 이름으로 바꿀 수 있도록 이름 테이블을 함께 기록한다.
+    put_file_u32(lw, NUM_OP_TYPES);
+    for (uns i = 0; i < NUM_OP_TYPES; i++)
+        put_str(lw, Op_Type_str(i));
+    put_file_u32(lw, NUM_CF_TYPES);
+    for (uns i = 0; i < NUM_CF_TYPES; i++)
+        put_str(lw, cf_type_names[i]);
+    // mem_type_names[]는 MEM_PF까지만 정의되어 있다.
+    put_file_u32(lw, MEM_PF + 1);
+    for (uns i = 0; i <= MEM_PF; i++)
+        put_str(lw, mem_type_names[i]);
+    put_file_u32(lw, NUM_REGS);
+    for (uns i = 0; i < NUM_REGS; i++)
+        put_str(lw, reg_names[i]);
+}
+
+Log_Writer* log_writer_open(const char* name) {
+    char file_name[MAX_STR_LENGTH + 1];
+    snprintf(file_name, MAX_STR_LENGTH, "%s/%s%s.%s", OUTPUT_DIR, FILE_TAG, name, H2P_LOG_BINARY ? "bin" : "out");
+
+    FILE* file = fopen(file_name, H2P_LOG_BINARY ? "wb" : "w");
+    if (!file) {
+        perror(file_name);
+        return NULL;
+    }
+
+    Log_Writer* lw = (Log_Writer*)calloc(1, sizeof(Log_Writer));
+    lw->file = file;
+    lw->binary = H2P_LOG_BINARY;
+    // 엔트리마다 fflush 하지 않고 큰 버퍼가 찰 때만 디스크에 쓴다.
+    lw->buf = (char*)malloc(H2P_LOG_BUF_SIZE);
+    setvbuf(lw->file, lw->buf, _IOFBF, H2P_LOG_BUF_SIZE);
+
+    if (lw->binary)
+        write_header(lw, name);
+
+    ASSERTM(0, num_open_writers < MAX_OPEN_LOG_WRITERS, "Too many H2P log files\n");
+    if (num_open_writers == 0)
+        atexit(close_all_log_writers);
+    open_writers[num_open_writers++] = lw;
+    return lw;
+}
+
+void log_writer_close(Log_Writer* lw) {
+    if (!lw || !lw->file)
+        return;
+    fclose(lw->file);
+    lw->file = NULL;
+    free(lw->buf);
+    lw->buf = NULL;
+}
+
+void log_writer_printf(Log_Writer* lw, const char* fmt, ...) {
+    va_list args;
+    if (!lw || !lw->file)
+        return;
+
+    va_start(args, fmt);
+    if (!lw->binary) {
+        vfprintf(lw->file, fmt, args);
+    } else {
+        char text[MAX_STR_LENGTH * 4];
+        int len = vsnprintf(text, sizeof(text), fmt, args);
+        if (len > (int)sizeof(text) - 1)
+            len = sizeof(text) - 1;
+        uns8 type = H2P_REC_TEXT;
+        uns32 hdr_len = len;
+        uns32 num_ops = 0;
+        fwrite(&type, sizeof(type), 1, lw->file);
+        fwrite(&hdr_len, sizeof(hdr_len), 1, lw->file);
+        fwrite(text, 1, len, lw->file);
+        fwrite(&num_ops, sizeof(num_ops), 1, lw->file);
+    }
+    va_end(args);
+}
+
+void log_writer_begin(Log_Writer* lw, H2P_Log_Rec_Type type) {
+    if (!lw || !lw->file)
+        return;
+    ASSERT(0, lw->binary);
+    lw->rec_type = type;
+    lw->hdr_len = 0;
+}
+
+void log_writer_put_u8(Log_Writer* lw, uns8 val) {
+    put_raw(lw, &val, sizeof(val));
+}
+
+void log_writer_put_u32(Log_Writer* lw, uns32 val) {
+    put_raw(lw, &val, sizeof(val));
+}
+
+void log_writer_put_u64(Log_Writer* lw, uns64 val) {
+    put_raw(lw, &val, sizeof(val));
+}
+
+void log_writer_end(Log_Writer* lw, uns num_ops) {
+    if (!lw || !lw->file)
+        return;
+    uns32 hdr_len = lw->hdr_len;
+    uns32 count = num_ops;
+    fwrite(&lw->rec_type, sizeof(lw->rec_type), 1, lw->file);
+    fwrite(&hdr_len, sizeof(hdr_len), 1, lw->file);
+    fwrite(lw->hdr, 1, hdr_len, lw->file);
+    fwrite(&count, sizeof(count), 1, lw->file);
+}
+
+void log_writer_ops(Log_Writer* lw, const Retired_Op_Record* ops, uns num_ops) {
+    if (!lw || !lw->file)
+        return;
+    if (num_ops)
+        fwrite(ops, sizeof(Retired_Op_Record), num_ops, lw->file);
+}
+
+// 손상된 레코드의 레지스터 번호로 reg_names 밖을 읽지 않도록 한다.
+static const char* retired_reg_name(uns reg) {
+    return reg < NUM_REGS ? reg_names[reg] : "?";
+}
+
+char* disasm_retired_op(const Retired_Op_Record* op) {
+    static char buf[512];
+    int i = 0;
+
+    const char* opcode = Op_Type_str(op->op_type);
+    if (op->op_type == OP_CF) {
+        opcode = cf_type_names[op->cf_type];
+    }
+    i += sprintf(&buf[i], "%-8s ", opcode);
+
+    for (int j = 0; j < op->num_dest_regs; j++) {
+        i += sprintf(&buf[i], "r%u(%s)%s", op->dests[j], retired_reg_name(op->dests[j]),
+                     (j == op->num_dest_regs - 1) ? "" : ",");
+    }
+    if (op->num_dest_regs > 0 && op->num_src_regs > 0) {
+        i += sprintf(&buf[i], " <- ");
+    }
+    for (int j = 0; j < op->num_src_regs; j++) {
+        i += sprintf(&buf[i], "r%u(%s)%s", op->srcs[j], retired_reg_name(op->srcs[j]),
+                     (j == op->num_src_regs - 1) ? "" : ",");
+    }
+    if ((op->mem_type == MEM_LD || op->mem_type == MEM_ST) && op->mem_size > 0) {
+        i += sprintf(&buf[i], " %d@%08llx", op->mem_size, op->va);
+    }
+    buf[i] = '\0';
+    return buf;
+}
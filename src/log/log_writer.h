@@ -0,0 +1,82 @@
+#ifndef __LOG_WRITER_H__
+#define __LOG_WRITER_H__
+
+#include <stdio.h>
+#include "globals/global_types.h"
+#include "../fill_buffer.h"
+
+/*
+ * Common output backend for the H2P analysis logs.
+ *
+ * In text mode (default) the writer is a FILE* with a large stdio buffer and the
+ * log functions format lines exactly as before. With H2P_LOG_BINARY the same
+ * calls produce a record stream instead:
+ *
+ *   file   := header record*
+ *   header := "SCRBH2PL" u32 version str log_name
+ *             u32 record_size u32 num_fields (str name, u32 offset, u32 size, u32 count)*
+ *             table(Op_Type) table(Cf_Type) table(Mem_Type) table(Reg)
+ *   table  := u32 n str*          str := u16 len bytes
+ *   record := u8 type u32 hdr_len hdr u32 num_ops Retired_Op_Record[num_ops]
+ *
+ * All integers are host (little) endian. Retired_Op_Records are copied raw and
+ * described by the field table, so the decoder never needs to know the C layout.
+ * utils/h2p_log_decode.py renders a binary log back to the text format.
+ */
+
+#define H2P_LOG_MAGIC   "SCRBH2PL"
+#define H2P_LOG_VERSION 1
+#define H2P_LOG_MAX_HDR 512
+
+typedef enum H2P_Log_Rec_Type_enum {
+    H2P_REC_TEXT = 1,           // hdr: 미리 포맷된 텍스트 (recovery 로그 등)
+    H2P_REC_FILL_ROB_OP,        // hdr: cycle, op_num, pc, off_path, cf 정보, disasm 필드
+    H2P_REC_RETIRED_COUNT,      // hdr: cycle, ret_count
+    H2P_REC_FILL_BUFFER,        // hdr: proc_id, cycle, size, count, head, tail + ops
+    H2P_REC_ON_OFF_PATH,        // hdr: proc_id, h2p pc, op_num + ops
+    H2P_REC_DEP_CHAIN,          // hdr: proc_id, cycle, h2p pc, op_num + ops
+    H2P_REC_DEP_BLOCK,          // hdr: proc_id, cycle, block pc, op_num, block len, mask + ops
+    H2P_REC_CACHE_DUMP_BEGIN,   // hdr: proc_id, cycle
+    H2P_REC_CACHE_DUMP_ENTRY,   // hdr: index, pc, op_num, block len, mask + ops
+    H2P_REC_CACHE_DUMP_END,     // hdr: 없음
+} H2P_Log_Rec_Type;
+
+typedef struct Log_Writer_struct {
+    FILE*  file;
+    Flag   binary;
+    char*  buf;                      // stdio 버퍼 (H2P_LOG_BUF_SIZE)
+    uns8   hdr[H2P_LOG_MAX_HDR];     // 현재 작성 중인 레코드 헤더
+    uns    hdr_len;
+    uns8   rec_type;
+} Log_Writer;
+
+/*
+ * @brief Opens <OUTPUT_DIR>/<name>.out (text) or <name>.bin (H2P_LOG_BINARY).
+ *        Returns NULL if the file could not be created.
+ */
+Log_Writer* log_writer_open(const char* name);
+void log_writer_close(Log_Writer* lw);
+
+/*
+ * @brief Appends formatted text. In binary mode the text becomes an H2P_REC_TEXT record.
+ */
+void log_writer_printf(Log_Writer* lw, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/*
+ * @brief Builds one binary record: begin, put_* header fields, end(num_ops), then
+ *        exactly num_ops Retired_Op_Records through one or more log_writer_ops calls.
+ */
+void log_writer_begin(Log_Writer* lw, H2P_Log_Rec_Type type);
+void log_writer_put_u8(Log_Writer* lw, uns8 val);
+void log_writer_put_u32(Log_Writer* lw, uns32 val);
+void log_writer_put_u64(Log_Writer* lw, uns64 val);
+void log_writer_end(Log_Writer* lw, uns num_ops);
+void log_writer_ops(Log_Writer* lw, const Retired_Op_Record* ops, uns num_ops);
+
+/*
+ * @brief Text-mode disassembly of a Retired_Op_Record (shared by the H2P logs).
+ *        Returns a static buffer.
+ */
+char* disasm_retired_op(const Retired_Op_Record* op);
+
+#endif // __LOG_WRITER_H__
@@ -2,86 +2,52 @@
 #include <stdlib.h>
 #include <string.h>
 #include "on_off_path_log.h"
+#include "log_writer.h"
 #include "../globals/utils.h"
-#include "../isa/isa.h"
-#include "../debug/debug_print.h" // Op_Type_str() 매크로를 위해 포함
 #include "debug/debug.param.h"
 
-extern char* OUTPUT_DIR;
-static FILE* on_off_path_log_file = NULL;
-
-#define REG(x) #x,
-static const char* reg_names[NUM_REGS] = {
-#include "../isa/x86_regs.def"
-};
-#undef REG
-
-static char* disasm_cached_op(Op* op) {
-    static char buf[512];
-    int i = 0;
-
-    const char* opcode = Op_Type_str(op->table_info->op_type);
-    if (op->table_info->op_type == OP_CF) {
-        opcode = cf_type_names[op->table_info->cf_type];
-    }
-    i += sprintf(&buf[i], "%-8s ", opcode);
-
-    for (int j = 0; j < op->table_info->num_dest_regs; j++) {
-        i += sprintf(&buf[i], "r%u(%s)%s", op->inst_info->dests[j].id, reg_names[op->inst_info->dests[j].id], (j == op->table_info->num_dest_regs - 1) ? "" : ",");
-    }
-    if (op->table_info->num_dest_regs > 0 && op->table_info->num_src_regs > 0) {
-        i += sprintf(&buf[i], " <- ");
-    }
-    for (int j = 0; j < op->table_info->num_src_regs; j++) {
-        i += sprintf(&buf[i], "r%u(%s)%s", op->inst_info->srcs[j].id, reg_names[op->inst_info->srcs[j].id], (j == op->table_info->num_src_regs - 1) ? "" : ",");
-    }
-    if (op->table_info->mem_type == MEM_LD && op->oracle_info.mem_size > 0) {
-      i += sprintf(&buf[i], " %d@%08llx", op->oracle_info.mem_size, op->oracle_info.va);
-    }
-    if (op->table_info->mem_type == MEM_ST && op->oracle_info.mem_size > 0) {
-      i += sprintf(&buf[i], " %d@%08llx", op->oracle_info.mem_size, op->oracle_info.va);
-    }
-    buf[i] = '\0';
-    return buf;
-}
-
-static void close_on_off_path_log(void) {
-    if (on_off_path_log_file) fclose(on_off_path_log_file);
-}
+static Log_Writer* on_off_path_log = NULL;
 
 void init_on_off_path_log(void) {
-    if (on_off_path_log_file == NULL) {
-        on_off_path_log_file = file_tag_fopen(OUTPUT_DIR, "on_off_path", "w");
-        if (on_off_path_log_file) atexit(close_on_off_path_log);
-    }
+    if (on_off_path_log == NULL)
+        on_off_path_log = log_writer_open("on_off_path");
 }
 
 void finalize_on_off_path_log(void) {
-    close_on_off_path_log();
+    log_writer_close(on_off_path_log);
 }
 
 void log_on_off_path_entry(uns proc_id, On_Off_Path_Cache_Entry* entry, Counter cycle_count) {
-    if (!on_off_path_log_file || !entry || !entry->is_valid||
+    if (!on_off_path_log || !entry || !entry->is_valid||
         !(cycle_count >= DEBUG_CYCLE_START && cycle_count <= DEBUG_CYCLE_STOP)) return;
 
-    fprintf(on_off_path_log_file, "--- [LOG] On-Off Path for Core %u ---\n", proc_id);
-    fprintf(on_off_path_log_file, "Triggering H2P Branch PC: 0x%llx, OpNum: %llu, Path Length: %u\n",
+    if (on_off_path_log->binary) {
+        log_writer_begin(on_off_path_log, H2P_REC_ON_OFF_PATH);
+        log_writer_put_u32(on_off_path_log, proc_id);
+        log_writer_put_u64(on_off_path_log, entry->h2p_branch_pc);
+        log_writer_put_u64(on_off_path_log, entry->h2p_branch_op_num);
+        log_writer_end(on_off_path_log, entry->path_length);
+        log_writer_ops(on_off_path_log, entry->path, entry->path_length);
+        return;
+    }
+
+    log_writer_printf(on_off_path_log, "--- [LOG] On-Off Path for Core %u ---\n", proc_id);
+    log_writer_printf(on_off_path_log, "Triggering H2P Branch PC: 0x%llx, OpNum: %llu, Path Length: %u\n",
             entry->h2p_branch_pc, entry->h2p_branch_op_num, entry->path_length);
-    fprintf(on_off_path_log_file, "------------------------------------------------------------------\n");
+    log_writer_printf(on_off_path_log, "------------------------------------------------------------------\n");
 
     for (int i = 0; i < entry->path_length; ++i) {
-        Op* op = &entry->path[i];
-        char* disasm_str = disasm_cached_op(op);
-        fprintf(on_off_path_log_file, "[PC: 0x%08llx] OpNum:%-10llu (S/E/D/R: %-4llu/%-4llu/%-4llu/%-4llu) H2p:%s Disasm: %-45s\n",
-            op->inst_info->addr, 
+        Retired_Op_Record* op = &entry->path[i];
+        char* disasm_str = disasm_retired_op(op);
+        log_writer_printf(on_off_path_log, "[PC: 0x%08llx] OpNum:%-10llu (S/E/D/R: %-4llu/%-4llu/%-4llu/%-4llu) H2p:%s Disasm: %-45s\n",
+            op->pc, 
             op->op_num,
             op->sched_cycle,
             op->exec_cycle,
             op->done_cycle,
             op->retire_cycle,
-            op->oracle_info.hbt_pred_is_hard ? "O" : "X", 
+            op->h2p ? "O" : "X", 
             disasm_str);
     }
-    fprintf(on_off_path_log_file, "-------------------------- END LOG ---------------------------\n\n");
-    fflush(on_off_path_log_file);
+    log_writer_printf(on_off_path_log, "-------------------------- END LOG ---------------------------\n\n");
 }
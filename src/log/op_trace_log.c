@@ -10,49 +10,73 @@
 #include "bp/bp_conf.h"
 #include "bp/hbt.h"
 
-static FILE* op_asm_log_file = NULL;
-FILE* retired_op_log_file = NULL;
-extern char* OUTPUT_DIR;
+static Log_Writer* op_asm_log = NULL;
+Log_Writer* retired_op_log = NULL;
 
 void close_op_asm_log_file(void) {
-    if (op_asm_log_file) {
-        fclose(op_asm_log_file);
-        op_asm_log_file = NULL;
-    }
+    log_writer_close(op_asm_log);
 }
 
 void close_retired_op_log_file(void) {
-    if (retired_op_log_file) {
-        fclose(retired_op_log_file);
-        retired_op_log_file = NULL;
-    }
+    log_writer_close(retired_op_log);
 }
 
 void init_op_trace_log(void) {
-    if (op_asm_log_file == NULL) {
-        op_asm_log_file = file_tag_fopen(OUTPUT_DIR, "fill_rob_op_per_cycle", "w");
-        if (op_asm_log_file == NULL) {
-            perror("Error opening fill_rob_op_per_cycle in output directory");
-        } else {
-            atexit(close_op_asm_log_file);
-        }
+    if (op_asm_log == NULL)
+        op_asm_log = log_writer_open("fill_rob_op_per_cycle");
+    if (retired_op_log == NULL)
+        retired_op_log = log_writer_open("retired_op_per_cycle");
+}
+
+static uns8 mispred_type(Op* op) {
+    return op->oracle_info.mispred ? 1 : (op->oracle_info.misfetch ? 2 : 0);
+}
+
+// disasm_op(op, TRUE)를 만드는 데 필요한 필드만 기록하고 문자열은 디코더가 만든다.
+static void put_fill_rob_op(Op* op, Counter cycle_count) {
+    log_writer_begin(op_asm_log, H2P_REC_FILL_ROB_OP);
+    log_writer_put_u64(op_asm_log, cycle_count);
+    log_writer_put_u64(op_asm_log, op->op_num);
+    log_writer_put_u64(op_asm_log, op->inst_info->addr);
+    log_writer_put_u8(op_asm_log, op->off_path);
+    log_writer_put_u8(op_asm_log, op->table_info->cf_type != NOT_CF);
+    if (op->table_info->cf_type) {
+        log_writer_put_u8(op_asm_log, op->oracle_info.hbt_pred_is_hard);
+        log_writer_put_u32(op_asm_log, op->oracle_info.hbt_misp_counter);
+        log_writer_put_u8(op_asm_log, mispred_type(op));
+        log_writer_put_u64(op_asm_log, op->oracle_info.npc);
+        log_writer_put_u8(op_asm_log, op->oracle_info.dir);
+        log_writer_put_u64(op_asm_log, op->oracle_info.pred_npc);
+        log_writer_put_u8(op_asm_log, op->oracle_info.pred);
     }
-    if (retired_op_log_file == NULL) {
-        retired_op_log_file = file_tag_fopen(OUTPUT_DIR, "retired_op_per_cycle", "w");
-        if (retired_op_log_file == NULL) {
-            perror("Error opening retired_op_per_cycle in output directory");
-        } else {
-            atexit(close_retired_op_log_file);
-        }
+    log_writer_put_u8(op_asm_log, op->table_info->op_type);
+    log_writer_put_u8(op_asm_log, op->table_info->cf_type);
+    log_writer_put_u8(op_asm_log, op->table_info->mem_type);
+    log_writer_put_u8(op_asm_log, op->table_info->num_dest_regs);
+    log_writer_put_u8(op_asm_log, op->table_info->num_src_regs);
+    for (int j = 0; j < op->table_info->num_dest_regs; j++) {
+        log_writer_put_u8(op_asm_log, op->inst_info->dests[j].id);
+        log_writer_put_u32(op_asm_log, op->dst_reg_id[j][REG_TABLE_TYPE_PHYSICAL]);
+    }
+    for (int j = 0; j < op->table_info->num_src_regs; j++) {
+        log_writer_put_u8(op_asm_log, op->inst_info->srcs[j].id);
+        log_writer_put_u32(op_asm_log, op->src_reg_id[j][REG_TABLE_TYPE_PHYSICAL]);
     }
+    log_writer_put_u32(op_asm_log, op->oracle_info.mem_size);
+    log_writer_put_u64(op_asm_log, op->oracle_info.va);
+    log_writer_end(op_asm_log, 0);
 }
 
 void log_fill_rob_op(Op* op, Counter cycle_count) {
-    if (op_asm_log_file && cycle_count >= DEBUG_CYCLE_START && cycle_count <= DEBUG_CYCLE_STOP) {
+    if (op_asm_log && cycle_count >= DEBUG_CYCLE_START && cycle_count <= DEBUG_CYCLE_STOP) {
+        if (op_asm_log->binary) {
+            put_fill_rob_op(op, cycle_count);
+            return;
+        }
         const char* disasm_str = disasm_op(op, TRUE);
         if (op->table_info->cf_type) {
 
-            fprintf(op_asm_log_file, "Cycle:%-10llu OpNum:%-10llu PC:0x%-10llx OffPath:%d Disasm: %-80s H2P:%s HBT_CTR:%-3u Mispred_Type:%-4s Target:0x%-10llx Dir:%d PredNPC:0x%llx Pred:%d\n",
+            log_writer_printf(op_asm_log, "Cycle:%-10llu OpNum:%-10llu PC:0x%-10llx OffPath:%d Disasm: %-80s H2P:%s HBT_CTR:%-3u Mispred_Type:%-4s Target:0x%-10llx Dir:%d PredNPC:0x%llx Pred:%d\n",
                     cycle_count,
                     op->op_num,
                     op->inst_info->addr,
@@ -66,22 +90,27 @@ void log_fill_rob_op(Op* op, Counter cycle_count) {
                     op->oracle_info.pred_npc,
                     op->oracle_info.pred);
         } else {
-            fprintf(op_asm_log_file, "Cycle:%-10llu OpNum:%-10llu PC:0x%-10llx OffPath:%d Disasm: %-60s\n",
+            log_writer_printf(op_asm_log, "Cycle:%-10llu OpNum:%-10llu PC:0x%-10llx OffPath:%d Disasm: %-60s\n",
                     cycle_count,
                     op->op_num,
                     op->inst_info->addr,
                     op->off_path,
                     disasm_str);
         }
-        fflush(op_asm_log_file);
     }
 }
 
 void log_retired_ops(Counter cycle_count, uns ret_count) {
-    if (retired_op_log_file && cycle_count >= DEBUG_CYCLE_START && cycle_count <= DEBUG_CYCLE_STOP) {
+    if (retired_op_log && cycle_count >= DEBUG_CYCLE_START && cycle_count <= DEBUG_CYCLE_STOP) {
         if (ret_count > 0) {
-            fprintf(retired_op_log_file, "Cycle:%-10llu Retired Ops: %u\n", cycle_count, ret_count);
-            fflush(retired_op_log_file);
+            if (retired_op_log->binary) {
+                log_writer_begin(retired_op_log, H2P_REC_RETIRED_COUNT);
+                log_writer_put_u64(retired_op_log, cycle_count);
+                log_writer_put_u32(retired_op_log, ret_count);
+                log_writer_end(retired_op_log, 0);
+            } else {
+                log_writer_printf(retired_op_log, "Cycle:%-10llu Retired Ops: %u\n", cycle_count, ret_count);
+            }
         }
     }
 }
@@ -3,9 +3,9 @@
 
 #include "globals/global_types.h"
 #include "op.h"
-#include <stdio.h>
+#include "log_writer.h"
 
-extern FILE* retired_op_log_file;
+extern Log_Writer* retired_op_log;
 
 /*
  * @brief Initializes the op trace logger.
@@ -4,6 +4,7 @@
 #include "op.h"
 #include "node_stage.h"
 #include "bp/bp.h"
+#include "log_writer.h"
 
 /*
  * @brief Initializes the recovery logger. Opens the log file.
@@ -13,7 +14,7 @@ void init_recovery_log(void);
 
 
 
-void log_rat_state(FILE* log_file, const char* title, struct reg_table_entry* arch_entries, uns arch_size, struct reg_table_entry* physical_entries, uns physical_size);
+void log_rat_state(Log_Writer* lw, const char* title, struct reg_table_entry* arch_entries, uns arch_size, struct reg_table_entry* physical_entries, uns physical_size);
 /*
  * @brief Logs information at the time a misprediction is detected.
  *
@@ -94,6 +94,7 @@ Scarab's source code is organized as follows:
     + cmp_model.h
     + cmp_model_support.h
     + dumb_model.h
+    + bp_model.h
 
   + Cores
 
@@ -215,6 +216,7 @@ Scarab's source code is organized as follows:
 #include "optimizer2.h"
 #include "param_parser.h"
 #include "sim.h"
+#include "simprof.h"
 #include "statistics.h"
 #include "version.h"
 
@@ -256,6 +258,8 @@ int main(int argc, char* argv[], char* envp[]) {
 
   /* set up signal handler for SIGINT */
   signal(SIGINT, handle_SIGINT);
+  /* SIGUSR1 toggles self-profiling (SIMPROF) */
+  signal(SIGUSR1, simprof_handle_signal);
 
   /* print startup messages */
   time(&cur_time);
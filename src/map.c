@@ -55,7 +55,10 @@
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_MAP, ##args)
 //#define DEBUGU(proc_id, args...) _DEBUGU(proc_id, DEBUG_MAP, ##args)
 
-#define WAKE_UP_ENTRIES_INC 256 /* default 256 */
+#define WAKE_UP_ENTRIES_INC 256 /* default 256, entries added to a size class at a time (at least one block) */
+#define WAKE_UP_MIN_CAPACITY 4  /* entries in the smallest wake up list block */
+/* a free block links to the next free block of its size class through its first word */
+#define WAKE_UP_BLOCK_NEXT(block) (*(Wake_Up_Entry**)(block))
 #define MEM_ADDR_SRC 0          /* address for memory instructions calculated off source 0 */
 
 #define MEM_MAP_ENTRY_SIZE_LOG 3
@@ -112,7 +115,10 @@ static inline void read_reg_map(Op*);
 static inline void read_store_map(Op*);
 static inline void update_map(Op*);
 
-static inline void expand_wake_up_entries(void);
+static inline void expand_wake_up_entries(uns size_class);
+static inline Wake_Up_Entry* alloc_wake_up_block(uns size_class);
+static inline void free_wake_up_block(Wake_Up_Entry* block, uns capacity);
+static inline uns wake_up_size_class(uns capacity);
 static inline void update_store_hash(Op* op);
 static inline Op* add_store_deps(Op* op);
 static inline void update_map_entry(Op* op, Map_Entry* map_entry);
@@ -158,8 +164,8 @@ void init_map(uns8 proc_id) {
   map_data->last_store[1].op = &invalid_op;
   map_data->last_store[1].op_num = 0;
 
-  /* Allocate the wake_up_entry pool. */
-  expand_wake_up_entries();
+  /* Allocate the wake_up_entry pool for the smallest lists, the others are allocated on demand */
+  expand_wake_up_entries(0);
 
   /* Initialize the memory dependence hash table. The number of
      buckets matters since we scan all entries (and all buckets) on
@@ -221,19 +227,58 @@ void rebuild_offpath_map() {
 }
 
 /**************************************************************************************/
-/* expand_wake_up_pool: */
+/* expand_wake_up_pool: carves a new chunk into free blocks of one size class */
 
-static inline void expand_wake_up_entries() {
-  Wake_Up_Entry* new_pool = (Wake_Up_Entry*)calloc(WAKE_UP_ENTRIES_INC, sizeof(Wake_Up_Entry));
+static inline void expand_wake_up_entries(uns size_class) {
+  uns capacity = WAKE_UP_MIN_CAPACITY << size_class;
+  uns num_blocks = MAX2(WAKE_UP_ENTRIES_INC / capacity, 1);
+  Wake_Up_Entry* new_pool = (Wake_Up_Entry*)calloc(num_blocks * capacity, sizeof(Wake_Up_Entry));
   uns ii;
 
-  //DEBUGU(map_data->proc_id, "Expanding wake up pool to size %d\n", (map_data->wake_up_entries + WAKE_UP_ENTRIES_INC));
-  for (ii = 0; ii < WAKE_UP_ENTRIES_INC - 1; ii++)
-    new_pool[ii].next = &new_pool[ii + 1];
-  new_pool[ii].next = map_data->free_list_head;
-  map_data->free_list_head = &new_pool[0];
-  map_data->wake_up_entries += WAKE_UP_ENTRIES_INC;
-  ASSERT(map_data->proc_id, map_data->wake_up_entries <= WAKE_UP_ENTRIES_INC * 128);
+  ASSERT(map_data->proc_id, new_pool);
+  //DEBUGU(map_data->proc_id, "Expanding wake up pool to size %d\n", (map_data->wake_up_entries + num_blocks * capacity));
+  for (ii = 0; ii < num_blocks; ii++) {
+    Wake_Up_Entry* block = &new_pool[ii * capacity];
+    WAKE_UP_BLOCK_NEXT(block) = map_data->wake_up_free_blocks[size_class];
+    map_data->wake_up_free_blocks[size_class] = block;
+  }
+  map_data->wake_up_entries += num_blocks * capacity;
+  ASSERT(map_data->proc_id, map_data->wake_up_entries <= WAKE_UP_ENTRIES_INC * 1024);
+}
+
+/**************************************************************************************/
+/* wake_up_size_class: size class of a block holding capacity entries */
+
+static inline uns wake_up_size_class(uns capacity) {
+  uns size_class = __builtin_ctz(capacity / WAKE_UP_MIN_CAPACITY);
+  ASSERT(map_data->proc_id, size_class < WAKE_UP_NUM_CLASSES && capacity == WAKE_UP_MIN_CAPACITY << size_class);
+  return size_class;
+}
+
+/**************************************************************************************/
+/* alloc_wake_up_block: */
+
+static inline Wake_Up_Entry* alloc_wake_up_block(uns size_class) {
+  Wake_Up_Entry* block;
+
+  ASSERTM(map_data->proc_id, size_class < WAKE_UP_NUM_CLASSES, "wake up list longer than %u entries\n",
+          WAKE_UP_MIN_CAPACITY << (WAKE_UP_NUM_CLASSES - 1));
+  if (map_data->wake_up_free_blocks[size_class] == NULL)
+    expand_wake_up_entries(size_class);
+
+  block = map_data->wake_up_free_blocks[size_class];
+  map_data->wake_up_free_blocks[size_class] = WAKE_UP_BLOCK_NEXT(block);
+  return block;
+}
+
+/**************************************************************************************/
+/* free_wake_up_block: */
+
+static inline void free_wake_up_block(Wake_Up_Entry* block, uns capacity) {
+  uns size_class = wake_up_size_class(capacity);
+
+  WAKE_UP_BLOCK_NEXT(block) = map_data->wake_up_free_blocks[size_class];
+  map_data->wake_up_free_blocks[size_class] = block;
 }
 
 /**************************************************************************************/
@@ -531,7 +576,7 @@ static inline void update_store_hash(Op* op) {
 /* wake_up_ops: */
 
 void wake_up_ops(Op* op, Dep_Type type, void (*wake_action)(Op*, Op*, uns8)) {
-  Wake_Up_Entry* temp;
+  uns ii;
 
   _DEBUG(op->proc_id, DEBUG_REPLAY, "Waking up ops from src_op:%s unique:%s type:%s\n", unsstr64(op->op_num),
          unsstr64(op->unique_num), dep_type_names[type]);
@@ -542,31 +587,26 @@ void wake_up_ops(Op* op, Dep_Type type, void (*wake_action)(Op*, Op*, uns8)) {
   reg_file_produce(op);
 
   ASSERT(op->proc_id, wake_action);
-  for (temp = op->wake_up_head; temp; temp = temp->next) {
+  /* index the list on every iteration, a wake action may not keep a pointer into it */
+  for (ii = 0; ii < op->wake_up_count; ii++) {
+    Wake_Up_Entry* temp = &op->wake_up_list[ii];
     Op* dep_op = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-    ASSERT(op->proc_id, dep_op);
 
     if (temp->dep_type != type)
       continue;
-    /* if the stored unique num is not the same as the op pool entry, the op has
-           been reclaimed and the wake up should be ignored */
-    if (dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      ASSERTM(op->proc_id, op->proc_id == dep_op->proc_id, "dep_op proc_id: %u, valid: %u\n", dep_op->proc_id,
-              dep_op->op_pool_valid);
-      if (test_not_rdy_bit(dep_op, temp->rdy_bit)) {
-        DEBUG(dep_op->proc_id, "Waking up  op_num:%s\n", unsstr64(dep_op->op_num));
-
-        ASSERTM(dep_op->proc_id, test_not_rdy_bit(dep_op, temp->rdy_bit), "dep_op_num:%s  not_rdy_vector:%x\n",
-                unsstr64(dep_op->op_num), dep_op->srcs_not_rdy_vector);
-
-        /* unset the not ready bit for this source */
-        clear_not_rdy_bit(dep_op, temp->rdy_bit);
-
-        /* call the wake action function */
-        wake_action(op, dep_op, temp->rdy_bit);
-      }
+    /* entries of reclaimed ops are removed at recovery (recover_wake_up_lists), so
+       every entry here is a live consumer */
+    ASSERTD(op->proc_id, dep_op);
+    ASSERTD(op->proc_id, dep_op->unique_num == temp->unique_num && dep_op->op_pool_valid);
+    ASSERTD(op->proc_id, op->proc_id == dep_op->proc_id);
+    if (test_not_rdy_bit(dep_op, temp->rdy_bit)) {
+      DEBUG(dep_op->proc_id, "Waking up  op_num:%s\n", unsstr64(dep_op->op_num));
+
+      /* unset the not ready bit for this source */
+      clear_not_rdy_bit(dep_op, temp->rdy_bit);
+
+      /* call the wake action function */
+      wake_action(op, dep_op, temp->rdy_bit);
     }
   }
   op->wake_up_signaled[type] = TRUE;
@@ -600,34 +640,29 @@ void add_to_wake_up_lists(Op* op, Op_Info* op_info, void (*wake_action)(Op*, Op*
               "op num: %llu fetch: %llu, src_op num: %llu unique: %llu fetch: %llu\n", op->op_num, op->fetch_cycle,
               src_op->op_num, src_op->unique_num, src_op->fetch_cycle);
 
-      if (map_data->free_list_head == NULL) {
-        ASSERT(map_data->proc_id, map_data->active_wake_up_entries == map_data->wake_up_entries);
-        expand_wake_up_entries();
+      /* a full list moves to a block of twice the size */
+      if (src_op->wake_up_count == src_op->wake_up_capacity) {
+        uns capacity = src_op->wake_up_capacity ? 2 * src_op->wake_up_capacity : WAKE_UP_MIN_CAPACITY;
+        Wake_Up_Entry* block = alloc_wake_up_block(wake_up_size_class(capacity));
+
+        if (src_op->wake_up_list) {
+          memcpy(block, src_op->wake_up_list, src_op->wake_up_count * sizeof(Wake_Up_Entry));
+          free_wake_up_block(src_op->wake_up_list, src_op->wake_up_capacity);
+        }
+        src_op->wake_up_list = block;
+        src_op->wake_up_capacity = capacity;
       }
 
       if (src_info->type == MEM_DATA_DEP)
         dep_on_in_window_store = TRUE;
 
-      wake = map_data->free_list_head;
+      wake = &src_op->wake_up_list[src_op->wake_up_count++];
       map_data->active_wake_up_entries++;
-      map_data->free_list_head = wake->next;
 
       wake->op = op;
       wake->unique_num = op->unique_num;
       wake->dep_type = src_info->type;
       wake->rdy_bit = ii;
-      wake->next = NULL;
-
-      if (src_op->wake_up_tail == NULL) {
-        src_op->wake_up_head = wake;
-        src_op->wake_up_tail = wake;
-        src_op->wake_up_count = 1;
-      } else {
-        ASSERT(map_data->proc_id, src_op->wake_up_head);
-        src_op->wake_up_tail->next = wake;
-        src_op->wake_up_tail = wake;
-        src_op->wake_up_count++;
-      }
 
       if (TRACK_L1_MISS_DEPS) {
         // An op can occupy multiple entries in the wakeup list of another op
@@ -660,20 +695,47 @@ void free_wake_up_list(Op* op) {
   ASSERT(map_data->proc_id, op);
   ASSERT(map_data->proc_id, op->proc_id == map_data->proc_id);
 
-  if (op->wake_up_tail) {
-    ASSERT(map_data->proc_id, op->wake_up_head);
+  if (op->wake_up_list) {
     DEBUG(map_data->proc_id, "Freeing wake up list for op_num:%s\n", unsstr64(op->op_num));
-    op->wake_up_tail->next = map_data->free_list_head;
-    map_data->free_list_head = op->wake_up_head;
+    free_wake_up_block(op->wake_up_list, op->wake_up_capacity);
+    ASSERT(map_data->proc_id, map_data->active_wake_up_entries >= op->wake_up_count);
     map_data->active_wake_up_entries -= op->wake_up_count;
-    ASSERT(map_data->proc_id, map_data->active_wake_up_entries >= 0);
-    op->wake_up_head = NULL;
-    op->wake_up_tail = NULL;
+    op->wake_up_list = NULL;
+    op->wake_up_count = 0;
+    op->wake_up_capacity = 0;
   } else {
     DEBUG(map_data->proc_id, "No wake up list for op_num:%s\n", unsstr64(op->op_num));
   }
 }
 
+/**************************************************************************************/
+/* recover_wake_up_lists: drops the flushed consumers (younger than op_num) from
+   the wake up lists of the ops that stay in the machine. Called after the
+   sequential op list is recovered and before the flushed ops are freed, so
+   wake_up_ops() never has to check an entry for staleness. */
+
+void recover_wake_up_lists(Counter op_num) {
+  Op** op_p;
+
+  ASSERT(map_data->proc_id, map_data->proc_id == td->proc_id);
+  for (op_p = (Op**)list_start_head_traversal(&td->seq_op_list); op_p;
+       op_p = (Op**)list_next_element(&td->seq_op_list)) {
+    Op* op = *op_p;
+    uns ii, kept = 0;
+
+    for (ii = 0; ii < op->wake_up_count; ii++) {
+      Wake_Up_Entry* temp = &op->wake_up_list[ii];
+      Op* dep_op = temp->op;
+
+      if (dep_op->op_pool_valid && dep_op->unique_num == temp->unique_num && dep_op->op_num <= op_num)
+        op->wake_up_list[kept++] = *temp;
+    }
+    ASSERT(map_data->proc_id, map_data->active_wake_up_entries >= op->wake_up_count - kept);
+    map_data->active_wake_up_entries -= op->wake_up_count - kept;
+    op->wake_up_count = kept;
+  }
+}
+
 /**************************************************************************************/
 /* add_src_from_op: . */
 
@@ -35,6 +35,11 @@
 #include "map_rename.h"
 #include "op.h"
 
+/**************************************************************************************/
+/* Defines */
+
+#define WAKE_UP_NUM_CLASSES 16 /* wake up list blocks hold WAKE_UP_MIN_CAPACITY << 0..15 entries */
+
 /**************************************************************************************/
 /* Types */
 
@@ -55,9 +60,9 @@ typedef struct Map_Data_struct {
 
   Hash_Table oracle_mem_hash;
 
-  Wake_Up_Entry* free_list_head;
-  uns wake_up_entries;
-  uns active_wake_up_entries;
+  Wake_Up_Entry* wake_up_free_blocks[WAKE_UP_NUM_CLASSES];  // free wake up list blocks, by size class
+  uns wake_up_entries;                                      // entries in all blocks, free or not
+  uns active_wake_up_entries;                               // entries holding a consumer
 
   /* register files for INT/FP with arch/physical tables */
   Reg_File* reg_file[REG_FILE_REG_TYPE_NUM];
@@ -80,6 +85,7 @@ void map_op(Op*);
 void map_mem_dep(Op*);
 void wake_up_ops(Op*, Dep_Type, void (*)(Op*, Op*, uns8));
 void free_wake_up_list(Op*);
+void recover_wake_up_lists(Counter);
 void add_to_wake_up_lists(Op*, Op_Info*, void (*)(Op*, Op*, uns8));
 
 void add_src_from_op(Op*, Op*, Dep_Type);
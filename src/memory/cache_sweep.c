@@ -0,0 +1,250 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/***************************************************************************************
+ * File         : memory/cache_sweep.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Single-pass miss rates of many sizes and associativities of one
+ *                cache level.
+ *
+ * Every access of the swept level (--cache_sweep_level) is looked up in per-set
+ * LRU stacks of line addresses. All configurations with the same number of sets
+ * share one group of stacks, as deep as their largest associativity: an access
+ * found at stack distance d hits in every configuration of the group with more
+ * than d ways (Mattson's stack algorithm), so one pass gives the misses of all of
+ * them. The stacks see the access stream of the modeled cache, which does not
+ * change with the swept configurations.
+ ***************************************************************************************/
+
+#include "memory/cache_sweep.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define CACHE_SWEEP_MAX_SIZES 64
+#define CACHE_SWEEP_MAX_ASSOCS 32
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Cache_Sweep_Group_struct {
+  uns num_sets;
+  uns depth;       // largest associativity of the group's configurations
+  uns* num_valid;  // [stack][set] valid lines of each LRU stack
+  Addr* lines;     // [stack][set][depth] line addresses, MRU first
+  Counter* hits;   // [proc_id][depth] hits at each LRU stack distance
+} Cache_Sweep_Group;
+
+typedef struct Cache_Sweep_Config_struct {
+  uns size;
+  uns assoc;
+  Cache_Sweep_Group* group;
+} Cache_Sweep_Config;
+
+/**************************************************************************************/
+/* Global variables */
+
+static Cache_Sweep_Group* groups;
+static uns num_groups;
+static Cache_Sweep_Config* configs;
+static uns num_configs;
+static uns line_size;
+static Flag shared;        // one set of stacks for all cores
+static Counter* accesses;  // [proc_id]
+
+DEFINE_ENUM(Cache_Sweep_Level, CACHE_SWEEP_LEVEL_LIST);
+
+/**************************************************************************************/
+/* Static prototypes */
+
+static Cache_Sweep_Group* cache_sweep_get_group(uns num_sets);
+static void cache_sweep_update(uns proc_id, Addr addr, Flag count);
+
+/**************************************************************************************/
+/* cache_sweep_init: */
+
+void cache_sweep_init() {
+  if (CACHE_SWEEP_LEVEL == CACHE_SWEEP_LEVEL_NONE)
+    return;
+
+  switch (CACHE_SWEEP_LEVEL) {
+    case CACHE_SWEEP_LEVEL_DCACHE:
+      line_size = DCACHE_LINE_SIZE;
+      shared = FALSE;
+      break;
+    case CACHE_SWEEP_LEVEL_MLC:
+      line_size = MLC_LINE_SIZE;
+      shared = TRUE;  // the MLC is shared by all cores (see init_uncores)
+      break;
+    case CACHE_SWEEP_LEVEL_LLC:
+      line_size = L1_LINE_SIZE;
+      shared = !PRIVATE_L1;
+      break;
+    default:
+      FATAL_ERROR(0, "Unknown cache sweep level %s\n", Cache_Sweep_Level_str(CACHE_SWEEP_LEVEL));
+  }
+  ASSERTM(0, line_size && !(line_size & (line_size - 1)), "The line size of the swept cache must be a power of 2\n");
+  ASSERTM(0, CACHE_SWEEP_SIZES, "--cache_sweep_sizes is needed with --cache_sweep_level\n");
+
+  uns sizes[CACHE_SWEEP_MAX_SIZES];
+  uns assocs[CACHE_SWEEP_MAX_ASSOCS];
+  uns num_sizes = parse_uns_array(sizes, CACHE_SWEEP_SIZES, CACHE_SWEEP_MAX_SIZES);
+  uns num_assocs = parse_uns_array(assocs, CACHE_SWEEP_ASSOCS, CACHE_SWEEP_MAX_ASSOCS);
+
+  groups = (Cache_Sweep_Group*)calloc(num_sizes * num_assocs, sizeof(Cache_Sweep_Group));
+  configs = (Cache_Sweep_Config*)calloc(num_sizes * num_assocs, sizeof(Cache_Sweep_Config));
+  for (uns ii = 0; ii < num_sizes; ii++) {
+    for (uns jj = 0; jj < num_assocs; jj++) {
+      uns size = sizes[ii];
+      uns assoc = assocs[jj];
+      ASSERTM(0, assoc && size && size % (line_size * assoc) == 0,
+              "Cache sweep size %u is not a multiple of %u ways of %u B lines\n", size, assoc, line_size);
+      uns num_sets = size / (line_size * assoc);
+      ASSERTM(0, !(num_sets & (num_sets - 1)), "Cache sweep size %u with %u ways has %u sets, not a power of 2\n", size,
+              assoc, num_sets);
+
+      Cache_Sweep_Config* config = &configs[num_configs++];
+      config->size = size;
+      config->assoc = assoc;
+      config->group = cache_sweep_get_group(num_sets);
+      config->group->depth = MAX2(config->group->depth, assoc);
+    }
+  }
+
+  uns num_stacks = shared ? 1 : NUM_CORES;
+  for (uns ii = 0; ii < num_groups; ii++) {
+    Cache_Sweep_Group* group = &groups[ii];
+    group->num_valid = (uns*)calloc(num_stacks * group->num_sets, sizeof(uns));
+    group->lines = (Addr*)malloc(sizeof(Addr) * num_stacks * group->num_sets * group->depth);
+    group->hits = (Counter*)calloc(NUM_CORES * group->depth, sizeof(Counter));
+    ASSERTM(0, group->num_valid && group->lines && group->hits, "Could not allocate the cache sweep stacks\n");
+  }
+  accesses = (Counter*)calloc(NUM_CORES, sizeof(Counter));
+}
+
+/**************************************************************************************/
+/* cache_sweep_get_group: the group of configurations with num_sets sets */
+
+static Cache_Sweep_Group* cache_sweep_get_group(uns num_sets) {
+  for (uns ii = 0; ii < num_groups; ii++) {
+    if (groups[ii].num_sets == num_sets)
+      return &groups[ii];
+  }
+  groups[num_groups].num_sets = num_sets;
+  return &groups[num_groups++];
+}
+
+/**************************************************************************************/
+/* cache_sweep_access: */
+
+void cache_sweep_access(Cache_Sweep_Level level, uns proc_id, Addr addr) {
+  if (level == CACHE_SWEEP_LEVEL)
+    cache_sweep_update(proc_id, addr, TRUE);
+}
+
+/**************************************************************************************/
+/* cache_sweep_warmup: */
+
+void cache_sweep_warmup(Cache_Sweep_Level level, uns proc_id, Addr addr) {
+  if (level == CACHE_SWEEP_LEVEL)
+    cache_sweep_update(proc_id, addr, FALSE);
+}
+
+/**************************************************************************************/
+/* cache_sweep_update: moves the line to the MRU position of its stack in every
+   group, counting the stack distance it was found at */
+
+static void cache_sweep_update(uns proc_id, Addr addr, Flag count) {
+  Addr line_addr = addr >> LOG2(line_size);
+  uns stack = shared ? 0 : proc_id;
+
+  if (count)
+    accesses[proc_id]++;
+  for (uns ii = 0; ii < num_groups; ii++) {
+    Cache_Sweep_Group* group = &groups[ii];
+    uns set = stack * group->num_sets + (line_addr & (group->num_sets - 1));
+    Addr* lines = &group->lines[(Counter)set * group->depth];
+    uns pos = 0;
+
+    while (pos < group->num_valid[set] && lines[pos] != line_addr)
+      pos++;
+    if (pos < group->num_valid[set]) {
+      if (count)
+        group->hits[proc_id * group->depth + pos]++;
+    } else if (group->num_valid[set] < group->depth) {
+      group->num_valid[set]++;
+    } else {
+      pos = group->depth - 1;  // miss in every configuration, drop the LRU line
+    }
+    memmove(&lines[1], &lines[0], pos * sizeof(Addr));
+    lines[0] = line_addr;
+  }
+}
+
+/**************************************************************************************/
+/* cache_sweep_done: writes cache_sweep.out */
+
+void cache_sweep_done() {
+  if (CACHE_SWEEP_LEVEL == CACHE_SWEEP_LEVEL_NONE)
+    return;
+
+  char file_name[MAX_STR_LENGTH + 1];
+  snprintf(file_name, MAX_STR_LENGTH, "%s/%s%s", OUTPUT_DIR, FILE_TAG, "cache_sweep.out");
+  FILE* file = fopen(file_name, "w");
+  ASSERTM(0, file, "Could not open %s\n", file_name);
+
+  fprintf(file, "Level: %s  Line size: %u  %s\n\n", Cache_Sweep_Level_str(CACHE_SWEEP_LEVEL), line_size,
+          shared ? "Shared by all cores" : "Private to each core");
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    double kinsts = inst_count[proc_id] / 1000.0;
+
+    fprintf(file, "Core %u\n", proc_id);
+    fprintf(file, "Insts:     %12llu\n", inst_count[proc_id]);
+    fprintf(file, "Accesses:  %12llu\n\n", accesses[proc_id]);
+    fprintf(file, "%12s %6s %8s %14s %10s %10s\n", "Size", "Assoc", "Sets", "Misses", "Miss rate", "MPKI");
+    for (uns ii = 0; ii < num_configs; ii++) {
+      Cache_Sweep_Config* config = &configs[ii];
+      Counter* hits = &config->group->hits[proc_id * config->group->depth];
+      Counter misses = accesses[proc_id];
+      for (uns jj = 0; jj < config->assoc; jj++)
+        misses -= hits[jj];
+      fprintf(file, "%12u %6u %8u %14llu %9.4f%% %10.4f\n", config->size, config->assoc, config->group->num_sets,
+              misses, accesses[proc_id] ? 100.0 * misses / accesses[proc_id] : 0.0, kinsts ? misses / kinsts : 0.0);
+    }
+    fprintf(file, "\n");
+  }
+  fclose(file);
+}
@@ -0,0 +1,59 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/***************************************************************************************
+ * File         : memory/cache_sweep.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Single-pass miss rates of many sizes and associativities of one
+ *                cache level (LRU stack distances)
+ ***************************************************************************************/
+
+#ifndef __CACHE_SWEEP_H__
+#define __CACHE_SWEEP_H__
+
+#include "globals/enum.h"
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Enums */
+
+#define CACHE_SWEEP_LEVEL_LIST(elem) elem(NONE) elem(DCACHE) elem(MLC) elem(LLC)
+
+DECLARE_ENUM(Cache_Sweep_Level, CACHE_SWEEP_LEVEL_LIST, CACHE_SWEEP_LEVEL_);
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize */
+void cache_sweep_init(void);
+
+/* Report an access to a cache level (ignored unless it is the swept level) */
+void cache_sweep_access(Cache_Sweep_Level level, uns proc_id, Addr addr);
+
+/* Report an access during warmup: updates the LRU stacks, not the counts */
+void cache_sweep_warmup(Cache_Sweep_Level level, uns proc_id, Addr addr);
+
+/* Write cache_sweep.out */
+void cache_sweep_done(void);
+
+#endif /* #ifndef __CACHE_SWEEP_H__ */
@@ -57,10 +57,12 @@
 
 #include "addr_trans.h"
 #include "cache_part.h"
+#include "cache_sweep.h"
 #include "cmp_model.h"
 #include "icache_stage.h"
 #include "mem_req.h"
 #include "op.h"
+#include "simprof.h"
 #include "statistics.h"
 // #include "dram.h"
 // #include "dram.param.h"
@@ -169,6 +171,9 @@ static void mem_init_new_req(Mem_Req* new_req, Mem_Req_Type type, Mem_Queue_Type
                              Counter new_priority);
 
 static inline void init_mem_queue(Mem_Queue* queue, char* name, uns size, Mem_Queue_Type type);
+static void mem_queue_sort(Mem_Queue* queue);
+static void mem_queue_remove_tail(Mem_Queue* queue, int removal_count);
+static void mem_queue_clear(Mem_Queue* queue);
 
 static void print_mem_queue_generic(Mem_Queue* queue);
 
@@ -205,11 +210,90 @@ static inline void init_mem_queue(Mem_Queue* queue, char* name, uns size, Mem_Qu
   ASSERTM(0, !(type & QUEUE_MEM), "Ramulator does not use QUEUE_MEM. QUEUE_MEM should not be initialized!\n");
 
   queue->base = (Mem_Queue_Entry*)malloc(sizeof(Mem_Queue_Entry) * (size + 1));
+  queue->sort_buf = (Mem_Queue_Entry*)malloc(sizeof(Mem_Queue_Entry) * (size + 1));
   queue->size = size;
   queue->entry_count = 0;
   queue->reserved_entry_count = 0;
   queue->type = type;
   strcpy(queue->name, name);
+
+  init_hash_table(&queue->line_index, name, 2 * size + 1, sizeof(int));
+  queue->line_index_size = 0;
+  queue->line_index_valid = TRUE;
+}
+
+/**************************************************************************************/
+/* mem_queue_sort: stable sort of the queue by priority. Between sorts only
+ * the entries inserted or re-prioritized since the last sort are out of
+ * place, so the queue is merged from its already sorted runs, which is
+ * close to a single pass. Being stable, the order of equal-priority
+ * entries is the same as glibc's (merge sort based) qsort. */
+
+static void mem_queue_sort(Mem_Queue* queue) {
+  Mem_Queue_Entry* src = queue->base;
+  Mem_Queue_Entry* dst = queue->sort_buf;
+  int n = queue->entry_count;
+  int run_count;
+
+  do {
+    run_count = 0;
+    for (int start = 0; start < n;) {
+      int mid = start + 1;
+      while (mid < n && src[mid - 1].priority <= src[mid].priority)
+        mid++;
+      int end = mid;
+      if (mid < n) {
+        end++;
+        while (end < n && src[end - 1].priority <= src[end].priority)
+          end++;
+      }
+
+      int ii = start, jj = mid, kk = start;
+      while (ii < mid && jj < end)
+        dst[kk++] = src[jj].priority < src[ii].priority ? src[jj++] : src[ii++];
+      while (ii < mid)
+        dst[kk++] = src[ii++];
+      while (jj < end)
+        dst[kk++] = src[jj++];
+
+      run_count++;
+      start = end;
+    }
+    Mem_Queue_Entry* tmp = src;
+    src = dst;
+    dst = tmp;
+  } while (run_count > 1);
+
+  /* after the final swap src holds the sorted entries */
+  if (src != queue->base)
+    memcpy(queue->base, src, sizeof(Mem_Queue_Entry) * n);
+}
+
+/**************************************************************************************/
+/* mem_queue_remove_tail: drop the last removal_count entries of the queue */
+
+static void mem_queue_remove_tail(Mem_Queue* queue, int removal_count) {
+  ASSERT(0, removal_count <= queue->entry_count);
+  if (queue->line_index_valid) {
+    for (int ii = queue->entry_count - removal_count; ii < queue->entry_count; ii++) {
+      int* count = (int*)hash_table_access(&queue->line_index, queue->base[ii].line_addr);
+      ASSERT(0, count && *count > 0);
+      if (--(*count) == 0)
+        hash_table_access_delete(&queue->line_index, queue->base[ii].line_addr);
+    }
+  }
+  queue->entry_count -= removal_count;
+  if (queue->entry_count == 0 && !queue->line_index_valid)
+    mem_queue_clear(queue);
+}
+
+/**************************************************************************************/
+/* mem_queue_clear: */
+
+static void mem_queue_clear(Mem_Queue* queue) {
+  queue->entry_count = 0;
+  hash_table_clear(&queue->line_index);
+  queue->line_index_valid = TRUE;
 }
 
 /**************************************************************************************/
@@ -465,11 +549,11 @@ void reset_memory() {
 
   clear_list(&mem->req_buffer_free_list);
 
-  mem->l1_queue.entry_count = 0;
-  mem->mlc_queue.entry_count = 0;
-  mem->bus_out_queue.entry_count = 0;
-  mem->l1fill_queue.entry_count = 0;
-  mem->mlc_fill_queue.entry_count = 0;
+  mem_queue_clear(&mem->l1_queue);
+  mem_queue_clear(&mem->mlc_queue);
+  mem_queue_clear(&mem->bus_out_queue);
+  mem_queue_clear(&mem->l1fill_queue);
+  mem_queue_clear(&mem->mlc_fill_queue);
 
   for (ii = 0; ii < mem->total_mem_req_buffers; ii++) {
     int* free_list_entry = sl_list_add_tail(&mem->req_buffer_free_list);
@@ -770,17 +854,17 @@ void update_memory_queues() {
   }
 
   if (!ALL_FIFO_QUEUES && (cycle_l1q_insert_count > 0)) {
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_queue_sort(&mem->l1_queue);
     cycle_l1q_insert_count = 0;
   }
 
   if (!ALL_FIFO_QUEUES && (cycle_mlcq_insert_count > 0)) {
-    qsort(mem->mlc_queue.base, mem->mlc_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_queue_sort(&mem->mlc_queue);
     cycle_mlcq_insert_count = 0;
   }
 
   if (!ALL_FIFO_QUEUES && (cycle_busoutq_insert_count > 0)) {
-    qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_queue_sort(&mem->bus_out_queue);
     cycle_busoutq_insert_count = 0;
   }
 }
@@ -808,40 +892,52 @@ void update_on_chip_memory_stats() {
  *
  */
 void update_memory() {
+  SIMPROF_BEGIN(UPDATE_MEMORY);
   if (freq_is_ready(FREQ_DOMAIN_L1)) {
     cycle_count = freq_cycle_count(FREQ_DOMAIN_L1);
 
+    SIMPROF_BEGIN(MEM_PREF_QUEUES);
     perf_pred_cycle();
 
     pref_update();
     update_memory_queues();
     update_on_chip_memory_stats();
+    SIMPROF_END(MEM_PREF_QUEUES);
 
+    SIMPROF_BEGIN(MEM_FILL_REQS);
     mem_process_mlc_fill_reqs();
     mem_process_l1_fill_reqs();
+    SIMPROF_END(MEM_FILL_REQS);
   }
 
   if (freq_is_ready(FREQ_DOMAIN_MEMORY)) {
     cycle_count = freq_cycle_count(FREQ_DOMAIN_MEMORY);
 
     // dram_process_main_memory_reqs();
+    SIMPROF_BEGIN(RAMULATOR_TICK);
     ramulator_tick();
+    SIMPROF_END(RAMULATOR_TICK);
   }
 
   if (freq_is_ready(FREQ_DOMAIN_L1)) {
     cycle_count = freq_cycle_count(FREQ_DOMAIN_L1);
 
+    SIMPROF_BEGIN(MEM_REQS);
     mem_process_bus_out_reqs();
     mem_process_l1_reqs();
     mem_process_mlc_reqs();
+    SIMPROF_END(MEM_REQS);
   }
 
+  SIMPROF_BEGIN(MEM_CORE_FILL_REQS);
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     if (freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
       cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
       mem_process_core_fill_reqs(proc_id);
     }
   }
+  SIMPROF_END(MEM_CORE_FILL_REQS);
+  SIMPROF_END(UPDATE_MEMORY);
 }
 
 /**************************************************************************************/
@@ -1426,6 +1522,7 @@ static Flag mem_complete_l1_access(Mem_Req* req, Mem_Queue_Entry* l1_queue_entry
                                 update_l1_lru);  // access L2
   req->l1_hit = data ? TRUE : FALSE;
   cache_part_l1_access(req);
+  cache_sweep_access(CACHE_SWEEP_LEVEL_LLC, req->proc_id, req->addr);
   if (FORCE_L1_MISS)
     data = NULL;
 
@@ -1629,6 +1726,7 @@ static Flag mem_complete_mlc_access(Mem_Req* req, Mem_Queue_Entry* mlc_queue_ent
     update_mlc_lru = FALSE;
   data = (MLC_Data*)cache_access(&MLC(req->proc_id)->cache, req->addr, &line_addr, update_mlc_lru);  // access MLC
   req->mlc_hit = data ? TRUE : FALSE;
+  cache_sweep_access(CACHE_SWEEP_LEVEL_MLC, req->proc_id, req->addr);
 
   if (data || PERFECT_MLC) { /* mlc hit */
     /* if exclusive cache, invalidate the line in L2 if there is a done function
@@ -1755,8 +1853,8 @@ static void mem_process_l1_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the l1_queue */
     DEBUG(0, "l1_queue removal\n");
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->l1_queue.entry_count -= l1_queue_removal_count;
+    mem_queue_sort(&mem->l1_queue);
+    mem_queue_remove_tail(&mem->l1_queue, l1_queue_removal_count);
     ASSERT(req->proc_id, mem->l1_queue.entry_count >= 0);
     /* if HIER_MSHR_ON, requests stay in the queues until filled (by reserving
      * entries) */
@@ -1768,9 +1866,9 @@ static void mem_process_l1_reqs() {
   /* Sort the out queue if requests were inserted */
   if (!ALL_FIFO_QUEUES && (out_queue_insertion_count > 0)) {
     if (CONSTANT_MEMORY_LATENCY) {  // request went straight to L1 fill queue
-      qsort(mem->l1fill_queue.base, mem->l1fill_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
+      mem_queue_sort(&mem->l1fill_queue);
     } else {
-      qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
+      mem_queue_sort(&mem->bus_out_queue);
     }
   }
 }
@@ -1837,8 +1935,8 @@ static void mem_process_mlc_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the mlc_queue */
     DEBUG(0, "mlc_queue removal\n");
-    qsort(mem->mlc_queue.base, mem->mlc_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->mlc_queue.entry_count -= mlc_queue_removal_count;
+    mem_queue_sort(&mem->mlc_queue);
+    mem_queue_remove_tail(&mem->mlc_queue, mlc_queue_removal_count);
     ASSERT(req->proc_id, mem->mlc_queue.entry_count >= 0);
     /* if HIER_MSHR_ON, requests stay in the queues until filled (by reserving
      * entries) */
@@ -1849,7 +1947,7 @@ static void mem_process_mlc_reqs() {
 
   /* Sort the l1 queue if requests were inserted */
   if (!ALL_FIFO_QUEUES && (l1_queue_insertion_count > 0)) {
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_queue_sort(&mem->l1_queue);
   }
 }
 
@@ -2124,8 +2222,8 @@ static void mem_process_bus_out_reqs() {
     //}
 
     DEBUG(0, "bus_out_queue removal\n");
-    qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->bus_out_queue.entry_count--;
+    mem_queue_sort(&mem->bus_out_queue);
+    mem_queue_remove_tail(&mem->bus_out_queue, 1);
     ASSERT(req->proc_id, mem->bus_out_queue.entry_count >= 0);
 
     // Ramulator_remove: Ramulator implements its own request queues. This
@@ -2189,8 +2287,8 @@ static void remove_from_l1_fill_queue(uns proc_id, int* p_l1fill_queue_removal_c
     /* After this sort requests that should be removed will be at the tail of
      * the l1_queue */
     DEBUG(0, "l1fill_queue removal\n");
-    qsort(mem->l1fill_queue.base, mem->l1fill_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->l1fill_queue.entry_count -= *p_l1fill_queue_removal_count;
+    mem_queue_sort(&mem->l1fill_queue);
+    mem_queue_remove_tail(&mem->l1fill_queue, *p_l1fill_queue_removal_count);
     ASSERT(proc_id, mem->l1fill_queue.entry_count >= 0);
     /* free corresponding reserved entries in the L1 queue if HIER_MSHR_ON */
     if (HIER_MSHR_ON) {
@@ -2356,8 +2454,8 @@ static void mem_process_mlc_fill_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the mlc_queue */
     DEBUG(0, "mlc_fill_queue removal\n");
-    qsort(mem->mlc_fill_queue.base, mem->mlc_fill_queue.entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
-    mem->mlc_fill_queue.entry_count -= mlc_fill_queue_removal_count;
+    mem_queue_sort(&mem->mlc_fill_queue);
+    mem_queue_remove_tail(&mem->mlc_fill_queue, mlc_fill_queue_removal_count);
     ASSERT(req->proc_id, mem->mlc_fill_queue.entry_count >= 0);
     /* free corresponding reserved entries in the MLC queue if HIER_MSHR_ON */
     if (HIER_MSHR_ON) {
@@ -2407,8 +2505,8 @@ static void mem_process_core_fill_reqs(uns proc_id) {
     /* After this sort requests that should be removed will be at the tail of
      * the core_fill_queue */
     DEBUG(0, "core_fill_queue removal\n");
-    qsort(core_fill_queue->base, core_fill_queue->entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
-    core_fill_queue->entry_count -= core_fill_queue_removal_count;
+    mem_queue_sort(core_fill_queue);
+    mem_queue_remove_tail(core_fill_queue, core_fill_queue_removal_count);
     ASSERT(req->proc_id, core_fill_queue->entry_count >= 0);
   }
 }
@@ -2454,6 +2552,10 @@ static inline Mem_Req* mem_search_queue(
 
   // CMP ignore "size" from argument
 
+  if (queue->line_index_valid && queue->entry_count &&
+      !hash_table_access(&queue->line_index, CACHE_SIZE_ADDR(queue->line_index_size, addr)))
+    return NULL;
+
   for (ii = 0; ii < queue->entry_count; ii++) {
     used_reqbuf_id = queue->base[ii].reqbuf;
     req = &mem->req_buffer[used_reqbuf_id];
@@ -2803,8 +2905,7 @@ Flag mem_adjust_matching_request(Mem_Req* req, Mem_Req_Type type, Addr addr, uns
         req->type = type;
         memview_req_changed_type(req);
       }
-      qsort(req->queue->base, req->queue->entry_count, sizeof(Mem_Queue_Entry),
-            mem_compare_priority); /* Sort the associated queue */
+      mem_queue_sort(req->queue); /* Sort the associated queue */
     }
 
     switch (req->queue->type) {
@@ -2983,7 +3084,7 @@ static Mem_Req* mem_kick_out_prefetch_from_queue(uns mem_bank, Mem_Queue* queue,
   if (queue->entry_count == 0)
     return NULL;
 
-  qsort(queue->base, queue->entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
+  mem_queue_sort(queue);
 
   if (KICKOUT_OLDEST_PREFETCH) {
     int ii, oldest_index = 0;
@@ -3030,8 +3131,8 @@ static Mem_Req* mem_kick_out_prefetch_from_queue(uns mem_bank, Mem_Queue* queue,
       STAT_EVENT(req_kicked_out->proc_id, ONPATH_KICKED_OUT_PREFETCH);
       queue->base[oldest_index].priority = Mem_Req_Priority_Offset[MRT_MIN_PRIORITY];
       DEBUG(0, "%s removal\n", queue->name);
-      qsort(queue->base, queue->entry_count, sizeof(Mem_Queue_Entry), mem_compare_priority);
-      queue->entry_count--;
+      mem_queue_sort(queue);
+      mem_queue_remove_tail(queue, 1);
       pref_req_drop_process(req_kicked_out->proc_id, mem->req_buffer[queue->base[oldest_index].reqbuf].prefetcher_id);
     }
 
@@ -3048,7 +3149,7 @@ static Mem_Req* mem_kick_out_prefetch_from_queue(uns mem_bank, Mem_Queue* queue,
       ASSERT(0, mem->req_buffer[kickout_reqbuf_num].priority > new_priority);
       STAT_EVENT(mem->req_buffer[kickout_reqbuf_num].proc_id, ONPATH_KICKED_OUT_PREFETCH);
       queue->base[queue->entry_count - 1].priority = Mem_Req_Priority_Offset[MRT_MIN_PRIORITY];
-      queue->entry_count--;
+      mem_queue_remove_tail(queue, 1);
       pref_req_drop_process(mem->req_buffer[kickout_reqbuf_num].proc_id,
                             mem->req_buffer[kickout_reqbuf_num].prefetcher_id);
       return &(mem->req_buffer[kickout_reqbuf_num]);
@@ -3304,6 +3405,18 @@ static inline Mem_Queue_Entry* mem_insert_req_into_queue(Mem_Req* new_req, Mem_Q
   Mem_Queue_Entry* new_entry = &queue->base[queue->entry_count];
   new_entry->reqbuf = new_req->id;
   new_entry->priority = priority > 0 ? priority : new_req->priority;
+  new_entry->line_addr = CACHE_SIZE_ADDR(new_req->size, new_req->addr);
+  if (queue->entry_count == 0)
+    queue->line_index_size = new_req->size;
+  if (queue->line_index_valid && new_req->size != queue->line_index_size) {
+    hash_table_clear(&queue->line_index);
+    queue->line_index_valid = FALSE;
+  }
+  if (queue->line_index_valid) {
+    Flag new_line;
+    int* count = (int*)hash_table_access_create(&queue->line_index, new_entry->line_addr, &new_line);
+    *count = new_line ? 1 : *count + 1;
+  }
   queue->entry_count++;
 
   DEBUG(new_req->proc_id, "Inserted into %s index:%d pri:%s rc:%d l1:%d bo:%d lf:%d\n", queue->name, new_req->id,
@@ -4595,12 +4708,13 @@ void mark_ops_as_l1_miss_satisfied(Mem_Req* req) {
 /* recursively go through the wake up lists of the op and mark ops as
  * l1_miss_dep */
 static void mark_l1_miss_deps(Op* op) {
-  Wake_Up_Entry* temp;
+  uns jj;
 
   ASSERT(op->proc_id,
          (op->engine_info.l1_miss && !op->engine_info.l1_miss_satisfied) || op->engine_info.dep_on_l1_miss);
 
-  for (temp = op->wake_up_head; temp; temp = temp->next) {
+  for (jj = 0; jj < op->wake_up_count; jj++) {
+    Wake_Up_Entry* temp = &op->wake_up_list[jj];
     Op* dep_op = temp->op;
     Counter dep_unique_num = temp->unique_num;
 
@@ -4627,14 +4741,15 @@ static void mark_l1_miss_deps(Op* op) {
  * l1_miss_dep */
 
 static void unmark_l1_miss_deps(Op* op) {
-  Wake_Up_Entry* temp;
+  uns jj;
 
   ASSERT(op->proc_id,
          op->engine_info.l1_miss_satisfied || (!op->engine_info.dep_on_l1_miss && op->engine_info.was_dep_on_l1_miss));
 
   /* Go thru the wake up list and unmark ops if they are not dependent on
    * another l1 miss */
-  for (temp = op->wake_up_head; temp; temp = temp->next) {
+  for (jj = 0; jj < op->wake_up_count; jj++) {
+    Wake_Up_Entry* temp = &op->wake_up_list[jj];
     Op* dep_op = temp->op;
     Counter dep_unique_num = temp->unique_num;
 
@@ -4741,6 +4856,21 @@ int mem_get_req_count(uns proc_id) {
   return mem->num_req_buffers_per_core[proc_id];
 }
 
+/**************************************************************************************/
+/* mem_queues_empty: TRUE if no on-chip queue holds a request, i.e. only
+ * requests already handed to Ramulator are outstanding */
+
+Flag mem_queues_empty() {
+  if (mem->l1_queue.entry_count || mem->mlc_queue.entry_count || mem->bus_out_queue.entry_count ||
+      mem->l1fill_queue.entry_count || mem->mlc_fill_queue.entry_count)
+    return FALSE;
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if (mem->core_fill_queues[proc_id].entry_count)
+      return FALSE;
+  }
+  return TRUE;
+}
+
 /**************************************************************************************/
 /* stats_per_core_collect */
 void stats_per_core_collect(uns8 proc_id) {
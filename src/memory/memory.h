@@ -96,15 +96,23 @@ typedef struct Mem_Queue_Entry_struct {
   int reqbuf;       /* request buffer num */
   Counter priority; /* priority of the miss */
   Counter rdy_cycle;
+  Addr line_addr; /* key of the entry in the queue's line index */
 } Mem_Queue_Entry;
 
 typedef struct Mem_Queue_struct {
   Mem_Queue_Entry* base;
+  Mem_Queue_Entry* sort_buf; /* scratch space for mem_queue_sort */
   int entry_count;
   int reserved_entry_count; /* for HIER_MSHR_ON */
   uns size;
   char name[20];
   Mem_Queue_Type type;
+
+  /* line address -> number of entries, lets searches skip queues that
+     cannot match. Only valid while every entry has the same req size. */
+  Hash_Table line_index;
+  uns line_index_size;
+  Flag line_index_valid;
 } Mem_Queue;
 
 typedef struct Mem_Bank_Queue_Entry_struct {
@@ -247,6 +255,7 @@ Flag l1_fill_line(Mem_Req* req);
 
 void mark_ops_as_l1_miss_satisfied(Mem_Req* req);
 int mem_get_req_count(uns proc_id);
+Flag mem_queues_empty(void);
 Flag mem_can_allocate_req_buffer(uns proc_id, Mem_Req_Type type, Flag for_l1_writeback);
 
 void open_mem_stat_interval_file(void);
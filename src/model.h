@@ -39,6 +39,7 @@
 typedef enum Model_Id_enum {
   CMP_MODEL,
   DUMB_MODEL,
+  BP_MODEL,
   NUM_MODELS,
 } Model_Id;
 
@@ -67,6 +68,12 @@ typedef struct Model_struct {
   void (*op_retired_hook)(Op*);  // called just before the op is freed
   void (*warmup_func)(Op* op);   // called for warmup(may be NULL)
 
+  /* earliest time (in fs) at which the model state can change; anything
+     not after the current time means the model must be simulated every
+     cycle (may be NULL, used by IDLE_SKIP) */
+  Counter (*next_event_func)(void);
+  void (*idle_skip_func)(Counter); /* called with the number of chip cycles skipped (may be NULL) */
+
   /*      void (*l0_cache_miss_hook)      (Op *); */
   /*      void (*resolve_mispredict_hook) (Op *); */
 } Model;
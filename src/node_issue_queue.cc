@@ -56,6 +56,7 @@ extern "C" {
 
 int64 node_dispatch_find_emptiest_rs(Op*);
 void node_schedule_oldest_first_sched(Op*);
+void node_schedule_oldest_first_mask_sched(Op*);
 
 /**************************************************************************************/
 /* Issuers:
@@ -181,6 +182,48 @@ void node_schedule_oldest_first_sched(Op* op) {
   ASSERT(node->proc_id, node->sd.op_count <= node->sd.max_op_count);
 }
 
+/*
+ * OLDEST_FIRST_MASK: makes the same choices as OLDEST_FIRST, but finds the FU
+ * with word operations instead of walking the connected FUs. The RS's FU type
+ * mask gives the FUs that can execute the op; an empty one among them (the
+ * lowest fu_id, i.e. the first in connected_fus) is taken right away. Only when
+ * all of them already hold an op are their occupants compared, and the youngest
+ * one that is younger than the op is replaced.
+ */
+void node_schedule_oldest_first_mask_sched(Op* op) {
+  Reservation_Station* rs = &node->rs[op->rs_id];
+  uns fu_type_bit = __builtin_ctzll(get_fu_type(op->table_info->op_type, op->table_info->is_simd));
+  uns64 fus = rs->fu_type_fus[fu_type_bit];
+  uns64 empty_fus = fus & ~node->sched_fu_mask;
+  int32 fu_id = NODE_ISSUE_QUEUE_FU_SLOT_INVALID;
+
+  if (empty_fus) {
+    fu_id = __builtin_ctzll(empty_fus);
+    node->sched_fu_mask |= 1ull << fu_id;
+    node->sd.op_count++;
+  } else {
+    for (; fus; fus &= fus - 1) {
+      int32 slot = __builtin_ctzll(fus);
+      Op* s_op = node->sd.ops[slot];
+      ASSERTD(node->proc_id, s_op);
+      if (op->op_num < s_op->op_num &&
+          (fu_id == NODE_ISSUE_QUEUE_FU_SLOT_INVALID || s_op->op_num > node->sd.ops[fu_id]->op_num))
+        fu_id = slot;
+    }
+    /* Did not find an empty slot or a slot that is younger than me, do nothing */
+    if (fu_id == NODE_ISSUE_QUEUE_FU_SLOT_INVALID)
+      return;
+  }
+
+  DEBUG(node->proc_id, "Scheduler selecting    op_num:%s  fu_id:%d op:%s l1:%d\n", unsstr64(op->op_num), fu_id,
+        disasm_op(op, TRUE), op->engine_info.l1_miss);
+  ASSERT(node->proc_id, fu_id < (int32)node->sd.max_op_count);
+  op->fu_num = fu_id;
+  node->sd.ops[fu_id] = op;
+  node->last_scheduled_opnum = op->op_num;
+  ASSERT(node->proc_id, node->sd.op_count <= node->sd.max_op_count);
+}
+
 /**************************************************************************************/
 /* Driven Table */
 
@@ -192,6 +235,7 @@ Dispatch_Func dispatch_func_table[NODE_ISSUE_QUEUE_DISPATCH_SCHEME_NUM] = {
 using Schedule_Func = void (*)(Op*);
 Schedule_Func schedule_func_table[NODE_ISSUE_QUEUE_SCHEDULE_SCHEME_NUM] = {
     [NODE_ISSUE_QUEUE_SCHEDULE_SCHEME_OLDEST_FIRST] = {node_schedule_oldest_first_sched},
+    [NODE_ISSUE_QUEUE_SCHEDULE_SCHEME_OLDEST_FIRST_MASK] = {node_schedule_oldest_first_mask_sched},
 };
 
 /**************************************************************************************/
@@ -308,6 +352,7 @@ void node_issue_queue_schedule() {
    * regardless of whether they are actually sent to a functional unit
    */
   ASSERT(node->proc_id, node->sd.op_count == 0);
+  node->sched_fu_mask = 0;
 
   // Check to see if the L1 Q is (still) full
   node_issue_queue_check_mem();
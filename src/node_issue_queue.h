@@ -46,6 +46,7 @@ typedef enum NODE_ISSUE_QUEUE_DISPATCH_SCHEME_enum {
 
 typedef enum NODE_ISSUE_QUEUE_SCHEDULE_SCHEME_enum {
   NODE_ISSUE_QUEUE_SCHEDULE_SCHEME_OLDEST_FIRST,
+  NODE_ISSUE_QUEUE_SCHEDULE_SCHEME_OLDEST_FIRST_MASK,
   NODE_ISSUE_QUEUE_SCHEDULE_SCHEME_NUM
 } Node_Issue_Queue_Schedule_Scheme;
 
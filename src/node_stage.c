@@ -60,6 +60,7 @@
 #include "node_issue_queue.h"
 #include "op_pool.h"
 #include "sim.h"
+#include "simprof.h"
 #include "statistics.h"
 #include "thread.h"
 #include "xed-iclass-enum.h"
@@ -594,7 +595,7 @@ void node_retire() {
       STAT_EVENT(op->proc_id, LD_EXEC_CYCLES_0 + (op->done_cycle - op->sched_cycle));
     }
     if (op->table_info->mem_type == MEM_LD) {
-      STAT_EVENT(op->proc_id, LD_NO_DEPENDENTS + (op->wake_up_head ? 1 : 0));
+      STAT_EVENT(op->proc_id, LD_NO_DEPENDENTS + (op->wake_up_count ? 1 : 0));
     }
     STAT_EVENT(op->proc_id, RET_OP_EXEC_COUNT_0 + MIN2(32, op->exec_count));
 
@@ -602,7 +603,9 @@ void node_retire() {
 
     op->oracle_info.hbt_pred_is_hard = hbt_is_hard_branch(op->inst_info->addr);
     op->oracle_info.hbt_misp_counter = hbt_get_counter(op->inst_info->addr);
+    SIMPROF_BEGIN(H2P_FILL_BUFFER);
     fill_buffer_add(op->proc_id, op);
+    SIMPROF_END(H2P_FILL_BUFFER);
 
     // free the previous register entries with same architectural destination
     reg_file_commit(op);
@@ -657,6 +660,17 @@ void node_retire() {
   }
 }
 
+/**************************************************************************************/
+/* node_stage_idle_skip: extends the retirement stall and the memory block
+ * over skipped idle cycles. An idle core with ops in the node table is
+ * stalled on its head. */
+
+void node_stage_idle_skip(Counter cycles) {
+  if (!is_node_table_empty())
+    node->ret_stall_length += cycles;
+  node->mem_block_length += node->mem_blocked * cycles;
+}
+
 /**************************************************************************************/
 /* is_node_stage_stalled: returns TRUE if node table is full and there are no
  * ready ops */
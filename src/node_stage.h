@@ -43,6 +43,7 @@ typedef struct Reservation_Station_struct {
   uns32 num_fus;                       // number of fus that this rs is connected to.
   uns32 rs_op_count;                   // number of ops in this reservation station
   uint64_t* entry_status;              // bitmask for entry status (0: empty, 1: occupied)
+  uns64* fu_type_fus;                  // per FU type bit (see get_fu_type), the connected FUs that execute it, by fu_id
 } Reservation_Station;
 
 typedef struct Node_Stage_struct {
@@ -62,6 +63,7 @@ typedef struct Node_Stage_struct {
 
   Counter ret_op;                // next op number to retire
   Counter last_scheduled_opnum;  // op num of the last scheduled op
+  uns64 sched_fu_mask;           // FUs (by fu_id) that have been given an op by the scheduler this cycle
 
   Op* next_op_into_rs;      // oldest issued op not yet in the scheduling window (RS)
   Reservation_Station* rs;  // information about all of the reservation stations
@@ -87,6 +89,7 @@ void recover_node_stage(void);
 void debug_node_stage(void);
 void update_node_stage(Stage_Data*);
 Flag is_node_stage_stalled(void);
+void node_stage_idle_skip(Counter cycles);
 
 /**************************************************************************************/
 
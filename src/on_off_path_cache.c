@@ -23,22 +23,22 @@ void reset_on_off_path_cache(uns proc_id) {
     }
 }
 
-void record_on_off_path(uns proc_id, Op* h2p_op_at_head) {
+void record_on_off_path(uns proc_id, Retired_Op_Record* h2p_op_at_head) {
     Fill_Buffer* fb = retired_fill_buffers[proc_id];
     if (!fb || fb->count == 0) return;
 
     On_Off_Path_Cache_Entry* cache = on_off_path_caches[proc_id];
-    int entry_index = h2p_op_at_head->inst_info->addr % ON_OFF_PATH_CACHE_SIZE;
+    int entry_index = h2p_op_at_head->pc % ON_OFF_PATH_CACHE_SIZE;
     On_Off_Path_Cache_Entry* entry = &cache[entry_index];
 
     entry->is_valid = TRUE;
-    entry->h2p_branch_pc = h2p_op_at_head->inst_info->addr;
+    entry->h2p_branch_pc = h2p_op_at_head->pc;
     entry->h2p_branch_op_num = h2p_op_at_head->op_num;
     entry->path_length = 0;
 
     int current_idx = fb->head;
     for (int i = 0; i < fb->count && entry->path_length < MAX_ON_OFF_PATH_LENGTH; ++i) {
-        Op* op_in_path = &fb->entries[current_idx];
+        Retired_Op_Record* op_in_path = &fb->entries[current_idx];
         entry->path[entry->path_length++] = *op_in_path;
         current_idx = (current_idx + 1) % fb->size;
     }
@@ -70,12 +70,13 @@ DECLARE_ENUM(Op_State, OP_STATE_LIST, OS_);
 
 /**************************************************************************************/
 
+/* One consumer in a producer's wake up list. The list is a contiguous block of
+   entries (see map.c), so the consumers of a producer share a few cache lines. */
 typedef struct Wake_Up_Entry_struct {
   Op* op;
   Counter unique_num;
   Dep_Type dep_type;
   uns8 rdy_bit;
-  struct Wake_Up_Entry_struct* next;
 } Wake_Up_Entry;
 
 // per branch stats
@@ -124,25 +125,65 @@ typedef struct Dp_Info_struct {
 /* typedef in globals/global_types.h */
 
 struct Op_struct {
+  /*------------------------------------------------------------------------------------*/
+  // HOT HEADER: fields the scheduler, wake up and ready list walks touch every
+  // cycle. They are kept together so that a walk touches the first few cache
+  // lines of an op only; init_op_pool() checks the header size.
+  // Add fields here only if they are read per op per cycle.
+
   // {{{ op_pool stuff --- don't use outside of op pool management
   Flag op_pool_valid;  // is op allocated from the op_pool?
   Op* op_pool_next;    // either next free or next active op
   uns op_pool_id;      // unique identifier for op (doesn't change)
   // }}}
 
+  // {{{ scheduler state
+  uns proc_id;              // processor id for cmp model
+  Op_State state;           // the state of the op in the datapath
+  uns srcs_not_rdy_vector;  // bits as given by order in the src_info array
+  uns fu_num;               // functional unit number the op will or did execute on
+  Flag in_rdy_list;         // is the op in the node stage's ready list?
+  Flag in_node_list;        // is the op in the node list?
+  Flag off_path;            // is the op on the correct path of the program? - oracle information
+  Flag replay;              // is the op waiting to replay?
+  Counter op_num;           // op number
+  Counter unique_num;       // unique number for each instance of an op (not reset on recovery)
+  Counter rdy_cycle;        // cycle when the final source value is available to the op (only useful when vector is clear)
+  Counter sched_cycle;      // cycle when the op is scheduled (arrives at the functional unit)
+  Counter exec_cycle;       // cycle when execution (or addr gen) of op will be completed (result usable)
+  Counter done_cycle;       // cycle when the op is ready to retire
+  Counter rs_id;            // id for which Reservation Station (RS) this op is assigned to
+  Counter node_id;          // id for position in the node table
+  struct Op_struct* next_rdy;   // pointer to next ready op (node table)
+  struct Op_struct* next_node;  // pointer to the next op in the node table
+  Table_Info* table_info;       // copy of info->table_info to limit pointer chasing
+  Inst_Info* inst_info;         // pointer to unique struct for each static instruction
+  // }}}
+
+  // {{{ wake up state
+  Wake_Up_Entry* wake_up_list;           // ops that are dependent on this op, all dependency types, oldest first
+  uns wake_up_count;                     // count of ops to be awakened by this op (wake up list length)
+  uns wake_up_capacity;                  // entries in the wake_up_list block
+  Flag wake_up_signaled[NUM_DEP_TYPES];  // set to true once a wake up has been signaled by the op for the given type
+  Counter dcache_cycle;                  // cycle when the op accesses the dcache
+  Counter replay_cycle;                  // cycle when the op catches a replay signal
+  struct Mem_Req_struct* req;            // pointer to memory request responsible for waking up the op
+  Counter wake_cycle;                    // used by wake up logic for time wake up signal is sent (last hot field)
+  // }}}
+
+  /*------------------------------------------------------------------------------------*/
+  // COLD BODY: everything below is read at fetch, map, retire, recovery or for
+  // stats and debugging, and may be large (oracle_info and engine_info alone are
+  // several kilobytes).
+
   // {{{ op numbers and info pointers
-  uns proc_id;                  // processor id for cmp model
   uns thread_id;                // id number for the thread to which this op belongs
   Flag bom;                     // begining of macro instruction when we use op as a uop
   Flag eom;                     // end of macro instruction when we use op as a uop
   Flag fetched_instruction;     // is this op fetched or a rep op?
-  Counter op_num;               // op number
-  Counter unique_num;           // unique number for each instance of an op (not reset on recovery)
   Counter unique_num_per_proc;  // unique number per core
   uns64 inst_uid;               // unique number for the macro instruction provided by the frontend (PIN)
   Counter addr_pred_num;        // unique number for each address prediction
-  Table_Info* table_info;       // copy of info->table_info to limit pointer chasing
-  Inst_Info* inst_info;         // pointer to unique struct for each static instruction
   Op_Info oracle_info;          // information about the execution of the op in the oracle
   Op_Info engine_info;          // information about the execution of the op in the engine
   int oracle_cp_num;            // if the op has created an oracle checkpointed this is not -1
@@ -151,25 +192,17 @@ struct Op_struct {
   int32 perceptron_output;
   int32 conf_perceptron_output;  // confidece perceptron
   // {{{ state and event cycle counters
-  Op_State state;        // the state of the op in the datapath
   Counter fetch_cycle;   // cycle an individual instruction is fetched
   Counter bp_cycle;      // cycle a CF instruction accesses the branch predictor
   Counter map_cycle;     // cycle an individual instruction enters the map stage
   Counter issue_cycle;   // cycle an individual instruction is issued -- same as chkpt
-  Counter rdy_cycle;     // cycle when the final source value is available to the op (only useful when vector is clear)
-  Counter sched_cycle;   // cycle when the op is scheduled (arrives at the functional unit)
-  Counter exec_cycle;    // cycle when execution (or addr gen) of op will be completed (result usable)
-  Counter dcache_cycle;  // cycle when the op accesses the dcache
-  Counter done_cycle;    // cycle when the op is ready to retire
   Counter retire_cycle;  // cycle when the op actually retires (useful if you keep the ops around after they commit
-  Counter replay_cycle;  // cycle when the op catches a replay signal
   Counter pred_cycle;
   Counter precommit_cycle;  // cycle when the op is precommit (will eventually retire)
   Counter decode_cycle;     // cycle when decode completes
   // }}}
 
   // {{{ path and fetch info
-  Flag off_path;                // is the op on the correct path of the program? - oracle information
   Flag conf_off_path;           // is the op on the correct path of the program? - confidence information
   Flag exit;                    // is this the last instruction to execute?
   Flag prog_input;              // is this op directly related to an input value of the program ?
@@ -178,37 +211,17 @@ struct Op_struct {
   // }}}
 
   // {{{ scheduler information
-  uns fu_num;         // functional unit number the op will or did execute on
-  Counter node_id;    // id for position in the node table
-  Counter rs_id;      // id for which Reservation Station (RS) this op is assigned to
   Counter rs_entry_id; // id for the entry within the assigned RS
   Counter chkpt_num;  // id for chkpt (WARNING: this can change due to recoveries)
 
-  struct Op_struct* next_rdy;   // pointer to next ready op (node table)
-  Flag in_rdy_list;             // is the op in the node stage's ready list?
-  struct Op_struct* next_node;  // pointer to the next op in the node table
-  Flag in_node_list;            // is the op in the node list?
   Flag precommitted;            // if the op is pre-commit in the ROB
   Flag macro_fused;             // if the op should be fused with the previous op (CMP/TEST)
   Flag move_eliminated;         // if the op can be move-eliminated
-  Flag replay;                  // is the op waiting to replay?
   uns replay_count;             // number of times the op has replayed
   Flag dont_cause_replays;      // true if the op should not cause other ops to replay (like a correct value prediction)
   uns exec_count;               // how many times has this op been executed?
   // }}}
 
-  // {{{ dependency information
-  uns srcs_not_rdy_vector;               // bits as given by order in the src_info array
-  Flag wake_up_signaled[NUM_DEP_TYPES];  // set to true once a wake up has been signaled by the op for the given type
-  Wake_Up_Entry* wake_up_head;           // list of ops that are dependent on this op, by dependency type
-  Wake_Up_Entry* wake_up_tail;           // last entry in each wake up list (for speed)
-  uns wake_up_count;                     // count of ops to be awakened by this op (wake up list length)
-  Counter wake_cycle;                    // used by wake up logic for time wake up signal is sent
-  // }}}
-
-  struct Mem_Req_struct* req;  // pointer to memory request responsible for waking up the op
-  // }}}
-
   Flag marked;  // for algorithms that mark already seen ops
 
   /*------------------------------------------------------------------------------------*/
@@ -269,8 +282,6 @@ struct Op_struct {
   int dst_reg_id[MAX_DESTS][REG_TABLE_TYPE_NUM];       // the reg id of allocated reg file entries
   int prev_dst_reg_id[MAX_DESTS][REG_TABLE_TYPE_NUM];  // the previous dst reg id with the same parent register id
   // }}}
-
-  Flag chain_bit;
 };
 
 /**************************************************************************************/
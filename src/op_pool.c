@@ -28,6 +28,8 @@ Ops, thus eliminating dynamic allocation all over the place.  Basically, it
 allocates them once and then hands out pointers every time 'alloc_op' is called.
 ***************************************************************************************/
 
+#include <stddef.h>
+
 #include "op_pool.h"
 
 #include "globals/assert.h"
@@ -60,26 +62,49 @@ allocates them once and then hands out pointers every time 'alloc_op' is called.
 
 // TODO: it should be increased to 512 to use more than 50,000 FDIP lookahead buffer entries
 #define OP_POOL_ENTRIES_INC 128 /* default 128 */
+// ops a fetch target holds on average, used to size the FTQ share of a core's first slab
+#define OP_POOL_OPS_PER_FT 16
+// the scheduler-hot header of an Op (see op.h) must end within this many bytes
+#define OP_POOL_HOT_BYTES 192
+
+/**************************************************************************************/
+/* Types */
+
+/* Every core allocates its ops from its own slabs, so the ops a core keeps in
+   flight sit together in memory instead of interleaving with other cores'. The
+   first slab is sized to cover a full ROB and FTQ; later slabs add
+   OP_POOL_ENTRIES_INC ops each. */
+typedef struct Op_Pool_struct {
+  Op* free_head;
+  uns entries;
+  uns active_ops;
+} Op_Pool;
 
 /**************************************************************************************/
 /* Global variables */
 
-uns op_pool_entries = 0;
-uns op_pool_active_ops = 0;
-static Op* op_pool_free_head;
+uns op_pool_entries = 0;     // summed over all cores
+uns op_pool_active_ops = 0;  // summed over all cores
+static Op_Pool* op_pools;    // one per core
 
 Op invalid_op;
 
 /**************************************************************************************/
 /* Prototypes */
 
-static inline void expand_op_pool(void);
+static void expand_op_pool(uns proc_id, uns num_ops);
 
 /**************************************************************************************/
 /* init_op_pool: */
 
 void init_op_pool() {
+  uns proc_id;
+  uns first_slab = NODE_TABLE_SIZE + FE_FTQ_BLOCK_NUM * OP_POOL_OPS_PER_FT;
+
   DEBUGU(0, "Initializing op pool...\n");
+  ASSERTM(0, offsetof(Op, wake_cycle) + sizeof(Counter) <= OP_POOL_HOT_BYTES,
+          "Op hot header is %lu bytes, expected at most %u\n", offsetof(Op, wake_cycle) + sizeof(Counter),
+          OP_POOL_HOT_BYTES);
 
   /* set up invalid op (for use as default value various places) */
   op_pool_init_op(&invalid_op);
@@ -90,8 +115,12 @@ void init_op_pool() {
   /* clear counters */
   reset_op_pool();
 
-  /* allocate memory for op pool */
-  expand_op_pool();
+  /* allocate the first slab of every core, rounded up to whole increments */
+  if (!op_pools)
+    op_pools = (Op_Pool*)calloc(NUM_CORES, sizeof(Op_Pool));
+  first_slab = (first_slab + OP_POOL_ENTRIES_INC - 1) / OP_POOL_ENTRIES_INC * OP_POOL_ENTRIES_INC;
+  for (proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    expand_op_pool(proc_id, first_slab);
 }
 
 /**************************************************************************************/
@@ -107,23 +136,25 @@ void reset_op_pool() {
 /* alloc_op:  returns a pointer to the next available op */
 
 Op* alloc_op(uns proc_id) {
+  Op_Pool* pool = &op_pools[proc_id];
   Op* new_op;
 
-  if (op_pool_free_head == NULL) {
-    ASSERT(0, op_pool_active_ops == op_pool_entries);
-    expand_op_pool();
+  if (pool->free_head == NULL) {
+    ASSERT(proc_id, pool->active_ops == pool->entries);
+    expand_op_pool(proc_id, OP_POOL_ENTRIES_INC);
   }
 
-  new_op = op_pool_free_head;
-  ASSERT(0, !new_op->op_pool_valid);
+  new_op = pool->free_head;
+  ASSERT(proc_id, !new_op->op_pool_valid);
   new_op->op_pool_valid = TRUE;
 
   op_pool_setup_op(proc_id, new_op);
 
+  pool->active_ops++;
   op_pool_active_ops++;
-  DEBUG(0, "Allocating op  id:%u  op_pool_active_ops:%u  op_pool_entries:%d\n", new_op->op_pool_id, op_pool_active_ops,
-        op_pool_entries);
-  op_pool_free_head = new_op->op_pool_next;
+  DEBUG(proc_id, "Allocating op  id:%u  active_ops:%u  entries:%u\n", new_op->op_pool_id, pool->active_ops,
+        pool->entries);
+  pool->free_head = new_op->op_pool_next;
 
   return new_op;
 }
@@ -132,6 +163,8 @@ Op* alloc_op(uns proc_id) {
 /* free_op:  "frees" an op */
 
 void free_op(Op* op) {
+  Op_Pool* pool;
+
   ASSERT(0, op);
   ASSERT(0, op->op_pool_valid);
   ASSERT(0, !op->marked);
@@ -139,10 +172,13 @@ void free_op(Op* op) {
   if (PIPEVIEW)
     pipeview_print_op(op);
 
+  /* an op goes back to the pool of the core that allocated it */
+  pool = &op_pools[op->proc_id];
   op->op_pool_valid = FALSE;
+  ASSERTM(op->proc_id, pool->active_ops > 0, "active_ops:%u\n", pool->active_ops);
+  pool->active_ops--;
   op_pool_active_ops--;
-  ASSERTM(0, op_pool_active_ops >= 0, "op_pool_active_ops:%u\n", op_pool_active_ops);
-  DEBUG(0, "Freed op  id:%u  op_pool_active_ops: %u\n", op->op_pool_id, op_pool_active_ops);
+  DEBUG(op->proc_id, "Freed op  id:%u  active_ops: %u\n", op->op_pool_id, pool->active_ops);
 
   if (op->sched_info)
     free(op->sched_info);
@@ -158,8 +194,8 @@ void free_op(Op* op) {
     op->inst_info = NULL;
   }
 
-  op->op_pool_next = op_pool_free_head;
-  op_pool_free_head = op;
+  op->op_pool_next = pool->free_head;
+  pool->free_head = op;
   free_wake_up_list(op);
 }
 
@@ -267,24 +303,24 @@ void op_pool_setup_op(uns proc_id, Op* op) {
 }
 
 /**************************************************************************************/
-/* expand_op_pool: */
+/* expand_op_pool: adds a contiguous slab of num_ops ops to the pool of a core,
+   linked in address order so that consecutive allocations walk the slab */
 
-static inline void expand_op_pool() {
-  Op* new_pool = (Op*)calloc(OP_POOL_ENTRIES_INC, sizeof(Op));
+static void expand_op_pool(uns proc_id, uns num_ops) {
+  Op_Pool* pool = &op_pools[proc_id];
+  Op* new_pool = (Op*)calloc(num_ops, sizeof(Op));
   uns ii;
 
-  DEBUGU(0, "Expanding op pool to size %d\n", op_pool_entries + OP_POOL_ENTRIES_INC);
-  for (ii = 0; ii < OP_POOL_ENTRIES_INC - 1; ii++) {
+  ASSERT(proc_id, new_pool);
+  DEBUGU(proc_id, "Expanding op pool of core %u to size %u\n", proc_id, pool->entries + num_ops);
+  for (ii = 0; ii < num_ops; ii++) {
     new_pool[ii].op_pool_valid = FALSE;
-    new_pool[ii].op_pool_next = &new_pool[ii + 1];
+    new_pool[ii].op_pool_next = ii + 1 < num_ops ? &new_pool[ii + 1] : pool->free_head;
     new_pool[ii].op_pool_id = op_pool_entries++;
     op_pool_init_op(&new_pool[ii]);
   }
-  new_pool[ii].op_pool_valid = FALSE;
-  new_pool[ii].op_pool_next = op_pool_free_head;
-  new_pool[ii].op_pool_id = op_pool_entries++;
-  op_pool_init_op(&new_pool[ii]);
 
-  op_pool_free_head = &new_pool[0];
-  ASSERT(0, op_pool_entries <= OP_POOL_ENTRIES_INC * 128);
+  pool->free_head = &new_pool[0];
+  pool->entries += num_ops;
+  ASSERT(proc_id, pool->entries <= OP_POOL_ENTRIES_INC * 128);
 }
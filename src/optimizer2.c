@@ -43,6 +43,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include "globals/assert.h"
@@ -100,6 +101,7 @@ typedef struct Slave_Result_struct {
 static Flag in_use = FALSE;
 static Flag is_leader = TRUE;  // if we have not initialized, there's only one
                                // process which is the leader
+static Flag is_sweep_child = FALSE;
 static uns num_configs;
 static uns master_pid;
 static uns my_config_num;
@@ -376,11 +378,54 @@ void spawn_children() {
   is_leader = TRUE;
 }
 
+void opt2_fork_sweep(uns n, void (*fn)(int)) {
+  uns num_running = 0;
+  uns num_failed = 0;
+  int status;
+
+  ASSERTM(0, !in_use, "Sweeps cannot be combined with other optimizer2 uses.\n");
+  ASSERT(0, n > 0 && OPTIMIZER2_MAX_NUM_SLAVES > 0);
+  DEBUG(0, "Forking %d sweep configurations\n", n);
+  fflush(NULL); /* avoid repeated messages */
+  for (uns config_num = 0; config_num < n; config_num++) {
+    if (num_running == OPTIMIZER2_MAX_NUM_SLAVES) {
+      if (wait(&status) == -1)
+        FATAL_ERROR(0, "wait FAILED. errno: %s\n", strerror(errno));
+      num_failed += !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS;
+      num_running--;
+    }
+    pid_t pid = fork();
+    if (pid == -1)
+      FATAL_ERROR(0, "Fork of sweep config %d FAILED. errno: %s\n", config_num, strerror(errno));
+    if (!pid) {
+      in_use = TRUE;
+      is_sweep_child = TRUE;
+      is_leader = config_num == 0;
+      my_config_num = config_num;
+      decouple_open_files();
+      fn(config_num);
+      return;
+    }
+    num_running++;
+  }
+  while (num_running) {
+    if (wait(&status) == -1)
+      FATAL_ERROR(0, "wait FAILED. errno: %s\n", strerror(errno));
+    num_failed += !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS;
+    num_running--;
+  }
+  if (num_failed)
+    FATAL_ERROR(0, "%d of %d sweep configurations FAILED\n", num_failed, n);
+  exit(EXIT_SUCCESS);
+}
+
 void opt2_decision_point(void) {
   spawn_children();
 }
 
 void opt2_sim_complete(void) {
+  if (is_sweep_child)
+    return; /* the sweep parent only waits for its children */
   send_msg(feedback_write_stream, OPT_SIM_COMPLETE, 0);
   slave_clean_up();
 }
@@ -424,6 +469,9 @@ void decouple_open_files(void) {
       int fd = fds[i];
       if (fd <= 2)
         continue;  // do not decouple standard input/output/error
+      struct stat st;
+      if (fstat(fd, &st) || !S_ISREG(st.st_mode))
+        continue;  // pipes (e.g. bzip2 trace readers) cannot be reopened, their owners handle them
       char fd_path[MAX_STR_LENGTH + 1];
       uns len = snprintf(fd_path, MAX_STR_LENGTH, "/proc/%d/fd/%d", getpid(), fd);
       ASSERT(0, len < MAX_STR_LENGTH);
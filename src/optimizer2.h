@@ -47,6 +47,12 @@ void opt2_decision_point(void);
 /* Called by slave when its simulation is complete */
 void opt2_sim_complete(void);
 
+/* Forks n children (e.g. once warmup is done), calls setup_param_fn(config_num)
+ * in each and returns control to them. The parent keeps at most
+ * OPTIMIZER2_MAX_NUM_SLAVES children running, waits for all of them and exits
+ * (with failure if any child failed); it never returns. */
+void opt2_fork_sweep(uns n, void (*setup_param_fn)(int));
+
 /* Is optimizer2 being used? */
 Flag opt2_in_use(void);
 
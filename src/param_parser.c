@@ -148,12 +148,18 @@ typedef struct Param_Record_struct {
   char optarg[MAX_STR_LENGTH + 1];
 } Param_Record;
 
-void dump_params(char** arg_list, Param_Record used_params[], Flag exe_found);
+static Param_Record used_params[NUM_PARAMS]; /* Keeps track of the values that
+                                                are actually used by the
+                                                simulator. */
+static char** sim_argv;                     /* simulated argv, for dumps */
+
+void dump_params(const char* dir, char** exe_argv, Param_Record used_params[], Flag exe_found);
 
 /**************************************************************************************/
 /* Local prototypes */
 
 static void print_help(void);
+static void parse_arg_list(int arg_list_count, char** arg_list);
 void mark_all_params_as_unused(Param_Record* used_params);
 Flag contains_help_options(int argc, char* argv[]);
 Flag param_file_exists(FILE* f);
@@ -438,9 +444,9 @@ void get_uns64_param(const char* name, uns64* variable) {
 /**************************************************************************************/
 /* dump_params: */
 
-void dump_params(char** arg_list, Param_Record used_params[], Flag exe_found) {
+void dump_params(const char* dir, char** exe_argv, Param_Record used_params[], Flag exe_found) {
   int ii;
-  FILE* arg_stream_out = file_tag_fopen(NULL, ARG_FILE_OUT, "w");
+  FILE* arg_stream_out = file_tag_fopen(dir, ARG_FILE_OUT, "w");
   if (!arg_stream_out) {
     WARNINGU(0, "Couldn't open parameter output file %s.out --- Dumping to stderr.\n", ARG_FILE_OUT);
     arg_stream_out = stderr;
@@ -450,8 +456,8 @@ void dump_params(char** arg_list, Param_Record used_params[], Flag exe_found) {
       fprintf(arg_stream_out, "--%s %s\n", long_options[ii].name, used_params[ii].optarg);
   if (exe_found)
     fprintf(arg_stream_out, "--exe ");
-  for (ii = optind; arg_list[ii]; ii++)
-    fprintf(arg_stream_out, "%s ", arg_list[ii]);
+  for (ii = 0; exe_argv[ii]; ii++)
+    fprintf(arg_stream_out, "%s ", exe_argv[ii]);
 
   fprintf(arg_stream_out, "\n\n--- Cut out everything below to use this file as PARAMS.in ---\n\n");
 
@@ -724,26 +730,15 @@ uns get_param_file_args_and_command_line_args(char*** arg_list_ptr, int argc, ch
   return param_file_arg_count + argc; /*Return the total number of args in the arg_list*/
 }
 
-char** get_params(int argc, char* argv[]) {
-  uns arg_list_count;                   /*Count of all args and values in the arg_list (like argc
-                                           for the command line)*/
-  char** arg_list = NULL;               /*Merged list of all args and values from PARAMS.in
-                                           and the command line (like argv for the command
-                                           line)*/
-  Param_Record used_params[NUM_PARAMS]; /*Keeps track of the values that are
-                                           actually used by the simulator. */
-
-  if (contains_help_options(argc, argv)) {
-    print_help();
-    exit(0);
-  }
-
-  arg_list_count = get_param_file_args_and_command_line_args(&arg_list, argc, argv);
+/* parse_arg_list: Runs getopt over an argv-style list of "--name value" pairs
+   and sets the matching parameters. Leaves optind at the first argument that
+   is not a parameter. */
 
+static void parse_arg_list(int arg_list_count, char** arg_list) {
   int temp_index = 0;
   param_idx = -1;
+  optind = 0;  // (re)initialize getopt, lists may be parsed more than once
   opterr = 0;  // Suppress getopt_long's error message (we have our own)
-  mark_all_params_as_unused(used_params);
   while (getopt_long(arg_list_count, arg_list, "", long_options, &temp_index) != -1) {
     int index = param_idx;
     param_idx = -1;
@@ -765,6 +760,25 @@ char** get_params(int argc, char* argv[]) {
         FATAL_ERROR(0, "Unknown command-line option found (index:%u).\n", index);
     }
   }
+}
+
+char** get_params(int argc, char* argv[]) {
+  uns arg_list_count;     /*Count of all args and values in the arg_list (like argc
+                             for the command line)*/
+  char** arg_list = NULL; /*Merged list of all args and values from PARAMS.in
+                             and the command line (like argv for the command
+                             line)*/
+
+  if (contains_help_options(argc, argv)) {
+    print_help();
+    exit(0);
+  }
+
+  arg_list_count = get_param_file_args_and_command_line_args(&arg_list, argc, argv);
+
+  mark_all_params_as_unused(used_params);
+  parse_arg_list(arg_list_count, arg_list);
+  sim_argv = &arg_list[optind];
 
   // Set global size variables.
   NUM_RS = num_tokens(RS_SIZES, DELIMITERS);
@@ -791,10 +805,48 @@ char** get_params(int argc, char* argv[]) {
   ASSERTM(0, arg_list[arg_list_count] == 0x0,
           "3: Reading in parameters overflowed the space allocated for the "
           "args_list\n");
-  dump_params(arg_list, used_params, FALSE);
-  return &arg_list[optind]; /* return pointer to simulated argv */
+  dump_params(NULL, sim_argv, used_params, FALSE);
+  return sim_argv; /* return pointer to simulated argv */
 }
 
+/**************************************************************************************/
+/* apply_param_overrides: Sets the parameters given as whitespace-separated
+   "--name value" pairs in overrides (one line of a SWEEP_FILE) on top of the
+   current values. Values cannot contain whitespace. */
+
+void apply_param_overrides(const char* overrides) {
+  char* buf = strdup(overrides);
+  uns count = 1;
+  char* tok;
+
+  for (tok = strtok(buf, " \t\n"); tok; tok = strtok(NULL, " \t\n"))
+    count++;
+  free(buf);
+
+  char** list = (char**)calloc(count + 1, sizeof(char*));
+  buf = strdup(overrides);
+  list[0] = (char*)strdup("scarab"); /* exec name, skipped by getopt */
+  count = 1;
+  for (tok = strtok(buf, " \t\n"); tok; tok = strtok(NULL, " \t\n"))
+    list[count++] = tok;
+
+  parse_arg_list(count, list);
+  if (optind != (int)count)
+    FATAL_ERROR(0, "Unexpected argument '%s' in parameter overrides '%s'\n", list[optind], overrides);
+  free(list[0]);
+  free(list);
+  free(buf);
+}
+
+/**************************************************************************************/
+/* dump_params_to_dir: Dumps the current parameter set (including overrides)
+   to the PARAMS file in dir. */
+
+void dump_params_to_dir(const char* dir) {
+  dump_params(dir, sim_argv, used_params, FALSE);
+}
+
+
 static void print_help(void) {
   const char* help =
       "Scarab command-line option summary:\n"
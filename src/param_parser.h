@@ -40,6 +40,8 @@ extern const char* sim_mode_names[];
 /* Prototypes */
 
 char** get_params(int, char*[]);
+void apply_param_overrides(const char*);
+void dump_params_to_dir(const char*);
 void get_bp_mech_param(const char*, uns*);
 void get_btb_mech_param(const char*, uns*);
 void get_ibtb_mech_param(const char*, uns*);
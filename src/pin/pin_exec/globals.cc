@@ -38,6 +38,8 @@ ADDRINT next_eip;
 
 Client*                   scarab;
 ScarabOpBuffer_type       scarab_op_buffer;
+Op_Ring*                  op_ring                   = NULL;
+uint64_t                  op_ring_epoch             = 0;
 compressed_op             op_mailbox;
 bool                      op_mailbox_full           = false;
 bool                      pending_fetch_op          = false;
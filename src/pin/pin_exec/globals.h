@@ -34,6 +34,7 @@
 #undef WARNING
 
 #include "../pin_lib/message_queue_interface_lib.h"
+#include "../pin_lib/op_ring.h"
 #include "read_mem_map.h"
 #include "utils.h"
 
@@ -55,6 +56,8 @@ extern ADDRINT next_eip;
 
 extern Client*                   scarab;
 extern ScarabOpBuffer_type       scarab_op_buffer;
+extern Op_Ring*                  op_ring;
+extern uint64_t                  op_ring_epoch;
 extern compressed_op             op_mailbox;
 extern bool                      op_mailbox_full;
 extern bool                      pending_fetch_op;
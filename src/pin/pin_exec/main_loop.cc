@@ -152,6 +152,7 @@ bool do_fe_recover(Scarab_To_Pin_Msg& cmd, CONTEXT* ctxt) {
   pending_syscall         = false;
   pending_exception       = false;
   buffer_sentinel         = false;
+  op_ring_epoch           = cmd.epoch;
   bool enter_ff           = false;
   if(cmd.type == FE_RECOVER_BEFORE) {
     enter_ff = false;
@@ -186,6 +187,7 @@ bool do_fe_redirect(Scarab_To_Pin_Msg& cmd, CONTEXT* ctxt) {
   pending_syscall         = false;
   pending_exception       = false;
   buffer_sentinel         = false;
+  op_ring_epoch           = cmd.epoch;
   redirect_to_inst(cmd.inst_addr, ctxt, cmd.inst_uid);
   if(on_wrongpath_nop_mode) {
     if(entered_wpnm) {
@@ -240,8 +242,9 @@ void main_loop(CONTEXT* ctxt) {
     }
 
     buffer_ready               = scarab_buffer_full() || pending_syscall;
-    bool send_buffer_to_scarab = buffer_ready && pending_fetch_op &&
-                                 have_consumed_op;
+    bool send_buffer_to_scarab = buffer_ready && have_consumed_op &&
+                                 (pending_fetch_op ||
+                                  (!pending_syscall && scarab_can_send_ahead()));
     if(send_buffer_to_scarab) {
       scarab_send_buffer();
       pending_fetch_op                = false;
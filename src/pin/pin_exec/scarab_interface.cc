@@ -27,6 +27,13 @@ Scarab_To_Pin_Msg get_scarab_cmd() {
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "START: Receiving from Scarab\n");
   cmd = scarab->receive<Scarab_To_Pin_Msg>();
+  if(cmd.type == FE_OP_RING) {
+    // Scarab announces the shared-memory op ring before any other command
+    char path[256];
+    op_ring_path(path, sizeof(path), cmd.inst_addr, cmd.inst_uid);
+    op_ring = op_ring_attach(path);
+    cmd     = scarab->receive<Scarab_To_Pin_Msg>();
+  }
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "END: %d Received from Scarab\n", cmd.type);
 
@@ -44,11 +51,46 @@ bool scarab_buffer_full() {
   // the last two elements of a packet sent to Scarab.
 }
 
+// Without an outstanding FE_FETCH_OP, a full buffer may still be written ahead
+// into the op ring. One batch is always left free for the answer to the next
+// FE_FETCH_OP, so that one never waits on Scarab. Writing ahead stops as soon
+// as Scarab has sent a command: Scarab drops the batches of an old epoch, which
+// frees ring space, so after a redirect or recover the ring alone would never
+// make us stop and read it.
+bool scarab_can_send_ahead() {
+  return op_ring && op_ring_free_batches(op_ring) >= 2 &&
+         !scarab->has_message_to_receive();
+}
+
+static void scarab_write_buffer_to_ring() {
+  Op_Ring_Batch* batch;
+  Op_Ring_Wait   wait = {};
+  ASSERTM(0, scarab_op_buffer.size() <= OP_RING_MAX_BATCH,
+          "%u ops do not fit in an op ring batch, lower max_buffer_size\n",
+          (uint32_t)scarab_op_buffer.size());
+  while(!(batch = op_ring_next_free(op_ring))) {
+    // The protocol keeps a batch free for every answer, so a long wait means
+    // Scarab stopped reading the ring
+    ASSERTM(0, op_ring_wait(&wait, OP_RING_PRODUCER_TIMEOUT),
+            "Scarab freed no op ring batch for %u seconds\n",
+            OP_RING_PRODUCER_TIMEOUT);
+  }
+  batch->epoch       = op_ring_epoch;
+  batch->num_ops     = scarab_op_buffer.size();
+  batch->is_response = pending_fetch_op;
+  std::copy(scarab_op_buffer.begin(), scarab_op_buffer.end(), batch->ops);
+  op_ring_publish(op_ring);
+}
+
 void scarab_send_buffer() {
-  Message<ScarabOpBuffer_type> message = scarab_op_buffer;
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "START: Sending message to Scarab.\n");
-  scarab->send(message);
+  if(op_ring) {
+    scarab_write_buffer_to_ring();
+  } else {
+    Message<ScarabOpBuffer_type> message = scarab_op_buffer;
+    scarab->send(message);
+  }
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "END: Sending message to Scarab.\n");
   scarab_op_buffer.clear();
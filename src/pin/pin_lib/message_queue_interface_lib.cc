@@ -22,6 +22,8 @@
 
 #include "message_queue_interface_lib.h"
 
+#include <poll.h>
+
 extern "C" {}
 
 #define RECEIVE_BUFFER_MAX_SIZE (0x01 << 12)
@@ -239,6 +241,18 @@ int TCPSocket::setNonblocking() {
 #endif
 }
 
+// True if a receive would find data without waiting: bytes already buffered
+// from an earlier read, or a readable (or closed) socket.
+bool TCPSocket::has_data_to_receive(SocketDescriptor socket) {
+  if(!receive_buffer.empty())
+    return true;
+  struct pollfd pfd;
+  pfd.fd      = socket;
+  pfd.events  = POLLIN;
+  pfd.revents = 0;
+  return poll(&pfd, 1, 0) > 0;
+}
+
 void TCPSocket::disconnect(SocketDescriptor socket) {
   close(socket);
 }
@@ -393,6 +407,10 @@ void Client::init(uint32_t requested_client_id) {
   send_requested_client_id(requested_client_id);
 }
 
+bool Client::has_message_to_receive() {
+  return has_data_to_receive(socket_fd);
+}
+
 void Client::disconnect() {
   TCPSocket::disconnect(socket_fd);
 }
@@ -266,6 +266,8 @@ class TCPSocket {
                                 uint32_t         num_bytes_recv);
 #endif
 
+  bool has_data_to_receive(SocketDescriptor socket);
+
   void verify_socket_read(SocketDescriptor new_socket, std::string msg);
   void verify_socket_write(SocketDescriptor new_socket, std::string msg);
   void create_socket_file_descriptor();
@@ -330,6 +332,7 @@ class Client : public TCPSocket {
   void send(const Message<T>& m);
   template <typename T>
   Message<T> receive();
+  bool       has_message_to_receive();  // never blocks
   void       disconnect();
 
 #ifdef GTEST_COMPILE
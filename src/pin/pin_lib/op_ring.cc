@@ -0,0 +1,127 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : op_ring.cc
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Setup of the shared-memory op ring (see op_ring.h)
+ ***************************************************************************************/
+
+#include "op_ring.h"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "message_queue_interface_lib.h"
+
+static size_t op_ring_size(uint32_t num_batches) {
+  return offsetof(Op_Ring, batches) + num_batches * sizeof(Op_Ring_Batch);
+}
+
+static Op_Ring* op_ring_map(const char* path, int flags, size_t size) {
+  int fd = open(path, flags, 0600);
+  if(fd < 0) {
+    perror(path);
+    return NULL;
+  }
+  if((flags & O_CREAT) && ftruncate(fd, size)) {
+    perror(path);
+    close(fd);
+    return NULL;
+  }
+  if(!size) {
+    struct stat st;
+    size = fstat(fd, &st) ? 0 : st.st_size;
+  }
+  void* ring = size < sizeof(Op_Ring) ?
+                 MAP_FAILED :
+                 mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  return ring == MAP_FAILED ? NULL : (Op_Ring*)ring;
+}
+
+void op_ring_path(char* buf, size_t size, uint64_t owner_pid,
+                  uint32_t proc_id) {
+  snprintf(buf, size, "/dev/shm/scarab_op_ring.%llu.%u",
+           (unsigned long long)owner_pid, proc_id);
+}
+
+Op_Ring* op_ring_create(const char* path, uint32_t num_batches) {
+  assertm(num_batches && !(num_batches & (num_batches - 1)),
+          "The op ring size must be a power of two");
+  /* the file is new, so the mapping starts zeroed: head == tail == 0 */
+  unlink(path);
+  Op_Ring* ring = op_ring_map(path, O_RDWR | O_CREAT | O_EXCL,
+                              op_ring_size(num_batches));
+  assertm(ring, "Could not create the shared-memory op ring");
+  ring->num_batches   = num_batches;
+  ring->max_batch_ops = OP_RING_MAX_BATCH;
+  std::atomic_thread_fence(std::memory_order_release);
+  ring->magic = OP_RING_MAGIC;
+  return ring;
+}
+
+void op_ring_destroy(Op_Ring* ring, const char* path) {
+  munmap(ring, op_ring_size(ring->num_batches));
+  unlink(path);
+}
+
+Op_Ring* op_ring_attach(const char* path) {
+  Op_Ring* ring = op_ring_map(path, O_RDWR, 0);
+  assertm(ring, "Could not map the shared-memory op ring");
+  assertm(ring->magic == OP_RING_MAGIC &&
+            ring->max_batch_ops == OP_RING_MAX_BATCH,
+          "Op ring was created by an incompatible Scarab build");
+  return ring;
+}
+
+static uint64_t op_ring_now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+bool op_ring_wait(Op_Ring_Wait* wait, uint32_t timeout_s) {
+  if(wait->polls < OP_RING_WAIT_SPINS) {
+    wait->polls++;
+    sched_yield();
+    return true;
+  }
+  uint64_t now = op_ring_now_us();
+  if(!wait->sleep_us) {
+    wait->sleep_us = 1;
+    wait->start_us = now;
+  } else if(timeout_s &&
+            now - wait->start_us >= (uint64_t)timeout_s * 1000000) {
+    return false;
+  }
+  usleep(wait->sleep_us);
+  if(wait->sleep_us < OP_RING_WAIT_MAX_SLEEP_US)
+    wait->sleep_us *= 2;
+  return true;
+}
@@ -0,0 +1,131 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : op_ring.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Shared-memory ring of compressed_op batches from pin_exec to
+ *                Scarab's PIN exec-driven frontend.
+ ***************************************************************************************/
+
+/* One ring per core, created by Scarab in /dev/shm and announced to pin_exec
+ * with an FE_OP_RING message. pin_exec is the only producer and Scarab the
+ * only consumer, so head and tail are plain release/acquire counters.
+ *
+ * Batches are what used to travel as a ScarabOpBuffer_type message. Scarab
+ * reads them in place. Each batch is tagged with the epoch (number of
+ * redirects/recovers) pin_exec had processed when it was produced, so Scarab
+ * can drop batches built on a path it has already left. is_response marks the
+ * batch that answers an FE_FETCH_OP; every other batch was written ahead
+ * without being asked. Control messages (fetch, redirect, recover, retire)
+ * still go over the socket.
+ */
+
+#ifndef __OP_RING_H__
+#define __OP_RING_H__
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pin_scarab_common_lib.h"
+
+#define OP_RING_MAGIC 0x474e49525043424fULL /* "OBCPRING" */
+#define OP_RING_MAX_BATCH 64                /* ops in one batch */
+#define OP_RING_WAIT_SPINS 256              /* polls before the first sleep */
+#define OP_RING_WAIT_MAX_SLEEP_US 1024      /* sleeps double up to this */
+#define OP_RING_PRODUCER_TIMEOUT 60         /* seconds, pin_exec waiting */
+
+struct Op_Ring_Batch {
+  uint64_t      epoch;
+  uint32_t      num_ops;
+  uint32_t      is_response;
+  compressed_op ops[OP_RING_MAX_BATCH];
+};
+
+struct Op_Ring {
+  uint64_t                          magic;
+  uint32_t                          num_batches; /* power of two */
+  uint32_t                          max_batch_ops;
+  alignas(64) std::atomic<uint64_t> head;  // next batch to consume (Scarab)
+  alignas(64) std::atomic<uint64_t> tail;  // next batch to fill (pin_exec)
+  alignas(64) Op_Ring_Batch         batches[1];
+};
+
+/* Scarab side */
+Op_Ring* op_ring_create(const char* path, uint32_t num_batches);
+void     op_ring_destroy(Op_Ring* ring, const char* path);
+
+/* pin_exec side */
+Op_Ring* op_ring_attach(const char* path);
+
+/* Name of the ring of core proc_id of the Scarab process owner_pid */
+void op_ring_path(char* buf, size_t size, uint64_t owner_pid,
+                  uint32_t proc_id);
+
+/* Either side waiting on the other: the first OP_RING_WAIT_SPINS calls only
+ * yield, later calls sleep, starting at 1us and doubling up to
+ * OP_RING_WAIT_MAX_SLEEP_US. A zeroed Op_Ring_Wait starts a new wait. */
+struct Op_Ring_Wait {
+  uint32_t polls;
+  uint32_t sleep_us;
+  uint64_t start_us; /* time of the first sleep */
+};
+
+/* Backs off once. Returns false once timeout_s seconds have passed since the
+ * first sleep of this wait, never if timeout_s is 0. */
+bool op_ring_wait(Op_Ring_Wait* wait, uint32_t timeout_s);
+
+static inline uint32_t op_ring_free_batches(const Op_Ring* ring) {
+  return ring->num_batches -
+         (uint32_t)(ring->tail.load(std::memory_order_relaxed) -
+                    ring->head.load(std::memory_order_acquire));
+}
+
+/* Producer: batch to fill, valid until op_ring_publish(). NULL if full. */
+static inline Op_Ring_Batch* op_ring_next_free(Op_Ring* ring) {
+  if(!op_ring_free_batches(ring))
+    return NULL;
+  uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+  return &ring->batches[tail & (ring->num_batches - 1)];
+}
+
+static inline void op_ring_publish(Op_Ring* ring) {
+  ring->tail.store(ring->tail.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+}
+
+/* Consumer: oldest published batch, valid until op_ring_release(). NULL if
+ * empty. */
+static inline Op_Ring_Batch* op_ring_peek(Op_Ring* ring) {
+  uint64_t head = ring->head.load(std::memory_order_relaxed);
+  if(ring->tail.load(std::memory_order_acquire) == head)
+    return NULL;
+  return &ring->batches[head & (ring->num_batches - 1)];
+}
+
+static inline void op_ring_release(Op_Ring* ring) {
+  ring->head.store(ring->head.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+}
+
+#endif
@@ -47,6 +47,7 @@ typedef enum Scarab_To_Pin_Cmd_enum {
   FE_RECOVER_BEFORE,
   FE_RECOVER_AFTER,
   FE_RETIRE,
+  FE_OP_RING, /* op ring of Scarab pid inst_addr, core inst_uid is ready */
   FE_NUM_COMMANDS
 } Scarab_To_Pin_Cmd;
 
@@ -54,6 +55,7 @@ struct Scarab_To_Pin_Msg {
   Scarab_To_Pin_Cmd type;
   uint64_t          inst_uid;
   Addr              inst_addr;
+  uint64_t          epoch; /* redirects/recovers sent so far (op ring only) */
 } __attribute__((packed));
 
 typedef std::deque<compressed_op> ScarabOpBuffer_type;
@@ -48,6 +48,7 @@
 
 #include "ctype_pin_inst.h"
 #include "math.h"
+#include "op_pool.h"
 #include "statistics.h"
 
 /**************************************************************************************/
@@ -433,6 +434,24 @@ void uop_generator_get_uop(uns proc_id, Op* op, ctype_pin_inst* inst) {
   }
 }
 
+/**************************************************************************************/
+/* uop_generator_get_uops: the uops of the current instruction, at most max of
+   them, into ops allocated from the op pool. inst is only read at the
+   beginning of an instruction. Returns how many ops were filled; the last one
+   is the eom unless max cut the instruction short. */
+
+uns uop_generator_get_uops(uns proc_id, Op** ops, uns max, compressed_op* inst) {
+  uns num = 0;
+
+  ASSERT(proc_id, max > 0);
+  do {
+    Op* op = alloc_op(proc_id);
+    uop_generator_get_uop(proc_id, op, bom[proc_id] ? inst : NULL);
+    ops[num++] = op;
+  } while (!eom[proc_id] && num < max);
+  return num;
+}
+
 Flag uop_generator_get_bom(uns proc_id) {
   return bom[proc_id];
 }
@@ -891,12 +910,12 @@ void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi, Trace_Uop** trace
         info = cpp_hash_table_access_create(proc_id, pi->instruction_addr, pi->inst_binary_lsb, pi->inst_binary_msb, ii,
                                             &new_entry);
       }
-      ASSERT(proc_id, !new_entry);
+      ASSERTD(proc_id, !new_entry);
 
       trace_uop[ii]->info = info;
       trace_uop[ii]->eom = FALSE;
-      ASSERT(proc_id, info->addr == pi->instruction_addr);
-      ASSERT(proc_id, info->trace_info.inst_size == pi->size);
+      ASSERTD(proc_id, info->addr == pi->instruction_addr);
+      ASSERTD(proc_id, info->trace_info.inst_size == pi->size);
 
       Flag is_last_uop = (ii == (num_uop - 1));
       convert_dyn_uop(proc_id, info, pi, trace_uop[ii], info->table_info->mem_size, is_last_uop);
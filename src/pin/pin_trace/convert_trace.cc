@@ -0,0 +1,162 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Converts a .bz2 PIN trace into the chunked, seekable format described in
+ * frontend/pin_trace_chunked.h:
+ *
+ *   convert_trace [-c raw|zlib] [-l level] [-n insts_per_chunk] <in.bz2> <out>
+ *
+ * raw chunks are larger on disk but are read in place with no decompression;
+ * zlib chunks are inflated by the simulator's decode threads.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <inttypes.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+
+#include "../../ctype_pin_inst.h"
+#include "../../frontend/pin_trace_chunked.h"
+
+using namespace std;
+
+static void write_or_die(FILE* out, const void* data, size_t size) {
+  if(size && fwrite(data, 1, size, out) != size) {
+    perror("convert_trace: write");
+    exit(1);
+  }
+}
+
+static void pad_to_align(FILE* out) {
+  static const char zeros[PIN_TRACE_CHUNK_ALIGN] = {0};
+  long pos = ftell(out);
+  write_or_die(out, zeros,
+               (PIN_TRACE_CHUNK_ALIGN - pos % PIN_TRACE_CHUNK_ALIGN) %
+                 PIN_TRACE_CHUNK_ALIGN);
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t codec           = PIN_TRACE_CODEC_ZLIB;
+  int      level           = Z_DEFAULT_COMPRESSION;
+  uint32_t insts_per_chunk = PIN_TRACE_DEFAULT_INSTS_PER_CHUNK;
+  int      opt;
+
+  while((opt = getopt(argc, argv, "c:l:n:")) != -1) {
+    switch(opt) {
+      case 'c':
+        if(!strcmp(optarg, "raw"))
+          codec = PIN_TRACE_CODEC_RAW;
+        else if(!strcmp(optarg, "zlib"))
+          codec = PIN_TRACE_CODEC_ZLIB;
+        else {
+          cerr << "Unknown codec " << optarg << endl;
+          exit(1);
+        }
+        break;
+      case 'l':
+        level = atoi(optarg);
+        break;
+      case 'n':
+        insts_per_chunk = strtoul(optarg, NULL, 0);
+        break;
+      default:
+        exit(1);
+    }
+  }
+  if(argc - optind != 2 || insts_per_chunk == 0) {
+    cerr << "Usage: convert_trace [-c raw|zlib] [-l level] [-n "
+            "insts_per_chunk] <trace.bz2> <output>"
+         << endl;
+    exit(1);
+  }
+
+  char cmdline[1024];
+  snprintf(cmdline, sizeof(cmdline), "bzip2 -dc %s", argv[optind]);
+  FILE* in  = popen(cmdline, "r");
+  FILE* out = fopen(argv[optind + 1], "wb");
+  if(!in || !out) {
+    perror("convert_trace");
+    exit(1);
+  }
+
+  Pin_Trace_Chunked_Header hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, PIN_TRACE_CHUNKED_MAGIC, sizeof(hdr.magic));
+  hdr.version         = PIN_TRACE_CHUNKED_VERSION;
+  hdr.inst_size       = sizeof(ctype_pin_inst);
+  hdr.codec           = codec;
+  hdr.insts_per_chunk = insts_per_chunk;
+  /* the header is rewritten once the counts are known */
+  write_or_die(out, &hdr, sizeof(hdr));
+
+  vector<ctype_pin_inst>        insts(insts_per_chunk);
+  vector<Bytef>                 packed;
+  vector<Pin_Trace_Chunk_Index> index;
+  size_t                        num;
+
+  while((num = fread(insts.data(), sizeof(ctype_pin_inst), insts_per_chunk,
+                     in)) > 0) {
+    Pin_Trace_Chunk_Index entry;
+    uLong                 raw_size = num * sizeof(ctype_pin_inst);
+    const void*           data     = insts.data();
+    uLongf                size     = raw_size;
+
+    if(codec == PIN_TRACE_CODEC_ZLIB) {
+      packed.resize(compressBound(raw_size));
+      size = packed.size();
+      if(compress2(packed.data(), &size, (const Bytef*)insts.data(), raw_size,
+                   level) != Z_OK) {
+        cerr << "zlib compression failed" << endl;
+        exit(1);
+      }
+      data = packed.data();
+    }
+
+    pad_to_align(out);
+    entry.offset    = ftell(out);
+    entry.size      = size;
+    entry.num_insts = num;
+    write_or_die(out, data, size);
+    index.push_back(entry);
+    hdr.num_insts += num;
+  }
+  pclose(in);
+
+  pad_to_align(out);
+  hdr.num_chunks   = index.size();
+  hdr.index_offset = ftell(out);
+  write_or_die(out, index.data(), index.size() * sizeof(index[0]));
+  fseek(out, 0, SEEK_SET);
+  write_or_die(out, &hdr, sizeof(hdr));
+  if(fclose(out)) {
+    perror("convert_trace");
+    exit(1);
+  }
+
+  cout << hdr.num_insts << " instructions in " << hdr.num_chunks
+       << " chunks written to " << argv[optind + 1] << endl;
+  return 0;
+}
@@ -147,11 +147,13 @@ class FDIP {
   void init(uns proc_id);
   void recover();
   void update();
+  void idle_skip(Counter cycles);
   void set_ic_ref(Icache_Stage* ic) { ic_ref = ic; }
   Flag is_off_path();
   Flag is_conf_off_path();
   Counter get_last_recover_cycle() { return fdip_stat.last_recover_cycle; }
   Op* get_cur_op() { return cur_op; }
+  uint64_t get_ftq_offset() { return decoupled_fe_ftq_iter_offset(ftq_iter); }
   void update_unuseful_lines_uc(Addr line_addr);
   void update_useful_lines_uc(Addr line_addr);
   void update_useful_lines_bloom_filter(Addr line_addr);
@@ -238,6 +240,12 @@ void update_fdip() {
   fdip->update();
 }
 
+void fdip_idle_skip(uns proc_id, Counter cycles) {
+  if (!FDIP_ENABLE)
+    return;
+  per_core_fdip[proc_id].idle_skip(cycles);
+}
+
 uns64 fdip_get_ghist() {
   return g_bp_data->global_hist;
 }
@@ -380,6 +388,12 @@ Counter fdip_get_last_recover_cycle() {
   return fdip->get_last_recover_cycle();
 }
 
+uint64_t fdip_get_ftq_offset(uns proc_id) {
+  if (!FDIP_ENABLE)
+    return 0;
+  return per_core_fdip[proc_id].get_ftq_offset();
+}
+
 /* FDIP_Stat member functions */
 void FDIP_Stat::print_cl_info(Icache_Stage* ic_ref) {
   uns proc_id = fdip->get_proc_id();
@@ -1025,6 +1039,14 @@ void FDIP::update() {
   fdip_stat.last_break_reason = break_reason;
 }
 
+/* Account the per-cycle FTQ occupancy of cycles skipped by IDLE_SKIP, in
+ * which update() would have found the same FTQ state. */
+void FDIP::idle_skip(Counter cycles) {
+  fdip_stat.ftq_occupancy_ops += decoupled_fe_ftq_iter_offset(ftq_iter) * cycles;
+  if (fdip_stat.last_break_reason == BR_REACH_FTQ_END)
+    fdip_stat.ftq_occupancy_blocks += decoupled_fe_ftq_iter_ft_offset(ftq_iter) * cycles;
+}
+
 Flag FDIP::is_off_path() {
   ASSERT(proc_id, cur_op);
   return cur_op->off_path;
@@ -1289,7 +1311,7 @@ Flag FDIP::determine_usefulness(Addr line_addr, Op* op) {
     if (!fdip_off_path())
       emit_new_prefetch = TRUE;
     else {
-      emit_new_prefetch = buf_map_find(line_addr);
+      emit_new_prefetch = buf_map_find(proc_id, line_addr);
       if (emit_new_prefetch)
         STAT_EVENT(proc_id, FDIP_MEM_BUF_FOUND);
       else
@@ -38,6 +38,7 @@ extern "C" {
 void alloc_mem_fdip(uns numProcs);
 void init_fdip(uns proc_id);
 void update_fdip();
+void fdip_idle_skip(uns proc_id, Counter cycles);
 void recover_fdip();
 void set_fdip(int _proc_id, Icache_Stage* _ic);
 Flag fdip_off_path();
@@ -69,6 +70,8 @@ Flag fdip_search_pref_candidate(Addr addr);
 void assert_fdip_break_reason(Addr line_addr);
 Op* fdip_get_cur_op();
 Counter fdip_get_last_recover_cycle();
+/* ops of the FTQ FDIP has already walked (0 if FDIP is off) */
+uint64_t fdip_get_ftq_offset(uns proc_id);
 
 #ifdef __cplusplus
 }
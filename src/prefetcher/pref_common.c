@@ -650,6 +650,45 @@ void pref_update(void) {
   }
 }
 
+/* pref_queues_empty: TRUE if no request waits in a prefetch request queue */
+Flag pref_queues_empty(void) {
+  if (!PREF_FRAMEWORK_ON)
+    return TRUE;
+  for (uns proc_id = 0; proc_id < (PREF_SHARED_QUEUES ? 1 : NUM_CORES); proc_id++) {
+    HWP_Core* core = pref.cores[proc_id];
+    for (uns ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
+      if (core->dl0req_queue[ii].valid)
+        return FALSE;
+    }
+    for (uns ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
+      if (core->umlc_req_queue[ii].valid)
+        return FALSE;
+    }
+    for (uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
+      if (core->ul1req_queue[ii].valid)
+        return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/* pref_idle_skip: with empty queues every pref_update() moves the send
+ * positions ahead by the schedule widths, so cycles skipped by IDLE_SKIP
+ * only move them further */
+void pref_idle_skip(Counter cycles) {
+  if (!PREF_FRAMEWORK_ON)
+    return;
+  for (uns proc_id = 0; proc_id < (PREF_SHARED_QUEUES ? 1 : NUM_CORES); proc_id++) {
+    HWP_Core* core = pref.cores[proc_id];
+    core->dl0req_queue_send_pos = (core->dl0req_queue_send_pos + cycles * PREF_DL0SCHEDULE_NUM) %
+                                  PREF_DL0REQ_QUEUE_SIZE;
+    core->umlc_req_queue_send_pos = (core->umlc_req_queue_send_pos + cycles * PREF_UMLC_SCHEDULE_NUM) %
+                                    PREF_UMLC_REQ_QUEUE_SIZE;
+    core->ul1req_queue_send_pos = (core->ul1req_queue_send_pos + cycles * PREF_UL1SCHEDULE_NUM) %
+                                  PREF_UL1REQ_QUEUE_SIZE;
+  }
+}
+
 void pref_update_core(uns proc_id) {
   // first check the dl0 req queue to see if they can be satisfied by the dl0.
   // otherwise send them to the ul1 by putting them in the ul1req queue
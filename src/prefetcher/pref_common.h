@@ -199,6 +199,8 @@ void pref_ul1_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_
 void pref_ul1_pref_hit_late(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist, uns8 prefetcher_id);
 
 void pref_update(void);
+Flag pref_queues_empty(void);
+void pref_idle_skip(Counter cycles);
 
 // returns true if req hits in the req queue. It also invalidates the request in
 // the pref queue.
@@ -27,8 +27,6 @@
  ***************************************************************************************/
 
 #include <deque>
-#include <list>
-#include <map>
 #include <utility>
 
 #include "ramulator/Config.h"
@@ -38,6 +36,8 @@
 extern "C" {
 #include "globals/assert.h"
 
+#include "libs/hash_lib.h"
+
 #include "general.param.h"
 #include "memory/memory.param.h"
 #include "ramulator.param.h"
@@ -70,8 +70,15 @@ void stats_callback(int coreid, int type);
 deque<pair<long, Mem_Req*>> resp_queue;  // completed read request that need to
                                          // send back to Scarab
 
-map<long, list<Mem_Req*>> inflight_read_reqs;
-// map<long, Mem_Req*> inflight_read_reqs;
+// Scarab requests waiting on an in-flight Ramulator read, keyed by address.
+// Kept in the open-addressing hash_lib table so that issuing and completing
+// a read does not allocate.
+typedef struct Inflight_Read_struct {
+  uns num_reqs;
+  Mem_Req* reqs[2];  // the issued request and at most one duplicate
+} Inflight_Read;
+
+Hash_Table inflight_read_reqs;
 
 void ramulator_init() {
   ASSERTM(0, ICACHE_LINE_SIZE == DCACHE_LINE_SIZE,
@@ -84,12 +91,16 @@ void ramulator_init() {
   configs = new Config();
   init_configs();
 
+  init_hash_table(&inflight_read_reqs, "Ramulator inflight reads", 256, sizeof(Inflight_Read));
+
   wrapper = new ScarabWrapper(*configs, DCACHE_LINE_SIZE, &stats_callback);
 
   DPRINTF("Initialized Ramulator. \n");
 }
 
 void ramulator_finish() {
+  if (!wrapper)
+    return;  // models without a memory system (bp) never set it up
   wrapper->finish();
 
   delete wrapper;
@@ -176,17 +187,16 @@ int ramulator_send(Mem_Req* scarab_req) {
   // Mem_Req_Type_str(scarab_req->type), scarab_req->addr);
 
   // does inflight_read_reqs have the proc_id in the req?
-  auto it_scarab_req = inflight_read_reqs.find(req.addr);
-  if (it_scarab_req != inflight_read_reqs.end() && req.type == Request::Type::READ) {
+  Inflight_Read* inflight = (Inflight_Read*)hash_table_access(&inflight_read_reqs, req.addr);
+  if (inflight && req.type == Request::Type::READ) {
     DEBUG(scarab_req->proc_id, "Ramulator: Duplicate (%s) request to address %llx\n",
           Mem_Req_Type_str(scarab_req->type), scarab_req->addr);
     // Can have duplicate Ifetch and Dfetch requests, but only one of each
-    ASSERT(0, it_scarab_req->second.size() <= 1);
+    ASSERT(0, inflight->num_reqs <= 1);
 
     /* save it as an inflight request so later it will be moved to the resp_queue
      * at the same time with the older request */
-    if (req.type == Request::Type::READ)
-      inflight_read_reqs[req.addr].push_back(scarab_req);
+    inflight->reqs[inflight->num_reqs++] = scarab_req;
 
     scarab_req->mem_queue_cycle = cycle_count;
     return true;  // a request to the same address is already issued
@@ -198,11 +208,13 @@ int ramulator_send(Mem_Req* scarab_req) {
     STAT_EVENT(scarab_req->proc_id, POWER_MEMORY_CTRL_ACCESS);
 
     if (req.type == Request::Type::READ) {
-      ASSERTM(0, inflight_read_reqs.find(req.addr) == inflight_read_reqs.end(),
+      Flag new_entry;
+      inflight = (Inflight_Read*)hash_table_access_create(&inflight_read_reqs, req.addr, &new_entry);
+      ASSERTM(0, new_entry,
               "ERROR: A read request to the same address shouldn't be sent "
               "multiple times to Ramulator\n");
-      // inflight_read_reqs[req.addr] = scarab_req;
-      inflight_read_reqs[req.addr].push_back(scarab_req);
+      inflight->num_reqs = 1;
+      inflight->reqs[0] = scarab_req;
       STAT_EVENT(scarab_req->proc_id, POWER_MEMORY_CTRL_READ);
     } else if (req.type == Request::Type::WRITE) {
       STAT_EVENT(scarab_req->proc_id, POWER_MEMORY_CTRL_WRITE);
@@ -223,16 +235,15 @@ int ramulator_send(Mem_Req* scarab_req) {
 void enqueue_response(Request& req) {
   // This should only be called by READ requests
   ASSERTM(0, req.type == Request::Type::READ, "ERROR: Responses should be sent only for read requests! \n");
-  ASSERTM(0, inflight_read_reqs.find(req.addr) != inflight_read_reqs.end(),
+  Inflight_Read* inflight = (Inflight_Read*)hash_table_access(&inflight_read_reqs, req.addr);
+  ASSERTM(0, inflight,
           "ERROR: A corresponding Scarab request was not found for the "
           "Ramulator request that read address: %lu\n",
           req.addr);
 
-  auto it_scarab_req = inflight_read_reqs.find(req.addr);
-  for (auto req : it_scarab_req->second)
-    resp_queue.push_back(make_pair(it_scarab_req->first, req));
-  // resp_queue.push_back(make_pair(it_scarab_req->first, it_scarab_req->second));
-  inflight_read_reqs.erase(it_scarab_req);
+  for (uns ii = 0; ii < inflight->num_reqs; ii++)
+    resp_queue.push_back(make_pair(req.addr, inflight->reqs[ii]));
+  hash_table_access_delete(&inflight_read_reqs, req.addr);
 }
 
 bool try_completing_request(Mem_Req* req) {
@@ -315,11 +326,12 @@ Mem_Req* ramulator_search_queue(long phys_addr, Mem_Req_Type type) {
               (type == MRT_DSTORE) || (type == MRT_MIN_PRIORITY) || (type == MRT_FDIPPRFON) ||
               (type == MRT_FDIPPRFOFF) || (type == MRT_UOCPRF),
           "Ramulator: Cannot search write requests in Ramulator request queue\n");
-  auto it_req = inflight_read_reqs.find(phys_addr);
+  Inflight_Read* inflight = (Inflight_Read*)hash_table_access(&inflight_read_reqs, phys_addr);
 
   // Search request queue
-  if (it_req != inflight_read_reqs.end()) {
-    for (auto req : it_req->second) {
+  if (inflight) {
+    for (uns ii = 0; ii < inflight->num_reqs; ii++) {
+      Mem_Req* req = inflight->reqs[ii];
       if ((req->type == MRT_IFETCH || req->type == MRT_IPRF || req->type == MRT_FDIPPRFON ||
            req->type == MRT_FDIPPRFOFF || req->type == MRT_UOCPRF) &&
           (type == MRT_IFETCH || type == MRT_IPRF || type == MRT_FDIPPRFON || type == MRT_FDIPPRFOFF ||
@@ -24,9 +24,7 @@
 
 #include <cassert>
 #include <cstdio>
-#include <deque>
 #include <fstream>
-#include <list>
 #include <string>
 #include <vector>
 
@@ -96,8 +94,11 @@ public:
     RowTable<T>* rowtable;  // tracks metadata about rows (e.g., which are open and for how long)
     Refresh<T>* refresh;
 
+    // Requests are kept in arrival order in contiguous storage that is
+    // reserved up front, so enqueueing never allocates and the scheduler
+    // scans a flat array instead of chasing list nodes.
     struct Queue {
-        list<Request> q;
+        vector<Request> q;
         unsigned int max = 32;
         unsigned int size() {return q.size();}
     };
@@ -111,7 +112,7 @@ public:
                    // after ACTIVATE w/o READ of WRITE command)
     Queue otherq;  // queue for all "other" requests (e.g., refresh)
 
-    deque<Request> pending;  // read requests that are about to receive data from DRAM
+    RequestRing pending;  // read requests that are about to receive data from DRAM
     bool write_mode = false;  // whether write requests should be prioritized over reads
     float wr_high_watermark = 0.8f; // threshold for switching to write mode
     float wr_low_watermark = 0.2f; // threshold for switching back to read mode
@@ -154,6 +155,10 @@ public:
 
         readq.max = (unsigned int) configs.get_int("readq_entries");
         writeq.max = (unsigned int) configs.get_int("writeq_entries");
+        readq.q.reserve(readq.max);
+        writeq.q.reserve(writeq.max);
+        actq.q.reserve(readq.max + writeq.max);
+        otherq.q.reserve(otherq.max);
 
         // regStats
 
@@ -353,7 +358,7 @@ public:
         // shortcut for read requests, if a write to same addr exists
         // necessary for coherence
         if (req.type == Request::Type::READ && find_if(writeq.q.begin(), writeq.q.end(),
-                [req](Request& wreq){ return req.addr == wreq.addr;}) != writeq.q.end()){
+                [&req](Request& wreq){ return req.addr == wreq.addr;}) != writeq.q.end()){
             req.depart = clk + 1;
             pending.push_back(req);
             readq.q.pop_back();
@@ -419,7 +424,7 @@ public:
         if (req == queue->q.end() || !is_ready(req)) {
             // we couldn't find a command to schedule -- let's try to be speculative
             auto cmd = T::Command::PRE;
-            vector<int> victim = rowpolicy->get_victim(cmd);
+            AddrVec victim = rowpolicy->get_victim(cmd);
             if (!victim.empty()){
                 issue_cmd(cmd, victim, 0);
             }
@@ -469,8 +474,10 @@ public:
         if (!(channel->spec->is_accessing(cmd) || channel->spec->is_refreshing(cmd))) {
             if(channel->spec->is_opening(cmd)) {
                 // promote the request that caused issuing activation to actq
-                actq.q.push_back(*req);
+                // (copied out first: queue may be actq itself)
+                Request promoted = *req;
                 queue->q.erase(req);
+                actq.q.push_back(promoted);
             }
 
             return;
@@ -490,37 +497,37 @@ public:
         queue->q.erase(req);
     }
 
-    bool is_ready(list<Request>::iterator req)
+    bool is_ready(vector<Request>::iterator req)
     {
         typename T::Command cmd = get_first_cmd(req);
         return channel->check(cmd, req->addr_vec.data(), clk);
     }
 
-    bool is_ready(typename T::Command cmd, const vector<int>& addr_vec)
+    bool is_ready(typename T::Command cmd, const AddrVec& addr_vec)
     {
         return channel->check(cmd, addr_vec.data(), clk);
     }
 
-    bool is_row_hit(list<Request>::iterator req)
+    bool is_row_hit(vector<Request>::iterator req)
     {
         // cmd must be decided by the request type, not the first cmd
         typename T::Command cmd = channel->spec->translate[int(req->type)];
         return channel->check_row_hit(cmd, req->addr_vec.data());
     }
 
-    bool is_row_hit(typename T::Command cmd, const vector<int>& addr_vec)
+    bool is_row_hit(typename T::Command cmd, const AddrVec& addr_vec)
     {
         return channel->check_row_hit(cmd, addr_vec.data());
     }
 
-    bool is_row_open(list<Request>::iterator req)
+    bool is_row_open(vector<Request>::iterator req)
     {
         // cmd must be decided by the request type, not the first cmd
         typename T::Command cmd = channel->spec->translate[int(req->type)];
         return channel->check_row_open(cmd, req->addr_vec.data());
     }
 
-    bool is_row_open(typename T::Command cmd, const vector<int>& addr_vec)
+    bool is_row_open(typename T::Command cmd, const AddrVec& addr_vec)
     {
         return channel->check_row_open(cmd, addr_vec.data());
     }
@@ -559,7 +566,7 @@ public:
     }
 
 private:
-    typename T::Command get_first_cmd(list<Request>::iterator req)
+    typename T::Command get_first_cmd(vector<Request>::iterator req)
     {
         typename T::Command cmd = channel->spec->translate[int(req->type)];
         return channel->decode(cmd, req->addr_vec.data());
@@ -567,7 +574,7 @@ private:
 
     // upgrade to an autoprecharge command
     void cmd_issue_autoprecharge(typename T::Command& cmd,
-                                            const vector<int>& addr_vec) {
+                                            const AddrVec& addr_vec) {
 
         // currently, autoprecharge is only used with closed row policy
         if(channel->spec->is_accessing(cmd) && rowpolicy->type == RowPolicy<T>::Type::ClosedAP) {
@@ -575,15 +582,13 @@ private:
             Queue* queue = write_mode ? &writeq : &readq;
 
             auto begin = addr_vec.begin();
-            vector<int> rowgroup(begin, begin + int(T::Level::Row) + 1);
+            auto end = begin + int(T::Level::Row) + 1;
 
 			int num_row_hits = 0;
 
             for (auto itr = queue->q.begin(); itr != queue->q.end(); ++itr) {
                 if (is_row_hit(itr)) { 
-                    auto begin2 = itr->addr_vec.begin();
-                    vector<int> rowgroup2(begin2, begin2 + int(T::Level::Row) + 1);
-                    if(rowgroup == rowgroup2)
+                    if(equal(begin, end, itr->addr_vec.begin()))
                         num_row_hits++;
                 }
             }
@@ -592,9 +597,7 @@ private:
                 Queue* queue = &actq;
                 for (auto itr = queue->q.begin(); itr != queue->q.end(); ++itr) {
                     if (is_row_hit(itr)) {
-                        auto begin2 = itr->addr_vec.begin();
-                        vector<int> rowgroup2(begin2, begin2 + int(T::Level::Row) + 1);
-                        if(rowgroup == rowgroup2)
+                        if(equal(begin, end, itr->addr_vec.begin()))
                             num_row_hits++;
                     }
                 }
@@ -615,7 +618,7 @@ private:
 
     }
 
-    void issue_cmd(typename T::Command cmd, const vector<int>& addr_vec, int coreid)
+    void issue_cmd(typename T::Command cmd, const AddrVec& addr_vec, int coreid)
     {
         cmd_issue_autoprecharge(cmd, addr_vec);
         assert(is_ready(cmd, addr_vec));
@@ -663,17 +666,17 @@ private:
             printf("\n");
         }
     }
-    vector<int> get_addr_vec(typename T::Command cmd, list<Request>::iterator req){
+    AddrVec get_addr_vec(typename T::Command cmd, vector<Request>::iterator req){
         return req->addr_vec;
     }
 };
 
 template <>
-vector<int> Controller<SALP>::get_addr_vec(
-    SALP::Command cmd, list<Request>::iterator req);
+AddrVec Controller<SALP>::get_addr_vec(
+    SALP::Command cmd, vector<Request>::iterator req);
 
 template <>
-bool Controller<SALP>::is_ready(list<Request>::iterator req);
+bool Controller<SALP>::is_ready(vector<Request>::iterator req);
 
 template <>
 void Controller<ALDRAM>::update_temp(ALDRAM::Temp current_temperature);
@@ -683,7 +686,7 @@ void Controller<TLDRAM>::tick();
 
 template <>
 void Controller<TLDRAM>::cmd_issue_autoprecharge(typename TLDRAM::Command& cmd,
-                                                    const vector<int>& addr_vec);
+                                                    const AddrVec& addr_vec);
 
 } /*namespace ramulator*/
 
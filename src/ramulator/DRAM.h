@@ -117,7 +117,7 @@ private:
     // Timing
     long cur_clk = 0;
     long next[int(T::Command::MAX)]; // the earliest time in the future when a command could be ready
-    deque<long> prev[int(T::Command::MAX)]; // the most recent history of when commands were issued
+    vector<long> prev[int(T::Command::MAX)]; // the most recent history of when commands were issued (a few entries, newest first)
 
     // Lookup table for which commands must be preceded by which other commands (i.e., "prerequisite")
     // E.g., a read command to a closed bank must be preceded by an activate command
@@ -390,7 +390,7 @@ void DRAM<T>::update_timing(typename T::Command cmd, const int* addr, long clk)
     // I am a target node
     if (prev[int(cmd)].size()) {
         prev[int(cmd)].pop_back();  // FIXME TIANSHI why pop back?
-        prev[int(cmd)].push_front(clk); // update history
+        prev[int(cmd)].insert(prev[int(cmd)].begin(), clk); // update history, reusing the same storage
     }
 
     for (auto& t : timing[int(cmd)]) {
@@ -59,8 +59,8 @@ Processor::Processor(const Config& configs,
     }
   }
   for (int i = 0 ; i < tracenum ; ++i) {
-    cores[i]->callback = std::bind(&Processor::receive, this,
-        placeholders::_1);
+    cores[i]->callback = &Processor::receive_callback;
+    cores[i]->callback_context = this;
   }
 
   // regStats
@@ -86,6 +86,10 @@ void Processor::tick() {
   }
 }
 
+void Processor::receive_callback(Request& req) {
+  static_cast<Processor*>(req.context)->receive(req);
+}
+
 void Processor::receive(Request& req) {
   if (!no_shared_cache) {
     llc.callback(req);
@@ -259,6 +263,7 @@ void Core::tick()
         if (window.is_full()) return;
 
         Request req(req_addr, req_type, callback, id);
+        req.context = callback_context;
         if (!send(req)) return;
 
         window.insert(false, req_addr);
@@ -268,6 +273,7 @@ void Core::tick()
         // write request
         assert(req_type == Request::Type::WRITE);
         Request req(req_addr, req_type, callback, id);
+        req.context = callback_context;
         if (!send(req)) return;
         cpu_inst++;
     }
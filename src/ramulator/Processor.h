@@ -96,7 +96,8 @@ class Core {
   bool   finished();
   bool   has_reached_limit();
   long   get_insts();  // the number of the instructions issued to the core
-  function<void(Request&)> callback;
+  Request::Callback callback = Request::ignore_callback;
+  void* callback_context = nullptr;
 
   bool no_core_caches  = true;
   bool no_shared_cache = true;
@@ -140,6 +141,7 @@ class Processor {
             function<bool(Request)> send, MemoryBase& memory);
   void tick();
   void receive(Request& req);
+  static void receive_callback(Request& req);  // req.context is the Processor
   void reset_stats();
   bool finished();
   bool has_reached_limit();
@@ -73,7 +73,7 @@ void Refresh<DSARP>::early_inject_refresh() {
   Controller<DSARP>::Queue& rdq = ctrl->readq;
 
   // Figure out which banks are idle in order to refresh one of them
-  for (auto req: rdq.q)
+  for (const auto& req: rdq.q)
   {
     assert(req.addr_vec[level_chan] == ctrl->channel->id);
     int ridx = req.addr_vec[level_rank] * max_bank_count;
@@ -95,7 +95,7 @@ void Refresh<DSARP>::early_inject_refresh() {
 
       // Pending refresh
       bool pending_ref = false;
-      for (Request req : ctrl->otherq.q)
+      for (const Request& req : ctrl->otherq.q)
         if (req.type == Request::Type::REFRESH
             && req.addr_vec[level_chan] == ctrl->channel->id
             && req.addr_vec[level_rank] == r && req.addr_vec[level_bank] == bidx)
@@ -143,7 +143,7 @@ void Refresh<DSARP>::inject_refresh(bool b_ref_rank) {
         bool ref_now = false;
         // 1. Any pending refrehes?
         bool pending_ref = false;
-        for (Request req : ctrl->otherq.q) {
+        for (const Request& req : ctrl->otherq.q) {
           if (req.type == Request::Type::REFRESH) {
             pending_ref = true;
             break;
@@ -187,7 +187,7 @@ void Refresh<DSARP>::wrp() {
   {
     // Pending refresh in the rank?
     bool pending_ref = false;
-    for (Request req : ctrl->otherq.q) {
+    for (const Request& req : ctrl->otherq.q) {
       if (req.type == Request::Type::REFRESH && req.addr_vec[level_rank] == ref_rid) {
         pending_ref = true;
         break;
@@ -202,7 +202,7 @@ void Refresh<DSARP>::wrp() {
       sorted_bank_demand.push_back(wrq_idx(0,b));
     // Filter out all the writes to this rank
     int total_wr = 0;
-    for (auto req : ctrl->writeq.q) {
+    for (const auto& req : ctrl->writeq.q) {
       if (req.addr_vec[level_rank] == ref_rid) {
         sorted_bank_demand[req.addr_vec[level_bank]].first++;
         total_wr++;
@@ -213,7 +213,7 @@ void Refresh<DSARP>::wrp() {
       continue;
 
     // Add read
-    for (auto req : ctrl->readq.q)
+    for (const auto& req : ctrl->readq.q)
       if (req.addr_vec[level_rank] == ref_rid)
         sorted_bank_demand[req.addr_vec[level_bank]].first++;
 
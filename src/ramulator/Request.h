@@ -22,21 +22,81 @@
 #ifndef __REQUEST_H
 #define __REQUEST_H
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
-#include <functional>
 
 using namespace std;
 
 namespace ramulator
 {
 
+// Decoded DRAM address (channel, rank, ..., row, column), stored inline so
+// that a Request is a plain value that can be copied between the controller
+// queues without touching the heap. Mirrors the parts of the vector<int>
+// interface that the controller and schedulers use.
+class AddrVec
+{
+public:
+    static const int MAX_LEVELS = 8;
+
+    AddrVec() : len(0) { fill(lev, lev + MAX_LEVELS, -1); }
+
+    AddrVec(int n, int val) : len(n)
+    {
+        assert(n <= MAX_LEVELS);
+        fill(lev, lev + MAX_LEVELS, -1);
+        fill(lev, lev + n, val);
+    }
+
+    AddrVec(const int* first, const int* last) : len(int(last - first))
+    {
+        assert(len <= MAX_LEVELS);
+        fill(lev, lev + MAX_LEVELS, -1);
+        copy(first, last, lev);
+    }
+
+    int size() const { return len; }
+    bool empty() const { return len == 0; }
+    void resize(int n) { assert(n <= MAX_LEVELS); len = n; }
+
+    int* data() { return lev; }
+    const int* data() const { return lev; }
+    int* begin() { return lev; }
+    const int* begin() const { return lev; }
+    int* end() { return lev + len; }
+    const int* end() const { return lev + len; }
+
+    int& operator[](int i) { return lev[i]; }
+    const int& operator[](int i) const { return lev[i]; }
+
+    bool operator==(const AddrVec& other) const
+    {
+        return len == other.len && equal(begin(), end(), other.begin());
+    }
+
+    bool operator<(const AddrVec& other) const
+    {
+        return lexicographical_compare(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    int lev[MAX_LEVELS];
+    int len;
+};
+
 class Request
 {
 public:
+    // Completion callbacks are plain functions: a Request is copied through
+    // several queues on its way to DRAM, and a std::function member would
+    // make every one of those copies a potential heap allocation.
+    typedef void (*Callback)(Request&);
+
     bool is_first_command;
     long addr;
     // long addr_row;
-    vector<int> addr_vec;
+    AddrVec addr_vec;
     // specify which core this request sent from, for virtual address translation
     int coreid;
 
@@ -53,20 +113,67 @@ public:
 
     long arrive = -1;
     long depart = -1;
-    function<void(Request&)> callback; // call back with more info
+    Callback callback; // call back with more info
+    void* context = nullptr; // opaque pointer for the callback's owner
 
     Request(long addr, Type type, int coreid = 0)
         : is_first_command(true), addr(addr), coreid(coreid), type(type),
-      callback([](Request& req){}) {}
+      callback(ignore_callback) {}
 
-    Request(long addr, Type type, function<void(Request&)> callback, int coreid = 0)
+    Request(long addr, Type type, Callback callback, int coreid = 0)
         : is_first_command(true), addr(addr), coreid(coreid), type(type), callback(callback) {}
 
-    Request(vector<int>& addr_vec, Type type, function<void(Request&)> callback, int coreid = 0)
-        : is_first_command(true), addr_vec(addr_vec), coreid(coreid), type(type), callback(callback) {}
+    Request(const AddrVec& addr_vec, Type type, Callback callback, int coreid = 0)
+        : is_first_command(true), addr(0), addr_vec(addr_vec), coreid(coreid), type(type), callback(callback) {}
 
     Request()
-        : is_first_command(true), coreid(0) {}
+        : is_first_command(true), addr(0), coreid(0), type(Type::READ), callback(ignore_callback) {}
+
+    static void ignore_callback(Request& req) {}
+};
+
+// FIFO of requests on a ring buffer. Used for the controller's pending
+// reads, which are pushed and popped every few DRAM cycles; unlike a deque
+// it keeps its storage once it has grown to the steady-state occupancy.
+class RequestRing
+{
+public:
+    RequestRing(unsigned int capacity = 64) : buf(capacity) {}
+
+    unsigned int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    Request& front() { return buf[head]; }
+    Request& operator[](unsigned int i) { return buf[(head + i) % buf.size()]; }
+
+    void push_back(const Request& req)
+    {
+        if (count == buf.size())
+            grow();
+        buf[(head + count) % buf.size()] = req;
+        count++;
+    }
+
+    void pop_front()
+    {
+        assert(count > 0);
+        head = (head + 1) % buf.size();
+        count--;
+    }
+
+private:
+    vector<Request> buf;
+    unsigned int head = 0;
+    unsigned int count = 0;
+
+    void grow()
+    {
+        vector<Request> bigger(buf.size() * 2);
+        for (unsigned int i = 0; i < count; i++)
+            bigger[i] = (*this)[i];
+        buf.swap(bigger);
+        head = 0;
+    }
 };
 
 } /*namespace ramulator*/
@@ -25,10 +25,8 @@
 #include "DRAM.h"
 #include "Request.h"
 #include "Controller.h"
+#include <algorithm>
 #include <vector>
-#include <map>
-#include <list>
-#include <functional>
 #include <cassert>
 
 using namespace std;
@@ -68,7 +66,7 @@ sure to set RAMULATOR_SCHEDULING_POLICY to one of the \
 available policies: FCFS, FRFCFS, FRFCFS_Cap, \
 FRFCFS_PriorHit"); }
 
-    list<Request>::iterator get_head(list<Request>& q)
+    vector<Request>::iterator get_head(vector<Request>& q)
     {
       // TODO make the decision at compile time
       if (policy != Policy::FRFCFS_PriorHit) {
@@ -77,7 +75,7 @@ FRFCFS_PriorHit"); }
 
         auto head = q.begin();
         for (auto itr = next(q.begin(), 1); itr != q.end(); itr++)
-            head = compare[int(policy)](head, itr);
+            head = compare(policy, head, itr);
 
         return head;
       } else {
@@ -86,23 +84,22 @@ FRFCFS_PriorHit"); }
 
         auto head = q.begin();
         for (auto itr = next(q.begin(), 1); itr != q.end(); itr++) {
-            head = compare[int(Policy::FRFCFS_PriorHit)](head, itr);
+            head = compare(Policy::FRFCFS_PriorHit, head, itr);
         }
 
         if (this->ctrl->is_ready(head) && this->ctrl->is_row_hit(head)) {
           return head;
         }
 
+        // TODO Here it assumes all DRAM standards use PRE to close a row
+        // It's better to make it more general.
+        int rowgroup_len = int(ctrl->channel->spec->scope[int(T::Command::PRE)]) + 1; // bank or subarray
+
         // prepare a list of hit request
-        vector<vector<int>> hit_reqs;
+        hit_reqs.clear();
         for (auto itr = q.begin() ; itr != q.end() ; ++itr) {
           if (this->ctrl->is_row_hit(itr)) {
-            auto begin = itr->addr_vec.begin();
-            // TODO Here it assumes all DRAM standards use PRE to close a row
-            // It's better to make it more general.
-            auto end = begin + int(ctrl->channel->spec->scope[int(T::Command::PRE)]) + 1;
-            vector<int> rowgroup(begin, end); // bank or subarray
-            hit_reqs.push_back(rowgroup);
+            hit_reqs.push_back(itr->addr_vec);
           }
         }
         // if we can't find proper request, we need to return q.end(),
@@ -113,12 +110,8 @@ FRFCFS_PriorHit"); }
           if ((!this->ctrl->is_row_hit(itr)) && this->ctrl->is_row_open(itr)) {
             // so the next instruction to be scheduled is PRE, might violate hit
             auto begin = itr->addr_vec.begin();
-            // TODO Here it assumes all DRAM standards use PRE to close a row
-            // It's better to make it more general.
-            auto end = begin + int(ctrl->channel->spec->scope[int(T::Command::PRE)]) + 1;
-            vector<int> rowgroup(begin, end); // bank or subarray
-            for (const auto& hit_req_rowgroup : hit_reqs) {
-              if (rowgroup == hit_req_rowgroup) {
+            for (const auto& hit_req : hit_reqs) {
+              if (equal(begin, begin + rowgroup_len, hit_req.begin())) {
                   violate_hit = true;
                   break;
               }
@@ -131,7 +124,7 @@ FRFCFS_PriorHit"); }
           if (head == q.end()) {
             head = itr;
           } else {
-            head = compare[int(Policy::FRFCFS)](head, itr);
+            head = compare(Policy::FRFCFS, head, itr);
           }
         }
 
@@ -140,54 +133,52 @@ FRFCFS_PriorHit"); }
     }
 
 private:
-    typedef list<Request>::iterator ReqIter;
-    function<ReqIter(ReqIter, ReqIter)> compare[int(Policy::MAX)] = {
-        // FCFS
-        [this] (ReqIter req1, ReqIter req2) {
-            if (req1->arrive <= req2->arrive) return req1;
-            return req2;},
+    typedef vector<Request>::iterator ReqIter;
 
-        // FRFCFS
-        [this] (ReqIter req1, ReqIter req2) {
-            bool ready1 = this->ctrl->is_ready(req1);
-            bool ready2 = this->ctrl->is_ready(req2);
+    vector<AddrVec> hit_reqs;  // scratch space of FRFCFS_PriorHit, kept across ticks
 
-            if (ready1 ^ ready2) {
-                if (ready1) return req1;
-                return req2;
-            }
+    // Called for every pair of queued requests on every DRAM cycle, so the
+    // policies are a switch rather than a table of std::function objects.
+    ReqIter compare(Policy p, ReqIter req1, ReqIter req2)
+    {
+        bool ready1, ready2;
 
+        switch (p) {
+        case Policy::FCFS:
             if (req1->arrive <= req2->arrive) return req1;
-            return req2;},
+            return req2;
 
-        // FRFCFS_CAP
-        [this] (ReqIter req1, ReqIter req2) {
-            bool ready1 = this->ctrl->is_ready(req1);
-            bool ready2 = this->ctrl->is_ready(req2);
+        case Policy::FRFCFS:
+            ready1 = this->ctrl->is_ready(req1);
+            ready2 = this->ctrl->is_ready(req2);
+            break;
+
+        case Policy::FRFCFS_Cap:
+            ready1 = this->ctrl->is_ready(req1);
+            ready2 = this->ctrl->is_ready(req2);
 
             ready1 = ready1 && (this->ctrl->rowtable->get_hits(req1->addr_vec) <= this->cap);
             ready2 = ready2 && (this->ctrl->rowtable->get_hits(req2->addr_vec) <= this->cap);
+            break;
 
-            if (ready1 ^ ready2) {
-                if (ready1) return req1;
-                return req2;
-            }
+        case Policy::FRFCFS_PriorHit:
+            ready1 = this->ctrl->is_ready(req1) && this->ctrl->is_row_hit(req1);
+            ready2 = this->ctrl->is_ready(req2) && this->ctrl->is_row_hit(req2);
+            break;
 
-            if (req1->arrive <= req2->arrive) return req1;
-            return req2;},
-        // FRFCFS_PriorHit
-        [this] (ReqIter req1, ReqIter req2) {
-            bool ready1 = this->ctrl->is_ready(req1) && this->ctrl->is_row_hit(req1);
-            bool ready2 = this->ctrl->is_ready(req2) && this->ctrl->is_row_hit(req2);
-
-            if (ready1 ^ ready2) {
-                if (ready1) return req1;
-                return req2;
-            }
+        default:
+            assert(false && "Unknown memory request scheduler.");
+            return req1;
+        }
 
-            if (req1->arrive <= req2->arrive) return req1;
-            return req2;}
-    };
+        if (ready1 ^ ready2) {
+            if (ready1) return req1;
+            return req2;
+        }
+
+        if (req1->arrive <= req2->arrive) return req1;
+        return req2;
+    }
 };
 
 
@@ -205,37 +196,26 @@ public:
 
     RowPolicy(Controller<T>* ctrl) : ctrl(ctrl) {}
 
-    vector<int> get_victim(typename T::Command cmd)
+    AddrVec get_victim(typename T::Command cmd)
     {
-        return policy[int(type)](cmd);
-    }
-
-private:
-    function<vector<int>(typename T::Command)> policy[int(Type::MAX)] = {
+        switch (type) {
         // Closed
-        [this] (typename T::Command cmd) -> vector<int> {
-            for (auto& kv : this->ctrl->rowtable->table) {
-                if (!this->ctrl->is_ready(cmd, kv.first))
-                    continue;
-                return kv.first;
-            }
-            return vector<int>();},
-
+        case Type::Closed:
         // ClosedAP
-        [this] (typename T::Command cmd) -> vector<int> {
+        case Type::ClosedAP:
             for (auto& kv : this->ctrl->rowtable->table) {
                 if (!this->ctrl->is_ready(cmd, kv.first))
                     continue;
                 return kv.first;
             }
-            return vector<int>();},
+            return AddrVec();
 
         // Opened
-        [this] (typename T::Command cmd) {
-            return vector<int>();},
+        case Type::Opened:
+            return AddrVec();
 
         // Timeout
-        [this] (typename T::Command cmd) -> vector<int> {
+        case Type::Timeout:
             for (auto& kv : this->ctrl->rowtable->table) {
                 auto& entry = kv.second;
                 if (this->ctrl->clk - entry.timestamp < timeout)
@@ -244,9 +224,13 @@ private:
                     continue;
                 return kv.first;
             }
-            return vector<int>();}
-    };
+            return AddrVec();
 
+        default:
+            assert(false && "Unknown row policy.");
+            return AddrVec();
+        }
+    }
 };
 
 
@@ -262,25 +246,33 @@ public:
         long timestamp;
     };
 
-    map<vector<int>, Entry> table;
+    // Open rows keyed by their row group (the address above the row level),
+    // kept sorted by key like the std::map it replaces so that the row
+    // policies visit victims in the same order. There is at most one entry
+    // per bank (or subarray), so a flat array beats a node-based map here.
+    typedef pair<AddrVec, Entry> Row;
+    vector<Row> table;
 
     RowTable(Controller<T>* ctrl) : ctrl(ctrl) {}
 
-    void update(typename T::Command cmd, const vector<int>& addr_vec, long clk)
+    void update(typename T::Command cmd, const AddrVec& addr_vec, long clk)
     {
         auto begin = addr_vec.begin();
         auto end = begin + int(T::Level::Row);
-        vector<int> rowgroup(begin, end); // bank or subarray
+        AddrVec rowgroup(begin, end); // bank or subarray
         int row = *end;
 
         T* spec = ctrl->channel->spec;
 
-        if (spec->is_opening(cmd))
-            table.insert({rowgroup, {row, 0, clk}});
+        if (spec->is_opening(cmd)) {
+            auto pos = lower_bound(rowgroup);
+            if (pos == table.end() || !(pos->first == rowgroup))
+                table.insert(pos, Row(rowgroup, {row, 0, clk}));
+        }
 
         if (spec->is_accessing(cmd)) {
             // we are accessing a row -- update its entry
-            auto match = table.find(rowgroup);
+            auto match = find(rowgroup);
             assert(match != table.end());
             assert(match->second.row == row);
             match->second.hits++;
@@ -309,15 +301,15 @@ public:
         } /* closing */
     }
 
-    int get_hits(const vector<int>& addr_vec, const bool to_opened_row = false)
+    int get_hits(const AddrVec& addr_vec, const bool to_opened_row = false)
     {
         auto begin = addr_vec.begin();
         auto end = begin + int(T::Level::Row);
 
-        vector<int> rowgroup(begin, end);
+        AddrVec rowgroup(begin, end);
         int row = *end;
 
-        auto itr = table.find(rowgroup);
+        auto itr = find(rowgroup);
         if (itr == table.end())
             return 0;
 
@@ -327,18 +319,33 @@ public:
         return itr->second.hits;
     }
 
-    int get_open_row(const vector<int>& addr_vec) {
+    int get_open_row(const AddrVec& addr_vec) {
         auto begin = addr_vec.begin();
         auto end = begin + int(T::Level::Row);
 
-        vector<int> rowgroup(begin, end);
+        AddrVec rowgroup(begin, end);
 
-        auto itr = table.find(rowgroup);
+        auto itr = find(rowgroup);
         if(itr == table.end())
             return -1;
 
         return itr->second.row;
     }
+
+private:
+    typename vector<Row>::iterator lower_bound(const AddrVec& rowgroup)
+    {
+        return std::lower_bound(table.begin(), table.end(), rowgroup,
+            [](const Row& row, const AddrVec& key) { return row.first < key; });
+    }
+
+    typename vector<Row>::iterator find(const AddrVec& rowgroup)
+    {
+        auto pos = lower_bound(rowgroup);
+        if (pos != table.end() && pos->first == rowgroup)
+            return pos;
+        return table.end();
+    }
 };
 
 } /*namespace ramulator*/
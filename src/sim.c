@@ -28,9 +28,13 @@
 
 #include "sim.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <math.h>
 #include <signal.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <time.h>
 
 #include "globals/assert.h"
@@ -47,7 +51,10 @@
 
 #include "bp/bp.param.h"
 #include "core.param.h"
+#include "dvfs/dvfs.param.h"
 #include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/l2l1pref.param.h"
 #include "prefetcher/pref.param.h"
 
 #include "frontend/frontend.h"
@@ -57,13 +64,18 @@
 #include "prefetcher/eip.h"
 #include "prefetcher/fdip.h"
 
+#include "bp_model.h"
+#include "checkpoint.h"
 #include "cmp_model.h"
 #include "dumb_model.h"
 #include "freq.h"
 #include "model.h"
 #include "op_pool.h"
 #include "optimizer2.h"
+#include "param_parser.h"
 #include "ramulator.h"
+#include "simprof.h"
+#include "stat_sink.h"
 #include "stat_trace.h"
 #include "statistics.h"
 #include "thread.h"
@@ -149,6 +161,13 @@ static inline double sim_progress(void);
 static inline void set_last_sim_param(uns8 proc_id);
 static inline void print_bogus_sim_param(uns8 proc_id);
 
+static void init_idle_skip(void);
+static void idle_skip_cycle(void);
+
+static void init_sampling(void);
+static void sample_cycle(void);
+static void sample_done(void);
+
 /**************************************************************************************/
 /* handle_SIGINT: this handler is for exiting smoothly when a SIGINT is caught
  */
@@ -496,6 +515,7 @@ void init_global(char* argv[], char* envp[]) {
     init_global_stats(proc_id);
   process_params();
   stat_trace_init();
+  stat_sink_init();
   if (SIM_MODEL != DUMB_MODEL)
     frontend_init();
   power_intf_init();
@@ -627,6 +647,332 @@ void uop_sim() {
   }
 }
 
+/**************************************************************************************/
+/* Idle skipping: cycles in which the model reports that nothing can happen
+ * are not simulated. Their only effect, the per-cycle stat events, is
+ * replayed from the stat deltas of the last simulated idle cycle. */
+
+static Counter* idle_stat_snapshot;   /* stat counts before the last simulated cycle */
+static Counter* idle_stat_delta;      /* stat events of the last idle cycle */
+static Flag idle_stat_delta_valid = FALSE;
+
+static void init_idle_skip(void) {
+  ASSERTM(0, model->next_event_func, "Model %s does not support IDLE_SKIP\n", model->name);
+  ASSERTM(0, CHIP_CYCLE_TIME, "IDLE_SKIP requires the cores and L1 to share CHIP_CYCLE_TIME\n");
+  ASSERTM(0, !DUMB_CORE_ON && !DVFS_ON && !PERF_PRED_ENABLE && !CONFIDENCE_ENABLE && !L1_PART_ON,
+          "IDLE_SKIP does not support DUMB_CORE_ON, DVFS_ON, PERF_PRED_ENABLE, CONFIDENCE_ENABLE or L1_PART_ON\n");
+  ASSERTM(0, !PREF_HFILTER_ON || !PREF_HFILTER_RESET_ENABLE, "IDLE_SKIP does not support PREF_HFILTER_RESET_ENABLE\n");
+  ASSERTM(0, !STATS_TO_TRACE && !PIPEVIEW && !MEMVIEW, "IDLE_SKIP does not support per-cycle traces\n");
+  ASSERTM(0, !DEBUG_CYCLE_STOP, "IDLE_SKIP does not support the H2P logs (DEBUG_CYCLE_STOP)\n");
+  /* these prefetchers act on time windows that are not tracked as timers */
+  ASSERTM(0, !L2L1PREF_ON, "IDLE_SKIP does not support L2L1PREF_ON\n");
+  ASSERTM(0, !FDIP_ENABLE || (!FDIP_UTILITY_HASH_ENABLE && !FDIP_UC_SIZE && !FDIP_BLOOM_FILTER),
+          "IDLE_SKIP does not support FDIP_UTILITY_HASH_ENABLE, FDIP_UC_SIZE or FDIP_BLOOM_FILTER\n");
+  ASSERTM(0, !strcmp(SIM_LIMIT, "none") && !strcmp(CLEAR_STATS, "never"),
+          "IDLE_SKIP does not support SIM_LIMIT and CLEAR_STATS triggers\n");
+
+  idle_stat_snapshot = (Counter*)malloc(sizeof(Counter) * NUM_CORES * NUM_GLOBAL_STATS);
+  idle_stat_delta = (Counter*)malloc(sizeof(Counter) * NUM_CORES * NUM_GLOBAL_STATS);
+}
+
+static void idle_stat_take_snapshot(void) {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+      idle_stat_snapshot[proc_id * NUM_GLOBAL_STATS + ii] = global_stat_array[proc_id][ii].count;
+    }
+  }
+}
+
+/* Returns FALSE if the cycle changed a stat that cannot be replayed */
+static Flag idle_stat_compute_delta(void) {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+      Stat* stat = &global_stat_array[proc_id][ii];
+      Counter delta = stat->count - idle_stat_snapshot[proc_id * NUM_GLOBAL_STATS + ii];
+      if (delta && stat->type == FLOAT_TYPE_STAT)
+        return FALSE;
+      idle_stat_delta[proc_id * NUM_GLOBAL_STATS + ii] = delta;
+    }
+  }
+  return TRUE;
+}
+
+static void idle_stat_replay(Counter cycles) {
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+      global_stat_array[proc_id][ii].count += idle_stat_delta[proc_id * NUM_GLOBAL_STATS + ii] * cycles;
+    }
+  }
+}
+
+/* Simulates the current cycle, or skips it together with every following
+ * cycle before the model's next event */
+static void idle_skip_cycle(void) {
+  Counter now = freq_time();
+  Counter next_event = model->next_event_func();
+
+  if (next_event > now && idle_stat_delta_valid) {
+    Counter first_cycle = freq_cycle_count(FREQ_DOMAIN_L1);
+    freq_skip_until(next_event);
+    Counter skipped_cycles = freq_cycle_count(FREQ_DOMAIN_L1) - first_cycle + 1;
+    idle_stat_replay(skipped_cycles);
+    if (model->idle_skip_func)
+      model->idle_skip_func(skipped_cycles);
+    INC_STAT_EVENT_ALL(IDLE_SKIPPED_CYCLES, skipped_cycles);
+    return;
+  }
+
+  /* Only a cycle in which the chip ran alone can stand in for a skipped one */
+  Flag chip_only_cycle = freq_is_ready(FREQ_DOMAIN_L1) && !freq_is_ready(FREQ_DOMAIN_MEMORY);
+  if (next_event > now)
+    idle_stat_take_snapshot();
+  model->cycle_func();
+  /* A memory cycle can complete requests, so the chip has to run once
+   * more before it can be found idle again */
+  if (chip_only_cycle)
+    idle_stat_delta_valid = next_event > now && model->next_event_func() > now && idle_stat_compute_delta();
+  else
+    idle_stat_delta_valid = FALSE;
+}
+
+/**************************************************************************************/
+/* Sampled simulation (SMARTS): after warmup the run alternates between a
+ * detailed phase of SAMPLE_DETAILED_WARMUP + SAMPLE_DETAILED instructions and
+ * a functional warming phase of SAMPLE_WARMING instructions that only trains
+ * the caches and the branch predictor (model->warmup_func). The decoupled
+ * frontend is given a fetch budget for each detailed phase, so the pipeline
+ * drains by itself before the frontend is moved ahead functionally. Stats
+ * are accumulated over the SAMPLE_DETAILED windows only; the per-window CPIs
+ * give the confidence interval written to sampling.out. */
+
+typedef enum Sample_State_enum {
+  SAMPLE_DETAILED_WARMING,  // detailed, not measured
+  SAMPLE_MEASURING,         // detailed, measured
+  SAMPLE_DRAINING,          // waiting for the fetch budget to leave the pipeline
+} Sample_State;
+
+static Sample_State sample_state;
+static Counter sample_measure_start;  // instruction count at which the window starts
+static Counter sample_measure_end;    // instruction count at which the window (and fetch) ends
+static Counter sample_start_cycle;
+static Counter sample_start_inst;
+static Stat* sample_snapshot;  // stats at the start of the current window
+static Stat* sample_accum;     // stats summed over the finished windows
+static FILE* sample_file;
+static uns64 sample_windows;
+static Counter sample_insts;
+static Counter sample_cycles;
+static double sample_cpi_sum;
+static double sample_cpi_sq_sum;
+static Flag sample_stats_done;
+
+static void sample_take_snapshot(void) {
+  memcpy(sample_snapshot, global_stat_array[0], sizeof(Stat) * NUM_GLOBAL_STATS);
+  sample_start_cycle = cycle_count;
+  sample_start_inst = inst_count[0];
+  sample_state = SAMPLE_MEASURING;
+}
+
+static void sample_start_detailed(void) {
+  sample_measure_start = inst_count[0] + SAMPLE_DETAILED_WARMUP;
+  sample_measure_end = sample_measure_start + SAMPLE_DETAILED;
+  sample_state = SAMPLE_DETAILED_WARMING;
+  decoupled_fe_set_fetch_budget(0, SAMPLE_DETAILED_WARMUP + SAMPLE_DETAILED);
+  if (!SAMPLE_DETAILED_WARMUP)
+    sample_take_snapshot();
+}
+
+static void init_sampling(void) {
+  ASSERTM(0, NUM_CORES == 1, "SAMPLE_DETAILED works only for single core\n");
+  ASSERTM(0, model->warmup_func, "Model %s does not have a warmup function\n", model->name);
+  ASSERTM(0, !IDLE_SKIP && !PERIODIC_DUMP && !strcmp(CLEAR_STATS, "never"),
+          "SAMPLE_DETAILED does not support IDLE_SKIP, PERIODIC_DUMP and CLEAR_STATS\n");
+
+  sample_snapshot = (Stat*)malloc(sizeof(Stat) * NUM_GLOBAL_STATS);
+  sample_accum = (Stat*)calloc(NUM_GLOBAL_STATS, sizeof(Stat));
+  sample_file = file_tag_fopen(OUTPUT_DIR, "sampling", "w");
+  ASSERTM(0, sample_file, "Could not open sampling output file in %s\n", OUTPUT_DIR);
+  fprintf(sample_file, "# detailed warmup %llu  window %llu  functional warming %llu instructions\n",
+          SAMPLE_DETAILED_WARMUP, SAMPLE_DETAILED, SAMPLE_WARMING);
+  fprintf(sample_file, "# %8s %16s %10s %10s %10s\n", "window", "start_inst", "insts", "cycles", "CPI");
+  sample_start_detailed();
+}
+
+/* Runs the instructions of the warming phase through the warmup function,
+   as uop_sim() does for WARMUP */
+static void sample_functional_warming(Counter insts) {
+  Op op;
+  Table_Info table_info;
+  Inst_Info inst_info;
+  op.table_info = &table_info;
+  op.inst_info = &inst_info;
+  op.mbp7_info = NULL;
+
+  Counter end = inst_count[0] + insts;
+  if (INST_LIMIT)
+    end = MIN2(end, inst_limit[0]);
+
+  while (inst_count[0] < end && !retired_exit[0]) {
+    do {
+      frontend_fetch_op(0, &op);
+      if (op.exit)
+        retired_exit[0] = TRUE;
+      else
+        model->warmup_func(&op);
+      if (op.eom) {
+        inst_count[0]++;
+        inst_count_fetched[0]++;
+        frontend_retire(op.proc_id, op.inst_uid);
+      }
+    } while (!op.eom);
+    // HACK that ensures that cache replacement works in warmup
+    do {
+      freq_advance_time();
+    } while (!freq_is_ready(FREQ_DOMAIN_L1));
+    sim_time = freq_time();
+  }
+  cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  last_forward_progress[0] = cycle_count;
+}
+
+static void sample_end_window(void) {
+  Counter insts = inst_count[0] - sample_start_inst;
+  Counter cycles = cycle_count - sample_start_cycle;
+  double cpi = (double)cycles / insts;
+
+  sample_state = SAMPLE_DRAINING;
+  if (!insts)  // the detailed warmup retired past a very short window
+    return;
+
+  for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    Stat* stat = &global_stat_array[0][ii];
+    if (stat->type == FLOAT_TYPE_STAT)
+      sample_accum[ii].value += stat->value - sample_snapshot[ii].value;
+    else
+      sample_accum[ii].count += stat->count - sample_snapshot[ii].count;
+  }
+  sample_windows++;
+  sample_insts += insts;
+  sample_cycles += cycles;
+  sample_cpi_sum += cpi;
+  sample_cpi_sq_sum += cpi * cpi;
+  fprintf(sample_file, "  %8llu %16llu %10llu %10llu %10.4f\n", sample_windows, sample_start_inst, insts, cycles,
+          cpi);
+}
+
+/* The pipeline is empty once the budget is retired and no recovery is pending */
+static Flag sample_core_drained(void) {
+  return cmp_model.node_stage[0].node_count == 0 && cmp_model.bp_recovery_info[0].recovery_cycle == MAX_CTR &&
+         cmp_model.bp_recovery_info[0].redirect_cycle == MAX_CTR;
+}
+
+static void sample_cycle(void) {
+  if (sample_state == SAMPLE_DRAINING && sample_core_drained() && !retired_exit[0]) {
+    sample_functional_warming(SAMPLE_WARMING);
+    sample_start_detailed();
+  }
+  if (sample_state == SAMPLE_DETAILED_WARMING && inst_count[0] >= sample_measure_start)
+    sample_take_snapshot();
+  if (sample_state == SAMPLE_MEASURING && inst_count[0] >= sample_measure_end)
+    sample_end_window();
+}
+
+/* Replaces the stats of the whole run by their sum over the finished windows
+   before the final dump (stats marked NORESET keep their run-long value) */
+static void sample_done(void) {
+  if (sample_stats_done)
+    return;
+  sample_stats_done = TRUE;
+
+  if (!sample_windows) {
+    fprintf(sample_file, "# no window finished, the stats cover the whole run\n");
+    fprintf(mystdout, "** Sampling: no window finished, the stats cover the whole run\n");
+    fclose(sample_file);
+    return;
+  }
+
+  double mean = sample_cpi_sum / sample_windows;
+  double var = sample_windows > 1 ? (sample_cpi_sq_sum - sample_windows * mean * mean) / (sample_windows - 1) : 0;
+  double stddev = sqrt(MAX2(var, 0.0));
+  double half = 1.96 * stddev / sqrt(sample_windows);  // 95% confidence, normal approximation
+
+  fprintf(sample_file, "# windows %llu  insts %llu  cycles %llu  IPC %.5f\n", sample_windows, sample_insts,
+          sample_cycles, (double)sample_insts / sample_cycles);
+  fprintf(sample_file, "# CPI mean %.5f  stddev %.5f  CoV %.5f\n", mean, stddev, stddev / mean);
+  if (sample_windows > 1)
+    fprintf(sample_file, "# CPI 95%% confidence interval %.5f +- %.5f (+- %.2f%%)\n", mean, half,
+            100.0 * half / mean);
+  else
+    fprintf(sample_file, "# CPI 95%% confidence interval needs at least 2 windows\n");
+  fclose(sample_file);
+  fprintf(mystdout, "** Sampling: %llu windows  CPI %.5f +- %.2f%% (95%% confidence)\n", sample_windows, mean,
+          100.0 * half / mean);
+
+  for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    Stat* stat = &global_stat_array[0][ii];
+    if (stat->noreset)
+      continue;
+    if (stat->type == FLOAT_TYPE_STAT)
+      stat->value = sample_accum[ii].value;
+    else
+      stat->count = sample_accum[ii].count;
+  }
+  /* the cycle and instruction counts of the run stay as they are; the
+     windows get their own stats, SAMPLE_INST_COUNT is printed as their IPC */
+  INC_STAT_EVENT(0, SAMPLE_CYCLES, sample_cycles);
+  INC_STAT_EVENT(0, SAMPLE_INST_COUNT, sample_insts);
+}
+
+/**************************************************************************************/
+/* SWEEP_FILE: after warmup the simulation is forked once per line of the
+   sweep file, and each child simulates with the parameter overrides of its
+   line applied on top of the command line. */
+
+static char** sweep_configs;
+
+static uns read_sweep_file(void) {
+  FILE* file = fopen(SWEEP_FILE, "r");
+  char line[MAX_STR_LENGTH + 1];
+  uns num = 0;
+
+  ASSERTM(0, file, "Could not open sweep file %s\n", SWEEP_FILE);
+  ASSERTM(0, FRONTEND == FE_TRACE || FRONTEND == FE_SYNTH, "SWEEP_FILE requires the trace or synth frontend\n");
+  while (fgets(line, MAX_STR_LENGTH, file)) {
+    char* start = line + strspn(line, " \t\n");
+    if (!*start || *start == '#')
+      continue;
+    ASSERTM(0, strchr(start, '\n') || feof(file), "Sweep file %s has a line longer than %d characters\n",
+            SWEEP_FILE, MAX_STR_LENGTH);
+    start[strcspn(start, "\n")] = 0;
+    sweep_configs = (char**)realloc(sweep_configs, (num + 1) * sizeof(char*));
+    sweep_configs[num++] = strdup(start);
+  }
+  fclose(file);
+  ASSERTM(0, num, "Sweep file %s has no configurations\n", SWEEP_FILE);
+  return num;
+}
+
+/* runs in the child forked for line config_num of the sweep file */
+static void setup_sweep_config(int config_num) {
+  char dir[MAX_STR_LENGTH + 1];
+
+  close_output_streams();  // reopened below in the child's own OUTPUT_DIR
+  mystdout = stdout;
+  mystderr = stderr;
+  mystatus = NULL;
+
+  snprintf(dir, MAX_STR_LENGTH, "%s/sweep%d", OUTPUT_DIR, config_num);
+  OUTPUT_DIR = strdup(dir);
+  apply_param_overrides(sweep_configs[config_num]);  // may set --output_dir itself
+  if (mkdir(OUTPUT_DIR, 0777) && errno != EEXIST)
+    FATAL_ERROR(0, "Could not create sweep output directory %s: %s\n", OUTPUT_DIR, strerror(errno));
+  init_output_streams();
+  dump_params_to_dir(OUTPUT_DIR);
+  stat_sink_fork_child();
+  frontend_fork_child();
+  fprintf(mystdout, "** Sweep config %d: %s\n", config_num, sweep_configs[config_num]);
+}
+
 /**************************************************************************************/
 /* full_sim: This is the main loop for running in full simulation mode.*/
 
@@ -634,11 +980,20 @@ void full_sim() {
   uns8 proc_id;
   Flag all_sim_done = FALSE;
   Flag any_sim_done = FALSE;
+  Counter last_forward_progress_check = 0;
+  uns num_sweep_configs = SWEEP_FILE ? read_sweep_file() : 0;
 
   /* perform initialization  */
   init_model(WARMUP_MODE);  // make sure this happens before init_op_pool
 
-  if (WARMUP) {
+  if (WARM_CKPT_LOAD) {
+    /* the checkpoint replaces warmup: it restores the warmed caches,
+       predictors and trace positions (and the time they were warmed at) */
+    ckpt_load(WARM_CKPT_LOAD);
+    sim_time = freq_time();
+    reset_uop_mode_counters();
+    freq_reset_cycle_counts();
+  } else if (WARMUP) {
     operating_mode = WARMUP_MODE;
     uop_sim();
     reset_uop_mode_counters();
@@ -656,6 +1011,16 @@ void full_sim() {
     freq_reset_cycle_counts();
   }
 
+  if (WARM_CKPT_SAVE)
+    ckpt_save(WARM_CKPT_SAVE);
+
+  if (num_sweep_configs) {
+    /* children share the warmed-up state copy-on-write and return here; the
+       parent waits for them in opt2_fork_sweep() and exits there */
+    frontend_fork_prepare();
+    opt2_fork_sweep(num_sweep_configs, setup_sweep_config);
+  }
+
   operating_mode = SIMULATION_MODE;
   init_model(operating_mode);
 
@@ -670,14 +1035,25 @@ void full_sim() {
   sim_limit = trigger_create("SIM_LIMIT", SIM_LIMIT, TRIGGER_ONCE);
   clear_stats = trigger_create("CLEAR_STATS", CLEAR_STATS, TRIGGER_ONCE);
 
+  if (IDLE_SKIP)
+    init_idle_skip();
+  if (SAMPLE_DETAILED)
+    init_sampling();
+  simprof_init();
+
   /* main loop */
   while (!trigger_fired(sim_limit)) {
     // sim control
     if ((EXIT_COND == LAST_DONE && all_sim_done) || (EXIT_COND == FIRST_DONE && any_sim_done))
       break;
+    simprof_cycle();
     freq_advance_time();
     sim_time = freq_time();
-    model->cycle_func();
+    if (IDLE_SKIP)
+      idle_skip_cycle();
+    else
+      model->cycle_func();
+    sim_time = freq_time();
     if (SIM_MODEL != DUMB_MODEL && DUMB_CORE_ON)
       model_table[DUMB_MODEL].cycle_func();
 
@@ -688,10 +1064,14 @@ void full_sim() {
        forward progress) by using only core 0 cycles */
     cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
 
+    if (SAMPLE_DETAILED)
+      sample_cycle();
+
     // check_dump_stats();  This is not being used in general
     check_heartbeat(0, FALSE);
 
     stat_trace_cycle();
+    stat_sink_cycle();
     if (trigger_fired(clear_stats)) {
       reset_stats(TRUE);
     }
@@ -704,18 +1084,22 @@ void full_sim() {
       if (SIM_MODEL != DUMB_MODEL && DUMB_CORE_ON && DUMB_CORE == proc_id)
         continue;
       if (!sim_done[proc_id] && (retired_exit[proc_id] || reachedInstLimit)) {
+        if (SAMPLE_DETAILED)
+          sample_done();
         if (model->per_core_done_func)
           model->per_core_done_func(proc_id);
-        if (CONFIDENCE_ENABLE) {
+        /* the decoupled frontend and its prefetchers only exist in the cmp model */
+        Flag cmp_frontend = SIM_MODEL == CMP_MODEL;
+        if (CONFIDENCE_ENABLE && cmp_frontend) {
           decoupled_fe_print_conf_data();
         }
-        if (FDIP_ENABLE) {
+        if (FDIP_ENABLE && cmp_frontend) {
           if (FDIP_PRINT_CL_INFO)
             print_cl_info(proc_id);
           INC_STAT_EVENT(proc_id, FDIP_AVG_FTQ_OCCUPANCY_OPS, get_fdip_ftq_occupancy_ops(proc_id));
           INC_STAT_EVENT(proc_id, FDIP_AVG_FTQ_OCCUPANCY, get_fdip_ftq_occupancy(proc_id));
         }
-        if (EIP_ENABLE) {
+        if (EIP_ENABLE && cmp_frontend) {
           print_eip_stats(proc_id);
         }
         if (PERIODIC_DUMP == FALSE) {
@@ -725,13 +1109,13 @@ void full_sim() {
         any_sim_done = TRUE;
         check_heartbeat(proc_id, TRUE);
 
-        if (retired_exit[proc_id] && FRONTEND == FE_TRACE) {
+        if (retired_exit[proc_id] && FRONTEND == FE_TRACE && SIM_MODEL != BP_MODEL) {
           set_last_sim_param(proc_id);
           // rerun the corresponding benchmark again.
           // (reset retired_exit and reached_exit)
           cmp_init_bogus_sim(proc_id);
         }
-      } else if (sim_done[proc_id] && retired_exit[proc_id]) {
+      } else if (sim_done[proc_id] && retired_exit[proc_id] && SIM_MODEL != BP_MODEL) {
         ASSERTM(proc_id, FRONTEND == FE_TRACE, "Unhandled case: benchmark finished in execution-driven mode\n");
         // rerun the corresponding benchmark again.
         if (FRONTEND == FE_TRACE) {
@@ -744,8 +1128,13 @@ void full_sim() {
       all_sim_done &= sim_done[proc_id];
     }
 
-    if (cycle_count % FORWARD_PROGRESS_INTERVAL == 0) {  // for simulator performance check every 10000000 cycles.
+    // for simulator performance check every 10000000 cycles. Idle skipping can jump over the multiple itself.
+    if (IDLE_SKIP ? cycle_count / FORWARD_PROGRESS_INTERVAL != last_forward_progress_check
+                  : cycle_count % FORWARD_PROGRESS_INTERVAL == 0) {
+      last_forward_progress_check = cycle_count / FORWARD_PROGRESS_INTERVAL;
       for (proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+        if (SIM_MODEL == BP_MODEL && sim_done[proc_id])
+          continue;  // the bp model does not rerun finished cores
         check_forward_progress(proc_id);
       }
     }
@@ -766,12 +1155,16 @@ void full_sim() {
 
   for (proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     if (!sim_done[proc_id]) {
+      if (SAMPLE_DETAILED)
+        sample_done();
       if (PERIODIC_DUMP == FALSE) {
         dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
       }
       check_heartbeat(proc_id, TRUE);
     }
   }
+  stat_sink_done();
+  simprof_done();
   // fdip_print_hash_tables();
   trigger_free(sim_limit);
   trigger_free(clear_stats);
@@ -0,0 +1,204 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : simprof.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Simulator self-profiling (SIMPROF), see simprof.h.
+ ***************************************************************************************/
+
+#include "simprof.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "general.param.h"
+
+/**************************************************************************************/
+/* Global Variables */
+
+Flag simprof_on = FALSE;
+Simprof_Acc simprof_accs[NUM_SIMPROF_TIMERS];
+uns64 simprof_child_ticks[SIMPROF_MAX_DEPTH];
+uns simprof_depth = 0;
+
+static const char* const timer_names[] = {
+#define SIMPROF_TIMER(id, indent, name) name,
+#include "simprof.def"
+#undef SIMPROF_TIMER
+};
+
+static const uns timer_indents[] = {
+#define SIMPROF_TIMER(id, indent, name) indent,
+#include "simprof.def"
+#undef SIMPROF_TIMER
+};
+
+static volatile sig_atomic_t requested_on = FALSE;
+
+/* the profiled intervals so far, and the start of the open one */
+static uns64 total_ticks, total_ns;
+static Counter total_insts, total_cycles;
+static uns64 start_ticks, start_ns;
+static Counter start_insts, start_cycles;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static uns64 wall_ns(void);
+static Counter all_inst_count(void);
+static void start_interval(void);
+static void stop_interval(void);
+
+/**************************************************************************************/
+/* simprof_init: */
+
+void simprof_init(void) {
+  memset(simprof_accs, 0, sizeof(simprof_accs));
+  simprof_depth = 0;
+  requested_on = SIMPROF;
+  simprof_cycle();
+}
+
+/**************************************************************************************/
+/* simprof_cycle: */
+
+void simprof_cycle(void) {
+  if (simprof_on == requested_on)
+    return;
+
+  ASSERTM(0, simprof_depth == 0, "SIMPROF toggled inside a timer\n");
+  if (requested_on)
+    start_interval();
+  else
+    stop_interval();
+  simprof_on = requested_on;
+}
+
+/**************************************************************************************/
+/* simprof_request: */
+
+void simprof_request(Flag on) {
+  requested_on = on;
+}
+
+/**************************************************************************************/
+/* simprof_handle_signal: */
+
+void simprof_handle_signal(int signum) {
+  UNUSED(signum);
+  requested_on = !requested_on;
+}
+
+/**************************************************************************************/
+/* simprof_done: */
+
+void simprof_done(void) {
+  if (simprof_on)
+    stop_interval();
+  simprof_on = FALSE;
+  requested_on = FALSE;
+  if (!total_ticks)
+    return;
+
+  char file_name[MAX_STR_LENGTH + 1];
+  snprintf(file_name, MAX_STR_LENGTH, "%s/%s%s", OUTPUT_DIR, FILE_TAG, "simprof.out");
+  FILE* file = fopen(file_name, "w");
+  ASSERTM(0, file, "Could not open %s\n", file_name);
+
+  /* the TSC rate is whatever it was over the profiled intervals */
+  double ns_per_tick = (double)total_ns / total_ticks;
+  double kinsts = total_insts / 1000.0;
+  double seconds = total_ns / 1e9;
+
+  fprintf(file, "Profiled host time:   %12.3f s\n", seconds);
+  fprintf(file, "Profiled cycles:      %12llu\n", total_cycles);
+  fprintf(file, "Profiled insts:       %12llu\n", total_insts);
+  fprintf(file, "Host ns per kinst:    %12.1f\n", kinsts ? total_ns / kinsts : 0.0);
+  fprintf(file, "KIPS:                 %12.2f\n\n", seconds ? kinsts / seconds : 0.0);
+
+  fprintf(file, "%-32s %14s %12s %12s %7s %10s %12s %12s\n", "Timer", "Calls", "Total (ms)", "Self (ms)",
+          "Self %", "ns/call", "ns/kinst", "KIPS");
+  uns64 timed_self_ticks = 0;
+  for (uns ii = 0; ii < NUM_SIMPROF_TIMERS; ii++) {
+    const Simprof_Acc* acc = &simprof_accs[ii];
+    uns64 self_ticks = acc->ticks - acc->child_ticks;
+    double ns = acc->ticks * ns_per_tick;
+    double self_ns = self_ticks * ns_per_tick;
+    char name[64];
+    snprintf(name, sizeof(name), "%*s%s", 2 * timer_indents[ii], "", timer_names[ii]);
+    fprintf(file, "%-32s %14llu %12.3f %12.3f %6.2f%% %10.1f %12.1f %12.2f\n", name, acc->calls, ns / 1e6,
+            self_ns / 1e6, 100.0 * self_ns / total_ns, acc->calls ? ns / acc->calls : 0.0,
+            kinsts ? ns / kinsts : 0.0, ns ? kinsts / (ns / 1e9) : 0.0);
+    timed_self_ticks += self_ticks;
+  }
+  double other_ns = total_ns - timed_self_ticks * ns_per_tick;
+  fprintf(file, "%-32s %14s %12.3f %12.3f %6.2f%% %10s %12.1f %12s\n", "(untimed)", "", other_ns / 1e6,
+          other_ns / 1e6, 100.0 * other_ns / total_ns, "", kinsts ? other_ns / kinsts : 0.0, "");
+  fclose(file);
+}
+
+/**************************************************************************************/
+/* wall_ns: */
+
+static uns64 wall_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uns64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**************************************************************************************/
+/* all_inst_count: retired instructions of all cores */
+
+static Counter all_inst_count(void) {
+  Counter insts = 0;
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    insts += inst_count[proc_id];
+  return insts;
+}
+
+/**************************************************************************************/
+/* start_interval: */
+
+static void start_interval(void) {
+  start_insts = all_inst_count();
+  start_cycles = cycle_count;
+  start_ns = wall_ns();
+  start_ticks = simprof_now();
+}
+
+/**************************************************************************************/
+/* stop_interval: */
+
+static void stop_interval(void) {
+  total_ticks += simprof_now() - start_ticks;
+  total_ns += wall_ns() - start_ns;
+  total_insts += all_inst_count() - start_insts;
+  total_cycles += cycle_count - start_cycles;
+}
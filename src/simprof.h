@@ -0,0 +1,141 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : simprof.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Simulator self-profiling (SIMPROF).
+ *
+ * Scoped host-time timers around the hot calls of the simulator:
+ *
+ *   SIMPROF_BEGIN(ICACHE_STAGE);
+ *   update_icache_stage();
+ *   SIMPROF_END(ICACHE_STAGE);
+ *
+ * The timers are listed in simprof.def. They read the TSC, so an idle timer
+ * costs one branch and a running one two rdtsc. Nested timers report both
+ * inclusive and self time. At the end simprof.out lists for every timer the
+ * host time per simulated kilo-instruction and the KIPS the simulator would
+ * reach if only that component ran. SIMPROF turns profiling on from the
+ * start and SIGUSR1 toggles it during the run; the toggle takes effect at
+ * the next cycle boundary, so no timer is ever half counted.
+ ***************************************************************************************/
+
+#ifndef __SIMPROF_H__
+#define __SIMPROF_H__
+
+#include "globals/global_types.h"
+
+#if defined(X86_64) && !defined(__aarch64__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Simprof_Timer_enum {
+#define SIMPROF_TIMER(id, indent, name) SIMPROF_##id,
+#include "simprof.def"
+#undef SIMPROF_TIMER
+  NUM_SIMPROF_TIMERS
+} Simprof_Timer;
+
+#define SIMPROF_MAX_DEPTH 16
+
+typedef struct Simprof_Acc_struct {
+  uns64 ticks;       /* inclusive */
+  uns64 child_ticks; /* spent in nested timers */
+  Counter calls;
+} Simprof_Acc;
+
+/**************************************************************************************/
+/* Global Variables */
+
+extern Flag simprof_on;
+extern Simprof_Acc simprof_accs[NUM_SIMPROF_TIMERS];
+extern uns64 simprof_child_ticks[SIMPROF_MAX_DEPTH]; /* per open timer, ticks of its children */
+extern uns simprof_depth;
+
+/**************************************************************************************/
+/* Timer primitives */
+
+static inline uns64 simprof_now(void) {
+#if defined(X86_64) && !defined(__aarch64__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uns64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static inline uns64 simprof_enter(void) {
+  simprof_child_ticks[++simprof_depth] = 0;
+  return simprof_now();
+}
+
+static inline void simprof_leave(Simprof_Timer timer, uns64 start) {
+  uns64 ticks = simprof_now() - start;
+  Simprof_Acc* acc = &simprof_accs[timer];
+  acc->ticks += ticks;
+  acc->child_ticks += simprof_child_ticks[simprof_depth--];
+  acc->calls++;
+  simprof_child_ticks[simprof_depth] += ticks;
+}
+
+/* simprof_on only changes between cycles, so BEGIN and END always agree */
+#define SIMPROF_BEGIN(id) uns64 simprof_start_##id = simprof_on ? simprof_enter() : 0
+#define SIMPROF_END(id)                                \
+  do {                                                 \
+    if (simprof_on)                                    \
+      simprof_leave(SIMPROF_##id, simprof_start_##id); \
+  } while (0)
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize, profiling starts on if SIMPROF */
+void simprof_init(void);
+
+/* Call every cycle, outside of any timer; applies pending toggles */
+void simprof_cycle(void);
+
+/* Turn profiling on or off at the next simprof_cycle() */
+void simprof_request(Flag on);
+
+/* SIGUSR1 handler, toggles profiling */
+void simprof_handle_signal(int signum);
+
+/* Write simprof.out */
+void simprof_done(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SIMPROF_H__
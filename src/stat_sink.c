@@ -0,0 +1,216 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : stat_sink.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Columnar time series of all stats, see stat_sink.h for the format.
+ ***************************************************************************************/
+
+#include "stat_sink.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "general.param.h"
+
+#include "statistics.h"
+#include "trigger.h"
+
+/**************************************************************************************/
+/* Global Variables */
+
+static FILE* file;
+static Trigger* interval_trigger;
+static uns num_columns;
+static uns block_samples;  // samples in the current block
+static uint64_t* block;    // the current block, sample-major: block[sample * num_columns + column]
+static uint64_t* columns;  // the encoded payload, column-major
+static Bytef* zbuf;
+static uLongf zbuf_size;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static void open_sink_file(void);
+static void write_block(void);
+
+/**************************************************************************************/
+/* stat_sink_init: */
+
+void stat_sink_init(void) {
+  if (!STAT_SINK)
+    return;
+
+  ASSERTM(0, STAT_SINK_BLOCK > 0, "STAT_SINK_BLOCK must be positive\n");
+
+  num_columns = 1 + 2 * NUM_CORES + NUM_CORES * NUM_GLOBAL_STATS;
+  block = (uint64_t*)malloc(sizeof(uint64_t) * num_columns * STAT_SINK_BLOCK);
+  columns = (uint64_t*)malloc(sizeof(uint64_t) * num_columns * STAT_SINK_BLOCK);
+  zbuf_size = compressBound(sizeof(uint64_t) * num_columns * STAT_SINK_BLOCK);
+  zbuf = (Bytef*)malloc(zbuf_size);
+  block_samples = 0;
+
+  open_sink_file();
+  interval_trigger = trigger_create("STAT_SINK_INTERVAL", STAT_SINK_INTERVAL, TRIGGER_REPEAT);
+}
+
+/**************************************************************************************/
+/* stat_sink_fork_child: */
+
+void stat_sink_fork_child(void) {
+  if (!file)
+    return;
+
+  /* samples are only taken in simulation mode, after the fork, and the
+     parent flushed its streams before forking, so closing the inherited
+     stream writes nothing more to the parent's file */
+  ASSERT(0, !block_samples);
+  fclose(file);
+  open_sink_file();
+}
+
+/**************************************************************************************/
+/* open_sink_file: creates the sink file in OUTPUT_DIR and writes its header */
+
+static void open_sink_file(void) {
+  char file_name[MAX_STR_LENGTH + 1];
+  snprintf(file_name, MAX_STR_LENGTH, "%s/%s%s", OUTPUT_DIR, FILE_TAG, STAT_SINK_FILE);
+  file = fopen(file_name, "w");
+  ASSERTM(0, file, "Could not open %s\n", file_name);
+
+  Stat_Sink_Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, STAT_SINK_MAGIC, sizeof(header.magic));
+  header.version = STAT_SINK_VERSION;
+  header.num_cores = NUM_CORES;
+  header.num_stats = NUM_GLOBAL_STATS;
+  header.num_columns = num_columns;
+  fwrite(&header, sizeof(header), 1, file);
+
+  for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    const Stat* stat = &global_stat_array[0][ii];
+    Stat_Sink_Stat_Desc desc;
+    desc.type = stat->type;
+    desc.ratio_stat = stat->ratio_stat;
+    desc.name_length = strlen(stat->name);
+    desc.file_name_length = strlen(stat->file_name);
+    fwrite(&desc, sizeof(desc), 1, file);
+    fwrite(stat->name, 1, desc.name_length, file);
+    fwrite(stat->file_name, 1, desc.file_name_length, file);
+  }
+}
+
+/**************************************************************************************/
+/* stat_sink_cycle: */
+
+void stat_sink_cycle(void) {
+  if (!STAT_SINK)
+    return;
+
+  if (trigger_fired(interval_trigger))
+    stat_sink_sample();
+}
+
+/**************************************************************************************/
+/* stat_sink_sample: */
+
+void stat_sink_sample(void) {
+  if (!file)
+    return;
+
+  uint64_t* row = &block[block_samples * num_columns];
+  *row++ = cycle_count;
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    *row++ = inst_count[proc_id];
+    *row++ = pret_inst_count[proc_id];
+  }
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    const Stat* stat = global_stat_array[proc_id];
+    for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++, stat++) {
+      if (stat->type == FLOAT_TYPE_STAT) {
+        double value = stat->value + stat->total_value;
+        memcpy(row++, &value, sizeof(value));
+      } else {
+        *row++ = stat->count + stat->total_count;
+      }
+    }
+  }
+
+  if (++block_samples == STAT_SINK_BLOCK)
+    write_block();
+}
+
+/**************************************************************************************/
+/* stat_sink_done: */
+
+void stat_sink_done(void) {
+  if (!file)
+    return;
+
+  stat_sink_sample();
+  if (block_samples)
+    write_block();
+  fclose(file);
+  file = NULL;
+
+  free(block);
+  free(columns);
+  free(zbuf);
+  trigger_free(interval_trigger);
+}
+
+/**************************************************************************************/
+/* write_block: transpose the block into columns, delta encode and compress */
+
+static void write_block(void) {
+  uns first_stat_column = 1 + 2 * NUM_CORES;
+  uint64_t* out = columns;
+
+  for (uns col = 0; col < num_columns; col++) {
+    Flag is_float = col >= first_stat_column &&
+                    global_stat_array[0][(col - first_stat_column) % NUM_GLOBAL_STATS].type == FLOAT_TYPE_STAT;
+    uint64_t prev = 0;
+    for (uns sample = 0; sample < block_samples; sample++) {
+      uint64_t value = block[sample * num_columns + col];
+      *out++ = is_float ? value ^ prev : value - prev;
+      prev = value;
+    }
+  }
+
+  uLongf size = zbuf_size;
+  int ret = compress2(zbuf, &size, (const Bytef*)columns, sizeof(uint64_t) * num_columns * block_samples, Z_BEST_SPEED);
+  ASSERTM(0, ret == Z_OK, "Could not compress a stat sink block (zlib error %d)\n", ret);
+
+  Stat_Sink_Block_Header header = {block_samples, (uint32_t)size};
+  fwrite(&header, sizeof(header), 1, file);
+  fwrite(zbuf, 1, size, file);
+  fflush(file);
+  block_samples = 0;
+}
@@ -0,0 +1,94 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : stat_sink.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Columnar time series of all stats (STAT_SINK).
+ *
+ * Every STAT_SINK_INTERVAL the run-long value (total + current interval) of
+ * every stat of every core is appended to one binary file. Samples are
+ * grouped into blocks of up to STAT_SINK_BLOCK samples:
+ *
+ *   header | stat descriptors | block 0 | block 1 | ...
+ *
+ * A block is a Stat_Sink_Block_Header followed by the zlib-compressed block
+ * payload: the columns of the block one after the other, each holding one
+ * int64 per sample. Column 0 is cycle_count, then inst_count and
+ * pret_inst_count of each core, then the stats of core 0, core 1, ... in
+ * Stat_Enum order. Each column is delta encoded from the previous sample of
+ * the block (the first from 0); float stats store the XOR of the IEEE bits
+ * instead of the difference. Blocks are self-contained, so a reader can
+ * decode any of them without the others. All fields are host (little)
+ * endian. utils/stat_sink.py reads the format and utils/stat_sink_to_text.py
+ * turns samples back into .stat.out files.
+ ***************************************************************************************/
+
+#ifndef __STAT_SINK_H__
+#define __STAT_SINK_H__
+
+#include <stdint.h>
+
+#define STAT_SINK_MAGIC "SCRBSTSK"
+#define STAT_SINK_VERSION 1
+
+typedef struct Stat_Sink_Header_struct {
+  char magic[8]; /* STAT_SINK_MAGIC, not NUL terminated */
+  uint32_t version;
+  uint32_t num_cores;
+  uint32_t num_stats;
+  uint32_t num_columns; /* 1 + 2 * num_cores + num_cores * num_stats */
+} Stat_Sink_Header;
+
+/* followed by name_length bytes of name and file_name_length bytes of the
+   .stat.def file name, neither NUL terminated */
+typedef struct Stat_Sink_Stat_Desc_struct {
+  uint32_t type;       /* Stat_Type */
+  uint32_t ratio_stat; /* Stat_Enum used by RATIO and PERCENT stats */
+  uint16_t name_length;
+  uint16_t file_name_length;
+} Stat_Sink_Stat_Desc;
+
+typedef struct Stat_Sink_Block_Header_struct {
+  uint32_t num_samples;
+  uint32_t size; /* compressed payload bytes that follow */
+} Stat_Sink_Block_Header;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Opens the sink file if STAT_SINK is on */
+void stat_sink_init(void);
+
+/* Reopens the sink file in the OUTPUT_DIR of a forked sweep child */
+void stat_sink_fork_child(void);
+
+/* Call every cycle */
+void stat_sink_cycle(void);
+
+/* Appends a sample of the current stat values */
+void stat_sink_sample(void);
+
+/* Writes the final sample and closes the file */
+void stat_sink_done(void);
+
+#endif /* #ifndef __STAT_SINK_H__ */
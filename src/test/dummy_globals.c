@@ -37,4 +37,6 @@ Flag*    trace_read_done;
 // const char* PIN_EXEC_DRIVEN_FE_SOCKET = "./temp.socket";
 const char* FILE_TAG             = "";
 uns         INST_HASH_TABLE_SIZE = 500021;
+uns         PIN_TRACE_DECODE_THREADS = 2;
+uns         PIN_TRACE_CHUNKS_AHEAD   = 4;
 int         op_type_delays[NUM_OP_TYPES];
@@ -0,0 +1,290 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : test/hash_lib_bench.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Microbenchmark of libs/hash_lib against the chained-bucket table it
+ *                replaced. The old implementation is kept here as chain_* so both
+ *                run the same key streams and their results can be cross-checked.
+ *
+ *                make hash_lib_bench && ./obj/hash_lib_bench [steps]
+ ***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/utils.h"
+
+#include "libs/hash_lib.h"
+#include "libs/malloc_lib.h"
+
+/**************************************************************************************/
+/* Globals normally provided by the simulator */
+
+FILE* mystdout;
+FILE* mystderr;
+FILE* mystatus;
+Counter cycle_count = 0;
+Counter* op_count;
+Counter* inst_count;
+
+extern inline void print_backtrace(void);
+
+void breakpoint(const char file[], const int line) {
+}
+
+/**************************************************************************************/
+/* Reference: the chained-bucket table (prime bucket counts, per-entry smalloc) */
+
+typedef struct Chain_Entry_struct {
+  int64 key;
+  void* data;
+  struct Chain_Entry_struct* next;
+} Chain_Entry;
+
+typedef struct Chain_Table_struct {
+  uns buckets;
+  uns data_size;
+  int count;
+  Chain_Entry** entries;
+} Chain_Table;
+
+static inline uns chain_index(const Chain_Table* table, int64 key) {
+  int64_t mask = (~0UL) % table->buckets;
+  int64_t hash = 0;
+  int log2 = 64 - __builtin_clzl(table->buckets);
+  for (int i = 0; i < 64; i += log2) {
+    hash ^= (key & mask);
+    key = key >> log2;
+  }
+  return hash;
+}
+
+static void chain_init(Chain_Table* table, uns buckets, uns data_size) {
+  table->buckets = buckets;
+  table->data_size = data_size;
+  table->count = 0;
+  table->entries = (Chain_Entry**)calloc(buckets, sizeof(Chain_Entry*));
+}
+
+static void* chain_access(Chain_Table* table, int64 key) {
+  for (Chain_Entry* temp = table->entries[chain_index(table, key)]; temp; temp = temp->next)
+    if (temp->key == key)
+      return temp->data;
+  return NULL;
+}
+
+static void* chain_access_create(Chain_Table* table, int64 key, Flag* new_entry) {
+  uns index = chain_index(table, key);
+  Chain_Entry* prev = NULL;
+
+  *new_entry = FALSE;
+  for (Chain_Entry* temp = table->entries[index]; temp; temp = temp->next) {
+    if (temp->key == key)
+      return temp->data;
+    prev = temp;
+  }
+  Chain_Entry* new_hash = (Chain_Entry*)smalloc(sizeof(Chain_Entry));
+  new_hash->key = key;
+  new_hash->next = NULL;
+  new_hash->data = smalloc(table->data_size);
+  if (prev)
+    prev->next = new_hash;
+  else
+    table->entries[index] = new_hash;
+  table->count++;
+  *new_entry = TRUE;
+  return new_hash->data;
+}
+
+static Flag chain_access_delete(Chain_Table* table, int64 key) {
+  uns index = chain_index(table, key);
+  Chain_Entry* prev = NULL;
+
+  for (Chain_Entry* temp = table->entries[index]; temp; temp = temp->next) {
+    if (temp->key == key) {
+      if (prev)
+        prev->next = temp->next;
+      else
+        table->entries[index] = temp->next;
+      sfree(table->data_size, temp->data);
+      sfree(sizeof(Chain_Entry), temp);
+      table->count--;
+      return TRUE;
+    }
+    prev = temp;
+  }
+  return FALSE;
+}
+
+static void chain_clear(Chain_Table* table) {
+  for (uns ii = 0; ii < table->buckets; ii++) {
+    Chain_Entry* temp = table->entries[ii];
+    while (temp) {
+      Chain_Entry* next = temp->next;
+      sfree(table->data_size, temp->data);
+      sfree(sizeof(Chain_Entry), temp);
+      temp = next;
+    }
+    table->entries[ii] = NULL;
+  }
+  table->count = 0;
+}
+
+/**************************************************************************************/
+/* Workloads */
+
+#define STORE_WINDOW 512   /* in-flight stores, as in the oracle memory map */
+#define WORKING_SET (1 << 16)
+#define LOOKUPS_PER_STEP 3
+
+typedef struct Bench_Result_struct {
+  double secs;
+  uns64 checksum;
+} Bench_Result;
+
+static uns64 rng_state;
+
+static inline uns64 bench_rand(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return rng_state;
+}
+
+/* 8-byte granular addresses with some locality, like MEM_MAP_KEY() keys */
+static inline int64 bench_key(void) {
+  uns64 r = bench_rand();
+  return (int64)(0x7fff0000ULL + ((r >> 8) % WORKING_SET) * (r & 1 ? 1 : 64)) >> 3;
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Dependency-map pattern: every step a store creates (or hits) an entry,
+   a few loads look entries up, and the store leaving the window deletes
+   its entry. */
+#define MAP_WORKLOAD(name, table_t, init, access, create, del, clear, done)    \
+  static Bench_Result name(uns64 steps) {                                      \
+    table_t table;                                                             \
+    int64 window[STORE_WINDOW];                                                \
+    Bench_Result res = {0, 0};                                                 \
+    Flag new_entry;                                                            \
+    init(&table, NODE_BUCKETS, sizeof(uns64));                                 \
+    rng_state = 0x2545F4914F6CDD1DULL;                                         \
+    memset(window, 0, sizeof(window));                                         \
+    double start = now();                                                      \
+    for (uns64 ii = 0; ii < steps; ii++) {                                     \
+      int64 key = bench_key();                                                 \
+      uns64* data = (uns64*)create(&table, key, &new_entry);                   \
+      *data = new_entry ? ii : *data + 1;                                      \
+      for (uns jj = 0; jj < LOOKUPS_PER_STEP; jj++) {                          \
+        uns64* hit = (uns64*)access(&table, bench_key());                      \
+        res.checksum += hit ? *hit : 1;                                        \
+      }                                                                        \
+      int64 old = window[ii % STORE_WINDOW];                                   \
+      if (ii >= STORE_WINDOW)                                                  \
+        res.checksum += del(&table, old);                                      \
+      window[ii % STORE_WINDOW] = key;                                         \
+    }                                                                          \
+    res.secs = now() - start;                                                  \
+    res.checksum += table.count;                                               \
+    clear(&table);                                                             \
+    done(&table);                                                              \
+    return res;                                                                \
+  }
+
+/* Lookup-heavy pattern: a large resident table probed with a hit/miss mix. */
+#define LOOKUP_WORKLOAD(name, table_t, init, access, create, clear, done)      \
+  static Bench_Result name(uns64 steps) {                                      \
+    table_t table;                                                             \
+    Bench_Result res = {0, 0};                                                 \
+    Flag new_entry;                                                            \
+    init(&table, NODE_BUCKETS, sizeof(uns64));                                 \
+    rng_state = 0x9E3779B97F4A7C15ULL;                                         \
+    for (uns ii = 0; ii < WORKING_SET; ii++)                                   \
+      *(uns64*)create(&table, bench_key(), &new_entry) = ii;                   \
+    double start = now();                                                      \
+    for (uns64 ii = 0; ii < steps * LOOKUPS_PER_STEP; ii++) {                  \
+      uns64* hit = (uns64*)access(&table, bench_key());                        \
+      res.checksum += hit ? *hit : 1;                                          \
+    }                                                                          \
+    res.secs = now() - start;                                                  \
+    res.checksum += table.count;                                               \
+    clear(&table);                                                             \
+    done(&table);                                                              \
+    return res;                                                                \
+  }
+
+#define NODE_BUCKETS 1021 /* a typical NODE_TABLE_SIZE-scaled init size */
+
+#define hash_init(table, buckets, size) init_hash_table(table, "bench", buckets, size)
+
+static void chain_done(Chain_Table* table) {
+  free(table->entries);
+}
+
+static void hash_done(Hash_Table* table) {
+  free(table->name);
+  free(table->entries);
+  free(table->dists);
+}
+
+MAP_WORKLOAD(map_chain, Chain_Table, chain_init, chain_access, chain_access_create, chain_access_delete,
+             chain_clear, chain_done)
+MAP_WORKLOAD(map_flat, Hash_Table, hash_init, hash_table_access, hash_table_access_create,
+             hash_table_access_delete, hash_table_clear, hash_done)
+LOOKUP_WORKLOAD(lookup_chain, Chain_Table, chain_init, chain_access, chain_access_create, chain_clear, chain_done)
+LOOKUP_WORKLOAD(lookup_flat, Hash_Table, hash_init, hash_table_access, hash_table_access_create,
+                hash_table_clear, hash_done)
+
+static int report(const char* name, uns64 ops, Bench_Result chain, Bench_Result flat) {
+  printf("%-8s chained %8.2f ns/op   flat %8.2f ns/op   speedup %5.2fx\n", name, chain.secs * 1e9 / ops,
+         flat.secs * 1e9 / ops, chain.secs / flat.secs);
+  if (chain.checksum != flat.checksum) {
+    printf("%-8s checksum mismatch: %llu vs %llu\n", name, chain.checksum, flat.checksum);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  uns64 steps = argc > 1 ? strtoull(argv[1], NULL, 0) : 4000000;
+  int fail = 0;
+
+  mystdout = stdout;
+  mystderr = stderr;
+  mystatus = stdout;
+
+  fail |= report("map", steps, map_chain(steps), map_flat(steps));
+  fail |= report("lookup", steps * LOOKUPS_PER_STEP, lookup_chain(steps), lookup_flat(steps));
+  return fail;
+}
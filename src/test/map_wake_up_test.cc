@@ -0,0 +1,314 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : map_wake_up_test.cc
+ * Description  : Adds consumers to the wake up lists of map.c, wakes them and
+ *                truncates the lists at recovery, with lists that grow
+ *                through the block size classes.
+ ***************************************************************************************/
+
+#include <deque>
+#include <tuple>
+#include <vector>
+
+extern "C" {
+#include "../map.h"
+#include "../op.h"
+#include "../statistics.h"
+#include "../thread.h"
+}
+#include "gtest/gtest.h"
+
+extern "C" {
+/* the globals map.c and thread.c touch */
+FILE* mystdout;
+FILE* mystderr;
+FILE* mystatus;
+Counter cycle_count;
+Counter* op_count;
+Counter* inst_count;
+Stat** global_stat_array;
+Thread_Data* td;
+Op invalid_op;
+uns NODE_TABLE_SIZE = 256;
+Flag OBEY_REG_DEP = TRUE;
+Flag TRACK_L1_MISS_DEPS = FALSE;
+Flag MEM_OOO_STORES = TRUE;
+Flag MEM_OBEY_STORE_DEP = TRUE;
+
+void breakpoint(const char file[], const int line) {}
+void reg_file_init(void) {}
+void reg_file_produce(Op* op) {}
+void free_op(Op* op) {}
+uns get_proc_id_from_cmp_addr(Addr addr) {
+  return 0;
+}
+char* disasm_op(Op* op, Flag wide) {
+  return (char*)"";
+}
+char* unsstr64(uns64 value) {
+  return (char*)"";
+}
+}
+
+#define WAKE_UP_MIN_CAPACITY 4 /* as in map.c */
+
+/* (producer, consumer, rdy_bit) of every wake action, in call order */
+static std::vector<std::tuple<Counter, Counter, uns8>> wakes;
+
+static void record_wake(Op* src_op, Op* dep_op, uns8 rdy_bit) {
+  wakes.emplace_back(src_op->op_num, dep_op->op_num, rdy_bit);
+}
+
+class MapWakeUpTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mystdout = mystatus = stdout;
+    mystderr = stderr;
+    thread_data = Thread_Data();
+    td = &thread_data;
+    init_thread(td, NULL, NULL);
+    wakes.clear();
+  }
+
+  void TearDown() override {
+    for (Op& op : ops)
+      free_wake_up_list(&op);
+  }
+
+  /* a new op at the tail of the sequential op list */
+  Op* new_op() {
+    ops.emplace_back();
+    Op* op = &ops.back();
+    op->proc_id = 0;
+    op->op_num = ++last_op_num;
+    op->unique_num = ++last_unique_num;
+    op->op_pool_valid = TRUE;
+    op->table_info = &table_info;
+    add_to_seq_op_list(td, op);
+    return op;
+  }
+
+  /* a new op whose sources are produced by srcs, with the given dependence types */
+  Op* new_consumer(std::vector<Op*> srcs, std::vector<Dep_Type> types) {
+    Op* op = new_op();
+    op->oracle_info.num_srcs = srcs.size();
+    for (uns ii = 0; ii < srcs.size(); ii++) {
+      Src_Info* src_info = &op->oracle_info.src_info[ii];
+      src_info->type = types[ii];
+      src_info->op = srcs[ii];
+      src_info->op_num = srcs[ii]->op_num;
+      src_info->unique_num = srcs[ii]->unique_num;
+      set_not_rdy_bit(op, ii);
+    }
+    add_to_wake_up_lists(op, &op->oracle_info, record_wake);
+    return op;
+  }
+
+  /* recovers at op_num and frees the flushed ops, the way the cmp model does */
+  void recover(Counter op_num) {
+    recover_thread(td, 0, op_num, 0, FALSE);
+    for (Op& op : ops) {
+      if (op.op_num > op_num && op.op_pool_valid) {
+        free_wake_up_list(&op);
+        op.op_pool_valid = FALSE;
+      }
+    }
+    last_op_num = op_num;
+  }
+
+  /* retires every op still in the machine, the sequential op list holds at most 8192 */
+  void retire_all() {
+    for (Op& op : ops) {
+      if (op.op_pool_valid) {
+        remove_from_seq_op_list(td, &op);
+        free_wake_up_list(&op);
+        op.op_pool_valid = FALSE;
+      }
+    }
+  }
+
+  static uns capacity_for(uns count) {
+    uns capacity = WAKE_UP_MIN_CAPACITY;
+    while (capacity < count)
+      capacity *= 2;
+    return capacity;
+  }
+
+  static void expect_list(Op* op, std::vector<Op*> consumers) {
+    ASSERT_EQ(op->wake_up_count, consumers.size());
+    EXPECT_GE(op->wake_up_capacity, op->wake_up_count);
+    for (uns ii = 0; ii < consumers.size(); ii++) {
+      EXPECT_EQ(op->wake_up_list[ii].op, consumers[ii]) << "entry " << ii;
+      EXPECT_EQ(op->wake_up_list[ii].unique_num, consumers[ii]->unique_num) << "entry " << ii;
+    }
+  }
+
+  Thread_Data thread_data;
+  Table_Info table_info = {};
+  std::deque<Op> ops;
+  Counter last_op_num = 0;
+  Counter last_unique_num = 0;
+};
+
+/* list lengths around the boundaries of the first size classes, and a few large ones */
+static const uns list_lengths[] = {1, 3, 4, 5, 8, 9, 16, 17, 63, 64, 65, 200, 1000, 4096, 5000};
+
+TEST_F(MapWakeUpTest, AddAndWakeAcrossSizeClasses) {
+  for (uns length : list_lengths) {
+    Op* producer = new_op();
+    std::vector<Op*> consumers, reg_consumers, mem_consumers;
+    uns active = map_data->active_wake_up_entries;
+
+    for (uns ii = 0; ii < length; ii++) {
+      Dep_Type type = ii % 3 == 2 ? MEM_DATA_DEP : REG_DATA_DEP;
+      consumers.push_back(new_consumer({producer}, {type}));
+      (type == REG_DATA_DEP ? reg_consumers : mem_consumers).push_back(consumers.back());
+    }
+    expect_list(producer, consumers);
+    EXPECT_EQ(producer->wake_up_capacity, capacity_for(length));
+    EXPECT_EQ(map_data->active_wake_up_entries, active + length);
+    EXPECT_TRUE(wakes.empty());
+
+    /* a wake up only reaches the consumers of its type, oldest first */
+    wake_up_ops(producer, REG_DATA_DEP, record_wake);
+    ASSERT_EQ(wakes.size(), reg_consumers.size());
+    for (uns ii = 0; ii < reg_consumers.size(); ii++) {
+      EXPECT_EQ(wakes[ii], std::make_tuple(producer->op_num, reg_consumers[ii]->op_num, (uns8)0));
+      EXPECT_EQ(reg_consumers[ii]->srcs_not_rdy_vector, 0u);
+    }
+    for (Op* op : mem_consumers)
+      EXPECT_EQ(op->srcs_not_rdy_vector, 1u);
+
+    /* a consumer added after the wake up is woken right away */
+    wakes.clear();
+    Op* late = new_consumer({producer}, {REG_DATA_DEP});
+    ASSERT_EQ(wakes.size(), 1u);
+    EXPECT_EQ(late->srcs_not_rdy_vector, 0u);
+    consumers.push_back(late);
+    expect_list(producer, consumers);
+
+    wakes.clear();
+    wake_up_ops(producer, MEM_DATA_DEP, record_wake);
+    ASSERT_EQ(wakes.size(), mem_consumers.size());
+    for (uns ii = 0; ii < mem_consumers.size(); ii++)
+      EXPECT_EQ(std::get<1>(wakes[ii]), mem_consumers[ii]->op_num);
+
+    free_wake_up_list(producer);
+    EXPECT_EQ(producer->wake_up_list, nullptr);
+    EXPECT_EQ(map_data->active_wake_up_entries, active);
+    wakes.clear();
+    retire_all();
+  }
+}
+
+TEST_F(MapWakeUpTest, FreedBlocksAreReused) {
+  for (uns length : list_lengths) {
+    Op* first = new_op();
+    for (uns ii = 0; ii < length; ii++)
+      new_consumer({first}, {REG_DATA_DEP});
+    Wake_Up_Entry* block = first->wake_up_list;
+    uns entries = map_data->wake_up_entries;
+    free_wake_up_list(first);
+    retire_all();
+
+    /* the second list grows through the same size classes and ends in the freed block */
+    Op* second = new_op();
+    for (uns ii = 0; ii < length; ii++)
+      new_consumer({second}, {REG_DATA_DEP});
+    EXPECT_EQ(second->wake_up_list, block) << "length " << length;
+    EXPECT_EQ(map_data->wake_up_entries, entries) << "length " << length;
+    free_wake_up_list(second);
+    retire_all();
+  }
+  EXPECT_EQ(map_data->active_wake_up_entries, 0u);
+}
+
+TEST_F(MapWakeUpTest, RecoveryTruncatesLists) {
+  for (uns length : list_lengths) {
+    for (uns kept : {0u, 1u, length / 2, length - 1, length}) {
+      SCOPED_TRACE(testing::Message() << "length " << length << " kept " << kept);
+      Op* producer = new_op();
+      std::vector<Op*> consumers;
+
+      /* every consumer also depends on the previous one, so the lists of the
+         surviving consumers are truncated too */
+      consumers.push_back(new_consumer({producer}, {REG_DATA_DEP}));
+      for (uns ii = 1; ii < length; ii++)
+        consumers.push_back(new_consumer({producer, consumers.back()}, {REG_DATA_DEP, REG_DATA_DEP}));
+      uns capacity = producer->wake_up_capacity;
+
+      recover(producer->op_num + kept);
+      std::vector<Op*> survivors(consumers.begin(), consumers.begin() + kept);
+      expect_list(producer, survivors);
+      EXPECT_EQ(producer->wake_up_capacity, capacity);
+      for (uns ii = 0; ii < kept; ii++) {
+        if (ii + 1 < kept)
+          expect_list(consumers[ii], {consumers[ii + 1]});
+        else
+          EXPECT_EQ(consumers[ii]->wake_up_count, 0u);
+      }
+      EXPECT_EQ(map_data->active_wake_up_entries, kept ? 2 * kept - 1 : 0);
+
+      /* the ops fetched after the recovery are appended behind the survivors */
+      std::vector<Op*> expected = survivors;
+      for (uns ii = 0; ii < 5; ii++)
+        expected.push_back(new_consumer({producer}, {REG_DATA_DEP}));
+      expect_list(producer, expected);
+
+      wake_up_ops(producer, REG_DATA_DEP, record_wake);
+      std::vector<Counter> woken;
+      for (auto& wake : wakes)
+        if (std::get<0>(wake) == producer->op_num)
+          woken.push_back(std::get<1>(wake));
+      ASSERT_EQ(woken.size(), expected.size());
+      for (uns ii = 0; ii < expected.size(); ii++)
+        EXPECT_EQ(woken[ii], expected[ii]->op_num);
+      wakes.clear();
+
+      /* retire everything before the next round */
+      recover(producer->op_num - 1);
+      EXPECT_EQ(map_data->active_wake_up_entries, 0u);
+    }
+  }
+}
+
+TEST_F(MapWakeUpTest, RecoveryDropsReusedConsumers) {
+  Op* producer = new_op();
+  std::vector<Op*> consumers;
+  for (uns ii = 0; ii < 40; ii++)
+    consumers.push_back(new_consumer({producer}, {REG_DATA_DEP}));
+
+  /* consumers that left the machine and whose op was reallocated do not survive a recovery */
+  consumers[3]->op_pool_valid = FALSE;
+  consumers[17]->unique_num = ++last_unique_num;
+  recover(consumers[29]->op_num);
+
+  std::vector<Op*> survivors;
+  for (uns ii = 0; ii < 30; ii++)
+    if (ii != 3 && ii != 17)
+      survivors.push_back(consumers[ii]);
+  ASSERT_EQ(producer->wake_up_count, survivors.size());
+  for (uns ii = 0; ii < survivors.size(); ii++)
+    EXPECT_EQ(producer->wake_up_list[ii].op, survivors[ii]);
+  EXPECT_EQ(map_data->active_wake_up_entries, survivors.size());
+}
@@ -0,0 +1,235 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : node_issue_queue_sched_test.cc
+ * Description  : Runs the OLDEST_FIRST and OLDEST_FIRST_MASK schedulers on the
+ *                same reservation station states and checks that they select
+ *                the same ops for the same FUs.
+ ***************************************************************************************/
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "../exec_ports.h"
+#include "../exec_stage.h"
+#include "../memory/memory.h"
+#include "../node_stage.h"
+#include "../op.h"
+#include "../statistics.h"
+#include "../table_info.h"
+}
+#include "gtest/gtest.h"
+
+void node_schedule_oldest_first_sched(Op*);
+void node_schedule_oldest_first_mask_sched(Op*);
+
+extern "C" {
+void init_exec_ports_fu_list(uns, Func_Unit*);
+void init_exec_ports_rs_list(uns, Reservation_Station*, Func_Unit*);
+
+/* the globals the two schedulers and the exec port setup touch */
+FILE* mystdout;
+FILE* mystderr;
+FILE* mystatus;
+Counter cycle_count;
+Counter* op_count;
+Counter* inst_count;
+Node_Stage* node;
+Exec_Stage* exec;
+Stat** global_stat_array;
+const char* DELIMITERS = " ,";
+uns NUM_RS;
+uns NUM_FUS;
+char* RS_SIZES;
+char* RS_CONNECTIONS;
+char* FU_TYPES;
+uns RS_FILL_WIDTH = 8;
+uns DIE_ON_MEM_BLOCK_THRESH = 0;
+uns DIE_ON_MEM_BLOCK_CORE = 0;
+uns NODE_ISSUE_QUEUE_DISPATCH_SCHEME = 0;
+uns NODE_ISSUE_QUEUE_SCHEDULE_SCHEME = 0;
+
+void breakpoint(const char file[], const int line) {}
+const char* Op_State_str(Op_State state) {
+  return "";
+}
+Flag mem_can_allocate_req_buffer(uns proc_id, Mem_Req_Type type, Flag for_l1_writeback) {
+  return TRUE;
+}
+}
+
+#define FU_TYPE_WIDTH (2 * NUM_OP_TYPES)
+#define NUM_STATES 2000
+#define MAX_READY_OPS 40
+
+class NodeIssueQueueSchedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mystdout = mystatus = stdout;
+    mystderr = stderr;
+    node = &node_stage;
+    node_stage.proc_id = 0;
+  }
+
+  void TearDown() override { free_ports(); }
+
+  void free_ports() {
+    for (Reservation_Station& station : rs) {
+      free(station.connected_fus);
+      free(station.fu_type_fus);
+    }
+    rs.clear();
+  }
+
+  void init_ports(uns num_rs, uns num_fus, const std::string& rs_sizes, const std::string& rs_connections,
+                  const std::string& fu_types) {
+    free_ports();
+    NUM_RS = num_rs;
+    NUM_FUS = num_fus;
+    rs_sizes_str = rs_sizes;
+    rs_connections_str = rs_connections;
+    fu_types_str = fu_types;
+    RS_SIZES = &rs_sizes_str[0];
+    RS_CONNECTIONS = &rs_connections_str[0];
+    FU_TYPES = &fu_types_str[0];
+
+    fus.assign(num_fus, Func_Unit());
+    rs.assign(num_rs, Reservation_Station());
+    init_exec_ports_fu_list(0, fus.data());
+    init_exec_ports_rs_list(0, rs.data(), fus.data());
+    node_stage.rs = rs.data();
+    sd_ops.assign(num_fus, nullptr);
+    node_stage.sd.ops = sd_ops.data();
+    node_stage.sd.max_op_count = num_fus;
+  }
+
+  /* a random set of ready ops, in random ready-list order */
+  void make_ready_ops(std::mt19937_64& rng) {
+    uns num_ops = 1 + rng() % MAX_READY_OPS;
+    ops.assign(num_ops, Op());
+    table_infos.assign(num_ops, Table_Info());
+    std::vector<Counter> op_nums(num_ops);
+    for (uns i = 0; i < num_ops; ++i)
+      op_nums[i] = 1 + i * (1 + rng() % 4);
+    std::shuffle(op_nums.begin(), op_nums.end(), rng);
+    for (uns i = 0; i < num_ops; ++i) {
+      table_infos[i].op_type = (Op_Type)(rng() % NUM_OP_TYPES);
+      table_infos[i].is_simd = rng() % 2;
+      ops[i].table_info = &table_infos[i];
+      ops[i].op_num = op_nums[i];
+      ops[i].rs_id = rng() % NUM_RS;
+      ops[i].fu_num = -1;
+    }
+  }
+
+  /* schedules the ready ops with one scheme, returns the op chosen for every FU */
+  std::vector<Counter> schedule(void (*sched_func)(Op*)) {
+    std::fill(sd_ops.begin(), sd_ops.end(), nullptr);
+    node_stage.sd.op_count = 0;
+    node_stage.sched_fu_mask = 0;
+    for (Op& op : ops)
+      sched_func(&op);
+
+    std::vector<Counter> selected(NUM_FUS, 0);
+    for (uns fu_id = 0; fu_id < NUM_FUS; ++fu_id) {
+      if (sd_ops[fu_id]) {
+        EXPECT_EQ(sd_ops[fu_id]->fu_num, (int)fu_id);
+        selected[fu_id] = sd_ops[fu_id]->op_num;
+      }
+    }
+    EXPECT_EQ(node_stage.sd.op_count, (int)(NUM_FUS - std::count(sd_ops.begin(), sd_ops.end(), nullptr)));
+    return selected;
+  }
+
+  void check_same_selections(std::mt19937_64& rng, uns num_states) {
+    for (uns state = 0; state < num_states; ++state) {
+      make_ready_ops(rng);
+      std::vector<Counter> oldest_first = schedule(node_schedule_oldest_first_sched);
+      std::vector<Counter> oldest_first_mask = schedule(node_schedule_oldest_first_mask_sched);
+      ASSERT_EQ(oldest_first, oldest_first_mask) << "state " << state << " with " << ops.size() << " ready ops";
+    }
+  }
+
+  static std::string hex(uns64 val) {
+    char buf[20];
+    snprintf(buf, sizeof(buf), "x%llx", (unsigned long long)val);
+    return buf;
+  }
+
+  Node_Stage node_stage = {};
+  std::vector<Func_Unit> fus;
+  std::vector<Reservation_Station> rs;
+  std::vector<Op*> sd_ops;
+  std::vector<Op> ops;
+  std::vector<Table_Info> table_infos;
+  std::string rs_sizes_str, rs_connections_str, fu_types_str;
+};
+
+/* the ports of PARAMS.sunny_cove */
+TEST_F(NodeIssueQueueSchedTest, SunnyCovePorts) {
+  init_ports(3, 8, "64 32 32", "b00110011 b10000100 b01001000",
+             "b00100100111111100111001001111110010010011111110011100100111111 "
+             "b10010000110111100011111001110111001000011011110001111100111011 "
+             "b00000001000000001000000010000010000000100000000100000001000001 "
+             "b00000001000000001000000010000010000000100000000100000001000001 "
+             "b00000000110111100011011001110110000000011011110001101100111011 "
+             "b01001000000000000111001001111110100100000000000011100100111111 "
+             "b00000010000000010000000100000010000001000000001000000010000001 "
+             "b00000010000000010000000100000010000001000000001000000010000001");
+  std::mt19937_64 rng(1);
+  check_same_selections(rng, NUM_STATES);
+}
+
+/* FUs of one RS that differ in type, RSs that share FUs */
+TEST_F(NodeIssueQueueSchedTest, RandomPorts) {
+  std::mt19937_64 rng(2);
+  const uns64 all_types = FU_TYPE_WIDTH == 64 ? ~0ull : (1ull << FU_TYPE_WIDTH) - 1;
+
+  for (uns config = 0; config < 50; ++config) {
+    uns num_fus = 1 + rng() % 16;
+    uns num_rs = 1 + rng() % 4;
+    std::vector<uns64> types(num_fus);
+    uns64 covered = 0;
+    for (uns64& type : types) {
+      type = rng() & rng() & all_types;  // about a quarter of the op types per FU
+      covered |= type;
+    }
+    types[rng() % num_fus] |= all_types & ~covered;
+
+    std::string fu_types, rs_sizes, rs_connections;
+    for (uns64 type : types)
+      fu_types += hex(type ? type : all_types) + " ";
+    for (uns i = 0; i < num_rs; ++i) {
+      uns64 connections = rng() & ((1ull << num_fus) - 1);
+      rs_sizes += "16 ";
+      rs_connections += hex(connections ? connections : 1ull << (rng() % num_fus)) + " ";
+    }
+
+    init_ports(num_rs, num_fus, rs_sizes, rs_connections, fu_types);
+    check_same_selections(rng, NUM_STATES / 10);
+    if (HasFatalFailure())
+      return;
+  }
+}
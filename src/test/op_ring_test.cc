@@ -0,0 +1,194 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : op_ring_test.cc
+ * Description  : Runs the shared-memory op ring between two processes. The child
+ *                plays pin_exec (scarab_interface.cc): it writes ahead only while
+ *                two batches are free and no command is waiting, and marks the
+ *                batch that answers a fetch. The parent plays the exec-driven
+ *                frontend: it asks for a batch when the ring is empty, redirects
+ *                at random and drops the batches of old epochs.
+ ***************************************************************************************/
+
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../pin/pin_lib/op_ring.h"
+#include "gtest/gtest.h"
+
+#define NUM_OPS 2000000
+#define RING_BATCHES 16
+#define BUFFER_OPS 7 /* ops per batch, like a pin_exec buffer cut short by a syscall */
+#define REDIRECT_BACKUP 50
+#define TEST_TIMEOUT 60 /* seconds, a broken ring can keep both sides busy forever */
+
+enum Ring_Test_Cmd { RING_FETCH, RING_REDIRECT, RING_DONE };
+
+struct Ring_Test_Msg {
+  Ring_Test_Cmd type;
+  uint64_t epoch;
+  uint64_t uid;  // first op after a redirect
+};
+
+static bool has_message(int fd) {
+  struct pollfd pfd = {fd, POLLIN, 0};
+  return poll(&pfd, 1, 0) > 0;
+}
+
+/* the pin_exec side, numbers its ops by inst_uid */
+static int run_producer(const char* path, int fd) {
+  Op_Ring* ring = op_ring_attach(path);
+  compressed_op buffer[BUFFER_OPS];
+  uint32_t num_ops = 0;
+  uint64_t uid = 0, epoch = 0;
+  bool pending_fetch = false;
+
+  while (true) {
+    /* a waiting command is read first, a full buffer that cannot go out blocks on the socket */
+    bool full = num_ops == BUFFER_OPS;
+    bool can_send = pending_fetch || op_ring_free_batches(ring) >= 2;
+    if (has_message(fd) || (full && !can_send)) {
+      Ring_Test_Msg msg;
+      if (read(fd, &msg, sizeof(msg)) != sizeof(msg))
+        return 2;
+      if (msg.type == RING_FETCH) {
+        pending_fetch = true;
+      } else if (msg.type == RING_REDIRECT) {
+        epoch = msg.epoch;
+        uid = msg.uid;
+        num_ops = 0;
+      } else {
+        return 0;
+      }
+      continue;
+    }
+    if (!full) {
+      memset(&buffer[num_ops], 0, sizeof(buffer[num_ops]));
+      buffer[num_ops++].inst_uid = uid++;
+      continue;
+    }
+
+    Op_Ring_Batch* batch;
+    Op_Ring_Wait wait = {};
+    while (!(batch = op_ring_next_free(ring))) {
+      if (!op_ring_wait(&wait, 10))
+        return 3;
+    }
+    batch->epoch = epoch;
+    batch->num_ops = num_ops;
+    batch->is_response = pending_fetch;
+    memcpy(batch->ops, buffer, num_ops * sizeof(buffer[0]));
+    op_ring_publish(ring);
+    pending_fetch = false;
+    num_ops = 0;
+  }
+}
+
+static void send_msg(int fd, Ring_Test_Cmd type, uint64_t epoch, uint64_t uid) {
+  Ring_Test_Msg msg = {type, epoch, uid};
+  ASSERT_EQ(write(fd, &msg, sizeof(msg)), (ssize_t)sizeof(msg));
+}
+
+TEST(OpRingTest, TwoProcessesWithRedirects) {
+  char path[256];
+  op_ring_path(path, sizeof(path), getpid(), 0);
+  Op_Ring* ring = op_ring_create(path, RING_BATCHES);
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (!pid) {
+    close(fds[0]);
+    _exit(run_producer(path, fds[1]));
+  }
+  close(fds[1]);
+  alarm(TEST_TIMEOUT);
+
+  uint64_t expected_uid = 0, epoch = 0, num_ops = 0, num_batches = 0, redirects = 0;
+  bool fetch_outstanding = false;
+  Op_Ring_Wait wait = {};
+  unsigned seed = 1;
+  while (num_ops < NUM_OPS) {
+    Op_Ring_Batch* batch = op_ring_peek(ring);
+    if (!batch) {
+      if (!fetch_outstanding) {
+        send_msg(fds[0], RING_FETCH, epoch, 0);
+        fetch_outstanding = true;
+      }
+      ASSERT_TRUE(op_ring_wait(&wait, 10)) << "no batch after " << num_ops << " ops";
+      continue;
+    }
+    wait = {};
+    /* Scarab holds a batch while it simulates its ops, give pin_exec time to run ahead */
+    if (++num_batches % 64 == 0)
+      usleep(100);
+    if (batch->is_response)
+      fetch_outstanding = false;
+    if (batch->epoch == epoch) {
+      ASSERT_LE(batch->num_ops, (uint32_t)OP_RING_MAX_BATCH);
+      for (uint32_t ii = 0; ii < batch->num_ops; ii++, num_ops++)
+        ASSERT_EQ(batch->ops[ii].inst_uid, expected_uid++) << "epoch " << epoch;
+    }
+    op_ring_release(ring);
+
+    seed = seed * 1103515245 + 12345;
+    if ((seed >> 16) % 1000 == 0) {
+      epoch++;
+      redirects++;
+      expected_uid = expected_uid > REDIRECT_BACKUP ? expected_uid - REDIRECT_BACKUP : 0;
+      send_msg(fds[0], RING_REDIRECT, epoch, expected_uid);
+    }
+  }
+  alarm(0);
+  EXPECT_GT(redirects, 0u);
+
+  send_msg(fds[0], RING_DONE, 0, 0);
+  int status;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  op_ring_destroy(ring, path);
+  close(fds[0]);
+}
+
+TEST(OpRingTest, WaitBacksOffAndTimesOut) {
+  Op_Ring_Wait wait = {};
+  struct timespec start, end;
+  uint32_t calls = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (op_ring_wait(&wait, 1))
+    calls++;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+  EXPECT_GE(secs, 1.0);
+  EXPECT_LT(secs, 3.0);
+  EXPECT_EQ(wait.sleep_us, (uint32_t)OP_RING_WAIT_MAX_SLEEP_US);
+  /* at most the spins, the doubling sleeps and one sleep per OP_RING_WAIT_MAX_SLEEP_US after them */
+  EXPECT_LT(calls, OP_RING_WAIT_SPINS + 20 + 1000000 / OP_RING_WAIT_MAX_SLEEP_US);
+}
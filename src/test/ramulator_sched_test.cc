@@ -0,0 +1,145 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : ramulator_sched_test.cc
+ * Description  : Sends a fixed mix of streaming and random requests from four
+ *                cores to a DDR4 channel and checks the order and cycle in
+ *                which the reads complete under every scheduling policy. The
+ *                expected values were recorded with the std::list request
+ *                queues, so a change to how the scheduler breaks ties between
+ *                requests shows up here.
+ ***************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../ramulator/Config.h"
+#include "../ramulator/Request.h"
+#include "../ramulator/ScarabWrapper.h"
+#include "gtest/gtest.h"
+
+using namespace ramulator;
+
+#define NUM_REQUESTS 20000
+#define DRAIN_TICKS 20000
+
+static unsigned long long done_count, done_hash, cur_tick;
+static unsigned long long rng_state = 88172645463325252ULL;
+static unsigned long long streams[4] = {0x100000, 0x4000000, 0x9000000, 0x20000000};
+
+struct Expected {
+  const char* policy;
+  unsigned long long done_count;
+  unsigned long long sent_tick;
+  unsigned long long done_hash;
+};
+
+static const Expected expected[] = {
+  {"FCFS", 14985, 629494, 0x34e773f49c2a656eULL},
+  {"FRFCFS", 14985, 169978, 0xe7915f06683dc67eULL},
+  {"FRFCFS_Cap", 14985, 170859, 0x7b4150afb60940faULL},
+  {"FRFCFS_PriorHit", 14985, 155139, 0x6fc31d56d30dcfc3ULL},
+};
+
+static void read_done(Request& req) {
+  done_count++;
+  done_hash = done_hash * 1000003ULL + (unsigned long long)req.addr * 31 + req.coreid * 7 + cur_tick;
+}
+
+static void stats_callback(int, int) {}
+
+static unsigned long long rng() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return rng_state;
+}
+
+/* the DDR4 setup Scarab passes to ramulator, with one channel and rank */
+static void config(Config& configs, const char* policy) {
+  static const std::vector<std::pair<const char*, const char*>> params = {
+    {"standard", "DDR4"}, {"speed", "DDR4_2400R"}, {"org", "DDR4_8Gb_x8"}, {"channels", "1"}, {"ranks", "1"},
+    {"bank_groups", "4"}, {"banks", "4"}, {"rows", "65536"}, {"columns", "1024"}, {"chip_width", "8"},
+    {"channel_width", "64"}, {"record_cmd_trace", "off"}, {"print_cmd_trace", "off"},
+    {"use_rest_of_addr_as_row_addr", "on"}, {"readq_entries", "32"}, {"writeq_entries", "32"}, {"output_dir", "obj"},
+    {"tCK", "833333"}, {"tCL", "16"}, {"tCCD", "6"}, {"tCCDS", "4"}, {"tCCDL", "6"}, {"tCWL", "12"}, {"tBL", "4"},
+    {"tWTR", "9"}, {"tWTRS", "3"}, {"tWTRL", "9"}, {"tRP", "16"}, {"tRPpb", "16"}, {"tRPab", "16"}, {"tRCD", "16"},
+    {"tRCDR", "16"}, {"tRCDW", "16"}, {"tRAS", "39"}};
+  configs.set_core_num(4);
+  for (auto& param : params)
+    configs.add(param.first, param.second);
+  configs.add("scheduling_policy", policy);
+}
+
+/* a quarter of the requests go to random lines, the rest stream per core, a quarter are writes */
+static Request next_request() {
+  unsigned long long r = rng();
+  int core = r & 3;
+  Request req;
+  req.addr = (r >> 8) % 4 == 0 ? (rng() % (1ULL << 32)) & ~63ULL : (streams[core] += 64);
+  req.coreid = core;
+  req.type = ((r >> 4) & 3) == 0 ? Request::Type::WRITE : Request::Type::READ;
+  req.callback = read_done;
+  return req;
+}
+
+/* runs in its own process, ramulator's stat list can only be set up once */
+static void check_completion_order(const char* policy) {
+  Config configs;
+  config(configs, policy);
+  ScarabWrapper wrapper(configs, 64, stats_callback);
+
+  Request req = next_request();
+  for (long sent = 0; sent < NUM_REQUESTS;) {
+    cur_tick++;
+    for (int ii = 0; ii < 2 && sent < NUM_REQUESTS && wrapper.send(req); ii++) {
+      sent++;
+      req = next_request();
+    }
+    wrapper.tick();
+  }
+  unsigned long long sent_tick = cur_tick;
+  for (int ii = 0; ii < DRAIN_TICKS; ii++) {
+    cur_tick++;
+    wrapper.tick();
+  }
+
+  fprintf(stderr, "%s: %llu reads done, all sent at tick %llu, order hash 0x%llx\n", policy, done_count, sent_tick,
+          done_hash);
+  for (const Expected& exp : expected) {
+    if (std::string(exp.policy) == policy)
+      exit(done_count == exp.done_count && sent_tick == exp.sent_tick && done_hash == exp.done_hash ? 0 : 1);
+  }
+  exit(1);
+}
+
+class RamulatorSchedTest : public ::testing::TestWithParam<const char*> {};
+
+TEST_P(RamulatorSchedTest, CompletionOrder) {
+  EXPECT_EXIT(check_completion_order(GetParam()), ::testing::ExitedWithCode(0), "");
+}
+
+INSTANTIATE_TEST_SUITE_P(Policies, RamulatorSchedTest,
+                         ::testing::Values("FCFS", "FRFCFS", "FRFCFS_Cap", "FRFCFS_PriorHit"));
@@ -39,6 +39,9 @@
 #endif
 
 const char* PIN_EXEC_DRIVEN_FE_SOCKET = TEST_SOCKET_FILE;
+// the dummy client speaks the socket protocol only
+const uns PIN_EXEC_DRIVEN_OP_RING = 0;
+const uns PIN_EXEC_DRIVEN_OP_RING_TIMEOUT = 0;
 
 #ifndef NUM_CLIENTS
 #define NUM_CLIENTS 1
@@ -74,6 +74,7 @@ void init_thread(Thread_Data* td, char* argv[], char* envp[]) {
 void recover_thread(Thread_Data* td, Addr new_pc, Counter op_num, uns64 inst_uid, Flag remain_wrongpath) {
   recover_seq_op_list(td, op_num);
   recover_map();
+  recover_wake_up_lists(op_num);
   ASSERT(td->proc_id, !remain_wrongpath);
 }
 
@@ -54,6 +54,7 @@
 #include "libs/cpp_cache.h"
 #include "memory/memory.h"
 
+#include "checkpoint.h"
 #include "icache_stage.h"
 #include "op_pool.h"
 #include "statistics.h"
@@ -177,6 +178,7 @@ void init_uop_cache_stage(uns8 proc_id, const char* name) {
   // The cache library computes the number of entries from cache_size_bytes/cache_line_size_bytes
   per_core_uc_stage[proc_id].uop_cache =
       new Uop_Cache(UOP_CACHE_LINES, UOP_CACHE_ASSOC, UOP_CACHE_LINE_SIZE, (Repl_Policy)UOP_CACHE_REPL);
+  ckpt_register_object("uop_cache", proc_id, per_core_uc_stage[proc_id].uop_cache);
 }
 
 void recover_uop_cache(void) {
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+
+"""
+Renders the binary H2P analysis logs (written with --h2p_log_binary 1) back into the
+text format Scarab produces without that flag, e.g.
+
+   h2p_log_decode.py fill_buffer.bin > fill_buffer.out
+
+The schema (Retired_Op_Record field offsets and the enum/register name tables) is read
+from the file header, so the decoder does not depend on the simulator build.
+See src/log/log_writer.h for the file layout.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'SCRBH2PL'
+VERSION = 1
+
+REC_TEXT = 1
+REC_FILL_ROB_OP = 2
+REC_RETIRED_COUNT = 3
+REC_FILL_BUFFER = 4
+REC_ON_OFF_PATH = 5
+REC_DEP_CHAIN = 6
+REC_DEP_BLOCK = 7
+REC_CACHE_DUMP_BEGIN = 8
+REC_CACHE_DUMP_ENTRY = 9
+REC_CACHE_DUMP_END = 10
+
+MEM_LD = 1
+MEM_ST = 2
+
+INT_FORMATS = {1: 'B', 2: 'H', 4: 'I', 8: 'Q'}
+MISPRED_TYPES = ['----', 'MISP', 'MISF']
+
+
+def parse_args():
+  parser = argparse.ArgumentParser(description='Decode a binary Scarab H2P log into its text format.')
+  parser.add_argument('log_path', help='Path to a .bin log written with --h2p_log_binary 1')
+  parser.add_argument('-o', '--output', help='Output file (default: stdout)')
+  return parser.parse_args()
+
+
+class Reader:
+  def __init__(self, data, pos=0):
+    self.data = data
+    self.pos = pos
+
+  def done(self):
+    return self.pos >= len(self.data)
+
+  def take(self, size):
+    if self.pos + size > len(self.data):
+      raise EOFError('truncated log')
+    chunk = self.data[self.pos:self.pos + size]
+    self.pos += size
+    return chunk
+
+  def unpack(self, fmt):
+    return struct.unpack_from('<' + fmt, self.take(struct.calcsize('<' + fmt)))
+
+  def u8(self): return self.unpack('B')[0]
+  def u32(self): return self.unpack('I')[0]
+  def i32(self): return self.unpack('i')[0]
+  def u64(self): return self.unpack('Q')[0]
+
+  def str(self):
+    length = self.unpack('H')[0]
+    return self.take(length).decode('utf-8', errors='replace')
+
+  def table(self):
+    return [self.str() for _ in range(self.u32())]
+
+
+class Schema:
+  def __init__(self, reader):
+    if reader.take(len(MAGIC)) != MAGIC:
+      raise ValueError('not a binary H2P log (bad magic)')
+    version = reader.u32()
+    if version != VERSION:
+      raise ValueError(f'unsupported H2P log version {version}')
+    self.log_name = reader.str()
+    self.record_size = reader.u32()
+    self.fields = []
+    for _ in range(reader.u32()):
+      name = reader.str()
+      offset, size, count = reader.u32(), reader.u32(), reader.u32()
+      self.fields.append((name, offset, size, count))
+    self.op_names = reader.table()
+    self.cf_names = reader.table()
+    self.mem_names = reader.table()
+    self.reg_names = reader.table()
+    self.op_cf = self.op_names.index('CF')
+    self.mem_op_types = {self.op_names.index(name) for name in ('ILD', 'IST', 'FLD', 'FST') if name in self.op_names}
+
+  def decode_op(self, raw):
+    op = {}
+    for name, offset, size, count in self.fields:
+      fmt = '<' + INT_FORMATS[size] * count
+      values = struct.unpack_from(fmt, raw, offset)
+      op[name] = list(values) if count > 1 else values[0]
+    return op
+
+  def decode_ops(self, reader, num_ops):
+    return [self.decode_op(reader.take(self.record_size)) for _ in range(num_ops)]
+
+  def reg(self, reg_id):
+    return self.reg_names[reg_id] if reg_id < len(self.reg_names) else f'REG{reg_id}'
+
+  # Same output as disasm_retired_op() in src/log/log_writer.c.
+  def disasm_record(self, op):
+    opcode = self.op_names[op['op_type']]
+    if op['op_type'] == self.op_cf:
+      opcode = self.cf_names[op['cf_type']]
+    out = '%-8s ' % opcode
+    out += ','.join(f'r{r}({self.reg(r)})' for r in op['dests'][:op['num_dest_regs']])
+    if op['num_dest_regs'] > 0 and op['num_src_regs'] > 0:
+      out += ' <- '
+    out += ','.join(f'r{r}({self.reg(r)})' for r in op['srcs'][:op['num_src_regs']])
+    if op['mem_type'] in (MEM_LD, MEM_ST) and op['mem_size'] > 0:
+      out += ' %d@%08x' % (op['mem_size'], op['va'])
+    return out
+
+
+def mask_str(mask, length):
+  return ''.join('1' if (mask >> i) & 1 else '0' for i in range(length))
+
+
+def render_fill_rob_op(schema, hdr, out):
+  cycle, op_num, pc = hdr.u64(), hdr.u64(), hdr.u64()
+  off_path = hdr.u8()
+  is_cf = hdr.u8()
+  if is_cf:
+    h2p, hbt_ctr, mispred = hdr.u8(), hdr.u32(), hdr.u8()
+    npc, direction, pred_npc, pred = hdr.u64(), hdr.u8(), hdr.u64(), hdr.u8()
+  op_type, cf_type, mem_type = hdr.u8(), hdr.u8(), hdr.u8()
+  num_dests, num_srcs = hdr.u8(), hdr.u8()
+  dests = [(hdr.u8(), hdr.i32()) for _ in range(num_dests)]
+  srcs = [(hdr.u8(), hdr.i32()) for _ in range(num_srcs)]
+  mem_size, va = hdr.u32(), hdr.u64()
+
+  # Same output as disasm_op(op, TRUE) in src/debug/debug_print.c.
+  if op_type == schema.op_cf:
+    disasm = schema.cf_names[cf_type]
+  elif op_type in schema.mem_op_types:
+    disasm = schema.mem_names[mem_type]
+  else:
+    disasm = schema.op_names[op_type]
+  disasm += ' '
+  disasm += ', '.join(f'{schema.reg(r)}(r{r},p{p})' for r, p in dests)
+  if num_dests > 0 and num_srcs > 0:
+    disasm += ' <- '
+  disasm += ', '.join(f'{schema.reg(r)}(r{r},p{p})' for r, p in srcs)
+  if mem_type in (MEM_LD, MEM_ST) and mem_size > 0:
+    disasm += ' %d@%08x' % (mem_size, va & 0xffffffff)
+
+  if is_cf:
+    out.write('Cycle:%-10d OpNum:%-10d PC:0x%-10x OffPath:%d Disasm: %-80s H2P:%s HBT_CTR:%-3d Mispred_Type:%-4s '
+              'Target:0x%-10x Dir:%d PredNPC:0x%x Pred:%d\n' %
+              (cycle, op_num, pc, off_path, disasm, 'YES' if h2p else 'NO', hbt_ctr, MISPRED_TYPES[mispred], npc,
+               direction, pred_npc, pred))
+  else:
+    out.write('Cycle:%-10d OpNum:%-10d PC:0x%-10x OffPath:%d Disasm: %-60s\n' % (cycle, op_num, pc, off_path, disasm))
+
+
+def render_record(schema, rec_type, hdr, ops, out):
+  h2p = lambda op: 'O' if op['h2p'] else 'X'
+
+  if rec_type == REC_TEXT:
+    out.write(hdr.data.decode('utf-8', errors='replace'))
+  elif rec_type == REC_FILL_ROB_OP:
+    render_fill_rob_op(schema, hdr, out)
+  elif rec_type == REC_RETIRED_COUNT:
+    cycle, ret_count = hdr.u64(), hdr.u32()
+    out.write('Cycle:%-10d Retired Ops: %d\n' % (cycle, ret_count))
+  elif rec_type == REC_FILL_BUFFER:
+    proc_id, cycle = hdr.u32(), hdr.u64()
+    size, count, head, tail = hdr.u32(), hdr.u32(), hdr.u32(), hdr.u32()
+    out.write('--- [LOG] Fill Buffer for Core %d @ Cycle:%-6d ---\n' % (proc_id, cycle))
+    out.write('Buffer Size: %d | Count: %d | Head: %d | Tail: %d\n' % (size, count, head, tail))
+    out.write('---------------------------------------------------------\n')
+    for i, op in enumerate(ops):
+      out.write('[%3d] PC: 0x%08x | OpNum: %-10d | H2P: %s | Disasm: %-45s\n' %
+                (i, op['pc'], op['op_num'], h2p(op), schema.disasm_record(op)))
+    out.write('-------------------------- END LOG ---------------------------\n\n')
+  elif rec_type == REC_ON_OFF_PATH:
+    proc_id, pc, op_num = hdr.u32(), hdr.u64(), hdr.u64()
+    out.write('--- [LOG] On-Off Path for Core %d ---\n' % proc_id)
+    out.write('Triggering H2P Branch PC: 0x%x, OpNum: %d, Path Length: %d\n' % (pc, op_num, len(ops)))
+    out.write('------------------------------------------------------------------\n')
+    for op in ops:
+      out.write('[PC: 0x%08x] OpNum:%-10d (S/E/D/R: %-4d/%-4d/%-4d/%-4d) H2p:%s Disasm: %-45s\n' %
+                (op['pc'], op['op_num'], op['sched_cycle'], op['exec_cycle'], op['done_cycle'], op['retire_cycle'],
+                 h2p(op), schema.disasm_record(op)))
+    out.write('-------------------------- END LOG ---------------------------\n\n')
+  elif rec_type == REC_DEP_CHAIN:
+    proc_id, cycle, pc, op_num = hdr.u32(), hdr.u64(), hdr.u64(), hdr.u64()
+    out.write('--- [LOG] Dependency Chain for Core %d Cycle:%-4d---\n' % (proc_id, cycle))
+    out.write('Index PC(H2P Branch PC): 0x%x, OpNum: %d, Chain Length: %d\n' % (pc, op_num, len(ops)))
+    out.write('------------------------------------------------------------------\n')
+    for op in ops:
+      out.write('[PC: 0x%08x] OpNum:%-10d H2p:%s Disasm: %-45s\n' %
+                (op['pc'], op['op_num'], h2p(op), schema.disasm_record(op)))
+    out.write('-------------------------- END LOG ---------------------------\n\n')
+  elif rec_type == REC_DEP_BLOCK:
+    proc_id, cycle, pc, op_num = hdr.u32(), hdr.u64(), hdr.u64(), hdr.u64()
+    block_len, mask = hdr.u32(), hdr.u64()
+    out.write('--- [LOG] Dependency Chain Block for Core %d Cycle:%-4d---\n' % (proc_id, cycle))
+    out.write('Index PC(Block Starting PC): 0x%x, OpNum: %d\n' % (pc, op_num))
+    out.write('Block Length: %-3d Dependency Mask: %s\n' % (block_len, mask_str(mask, block_len)))
+    out.write('------------------------------------------------------------------\n')
+    out.write('Instructions in Block (Total: %d):\n' % len(ops))
+    for op in ops:
+      out.write('[PC: 0x%08x] OpNum:%-10d H2p:%s Disasm: %-45s\n' %
+                (op['pc'], op['op_num'], h2p(op), schema.disasm_record(op)))
+    out.write('-------------------------- END LOG ---------------------------\n\n')
+  elif rec_type == REC_CACHE_DUMP_BEGIN:
+    proc_id, cycle = hdr.u32(), hdr.u64()
+    out.write('\n=============== [CACHE DUMP] for Core %d @ Cycle:%-6d ===============\n' % (proc_id, cycle))
+  elif rec_type == REC_CACHE_DUMP_ENTRY:
+    index, pc, op_num = hdr.u32(), hdr.u64(), hdr.u64()
+    block_len, mask = hdr.u32(), hdr.u64()
+    out.write('[Index %-4d] PC: 0x%08x | OpNum: %-10d | BlockLen: %-2d | Mask: %s\n' %
+              (index, pc, op_num, block_len, mask_str(mask, block_len)))
+    out.write('             ChainLen: %d\n' % len(ops))
+    for j, op in enumerate(ops):
+      out.write('             |--> [%3d] PC: 0x%08x | OpNum: %-10d | H2P: %s | %s\n' %
+                (j, op['pc'], op['op_num'], h2p(op), schema.disasm_record(op)))
+  elif rec_type == REC_CACHE_DUMP_END:
+    out.write('=========================== END CACHE DUMP ===========================\n\n')
+  else:
+    raise ValueError(f'unknown record type {rec_type}')
+
+
+def decode(data, out):
+  reader = Reader(data)
+  schema = Schema(reader)
+  while not reader.done():
+    rec_type = reader.u8()
+    hdr = Reader(reader.take(reader.u32()))
+    ops = schema.decode_ops(reader, reader.u32())
+    render_record(schema, rec_type, hdr, ops, out)
+
+
+def main():
+  args = parse_args()
+  with open(args.log_path, 'rb') as f:
+    data = f.read()
+  if args.output:
+    with open(args.output, 'w') as out:
+      decode(data, out)
+  else:
+    decode(data, sys.stdout)
+
+
+main()
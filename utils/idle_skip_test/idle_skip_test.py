@@ -0,0 +1,148 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+# Idle Skip Equivalence Test
+
+Runs every config twice, without and with --idle_skip 1, and checks that
+all stat files of the two runs are identical. The only stat allowed to
+differ is IDLE_SKIPPED_CYCLES, which is printed to show how much of each run
+was skipped:
+
+> python ./utils/idle_skip_test/idle_skip_test.py results_dir
+
+The workloads are --frontend synth streams, so no binary or trace is needed.
+The H2P logs are turned off (--debug_cycle_stop 0) because IDLE_SKIP refuses
+to run with them.
+"""
+
+from __future__ import print_function
+
+import argparse
+import glob
+import itertools
+import os
+import shutil
+import subprocess
+import sys
+
+scarab_root_path = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+sys.path.append(scarab_root_path + '/bin')
+from scarab_globals import scarab_paths
+
+PARAMS_FILES = ['sunny_cove', 'golden_cove', 'cortex_a76']
+# The uop queue stage is a single instance shared by all cores, so only
+# single core runs complete in this tree.
+CORE_COUNTS = [1]
+
+# name -> extra scarab_args. synth_mem stalls on DRAM most of the time, which
+# is where IDLE_SKIP skips; synth_bp mispredicts often, so recoveries and
+# redirects end many of the skips.
+WORKLOADS = {
+  'synth'     : '',
+  'synth_mem' : '--synth_working_set 268435456 --synth_chase_pct 30',
+  'synth_bp'  : '--synth_branch_entropy 0.5',
+}
+
+IGNORED_STATS = ['IDLE_SKIPPED_CYCLES']
+
+def run(run_dir, workload, params, cores, idle_skip):
+  if os.path.exists(run_dir):
+    shutil.rmtree(run_dir)
+  os.makedirs(run_dir)
+  shutil.copy2(scarab_paths.src_dir + '/PARAMS.' + params, os.path.join(run_dir, 'PARAMS.in'))
+  scarab_args = ' '.join(filter(None, ['--inst_limit %d' % args.inst_limit, '--debug_cycle_stop 0',
+                                       '--idle_skip %d' % idle_skip, WORKLOADS[workload], args.scarab_args]))
+  cmd = [args.scarab, '--num_cores', str(cores), '--frontend', 'synth'] + scarab_args.split()
+  with open(os.path.join(run_dir, 'scarab.log'), 'w') as log:
+    status = subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT, cwd=run_dir)
+  if status:
+    raise RuntimeError('Scarab failed (status %d), see %s/scarab.log' % (status, run_dir))
+
+def read_stat_lines(path):
+  with open(path) as f:
+    return [line for line in f if not line.split() or line.split()[0] not in IGNORED_STATS]
+
+def skipped_cycles(run_dir):
+  with open(os.path.join(run_dir, 'core.stat.0.out')) as f:
+    for line in f:
+      fields = line.split()
+      if fields and fields[0] == 'IDLE_SKIPPED_CYCLES':
+        return int(fields[1])
+  return 0
+
+def compare(base_dir, skip_dir):
+  """Returns the stat files that differ between the two runs, with their
+  first differing line."""
+  diffs = []
+  base_files = sorted(os.path.basename(p) for p in glob.glob(os.path.join(base_dir, '*.stat.*out')))
+  skip_files = sorted(os.path.basename(p) for p in glob.glob(os.path.join(skip_dir, '*.stat.*out')))
+  if base_files != skip_files:
+    diffs.append('stat files differ: %s vs %s' % (base_files, skip_files))
+  for name in base_files:
+    if name not in skip_files:
+      continue
+    base_lines = read_stat_lines(os.path.join(base_dir, name))
+    skip_lines = read_stat_lines(os.path.join(skip_dir, name))
+    for base_line, skip_line in zip(base_lines, skip_lines):
+      if base_line != skip_line:
+        diffs.append('%s:\n  - %s  + %s' % (name, base_line, skip_line))
+        break
+    else:
+      if len(base_lines) != len(skip_lines):
+        diffs.append('%s: %d vs %d lines' % (name, len(base_lines), len(skip_lines)))
+  return diffs
+
+def __main():
+  global args
+
+  parser = argparse.ArgumentParser(description='Check that IDLE_SKIP leaves every stat unchanged')
+  parser.add_argument('results_dir', help='Directory for the runs.')
+  parser.add_argument('--workloads', default=','.join(WORKLOADS),
+                      help='Comma-separated workloads to run (default: %(default)s).')
+  parser.add_argument('--inst_limit', type=int, default=1000000, help='Instructions simulated per core.')
+  parser.add_argument('--scarab', default=scarab_paths.scarab_bin, help='Path to the scarab binary.')
+  parser.add_argument('--scarab_args', default='', help='Extra arguments for every run.')
+  args = parser.parse_args()
+
+  workloads = args.workloads.split(',')
+  for w in workloads:
+    if w not in WORKLOADS:
+      parser.error('unknown workload %s (known: %s)' % (w, ', '.join(WORKLOADS)))
+
+  failed = 0
+  for workload, params, cores in itertools.product(workloads, PARAMS_FILES, CORE_COUNTS):
+    name = '%s.%s.%dc' % (workload, params, cores)
+    base_dir = os.path.join(os.path.abspath(args.results_dir), name, 'base')
+    skip_dir = os.path.join(os.path.abspath(args.results_dir), name, 'idle_skip')
+    run(base_dir, workload, params, cores, 0)
+    run(skip_dir, workload, params, cores, 1)
+    diffs = compare(base_dir, skip_dir)
+    print('%-40s %-4s %12d cycles skipped' % (name, 'FAIL' if diffs else 'OK', skipped_cycles(skip_dir)))
+    for d in diffs:
+      print('  ' + d)
+    failed += bool(diffs)
+
+  if failed:
+    print('%d configs differ with IDLE_SKIP' % failed)
+  sys.exit(1 if failed else 0)
+
+if __name__ == "__main__":
+  __main()
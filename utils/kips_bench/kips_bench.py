@@ -0,0 +1,247 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+# Simulator Throughput Benchmark
+
+Runs a fixed matrix of Scarab configurations, records the wall time, peak
+RSS and KIPS (simulated kilo-instructions per host second) of each run to a
+JSON file and optionally compares them against a stored baseline:
+
+> python ./utils/kips_bench/kips_bench.py results_dir
+> python ./utils/kips_bench/kips_bench.py results_dir --baseline base.json --tolerance 0.05
+
+The default matrix crosses PARAMS.sunny_cove, PARAMS.golden_cove and
+PARAMS.kaby_lake with 1, 4 and 8 cores, and runs each single-core config
+once more with the uop cache, FDIP and the H2P fill buffer turned off one at
+a time. --full crosses everything instead. Each config runs --repeat times
+and the median wall time is kept, so the numbers are comparable across runs
+on the same host. Baselines only make sense on the host they were taken on.
+"""
+
+from __future__ import print_function
+
+import argparse
+import itertools
+import json
+import os
+import platform
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import time
+
+scarab_root_path = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+sys.path.append(scarab_root_path + '/bin')
+from scarab_globals import *
+
+PARAMS_FILES = ['sunny_cove', 'golden_cove', 'kaby_lake']
+CORE_COUNTS = [1, 4, 8]
+
+# name -> scarab_args that turn the feature off
+VARIANTS = {
+  'default'        : '',
+  'no_uop_cache'   : '--uop_cache_enable 0',
+  'no_fdip'        : '--fdip_enable 0',
+  'no_fill_buffer' : '--fill_buffer_size 0',
+}
+
+# name -> (frontend, program or trace, extra scarab_args). simple_loop is a
+# few hundred instructions, so its runs mostly time start-up and teardown. The
+# synth workloads need neither a binary nor a trace (--frontend synth).
+WORKLOADS = {
+  'qsort'       : ('exec',  scarab_paths.sim_dir + '/utils/qsort/test_qsort', ''),
+  'simple_loop' : ('trace', scarab_paths.src_dir + '/test/simple_loop.trace.bz2', ''),
+  'synth'       : ('synth', None, ''),
+  'synth_mem'   : ('synth', None, '--synth_working_set 268435456 --synth_chase_pct 30'),
+}
+
+def matrix(full):
+  configs = []
+  for params, cores, variant in itertools.product(PARAMS_FILES, CORE_COUNTS, VARIANTS):
+    if full or variant == 'default' or cores == 1:
+      configs.append((params, cores, variant))
+  return configs
+
+def build_test_qsort():
+  print('Building the test qsort static binary')
+  subprocess.check_call(['make', '-C', scarab_paths.sim_dir + '/utils/qsort', 'test_qsort'])
+
+def read_core_stats(run_dir, cores):
+  """Sums the instructions of all cores and takes the cycles of core 0 from
+  the header of the core.stat files."""
+  insts = 0
+  cycles = 0
+  for core in range(cores):
+    with open(os.path.join(run_dir, 'core.stat.%d.out' % core)) as f:
+      m = re.search(r'Cumulative:\s+Cycles:\s+(\d+)\s+Instructions:\s+(\d+)', f.read())
+    if not m:
+      raise RuntimeError('No cumulative counts in %s/core.stat.%d.out' % (run_dir, core))
+    cycles = cycles or int(m.group(1))
+    insts += int(m.group(2))
+  return insts, cycles
+
+def run_once(run_dir, workload, params, cores, variant):
+  frontend, target, workload_args = WORKLOADS[workload]
+  if os.path.exists(run_dir):
+    shutil.rmtree(run_dir)
+  os.makedirs(run_dir)
+
+  scarab_args = ' '.join(filter(None, ['--inst_limit %d' % args.inst_limit, workload_args, VARIANTS[variant],
+                                       args.scarab_args]))
+  if frontend == 'synth':
+    # scarab_launch.py wants a program or a trace, so run Scarab directly
+    shutil.copy2(scarab_paths.src_dir + '/PARAMS.' + params, os.path.join(run_dir, 'PARAMS.in'))
+    cmd = [args.scarab, '--num_cores', str(cores), '--frontend', 'synth'] + scarab_args.split()
+  else:
+    cmd = [sys.executable, scarab_paths.bin_dir + '/scarab_launch.py',
+           '--frontend', frontend,
+           '--params', scarab_paths.src_dir + '/PARAMS.' + params,
+           '--simdir', run_dir,
+           '--scarab', args.scarab,
+           '--scarab_args', scarab_args]
+    for _ in range(cores):
+      cmd += ['--program' if frontend == 'exec' else '--trace', target]
+
+  with open(os.path.join(run_dir, 'bench.log'), 'w') as log:
+    start = time.time()
+    proc = subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT, cwd=run_dir)
+    # wait4 reports the largest RSS of the launcher and everything it waited for
+    _, status, rusage = os.wait4(proc.pid, 0)
+    wall = time.time() - start
+  if status:
+    raise RuntimeError('Scarab failed (status %d), see %s/bench.log' % (status, run_dir))
+
+  insts, cycles = read_core_stats(run_dir, cores)
+  return {'wall_s': wall, 'peak_rss_kb': rusage.ru_maxrss, 'insts': insts, 'cycles': cycles}
+
+def run_config(workload, params, cores, variant):
+  name = '%s.%s.%dc.%s' % (workload, params, cores, variant)
+  runs = []
+  for rep in range(args.repeat):
+    run_dir = os.path.join(os.path.abspath(args.results_dir), name, 'rep%d' % rep)
+    runs.append(run_once(run_dir, workload, params, cores, variant))
+  wall = statistics.median(r['wall_s'] for r in runs)
+  result = {
+    'name'        : name,
+    'workload'    : workload,
+    'params'      : params,
+    'cores'       : cores,
+    'variant'     : variant,
+    'insts'       : runs[0]['insts'],
+    'cycles'      : runs[0]['cycles'],
+    'wall_s'      : wall,
+    'peak_rss_kb' : max(r['peak_rss_kb'] for r in runs),
+    'kips'        : runs[0]['insts'] / 1000.0 / wall if wall else 0.0,
+  }
+  print('%-48s %8.2f s %10d KB %10.1f KIPS' % (name, result['wall_s'], result['peak_rss_kb'], result['kips']))
+  return result
+
+def compare(results, baseline, tolerance):
+  """Returns the regressions of results against baseline: KIPS lower, or
+  peak RSS higher, by more than tolerance."""
+  base = {r['name']: r for r in baseline['runs']}
+  regressions = []
+  for r in results['runs']:
+    b = base.get(r['name'])
+    if not b:
+      continue
+    if r['kips'] < b['kips'] * (1 - tolerance):
+      regressions.append('%s: %.1f KIPS, baseline %.1f' % (r['name'], r['kips'], b['kips']))
+    if r['peak_rss_kb'] > b['peak_rss_kb'] * (1 + tolerance):
+      regressions.append('%s: %d KB peak RSS, baseline %d' % (r['name'], r['peak_rss_kb'], b['peak_rss_kb']))
+    if r['insts'] != b['insts']:
+      print('Note: %s simulated %d insts, baseline %d' % (r['name'], r['insts'], b['insts']))
+  missing = sorted(set(base) - set(r['name'] for r in results['runs']))
+  if missing:
+    print('Note: not run this time: ' + ', '.join(missing))
+  return regressions
+
+def git_rev():
+  try:
+    return subprocess.check_output(['git', '-C', scarab_paths.sim_dir, 'rev-parse', '--short', 'HEAD'],
+                                   universal_newlines=True).strip()
+  except (OSError, subprocess.CalledProcessError):
+    return 'unknown'
+
+def __main():
+  global args
+
+  parser = argparse.ArgumentParser(description='Measure Scarab simulation throughput (KIPS)')
+  parser.add_argument('results_dir', help='Directory for the runs and results.json.')
+  parser.add_argument('--workloads', default=','.join(WORKLOADS),
+                      help='Comma-separated workloads to run (default: %(default)s).')
+  parser.add_argument('--full', action='store_true', help='Cross every params file, core count and variant.')
+  parser.add_argument('--repeat', type=int, default=3, help='Runs per config; the median wall time is kept.')
+  parser.add_argument('--inst_limit', type=int, default=5000000, help='Instructions simulated per core.')
+  parser.add_argument('--scarab', default=scarab_paths.scarab_bin, help='Path to the scarab binary.')
+  parser.add_argument('--scarab_args', default='', help='Extra arguments for every run.')
+  parser.add_argument('--baseline', default=None, help='results.json of an earlier run to compare against.')
+  parser.add_argument('--tolerance', type=float, default=0.05,
+                      help='Allowed relative KIPS loss and peak RSS growth (default: %(default)s).')
+  parser.add_argument('--update_baseline', action='store_true', help='Write the results to --baseline afterwards.')
+  args = parser.parse_args()
+
+  workloads = args.workloads.split(',')
+  for w in workloads:
+    if w not in WORKLOADS:
+      parser.error('unknown workload %s (known: %s)' % (w, ', '.join(WORKLOADS)))
+  if 'qsort' in workloads:
+    build_test_qsort()
+  os.makedirs(args.results_dir, exist_ok=True)
+
+  results = {
+    'scarab_rev' : git_rev(),
+    'host'       : platform.node(),
+    'date'       : time.strftime('%Y-%m-%d %H:%M:%S'),
+    'inst_limit' : args.inst_limit,
+    'repeat'     : args.repeat,
+    'runs'       : [],
+  }
+  for workload in workloads:
+    for params, cores, variant in matrix(args.full):
+      results['runs'].append(run_config(workload, params, cores, variant))
+
+  results_path = os.path.join(args.results_dir, 'results.json')
+  with open(results_path, 'w') as f:
+    json.dump(results, f, indent=2)
+  print('Results written to', results_path)
+
+  status = 0
+  if args.baseline and os.path.exists(args.baseline):
+    with open(args.baseline) as f:
+      baseline = json.load(f)
+    if baseline.get('host') != results['host']:
+      print('Warning: baseline was taken on %s, this is %s' % (baseline.get('host'), results['host']))
+    regressions = compare(results, baseline, args.tolerance)
+    for r in regressions:
+      print('REGRESSION', r)
+    if not regressions:
+      print('No regressions against', args.baseline)
+    status = 1 if regressions else 0
+  if args.baseline and args.update_baseline:
+    shutil.copyfile(results_path, args.baseline)
+    print('Baseline updated:', args.baseline)
+  sys.exit(status)
+
+if __name__ == "__main__":
+  __main()
@@ -0,0 +1,178 @@
+"""
+Reader for the columnar stat files Scarab writes with --stat_sink 1, e.g.
+
+   from stat_sink import StatSink
+   sink = StatSink('stats.sink')
+   ipc = [i / c for i, c in zip(sink.insts(0), sink.cycles())]
+   misses = sink.intervals('DCACHE_MISS', core=0)
+
+Every sample holds the run-long value of every stat (interval plus total), so
+a series is cumulative; intervals() differences it. The stat names, types and
+files are read from the file header, so the reader does not depend on the
+simulator build. See src/stat_sink.h for the file layout.
+"""
+
+import struct
+import zlib
+from array import array
+
+MAGIC = b'SCRBSTSK'
+VERSION = 1
+MASK = (1 << 64) - 1
+
+HEADER = struct.Struct('<8sIIII')
+STAT_DESC = struct.Struct('<IIHH')
+BLOCK_HEADER = struct.Struct('<II')
+
+# Stat_Type in src/statistics.h
+COUNT_TYPE_STAT = 0
+FLOAT_TYPE_STAT = 1
+DIST_TYPE_STAT = 2
+PER_INST_TYPE_STAT = 3
+PER_1000_INST_TYPE_STAT = 4
+PER_1000_PRET_INST_TYPE_STAT = 5
+PER_CYCLE_TYPE_STAT = 6
+RATIO_TYPE_STAT = 7
+PERCENT_TYPE_STAT = 8
+LINE_TYPE_STAT = 9
+
+
+class Stat:
+  def __init__(self, index, name, type, ratio_stat, file_name):
+    self.index = index
+    self.name = name
+    self.type = type
+    self.ratio_stat = ratio_stat
+    self.file_name = file_name
+
+
+class Sample:
+  """Values of one sample: cycles, per-core insts and pret_insts, and
+  values[core][stat index]."""
+
+  def __init__(self, cycles, insts, pret_insts, values):
+    self.cycles = cycles
+    self.insts = insts
+    self.pret_insts = pret_insts
+    self.values = values
+
+
+class StatSink:
+  def __init__(self, path):
+    with open(path, 'rb') as f:
+      self.data = f.read()
+    magic, version, self.num_cores, self.num_stats, self.num_columns = HEADER.unpack_from(self.data, 0)
+    if magic != MAGIC:
+      raise ValueError(f'{path}: not a stat sink file (bad magic)')
+    if version != VERSION:
+      raise ValueError(f'{path}: unsupported stat sink version {version}')
+    if self.num_columns != 1 + 2 * self.num_cores + self.num_cores * self.num_stats:
+      raise ValueError(f'{path}: inconsistent column count')
+
+    pos = HEADER.size
+    self.stats = []
+    for index in range(self.num_stats):
+      type, ratio_stat, name_length, file_name_length = STAT_DESC.unpack_from(self.data, pos)
+      pos += STAT_DESC.size
+      name = self.data[pos:pos + name_length].decode()
+      pos += name_length
+      file_name = self.data[pos:pos + file_name_length].decode()
+      pos += file_name_length
+      self.stats.append(Stat(index, name, type, ratio_stat, file_name))
+    self.stat_index = {stat.name: stat.index for stat in self.stats}
+
+    # (payload offset, payload size, samples, first sample) of every block
+    self.blocks = []
+    self.num_samples = 0
+    while pos + BLOCK_HEADER.size <= len(self.data):
+      num_samples, size = BLOCK_HEADER.unpack_from(self.data, pos)
+      pos += BLOCK_HEADER.size
+      if pos + size > len(self.data):
+        break  # a block the simulator was still writing
+      self.blocks.append((pos, size, num_samples, self.num_samples))
+      self.num_samples += num_samples
+      pos += size
+    self._cached_block = None
+
+  def _decode_block(self, block):
+    if self._cached_block and self._cached_block[0] == block:
+      return self._cached_block[1]
+    offset, size, num_samples, _ = self.blocks[block]
+    payload = array('Q')
+    payload.frombytes(zlib.decompress(self.data[offset:offset + size]))
+    self._cached_block = (block, payload)
+    return payload
+
+  def _is_float_column(self, column):
+    first_stat_column = 1 + 2 * self.num_cores
+    if column < first_stat_column:
+      return False
+    return self.stats[(column - first_stat_column) % self.num_stats].type == FLOAT_TYPE_STAT
+
+  def _column_in_block(self, block, column):
+    payload = self._decode_block(block)
+    num_samples = self.blocks[block][2]
+    deltas = payload[column * num_samples:(column + 1) * num_samples]
+    values = []
+    prev = 0
+    if self._is_float_column(column):
+      for delta in deltas:
+        prev ^= delta
+        values.append(struct.unpack('<d', struct.pack('<Q', prev))[0])
+    else:
+      for delta in deltas:
+        prev = (prev + delta) & MASK
+        values.append(prev)
+    return values
+
+  def column(self, column):
+    values = []
+    for block in range(len(self.blocks)):
+      values.extend(self._column_in_block(block, column))
+    return values
+
+  def stat_column(self, stat, core=0):
+    index = self.stat_index[stat] if isinstance(stat, str) else stat
+    return 1 + 2 * self.num_cores + core * self.num_stats + index
+
+  def cycles(self):
+    return self.column(0)
+
+  def insts(self, core=0):
+    return self.column(1 + 2 * core)
+
+  def pret_insts(self, core=0):
+    return self.column(2 + 2 * core)
+
+  def series(self, stat, core=0):
+    """Run-long value of a stat at every sample."""
+    return self.column(self.stat_column(stat, core))
+
+  def intervals(self, stat, core=0):
+    """Change of a stat between consecutive samples (the first from zero)."""
+    values = self.series(stat, core)
+    return [cur - prev for prev, cur in zip([0] + values[:-1], values)]
+
+  def _block_samples(self, block):
+    columns = [self._column_in_block(block, column) for column in range(self.num_columns)]
+    first_stat_column = 1 + 2 * self.num_cores
+    for pos in range(self.blocks[block][2]):
+      row = [values[pos] for values in columns]
+      values = [row[first_stat_column + core * self.num_stats:first_stat_column + (core + 1) * self.num_stats]
+                for core in range(self.num_cores)]
+      yield Sample(row[0], row[1:first_stat_column:2], row[2:first_stat_column:2], values)
+
+  def samples(self):
+    """All samples in order, decoding every block once."""
+    for block in range(len(self.blocks)):
+      yield from self._block_samples(block)
+
+  def sample(self, index):
+    if index < 0:
+      index += self.num_samples
+    if not 0 <= index < self.num_samples:
+      raise IndexError(f'sample {index} out of range ({self.num_samples} samples)')
+    block = next(b for b, (_, _, num, first) in enumerate(self.blocks) if first <= index < first + num)
+    for pos, sample in enumerate(self._block_samples(block)):
+      if pos == index - self.blocks[block][3]:
+        return sample
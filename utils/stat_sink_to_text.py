@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+
+"""
+Writes samples of a stat sink file (--stat_sink 1) as the .stat.out text files
+dump_stats() produces, e.g.
+
+   stat_sink_to_text.py stats.sink -o final/            # the last sample, like a normal run
+   stat_sink_to_text.py stats.sink --all -o periods/    # every sample, like --periodic_dump
+
+Without --periodic a sample is written the way the final dump of a run without
+--clear_stats is.
+With --periodic (implied by --all) the counts are those since the previous
+sample and the files get the .period.<sample> suffix --periodic_dump uses.
+Only the .out files are written, not their CSV twins.
+"""
+
+import argparse
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from stat_sink import (COUNT_TYPE_STAT, DIST_TYPE_STAT, FLOAT_TYPE_STAT, LINE_TYPE_STAT,  # noqa: E402
+                       PER_1000_INST_TYPE_STAT, PER_1000_PRET_INST_TYPE_STAT, PER_CYCLE_TYPE_STAT, PER_INST_TYPE_STAT,
+                       PERCENT_TYPE_STAT, RATIO_TYPE_STAT, StatSink)
+
+
+def parse_args():
+  parser = argparse.ArgumentParser(description='Convert a Scarab stat sink file into .stat.out files.')
+  parser.add_argument('sink_path', help='Path to a file written with --stat_sink 1')
+  parser.add_argument('-o', '--output_dir', default='.', help='Directory for the .stat.out files (default: .)')
+  parser.add_argument('-s', '--sample', type=int, default=-1, help='Sample to write (default: the last one)')
+  parser.add_argument('--periodic', action='store_true', help='Write counts since the previous sample')
+  parser.add_argument('--all', action='store_true', help='Write every sample (implies --periodic)')
+  parser.add_argument('--file_tag', default='', help='Prefix of the file names, as --file_tag')
+  return parser.parse_args()
+
+
+def div(a, b):
+  # C double division, which the text files were written with
+  if b == 0:
+    return math.nan if a == 0 else math.copysign(math.inf, a)
+  return a / b
+
+
+def num(fmt, x):
+  # glibc prints the NaN of 0.0 / 0.0 as -nan
+  text = fmt % x
+  return text.replace(' nan', '-nan') if math.isnan(x) else text
+
+
+def line():
+  return '#' * 100 + '\n'
+
+
+class Dump:
+  """The stat_array, cycle_count and inst_count dump_stats() sees for one core."""
+
+  def __init__(self, sink, core, cur, prev, periodic):
+    self.stats = sink.stats
+    self.total = cur.values[core]
+    base = prev.values[core] if prev and periodic else [0] * sink.num_stats
+    self.count = [c - b for c, b in zip(self.total, base)]
+    self.cycles = cur.cycles
+    self.insts = cur.insts[core]
+    self.pret_insts = cur.pret_insts[core]
+    self.pret_insts0 = cur.pret_insts[0]
+    self.period_cycles = cur.cycles - (prev.cycles if prev and periodic else 0)
+    self.period_insts = cur.insts[core] - (prev.insts[core] if prev and periodic else 0)
+
+  def header(self, core):
+    out = '/* -*- Mode: c -*- */\n' + line() + 'Core %u\n' % core + line()
+    out += 'Cumulative:        Cycles: %-20d  Instructions: %-20d  IPC: %s\n\n' % (
+        self.cycles, self.insts, num('%.5f', div(self.insts, self.cycles)))
+    out += 'Periodic:          Cycles: %-20d  Instructions: %-20d  IPC: %s\n\n' % (
+        self.period_cycles, self.period_insts, num('%.5f', div(self.period_insts, self.period_cycles)))
+    return out
+
+  def ratio_line(self, ii, scale, count_div, total_div, pct):
+    fmt = '%12.3f%%' if pct else '%13.4f'
+    return '%13d %s    %13d %s\n' % (self.count[ii], num(fmt, div(scale * self.count[ii], count_div)),
+                                       self.total[ii], num(fmt, div(scale * self.total[ii], total_div)))
+
+  def dist(self, ii):
+    jj = ii + 1
+    while self.stats[jj].type != DIST_TYPE_STAT:
+      jj += 1
+    span = range(ii, jj + 1)
+    sums = [sum(values[k] for k in span) for values in (self.count, self.total)]
+    vtotals = [sum((k - ii) * values[k] for k in span) for values in (self.count, self.total)]
+    stddevs = []
+    for values, s, vtotal in zip((self.count, self.total), sums, vtotals):
+      mean = div(vtotal, s)
+      # as dump_stats(), which weighs the first bucket's term by the last bucket
+      variance = (0 - mean) ** 2 * values[jj] + sum((k - ii - mean) ** 2 * values[k] for k in span[1:])
+      variance = div(variance, s - 1)
+      stddevs.append(math.sqrt(variance) if variance >= 0 else math.nan)
+    return jj, sums, vtotals, stddevs
+
+  def stat(self, ii, dist_state):
+    s = self.stats[ii]
+    out = ''
+    if s.type == LINE_TYPE_STAT:
+      out += '\n/' + '*' * 43 + '*' * 43 + '/\n'
+    out += '%-40s ' % s.name
+    count, total = self.count[ii], self.total[ii]
+
+    if s.type == COUNT_TYPE_STAT and not dist_state:
+      out += '%13d %13s    %13d %13s\n' % (count, '', total, '')
+    elif s.type == COUNT_TYPE_STAT or (s.type == DIST_TYPE_STAT and not dist_state):
+      if s.type == DIST_TYPE_STAT:
+        dist_state.extend(self.dist(ii))
+      sums = dist_state[1]
+      out += '%13d %s    %13d %s' % (count, num('%12.3f%%', div(count * 100, sums[0])), total,
+                                      num('%12.3f%%', div(total * 100, sums[1])))
+    elif s.type == DIST_TYPE_STAT:
+      _, sums, vtotals, stddevs = dist_state
+      dist_state.clear()
+      out += '%13d %s    %13d %s\n' % (count, num('%12.3f%%', div(count * 100, sums[0])), total,
+                                        num('%12.3f%%', div(total * 100, sums[1])))
+      out += '%-40s %13d %s    %13d %s\n' % ('', sums[0], num('%12.3f%%', div(sums[0] * 100, sums[0])), sums[1],
+                                              num('%12.3f%%', div(sums[1] * 100, sums[1])))
+      out += '%-40s  %s %s      %s %s\n' % ('', num('%12.2f', div(vtotals[0], sums[0])), num('%12.2f', stddevs[0]),
+                                               num('%12.2f', div(vtotals[1], sums[1])), num('%12.2f', stddevs[1]))
+    elif s.type == FLOAT_TYPE_STAT:
+      out += '%13f %13s    %13f %13s\n' % (count, '', total, '')
+    elif s.type == PER_INST_TYPE_STAT:
+      out += self.ratio_line(ii, 1, self.insts, self.insts, False)
+    elif s.type == PER_1000_INST_TYPE_STAT:
+      out += self.ratio_line(ii, 1000, self.insts, self.insts, False)
+    elif s.type == PER_1000_PRET_INST_TYPE_STAT:
+      out += self.ratio_line(ii, 1000, self.pret_insts, self.pret_insts0, False)
+    elif s.type == PER_CYCLE_TYPE_STAT:
+      out += self.ratio_line(ii, 1, self.cycles, self.cycles, False)
+    elif s.type == RATIO_TYPE_STAT:
+      out += self.ratio_line(ii, 1, self.count[s.ratio_stat], self.total[s.ratio_stat], False)
+    elif s.type == PERCENT_TYPE_STAT:
+      out += self.ratio_line(ii, 100, self.count[s.ratio_stat], self.total[s.ratio_stat], True)
+    elif s.type == LINE_TYPE_STAT:
+      out += '\n/' + '*' * 43 + '*' * 43 + '/\n'
+    else:
+      raise ValueError(f'invalid type {s.type} of stat {s.name}')
+    return out + '\n'
+
+
+def write_sample(sink, index, cur, prev, args):
+  periodic = args.periodic or args.all
+  for core in range(sink.num_cores):
+    dump = Dump(sink, core, cur, prev, periodic)
+    out = None
+    dist_state = []
+    last_file_name = None
+    for ii, s in enumerate(sink.stats):
+      if s.file_name != last_file_name:
+        if out:
+          out.write('\n\n')
+          out.close()
+        last_file_name = s.file_name
+        # same name as gen_stat_output_file(): cut off 'def', add the core and 'out'
+        name = '%s%s%u.out' % (args.file_tag, s.file_name[:-3], core)
+        if periodic:
+          name += '.period.%d' % index
+        out = open(os.path.join(args.output_dir, name), 'w')
+        out.write(dump.header(core))
+      out.write(dump.stat(ii, dist_state))
+    if out:
+      out.write('\n\n')
+      out.close()
+
+
+def main():
+  args = parse_args()
+  sink = StatSink(args.sink_path)
+  if not sink.num_samples:
+    sys.exit(f'{args.sink_path}: no samples')
+  os.makedirs(args.output_dir, exist_ok=True)
+
+  if args.all:
+    prev = None
+    for index, cur in enumerate(sink.samples()):
+      write_sample(sink, index, cur, prev, args)
+      prev = cur
+  else:
+    index = args.sample if args.sample >= 0 else sink.num_samples + args.sample
+    cur = sink.sample(index)
+    prev = sink.sample(index - 1) if index > 0 else None
+    write_sample(sink, index, cur, prev, args)
+
+
+main()